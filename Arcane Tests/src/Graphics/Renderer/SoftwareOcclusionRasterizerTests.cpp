@@ -0,0 +1,290 @@
+#include "arcpch.h"
+#include "TestFramework.h"
+
+#include <Arcane/Graphics/Renderer/SoftwareOcclusionRasterizer.h>
+
+#include <chrono>
+
+using namespace Arcane;
+
+namespace
+{
+	const int TestWidth = 256, TestHeight = 128;
+
+	// Camera at the origin looking down -z, the same aspect ratio as the depth buffer
+	glm::mat4 GetPerspectiveViewProjection()
+	{
+		glm::mat4 projection = glm::perspective(glm::radians(90.0f), static_cast<float>(TestWidth) / TestHeight, 0.1f, 200.0f);
+		glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+		return projection * view;
+	}
+
+	// Maps world xy straight to pixels, z = 0 ends up at a depth of 0.5
+	glm::mat4 GetPixelViewProjection()
+	{
+		return glm::ortho(0.0f, static_cast<float>(TestWidth), 0.0f, static_cast<float>(TestHeight), -1.0f, 1.0f);
+	}
+
+	// Counter clockwise when seen from +z
+	void AddQuad(SoftwareOcclusionRasterizer &rasterizer, const glm::vec3 &min, const glm::vec3 &max, bool clockwise = false, bool cullBackface = true)
+	{
+		std::vector<glm::vec3> positions = { glm::vec3(min.x, min.y, min.z), glm::vec3(max.x, min.y, min.z), glm::vec3(max.x, max.y, max.z), glm::vec3(min.x, max.y, max.z) };
+		std::vector<unsigned int> indices = clockwise ? std::vector<unsigned int>{ 0, 2, 1, 0, 3, 2 } : std::vector<unsigned int>{ 0, 1, 2, 0, 2, 3 };
+		rasterizer.AddOccluderMesh(positions, indices, glm::mat4(1.0f), cullBackface);
+	}
+
+	bool IsBoxOccluded(const SoftwareOcclusionRasterizer &rasterizer, const glm::vec3 &center, float halfExtent)
+	{
+		return rasterizer.IsOccluded(glm::mat4(1.0f), center - glm::vec3(halfExtent), center + glm::vec3(halfExtent));
+	}
+
+	float GetDepth(const SoftwareOcclusionRasterizer &rasterizer, int x, int y)
+	{
+		return rasterizer.GetDepthBuffer()[y * rasterizer.GetWidth() + x];
+	}
+
+	// Fixed city block style scene used by the determinism test and the benchmark. Uses it's own LCG so the scene is the same with every standard library
+	struct BenchmarkScene
+	{
+		std::vector<std::pair<glm::vec3, glm::vec3>> Walls, QueryBoxes;
+
+		BenchmarkScene()
+		{
+			uint32_t state = 12345u;
+			auto random = [&state](float min, float max)
+			{
+				state = state * 1664525u + 1013904223u;
+				return min + (max - min) * (static_cast<float>(state >> 8) / 16777216.0f);
+			};
+
+			for (int i = 0; i < 256; i++)
+			{
+				glm::vec3 center(random(-80.0f, 80.0f), 0.0f, random(-150.0f, -5.0f));
+				glm::vec3 halfSize(random(1.0f, 8.0f), random(2.0f, 12.0f), random(1.0f, 8.0f));
+				Walls.push_back({ center - halfSize, center + halfSize });
+			}
+			for (int i = 0; i < 4096; i++)
+			{
+				glm::vec3 center(random(-80.0f, 80.0f), random(-2.0f, 10.0f), random(-150.0f, -5.0f));
+				QueryBoxes.push_back({ center - glm::vec3(0.5f), center + glm::vec3(0.5f) });
+			}
+		}
+
+		void Rasterize(SoftwareOcclusionRasterizer &rasterizer) const
+		{
+			rasterizer.BeginFrame(GetPerspectiveViewProjection());
+			for (const auto &wall : Walls)
+			{
+				rasterizer.AddOccluderBox(wall.first, wall.second);
+			}
+			rasterizer.Rasterize();
+		}
+	};
+}
+
+ARC_TEST(BoxBehindQuadIsOccluded)
+{
+	SoftwareOcclusionRasterizer rasterizer(TestWidth, TestHeight);
+	rasterizer.BeginFrame(GetPerspectiveViewProjection());
+	AddQuad(rasterizer, glm::vec3(-2.0f, -2.0f, -5.0f), glm::vec3(2.0f, 2.0f, -5.0f));
+	rasterizer.Rasterize();
+
+	ARC_CHECK(IsBoxOccluded(rasterizer, glm::vec3(0.0f, 0.0f, -10.0f), 0.5f));
+	ARC_CHECK(!IsBoxOccluded(rasterizer, glm::vec3(0.0f, 0.0f, -3.0f), 0.5f)); // In front of the quad
+	ARC_CHECK(!IsBoxOccluded(rasterizer, glm::vec3(8.0f, 0.0f, -10.0f), 0.5f)); // Beside the quad
+	ARC_CHECK(!IsBoxOccluded(rasterizer, glm::vec3(3.0f, 0.0f, -10.0f), 1.5f)); // Only partially behind it
+	ARC_CHECK(!IsBoxOccluded(rasterizer, glm::vec3(0.0f, 0.0f, 2.0f), 0.5f)); // Behind the camera
+}
+
+ARC_TEST(EmptyBufferOccludesNothing)
+{
+	SoftwareOcclusionRasterizer rasterizer(TestWidth, TestHeight);
+	rasterizer.BeginFrame(GetPerspectiveViewProjection());
+	rasterizer.Rasterize();
+
+	ARC_CHECK(rasterizer.GetTriangleCount() == 0);
+	ARC_CHECK(!IsBoxOccluded(rasterizer, glm::vec3(0.0f, 0.0f, -50.0f), 0.5f));
+}
+
+ARC_TEST(NearPlaneClipping)
+{
+	// A floor that starts behind the camera, the triangles crossing the near plane have to be clipped instead of projected through w <= 0
+	SoftwareOcclusionRasterizer rasterizer(TestWidth, TestHeight);
+	rasterizer.BeginFrame(GetPerspectiveViewProjection());
+	std::vector<glm::vec3> floor = { glm::vec3(-50.0f, -1.0f, 10.0f), glm::vec3(50.0f, -1.0f, 10.0f), glm::vec3(50.0f, -1.0f, -90.0f), glm::vec3(-50.0f, -1.0f, -90.0f) };
+	rasterizer.AddOccluderMesh(floor, { 0, 1, 2, 0, 2, 3 }, glm::mat4(1.0f), false);
+	rasterizer.Rasterize();
+
+	ARC_CHECK(rasterizer.GetTriangleCount() > 2); // Clipping a triangle against the near plane can turn it into two
+
+	// The floor is below eye level so nothing above the horizon can be written, and every written depth has to be in range
+	bool aboveHorizonUntouched = true, depthsInRange = true;
+	for (int y = 0; y < TestHeight; y++)
+	{
+		for (int x = 0; x < TestWidth; x++)
+		{
+			float depth = GetDepth(rasterizer, x, y);
+			if (depth < 0.0f || depth > 1.0f)
+				depthsInRange = false;
+			if (y >= TestHeight / 2 && depth != 1.0f)
+				aboveHorizonUntouched = false;
+		}
+	}
+	ARC_CHECK(aboveHorizonUntouched);
+	ARC_CHECK(depthsInRange);
+	ARC_CHECK(GetDepth(rasterizer, TestWidth / 2, 0) < 1.0f); // Right below the camera
+
+	ARC_CHECK(IsBoxOccluded(rasterizer, glm::vec3(0.0f, -3.0f, -20.0f), 0.5f)); // Under the floor
+	ARC_CHECK(!IsBoxOccluded(rasterizer, glm::vec3(0.0f, 0.0f, -20.0f), 0.5f)); // On top of it
+}
+
+ARC_TEST(BackfaceCulling)
+{
+	SoftwareOcclusionRasterizer rasterizer(TestWidth, TestHeight);
+
+	// Facing away from the camera
+	rasterizer.BeginFrame(GetPerspectiveViewProjection());
+	AddQuad(rasterizer, glm::vec3(-2.0f, -2.0f, -5.0f), glm::vec3(2.0f, 2.0f, -5.0f), true, true);
+	rasterizer.Rasterize();
+	ARC_CHECK(rasterizer.GetTriangleCount() == 0);
+	ARC_CHECK(!IsBoxOccluded(rasterizer, glm::vec3(0.0f, 0.0f, -10.0f), 0.5f));
+
+	// Double sided meshes still occlude from behind
+	rasterizer.BeginFrame(GetPerspectiveViewProjection());
+	AddQuad(rasterizer, glm::vec3(-2.0f, -2.0f, -5.0f), glm::vec3(2.0f, 2.0f, -5.0f), true, false);
+	rasterizer.Rasterize();
+	ARC_CHECK(rasterizer.GetTriangleCount() == 2);
+	ARC_CHECK(IsBoxOccluded(rasterizer, glm::vec3(0.0f, 0.0f, -10.0f), 0.5f));
+
+	// Only the face of a box pointing at the camera is kept
+	rasterizer.BeginFrame(GetPerspectiveViewProjection());
+	rasterizer.AddOccluderBox(glm::vec3(-2.0f, -2.0f, -7.0f), glm::vec3(2.0f, 2.0f, -5.0f));
+	rasterizer.Rasterize();
+	ARC_CHECK(rasterizer.GetTriangleCount() == 2);
+	ARC_CHECK(IsBoxOccluded(rasterizer, glm::vec3(0.0f, 0.0f, -10.0f), 0.5f));
+}
+
+ARC_TEST(BandBoundaryQuadsHaveNoSeams)
+{
+	SoftwareOcclusionRasterizer rasterizer(TestWidth, TestHeight);
+	rasterizer.BeginFrame(GetPixelViewProjection());
+	AddQuad(rasterizer, glm::vec3(16.0f, 8.0f, 0.0f), glm::vec3(64.0f, 16.0f, 0.0f)); // Exactly one band
+	AddQuad(rasterizer, glm::vec3(100.0f, 4.0f, 0.0f), glm::vec3(140.0f, 36.0f, 0.0f)); // Straddles several bands
+	rasterizer.Rasterize();
+
+	// Pixels are sampled at their centres, so the edges on whole pixel boundaries cover exactly the pixels inside them
+	auto checkRect = [&rasterizer](int minX, int minY, int maxX, int maxY)
+	{
+		bool exact = true;
+		for (int y = minY - 1; y <= maxY + 1; y++)
+		{
+			for (int x = minX - 1; x <= maxX + 1; x++)
+			{
+				bool inside = x >= minX && x <= maxX && y >= minY && y <= maxY;
+				if (GetDepth(rasterizer, x, y) != (inside ? 0.5f : 1.0f))
+					exact = false;
+			}
+		}
+		return exact;
+	};
+	ARC_CHECK(checkRect(16, 8, 63, 15));
+	ARC_CHECK(checkRect(100, 4, 139, 35));
+}
+
+ARC_TEST(BandBoundaryTriangleMatchesReference)
+{
+	// A thin triangle crossing every band, compared against a scalar rasterization of the same edge functions
+	const glm::vec3 vertices[3] = { glm::vec3(10.3f, 0.7f, 0.0f), glm::vec3(200.7f, 60.2f, 0.0f), glm::vec3(40.9f, 127.4f, 0.0f) };
+	glm::mat4 viewProjection = GetPixelViewProjection();
+
+	SoftwareOcclusionRasterizer rasterizer(TestWidth, TestHeight);
+	rasterizer.BeginFrame(viewProjection);
+	rasterizer.AddOccluderMesh(std::vector<glm::vec3>(vertices, vertices + 3), {}, glm::mat4(1.0f), true);
+	rasterizer.Rasterize();
+
+	// Same maths as the rasterizer, including the order of the floating point operations
+	glm::mat4 modelViewProjection = viewProjection * glm::mat4(1.0f);
+	glm::vec2 screen[3];
+	for (int i = 0; i < 3; i++)
+	{
+		glm::vec4 clipPosition = modelViewProjection * glm::vec4(vertices[i], 1.0f);
+		glm::vec3 ndcPosition = glm::vec3(clipPosition) / clipPosition.w;
+		screen[i] = glm::vec2((ndcPosition.x * 0.5f + 0.5f) * TestWidth, (ndcPosition.y * 0.5f + 0.5f) * TestHeight);
+	}
+
+	int mismatchCount = 0, coveredCount = 0;
+	for (int y = 0; y < TestHeight; y++)
+	{
+		for (int x = 0; x < TestWidth; x++)
+		{
+			float pixelX = static_cast<float>(x) + 0.5f, pixelY = y + 0.5f;
+			bool inside = true;
+			for (int edge = 0; edge < 3; edge++)
+			{
+				const glm::vec2 &start = screen[edge], &end = screen[(edge + 1) % 3];
+				float a = start.y - end.y;
+				float b = end.x - start.x;
+				float c = -(a * start.x + b * start.y);
+				float row = b * pixelY + c;
+				if (a * pixelX + row < 0.0f)
+					inside = false;
+			}
+
+			bool written = GetDepth(rasterizer, x, y) != 1.0f;
+			if (inside != written)
+				mismatchCount++;
+			if (written)
+				coveredCount++;
+		}
+	}
+	ARC_CHECK(coveredCount > 0);
+	ARC_CHECK(mismatchCount == 0);
+}
+
+ARC_TEST(RasterizationIsDeterministic)
+{
+	// Bands are rasterized on multiple threads, the result must not depend on how they were scheduled
+	BenchmarkScene scene;
+	SoftwareOcclusionRasterizer first(TestWidth, TestHeight), second(TestWidth, TestHeight);
+	scene.Rasterize(first);
+	for (int i = 0; i < 8; i++)
+	{
+		scene.Rasterize(second);
+		ARC_CHECK(first.GetDepthBuffer() == second.GetDepthBuffer());
+	}
+}
+
+ARC_BENCHMARK(OcclusionRasterizerCityBlock)
+{
+	BenchmarkScene scene;
+	SoftwareOcclusionRasterizer rasterizer;
+	const int iterations = 200;
+
+	// Warm up so thread creation and first touch of the buffers aren't measured
+	scene.Rasterize(rasterizer);
+
+	auto rasterizeStart = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < iterations; i++)
+	{
+		scene.Rasterize(rasterizer);
+	}
+	auto rasterizeEnd = std::chrono::high_resolution_clock::now();
+
+	int occludedCount = 0;
+	auto queryStart = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < iterations; i++)
+	{
+		occludedCount = 0;
+		for (const auto &box : scene.QueryBoxes)
+		{
+			if (rasterizer.IsOccluded(glm::mat4(1.0f), box.first, box.second))
+				occludedCount++;
+		}
+	}
+	auto queryEnd = std::chrono::high_resolution_clock::now();
+
+	double rasterizeMS = std::chrono::duration<double, std::milli>(rasterizeEnd - rasterizeStart).count() / iterations;
+	double queryMS = std::chrono::duration<double, std::milli>(queryEnd - queryStart).count() / iterations;
+	std::printf("    %dx%d, %u occluder triangles: %.3f ms rasterize\n", rasterizer.GetWidth(), rasterizer.GetHeight(), rasterizer.GetTriangleCount(), rasterizeMS);
+	std::printf("    %d query boxes: %.3f ms (%d occluded)\n", static_cast<int>(scene.QueryBoxes.size()), queryMS, occludedCount);
+}
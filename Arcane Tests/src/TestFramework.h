@@ -0,0 +1,43 @@
+#pragma once
+#ifndef TESTFRAMEWORK_H
+#define TESTFRAMEWORK_H
+
+#include <cstdio>
+#include <vector>
+
+namespace ArcaneTests
+{
+	typedef void(*TestFunction)();
+
+	struct TestCase
+	{
+		const char *Name;
+		TestFunction Function;
+	};
+
+	// Tests and benchmarks register themselves before main runs, see ARC_TEST and ARC_BENCHMARK
+	std::vector<TestCase>& GetTests();
+	std::vector<TestCase>& GetBenchmarks();
+
+	struct TestRegistrar
+	{
+		TestRegistrar(std::vector<TestCase> &cases, const char *name, TestFunction function) { cases.push_back({ name, function }); }
+	};
+
+	// Counts a failure for the test that is currently running, the test keeps going so every failed check gets reported
+	void ReportFailure(const char *file, int line, const char *expression);
+}
+
+#define ARC_TEST(name) \
+	static void name(); \
+	static ArcaneTests::TestRegistrar name##_Registrar(ArcaneTests::GetTests(), #name, &name); \
+	static void name()
+
+#define ARC_BENCHMARK(name) \
+	static void name(); \
+	static ArcaneTests::TestRegistrar name##_Registrar(ArcaneTests::GetBenchmarks(), #name, &name); \
+	static void name()
+
+#define ARC_CHECK(x) { if (!(x)) { ArcaneTests::ReportFailure(__FILE__, __LINE__, #x); } }
+
+#endif
@@ -0,0 +1,63 @@
+#include "TestFramework.h"
+
+#include <cstring>
+
+namespace ArcaneTests
+{
+	static int s_FailureCount = 0;
+
+	std::vector<TestCase>& GetTests()
+	{
+		static std::vector<TestCase> tests;
+		return tests;
+	}
+
+	std::vector<TestCase>& GetBenchmarks()
+	{
+		static std::vector<TestCase> benchmarks;
+		return benchmarks;
+	}
+
+	void ReportFailure(const char *file, int line, const char *expression)
+	{
+		std::printf("    FAILED %s:%d: %s\n", file, line, expression);
+		s_FailureCount++;
+	}
+}
+
+// Runs every test, pass --benchmark to run the benchmarks afterwards. Returns non-zero if any test failed
+int main(int argc, char **argv)
+{
+	using namespace ArcaneTests;
+
+	bool runBenchmarks = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--benchmark") == 0)
+			runBenchmarks = true;
+	}
+
+	int failedTestCount = 0;
+	for (const TestCase &test : GetTests())
+	{
+		int previousFailureCount = s_FailureCount;
+		test.Function();
+
+		bool passed = s_FailureCount == previousFailureCount;
+		std::printf("[%s] %s\n", passed ? "PASS" : "FAIL", test.Name);
+		if (!passed)
+			failedTestCount++;
+	}
+	std::printf("%d/%d tests passed\n", static_cast<int>(GetTests().size()) - failedTestCount, static_cast<int>(GetTests().size()));
+
+	if (runBenchmarks)
+	{
+		for (const TestCase &benchmark : GetBenchmarks())
+		{
+			std::printf("[BENCHMARK] %s\n", benchmark.Name);
+			benchmark.Function();
+		}
+	}
+
+	return failedTestCount == 0 ? 0 : 1;
+}
@@ -7,11 +7,13 @@
 namespace Arcane
 {
 	PoseAnimator::PoseAnimator() 
-		: m_CurrentAnimationClip(nullptr), m_CurrentTime(0.0f), m_FinalBoneMatrices(100, glm::mat4(1.0f))
+		: m_CurrentAnimationClip(nullptr), m_CurrentTime(0.0f), m_FinalBoneMatrices(100, glm::mat4(1.0f)), m_PreviousFinalBoneMatrices(100, glm::mat4(1.0f))
 	{}
 
 	void PoseAnimator::UpdateAnimation(float deltaTime)
 	{
+		m_PreviousFinalBoneMatrices = m_FinalBoneMatrices;
+
 		// Play animation clip
 		if (m_CurrentAnimationClip)
 		{
@@ -17,10 +17,12 @@ namespace Arcane
 
 		inline AnimationClip* GetCurrentAnimationClip() { return m_CurrentAnimationClip; }
 		inline const std::vector<glm::mat4>& GetFinalBoneMatrices() const { return m_FinalBoneMatrices; }
+		inline const std::vector<glm::mat4>& GetPreviousFinalBoneMatrices() const { return m_PreviousFinalBoneMatrices; } // Last frame's pose, used for motion vectors
 	private:
 		void CalculateBoneTransform(const AssimpBoneData *node, glm::mat4 parentTransform);
 	private:
 		std::vector<glm::mat4> m_FinalBoneMatrices;
+		std::vector<glm::mat4> m_PreviousFinalBoneMatrices;
 		AnimationClip *m_CurrentAnimationClip;
 		float m_CurrentTime;
 
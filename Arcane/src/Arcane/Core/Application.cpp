@@ -3,6 +3,8 @@
 
 #include <Arcane/Graphics/Window.h>
 #include <Arcane/Graphics/Renderer/Renderer.h>
+#include <Arcane/Graphics/Renderer/RenderTargetPool.h>
+#include <Arcane/Graphics/Mesh/GeometryArena.h>
 #include <Arcane/Graphics/Renderer/RenderPass/MasterRenderPass.h>
 #include <Arcane/Scene/Scene.h>
 #include <Arcane/Util/Loaders/AssetManager.h>
@@ -10,6 +12,7 @@
 #include <Arcane/Util/Loaders/TextureLoader.h>
 #include <Arcane/Util/Time.h>
 #include <Arcane/Core/Layer.h>
+#include <Arcane/Core/Threads/WorkerPool.h>
 #include <Arcane/ImGui/ImGuiLayer.h>
 #include <Arcane/RenderdocManager.h>
 #include <Arcane/Input/InputManager.h>
@@ -62,6 +65,9 @@ namespace Arcane
 		delete m_Window;
 		delete m_ActiveScene;
 		delete m_MasterRenderPass;
+		RenderTargetPool::Shutdown(); // After everything that leases from it has given it's targets back
+		GeometryArena::Shutdown();
+		WorkerPool::Shutdown();
 	}
 
 	void Application::InternalInit()
@@ -135,6 +141,8 @@ namespace Arcane
 				if (m_Specification.EnableImGui)
 					RenderImGui();
 
+				RenderTargetPool::EndOfFrameUpdate();
+
 #ifdef ARC_DEV_BUILD
 				GPUTimerManager::EndOfFrameUpdate();
 #endif
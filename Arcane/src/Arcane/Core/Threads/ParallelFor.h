@@ -0,0 +1,39 @@
+#pragma once
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <algorithm>
+
+#ifndef WORKERPOOL_H
+#include <Arcane/Core/Threads/WorkerPool.h>
+#endif
+
+namespace Arcane
+{
+	// Splits [0, count) into contiguous chunks and runs func(index) for each index across the worker pool. The calling thread processes chunks too
+	// and blocks until all chunks are complete, so func can safely write to per-index output without any extra synchronization
+	template<typename Func>
+	void ParallelFor(unsigned int count, Func &&func, unsigned int minIndicesPerThread = 1)
+	{
+		if (count == 0)
+			return;
+
+		unsigned int threadCount = std::min(WorkerPool::GetThreadCount(), std::max(1u, count / std::max(1u, minIndicesPerThread)));
+		if (threadCount <= 1)
+		{
+			for (unsigned int i = 0; i < count; i++)
+				func(i);
+			return;
+		}
+
+		unsigned int chunkSize = (count + threadCount - 1) / threadCount;
+		WorkerPool::Dispatch(threadCount, [&func, count, chunkSize](unsigned int chunkIndex)
+		{
+			unsigned int begin = chunkIndex * chunkSize;
+			unsigned int end = std::min(count, begin + chunkSize);
+			for (unsigned int i = begin; i < end; i++)
+				func(i);
+		});
+	}
+}
+#endif
@@ -0,0 +1,139 @@
+#include "arcpch.h"
+#include "WorkerPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Arcane
+{
+	// Every worker that is handed a batch holds a reference to it, the batch lives on the dispatching thread's stack so it can't return until they are all released
+	struct WorkerBatch
+	{
+		const std::function<void(unsigned int)> *Job;
+		unsigned int JobCount;
+		std::atomic<unsigned int> NextIndex;
+		unsigned int References; // Guarded by s_Mutex
+	};
+
+	static std::mutex s_Mutex;
+	static std::condition_variable s_WorkAvailable, s_BatchReleased;
+	static std::deque<WorkerBatch*> s_Queue;
+	static std::vector<std::thread> s_Workers;
+	static bool s_Started = false, s_Stopping = false;
+
+	static void RunBatch(WorkerBatch &batch)
+	{
+		for (unsigned int index = batch.NextIndex++; index < batch.JobCount; index = batch.NextIndex++)
+		{
+			(*batch.Job)(index);
+		}
+	}
+
+	void WorkerPool::Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			s_Stopping = true;
+		}
+		s_WorkAvailable.notify_all();
+
+		for (std::thread &worker : s_Workers)
+		{
+			worker.join();
+		}
+		s_Workers.clear();
+
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		s_Started = false;
+		s_Stopping = false;
+	}
+
+	unsigned int WorkerPool::GetThreadCount()
+	{
+		Start();
+
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		return static_cast<unsigned int>(s_Workers.size()) + 1;
+	}
+
+	void WorkerPool::Dispatch(unsigned int jobCount, const std::function<void(unsigned int)> &job)
+	{
+		if (jobCount == 0)
+			return;
+
+		Start();
+
+		WorkerBatch batch;
+		batch.Job = &job;
+		batch.JobCount = jobCount;
+		batch.NextIndex = 0;
+		{
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			batch.References = std::min(static_cast<unsigned int>(s_Workers.size()), jobCount - 1);
+			for (unsigned int i = 0; i < batch.References; i++)
+			{
+				s_Queue.push_back(&batch);
+			}
+		}
+		if (batch.References > 0)
+			s_WorkAvailable.notify_all();
+
+		RunBatch(batch);
+
+		// Every index has been taken, so any references still queued can be dropped instead of waiting for a worker to pick them up
+		std::unique_lock<std::mutex> lock(s_Mutex);
+		for (auto iter = s_Queue.begin(); iter != s_Queue.end();)
+		{
+			if (*iter == &batch)
+			{
+				iter = s_Queue.erase(iter);
+				batch.References--;
+			}
+			else
+			{
+				++iter;
+			}
+		}
+		s_BatchReleased.wait(lock, [&batch]() { return batch.References == 0; });
+	}
+
+	void WorkerPool::Start()
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		if (s_Started)
+			return;
+
+		// The dispatching thread does it's share of the work, so one less worker than there are cores
+		unsigned int hardwareThreads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 2;
+		for (unsigned int i = 1; i < hardwareThreads; i++)
+		{
+			s_Workers.emplace_back(&WorkerPool::WorkerLoop);
+		}
+		s_Started = true;
+	}
+
+	void WorkerPool::WorkerLoop()
+	{
+		std::unique_lock<std::mutex> lock(s_Mutex);
+		while (true)
+		{
+			s_WorkAvailable.wait(lock, []() { return s_Stopping || !s_Queue.empty(); });
+			if (s_Queue.empty())
+				return;
+
+			WorkerBatch *batch = s_Queue.front();
+			s_Queue.pop_front();
+
+			lock.unlock();
+			RunBatch(*batch);
+			lock.lock();
+
+			if (--batch->References == 0)
+				s_BatchReleased.notify_all();
+		}
+	}
+}
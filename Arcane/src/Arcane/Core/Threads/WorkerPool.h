@@ -0,0 +1,26 @@
+#pragma once
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <functional>
+
+namespace Arcane
+{
+	// Persistent worker threads for short, fork-join style jobs (see ParallelFor). The threads are started the first time work is dispatched and are
+	// reused by every dispatch after that, so splitting a few milliseconds of work across the cores doesn't pay for creating threads every time
+	class WorkerPool
+	{
+	public:
+		static void Shutdown();
+
+		static unsigned int GetThreadCount(); // Worker threads plus the calling thread, which always takes part in it's own dispatch
+
+		// Runs job(index) for every index in [0, jobCount) across the workers and the calling thread, and blocks until every index is complete.
+		// The calling thread keeps taking indices while it waits, so a job can dispatch more work without deadlocking the pool
+		static void Dispatch(unsigned int jobCount, const std::function<void(unsigned int)> &job);
+	private:
+		static void Start();
+		static void WorkerLoop();
+	};
+}
+#endif
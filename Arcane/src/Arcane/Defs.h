@@ -14,6 +14,21 @@
 // Render Settings
 #define FORWARD_RENDER 0
 
+// Render Target Pool Settings
+#define RENDER_TARGET_POOL_IDLE_FRAMES 120 // Pooled framebuffers that nothing has leased for this many frames are deleted
+
+// Geometry Arena Settings
+#define GEOMETRY_ARENA_MIN_VERTICES 65536 // A vertex layout's arena starts with room for this many vertices and doubles whenever it runs out
+#define GEOMETRY_ARENA_MIN_INDICES 196608
+#define RENDERER_MAX_INDIRECT_DRAWS 4096 // Most draws a single glMultiDrawElementsIndirect submits, bigger flushes are split up
+
+// Material Buffer Settings
+#define MATERIAL_ALLOW_BINDLESS 1 // Materials reference their textures with bindless handles if the driver supports ARB_bindless_texture, otherwise they use the texture array fallback
+#define MATERIAL_BUFFER_INITIAL_CAPACITY 256
+#define MATERIAL_TEXTURE_ARRAY_MAX_BUCKETS 10 // Different texture sizes/formats the fallback can hold, also hardcoded in the geometry pass shaders
+#define MATERIAL_TEXTURE_ARRAY_FIRST_UNIT 6 // Buckets are bound to this texture unit onwards
+#define MATERIAL_TEXTURE_ARRAY_INITIAL_LAYERS 4
+
 // Streaming Settings
 #define TEXTURE_LOADS_PER_FRAME 2
 #define CUBEMAP_FACES_PER_FRAME 2
@@ -23,15 +38,28 @@
 #define MSAA_SAMPLE_AMOUNT 4 // Only used in forward rendering & for water
 #define SUPERSAMPLING_FACTOR 1 // 1 means window resolution will be the render resolution
 
+// Dynamic Resolution Settings (deferred only, the frame is measured by an always-on GPU timestamp timer so it works in every build)
+#define DYNAMIC_RESOLUTION_TARGET_FRAME_TIME_MS_DEFAULT 16.0f // GPU time the render scale is adjusted to hit
+#define DYNAMIC_RESOLUTION_MIN_SCALE_DEFAULT 0.5f
+#define DYNAMIC_RESOLUTION_SCALE_STEPS 40 // Scale is snapped to multiples of 1 / steps so it settles instead of changing every frame, and common 16:9 resolutions divide into whole pixels
+
 // Texture Filtering Settings
 #define ANISOTROPIC_FILTERING_LEVEL 16.0f
 
 // IBL Settings
-#define LIGHT_PROBE_RESOLUTION 32
 #define REFLECTION_PROBE_MIP_COUNT 5
 #define REFLECTION_PROBE_RESOLUTION 128
-#define IBL_CAPTURE_RESOLUTION 256 // Should always be greater than the light and reflection probe resolution
+#define IBL_CAPTURE_RESOLUTION 256 // Should always be greater than the reflection probe resolution
 #define BRDF_LUT_RESOLUTION 512
+#define PROBE_BAKE_FILEPATH "res/baked/probes.arcprobes" // Generated probes are cached here and only re-baked when the scene's static content changes
+#define PROBE_GRID_CELL_SIZE 32.0f // Probes are bucketed into a uniform grid of this cell size so they can be looked up per object
+#define PROBE_DEFAULT_INFLUENCE_RADIUS 64.0f // Probes only affect objects within this distance, their weight fades out towards the edge
+#define PROBE_MAX_BLEND_COUNT 4 // Light probe slots blended per object when probe blending is enabled, one is always left for the fallback probe. Only supports a maximum of 4
+#define PROBE_MAX_PER_PIXEL_REFLECTION_PROBES 4 // Reflection probes closest to the camera that the deferred lighting pass picks from per pixel, also hardcoded in the shader
+#define PROBE_PER_PIXEL_REFLECTION_FIRST_UNIT 12
+#define PROBE_UPDATE_GPU_BUDGET_MS 1.0f // GPU time per frame that runtime probe re-captures can use, at least one step (a cube face or a mip) is always done
+#define PROBE_UPDATE_MAX_STEPS_PER_FRAME 8
+#define PROBE_UPDATE_CHANGE_THRESHOLD 0.05f // How much the lighting around a probe has to change (relative to it's brightness) before it is re-captured
 
 // Frustum Options
 #define DEFAULT_NEAR_PLANE 0.3f
@@ -45,8 +73,46 @@
 #define SHADOWMAP_FAR_PLANE_DEFAULT 200.0f
 #define SHADOWMAP_BIAS_DEFAULT 0.007f
 
+// Shadow Atlas Options (spot and point light shadows all share one depth atlas, point lights use six tiles)
+#define SHADOW_ATLAS_RESOLUTION 4096 // Largest the atlas can grow to, it is only allocated (at the size of the tiles in use) once a light requests a tile
+#define SHADOW_ATLAS_MIN_TILE_RESOLUTION 128 // Both resolutions must be a power of two
+
+// Directional Shadow Cascade Options (every cascade is a layer of the directional light's shadowmap at the light's shadow resolution)
+#define SHADOW_CASCADE_COUNT 4 // Between 1 and 4 is supported by the shaders
+#define SHADOW_CASCADE_MAX_DISTANCE 150.0f // Shadows are not rendered past this distance from the camera
+#define SHADOW_CASCADE_SPLIT_LAMBDA 0.75f // Blend between uniform (0.0) and logarithmic (1.0) cascade splits
+
 // SSAO Options
 #define SSAO_KERNEL_SIZE 32 // Maximum amount is restricted by the shader. Only supports a maximum of 64
+#define SSAO_SAMPLES_PER_FRAME 8 // With temporal accumulation every frame only samples a slice of the kernel, the kernel size must be a multiple of this
+#define SSAO_HISTORY_WEIGHT_DEFAULT 0.9f // How much of the accumulated AO is kept each frame
+#define SSAO_HISTORY_DEPTH_TOLERANCE 0.05f // Accumulated AO is thrown away if it's depth differs by more than this fraction of the pixel's depth (disocclusion)
+
+// Auto Exposure Options
+#define AUTO_EXPOSURE_MIN_LOG_LUMINANCE -10.0f // log2 luminance range covered by the luminance histogram
+#define AUTO_EXPOSURE_MAX_LOG_LUMINANCE 4.0f
+#define AUTO_EXPOSURE_KEY_VALUE 0.18f // Exposure is chosen so the adapted luminance is tonemapped to this (middle grey)
+#define AUTO_EXPOSURE_ADAPTATION_SPEED_DEFAULT 1.5f // Higher adapts to brightness changes faster
+
+// Bloom Options
+#define BLOOM_SOFT_KNEE 0.5f // Fraction of the threshold below it that bloom fades in over
+
+// Temporal Anti-Aliasing Options
+#define TAA_JITTER_SAMPLE_COUNT 8 // Length of the Halton(2, 3) sequence the projection is jittered by before it repeats
+#define TAA_HISTORY_WEIGHT_DEFAULT 0.9f // How much of the resolved history is kept each frame
+
+// Screen Space Reflection Options
+#define SSR_MAX_ITERATIONS_DEFAULT 64
+#define SSR_THICKNESS_DEFAULT 0.5f // Depth (in world units) surfaces are assumed to have, rays further behind a surface than this pass behind it instead of hitting it
+#define SSR_MAX_ROUGHNESS_DEFAULT 0.6f // Rougher surfaces only use the reflection probes since the traced reflection can't be blurred cheaply
+
+// Occlusion Culling Options
+#define OCCLUSION_CULLING_READBACK_MAX_WIDTH 128 // The first mip of the depth pyramid at most this wide is read back to the CPU for occlusion culling
+#define OCCLUSION_RASTERIZER_WIDTH 256 // Resolution of the software occlusion depth buffer, width must be a multiple of four
+#define OCCLUSION_RASTERIZER_HEIGHT 128
+#define OCCLUSION_RASTERIZER_BAND_HEIGHT 8 // Rows of the software depth buffer rasterized by one job
+#define OCCLUSION_RASTERIZER_MAX_OCCLUDER_TRIANGLES 2048 // Occluder models with more triangles than this aren't rasterized, they are too expensive to be worth it
+#define TERRAIN_OCCLUDER_CHUNKS_PER_SIDE 16 // The terrain is split into this many chunks per side, each one is a box under its lowest point for software occlusion
 
 // Parallax Options
 #define PARALLAX_MIN_STEPS 1
@@ -57,3 +123,17 @@
 #define WATER_REFLECTION_FAR_PLANE_DEFAULT 1000.0f
 #define WATER_REFRACTION_NEAR_PLANE_DEFAULT 0.3f
 #define WATER_REFRACTION_FAR_PLANE_DEFAULT 500.0f
+#define WATER_CAPTURE_MIN_SCREEN_SIZE_DEFAULT 0.01f // Meshes whose bounding sphere covers less of the reflection/refraction's height than this are not rendered into it
+#define WATER_CAPTURE_TEXTURE_LOD_BIAS 1.0f // Mip bias used by the reduced quality lighting shaders when rendering reflections/refractions
+#define WATER_ATLAS_RESOLUTION 2048 // Reflections and refractions are tiles of two atlases allocated once at this resolution
+#define WATER_ATLAS_MIN_TILE_RESOLUTION 128 // Both resolutions must be a power of two
+#define WATER_MSAA_CAPTURE_RESOLUTION 1024 // MSAA captures are rendered into a scratch target of this size then resolved into the atlas, so their tiles can't be any larger
+#define WATER_MAX_CAPTURES 4 // Maximum amount of different water heights that can be reflected/refracted at once, the closest water is prioritised
+#define WATER_CAPTURE_HEIGHT_TOLERANCE 0.01f // Water planes closer in height than this share their reflection and refraction
+
+// Clustered Lighting Options
+#define LIGHT_CLUSTER_GRID_X 16
+#define LIGHT_CLUSTER_GRID_Y 9
+#define LIGHT_CLUSTER_GRID_Z 24 // Depth slices are distributed exponentially between the camera's near and far plane
+#define LIGHT_CLUSTER_MAX_LIGHTS_PER_CLUSTER 256
+#define LIGHT_CLUSTER_CACHED_VIEW_COUNT 8 // Views that keep their own light clusters between binds (main camera, water captures and the six faces of a probe capture)
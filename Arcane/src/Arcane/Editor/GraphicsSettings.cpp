@@ -33,11 +33,63 @@ namespace Arcane
 				{
 					ImGui::Checkbox("Wireframe Mode", Application::GetInstance().GetWireframePtr());
 				}
+				if (ImGui::CollapsingHeader("Dynamic Resolution", ImGuiTreeNodeFlags_DefaultOpen))
+				{
+					DynamicResolution *dynamicResolution = m_MasterRenderPass->GetDynamicResolution();
+					ImGui::PushID("Dynamic Resolution Arcane Effect");
+					ImGui::Checkbox("Enabled", &dynamicResolution->GetEnabledRef());
+					ImGui::SliderFloat("Target GPU Time (ms)", &dynamicResolution->GetTargetFrameTimeRef(), 2.0f, 50.0f);
+					ImGui::SliderFloat("Min Scale", &dynamicResolution->GetMinScaleRef(), 0.25f, 1.0f);
+					ImGui::Text("Render Scale - %f", dynamicResolution->GetRenderScale());
+					ImGui::Text("Smoothed GPU Time - %f ms", dynamicResolution->GetSmoothedFrameTimeMS());
+					ImGui::PopID();
+				}
 				if (ImGui::CollapsingHeader("Screen Space Ambient Occlusion (SSAO)", ImGuiTreeNodeFlags_DefaultOpen))
 				{
 					ImGui::Checkbox("Enabled", &postProcessPass->GetSsaoEnabledRef());
 					ImGui::SliderFloat("Sample Radius", &postProcessPass->GetSsaoSampleRadiusRef(), 0.1f, 10.0f);
 					ImGui::SliderFloat("Intensity", &postProcessPass->GetSsaoStrengthRef(), 0.1f, 10.0f);
+					ImGui::Checkbox("Temporal Accumulation", &postProcessPass->GetSsaoTemporalEnabledRef());
+					ImGui::SliderFloat("History Weight", &postProcessPass->GetSsaoHistoryWeightRef(), 0.0f, 0.98f);
+				}
+				if (ImGui::CollapsingHeader("Screen Space Reflections (SSR)", ImGuiTreeNodeFlags_DefaultOpen))
+				{
+					ScreenSpaceReflectionPass *ssrPass = m_MasterRenderPass->GetScreenSpaceReflectionPass();
+					ImGui::PushID("SSR Arcane Effect");
+					ImGui::Checkbox("Enabled", &ssrPass->GetEnabledRef());
+					ImGui::SliderInt("Max Iterations", &ssrPass->GetMaxIterationsRef(), 8, 256);
+					ImGui::SliderFloat("Thickness", &ssrPass->GetThicknessRef(), 0.01f, 5.0f);
+					ImGui::SliderFloat("Max Roughness", &ssrPass->GetMaxRoughnessRef(), 0.0f, 1.0f);
+					ImGui::PopID();
+				}
+				if (ImGui::CollapsingHeader("Occlusion Culling", ImGuiTreeNodeFlags_DefaultOpen))
+				{
+					DeferredGeometryPass *geometryPass = m_MasterRenderPass->GetDeferredGeometryPass();
+					const char *modes[] = { "None", "Hi-Z (Previous Frame)", "Software Rasterizer" };
+					int mode = static_cast<int>(geometryPass->GetOcclusionCullingModeRef());
+					ImGui::Combo("Mode", &mode, modes, IM_ARRAYSIZE(modes));
+					geometryPass->GetOcclusionCullingModeRef() = static_cast<OcclusionCullingMode>(mode);
+					if (geometryPass->GetOcclusionCullingModeRef() == OcclusionCullingMode::OcclusionCullingMode_Software)
+					{
+						ImGui::Text("Occluder Triangles - %u", geometryPass->GetOcclusionRasterizer()->GetTriangleCount());
+					}
+					ImGui::Checkbox("Occluder Depth Pre-Pass", &geometryPass->GetOccluderPrepassEnabledRef());
+				}
+				if (ImGui::CollapsingHeader("Render Graph", ImGuiTreeNodeFlags_DefaultOpen))
+				{
+					const RenderGraphStats &stats = m_MasterRenderPass->GetRenderGraph()->GetStats();
+					ImGui::Text("Nodes - %u (%u culled)", stats.NodeCount, stats.CulledNodeCount);
+					ImGui::Text("Water Pass - %s", m_MasterRenderPass->GetRenderGraph()->IsNodeCulled("Water Pass") ? "Culled" : "Executed");
+					ImGui::Text("Transient Targets - %u using %u framebuffers", stats.TransientCount, stats.PhysicalTargetCount);
+					ImGui::Text("Transient Memory - %.2f MB requested, %.2f MB allocated (%.2f MB saved)", stats.RequestedBytes / (1024.0 * 1024.0), stats.AllocatedBytes / (1024.0 * 1024.0),
+						(static_cast<double>(stats.RequestedBytes) - static_cast<double>(stats.AllocatedBytes)) / (1024.0 * 1024.0));
+				}
+				if (ImGui::CollapsingHeader("Render Target Pool", ImGuiTreeNodeFlags_DefaultOpen))
+				{
+					const RenderTargetPoolStats &poolStats = RenderTargetPool::GetStats();
+					ImGui::Text("Framebuffers - %u (%u leased)", poolStats.TargetCount, poolStats.LeasedCount);
+					ImGui::Text("VRAM - %.2f MB (%.2f MB leased)", poolStats.TotalBytes / (1024.0 * 1024.0), poolStats.LeasedBytes / (1024.0 * 1024.0));
+					ImGui::Text("Created/Deleted Last Frame - %u/%u", poolStats.CreatedLastFrame, poolStats.DestroyedLastFrame);
 				}
 				ImGui::EndTabItem();
 			}
@@ -48,6 +100,28 @@ namespace Arcane
 					ImGui::PushID("Tonemap Settings Arcane Effect");
 					ImGui::SliderFloat("Gamma", &postProcessPass->GetGammaCorrectionRef(), 0.1f, 5.0f);
 					ImGui::SliderFloat("Exposure", &postProcessPass->GetExposureRef(), 0.1f, 5.0f);
+					ImGui::Checkbox("Auto Exposure", &postProcessPass->GetAutoExposureEnabledRef());
+					ImGui::SliderFloat("Adaptation Speed", &postProcessPass->GetAutoExposureAdaptationSpeedRef(), 0.1f, 10.0f);
+					ImGui::PopID();
+				}
+				ImGui::NewLine();
+				ImGui::Separator();
+				if (ImGui::CollapsingHeader("Bloom", ImGuiTreeNodeFlags_DefaultOpen))
+				{
+					ImGui::PushID("Bloom Arcane Effect");
+					ImGui::Checkbox("Enabled", &postProcessPass->GetBloomEnabledRef());
+					ImGui::Checkbox("Use Compute Shaders", &postProcessPass->GetBloomComputeEnabledRef());
+					ImGui::SliderFloat("Threshold", &postProcessPass->GetBloomThresholdRef(), 0.0f, 10.0f);
+					ImGui::SliderFloat("Strength", &postProcessPass->GetBloomStrengthRef(), 0.0f, 2.0f);
+					ImGui::PopID();
+				}
+				ImGui::NewLine();
+				ImGui::Separator();
+				if (ImGui::CollapsingHeader("TAA", ImGuiTreeNodeFlags_DefaultOpen))
+				{
+					ImGui::PushID("TAA Arcane Effect");
+					ImGui::Checkbox("Enabled", &postProcessPass->GetTaaEnabledRef());
+					ImGui::SliderFloat("History Weight", &postProcessPass->GetTaaHistoryWeightRef(), 0.0f, 0.98f);
 					ImGui::PopID();
 				}
 				ImGui::NewLine();
@@ -103,6 +177,13 @@ namespace Arcane
 			}
 			if (ImGui::BeginTabItem("Global Illumination"))
 			{
+				if (ImGui::CollapsingHeader("Probe Updates", ImGuiTreeNodeFlags_DefaultOpen))
+				{
+					ProbeUpdateScheduler *probeUpdateScheduler = m_MasterRenderPass->GetEnvironmentProbePass()->GetUpdateScheduler();
+					ImGui::Checkbox("Runtime Updates", &probeUpdateScheduler->GetUpdatesEnabledRef());
+					ImGui::SliderFloat("GPU Budget (ms)", &probeUpdateScheduler->GetBudgetRef(), 0.1f, 8.0f);
+					ImGui::Text("Estimated Step Cost - %f ms", probeUpdateScheduler->GetEstimatedStepCostMS());
+				}
 				ImGui::EndTabItem();
 			}
 		}
@@ -49,6 +49,7 @@ namespace Arcane
 						meshComponent.IsTransparent = choice;
 						ImGui::Checkbox("Is Static", &meshComponent.IsStatic);
 						ImGui::Checkbox("Cull Backface", &meshComponent.ShouldBackfaceCull);
+						ImGui::Checkbox("Is Occluder", &meshComponent.IsOccluder);
 						ImGui::Text("Texture Maps");
 						ImGui::Separator();
 
@@ -231,6 +232,15 @@ namespace Arcane
 
 						ImGui::Checkbox("Reflection Enabled", &waterComponent.ReflectionEnabled);
 						if (waterComponent.ReflectionEnabled)
+						{
+							const char *reflectionModeItems[] = { "Planar", "Screen Space" };
+							int reflectionModeChoice = static_cast<int>(waterComponent.ReflectionMode);
+							ImGui::Combo("Reflection Mode", &reflectionModeChoice, reflectionModeItems, IM_ARRAYSIZE(reflectionModeItems));
+							if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+								ImGui::SetTooltip("Screen space reflections don't re-render the scene, but can only reflect what is on screen and fall back to the reflection probe elsewhere. Requires the deferred renderer");
+							waterComponent.ReflectionMode = static_cast<WaterReflectionMode>(reflectionModeChoice);
+						}
+						if (waterComponent.ReflectionEnabled && waterComponent.ReflectionMode == WaterReflectionMode::WaterReflectionMode_Planar)
 						{
 							glm::uvec2 resolution = WaterManager::GetWaterReflectionRefractionQualityResolution(waterComponent.WaterReflectionResolution);
 							int reflectionChoice = static_cast<int>(waterComponent.WaterReflectionResolution);
@@ -241,6 +251,12 @@ namespace Arcane
 
 						ImGui::Checkbox("Reflection uses MSAA", &waterComponent.ReflectionMSAA);
 						ImGui::Checkbox("Refraction uses MSAA", &waterComponent.RefractionMSAA);
+						ImGui::Checkbox("Reflection Half Rate", &waterComponent.ReflectionHalfRate);
+						if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+							ImGui::SetTooltip("Only re-renders the reflection every other frame, the frames in between reproject the previous reflection. Halves the cost of reflections but fast camera movement can show artifacts near the edges");
+						ImGui::SliderFloat("Capture Min Screen Size", &waterComponent.CaptureMinScreenSize, 0.0f, 0.1f, "%.3f");
+						if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+							ImGui::SetTooltip("Meshes that cover less than this fraction of the reflection/refraction's height are not rendered into it. Small objects are barely visible through the distortion so this can save a lot of draw calls");
 
 						ImGui::Checkbox("Clear Water", &waterComponent.ClearWater);
 						ImGui::Checkbox("Enable Shine", &waterComponent.EnableShine);
@@ -3,6 +3,8 @@
 
 #include <Arcane/Vendor/Imgui/imgui.h>
 #include <Arcane/Graphics/Renderer/Renderer.h>
+#include <Arcane/Graphics/Mesh/GeometryArena.h>
+#include <Arcane/Graphics/Mesh/MaterialBuffer.h>
 
 #ifdef ARC_DEV_BUILD
 #include <Arcane/Platform/OpenGL/GPUTimerManager.h>
@@ -24,6 +26,21 @@ namespace Arcane
 			ImGui::Text("Total Draw Call Count: %u", rendererStats.DrawCallCount);
 			ImGui::Text("Mesh Draw Call Count: %u", rendererStats.MeshesDrawnCount);
 			ImGui::Text("Quads Draw Call Count: %u", rendererStats.QuadsDrawnCount);
+			ImGui::Text("Occluded Mesh Count: %u", rendererStats.MeshesOccludedCount);
+			ImGui::Text("Indirect Mesh Draw Count: %u", rendererStats.IndirectMeshesDrawnCount);
+			ImGui::Separator();
+
+			const GeometryArenaStats &arenaStats = GeometryArena::GetStats();
+			ImGui::Text("Geometry Arena Layouts: %u (%u meshes)", arenaStats.LayoutCount, arenaStats.AllocationCount);
+			ImGui::Text("Geometry Arena Vertices: %.2f/%.2f MB", arenaStats.VertexBytesUsed / (1024.0 * 1024.0), arenaStats.VertexBytesCapacity / (1024.0 * 1024.0));
+			ImGui::Text("Geometry Arena Indices: %.2f/%.2f MB", arenaStats.IndexBytesUsed / (1024.0 * 1024.0), arenaStats.IndexBytesCapacity / (1024.0 * 1024.0));
+			ImGui::Separator();
+
+			const MaterialBufferStats &materialStats = MaterialBuffer::GetStats();
+			ImGui::Text("Material Texture Path: %s", materialStats.TexturePath == MaterialTexturePath::MaterialTexturePath_Bindless ? "Bindless" : "Texture Arrays");
+			ImGui::Text("Material Buffer Count: %u (%u textures)", materialStats.MaterialCount, materialStats.TextureCount);
+			if (materialStats.TexturePath == MaterialTexturePath::MaterialTexturePath_TextureArrays)
+				ImGui::Text("Material Texture Arrays: %u (%.2f MB)", materialStats.BucketCount, materialStats.BucketBytes / (1024.0 * 1024.0));
 			ImGui::Separator();
 #ifdef ARC_DEV_BUILD
 			float frametime = 1000.0f / ImGui::GetIO().Framerate;
@@ -8,7 +8,7 @@
 namespace Arcane
 {
 	FPSCamera::FPSCamera(glm::vec3 position, glm::vec3 up, float yaw, float pitch, float nearPlane, float farPlane)
-		: ICamera(position, nearPlane, farPlane), m_Front(glm::vec3(0.0f, 0.0f, -1.0f)), m_CurrentMovementSpeed(FPSCAMERA_MAX_SPEED), m_CurrentFOV(FPSCAMERA_MAX_FOV)
+		: ICamera(position, nearPlane, farPlane), m_Front(glm::vec3(0.0f, 0.0f, -1.0f)), m_CurrentMovementSpeed(FPSCAMERA_MAX_SPEED), m_CurrentFOV(FPSCAMERA_MAX_FOV), m_ProjectionJitter(0.0f, 0.0f)
 	{
 		m_WorldUp = up;
 		m_Up = up;
@@ -18,7 +18,7 @@ namespace Arcane
 	}
 
 	FPSCamera::FPSCamera(float xPos, float yPos, float zPos, float xUp, float yUp, float zUp, float yaw, float pitch, float nearPlane, float farPlane)
-		: ICamera(glm::vec3(xPos, yPos, zPos), nearPlane, farPlane), m_Front(glm::vec3(0.0f, 0.0f, -1.0f)), m_CurrentMovementSpeed(FPSCAMERA_MAX_SPEED), m_CurrentFOV(FPSCAMERA_MAX_FOV)
+		: ICamera(glm::vec3(xPos, yPos, zPos), nearPlane, farPlane), m_Front(glm::vec3(0.0f, 0.0f, -1.0f)), m_CurrentMovementSpeed(FPSCAMERA_MAX_SPEED), m_CurrentFOV(FPSCAMERA_MAX_FOV), m_ProjectionJitter(0.0f, 0.0f)
 	{
 		m_WorldUp = glm::vec3(xUp, yUp, zUp);
 		m_CurrentYaw = yaw;
@@ -32,6 +32,15 @@ namespace Arcane
 	}
 
 	glm::mat4 FPSCamera::GetProjectionMatrix()
+	{
+		// Offset the projection along the third column, it gets multiplied by the view space depth and w is -depth, so the whole image is shifted by exactly the jitter after the perspective divide
+		glm::mat4 projection = GetUnjitteredProjectionMatrix();
+		projection[2][0] -= m_ProjectionJitter.x;
+		projection[2][1] -= m_ProjectionJitter.y;
+		return projection;
+	}
+
+	glm::mat4 FPSCamera::GetUnjitteredProjectionMatrix()
 	{
 		return glm::perspective(glm::radians(m_CurrentFOV), (float)Window::GetRenderResolutionWidth() / (float)Window::GetRenderResolutionHeight(), m_NearPlane, m_FarPlane);
 	}
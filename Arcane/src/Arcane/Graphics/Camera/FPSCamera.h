@@ -29,6 +29,10 @@ namespace Arcane
 
 		virtual glm::mat4 GetViewMatrix() override;
 		virtual glm::mat4 GetProjectionMatrix() override;
+		virtual glm::mat4 GetUnjitteredProjectionMatrix() override;
+
+		// Sub-pixel offset (in NDC) applied to the projection, used by temporal anti-aliasing so every frame samples a slightly different part of each pixel
+		inline void SetProjectionJitter(const glm::vec2 &jitter) { m_ProjectionJitter = jitter; }
 
 		void ProcessInput(float deltaTime);
 
@@ -56,6 +60,8 @@ namespace Arcane
 
 		float m_CurrentMovementSpeed;
 		float m_CurrentFOV;
+
+		glm::vec2 m_ProjectionJitter;
 	};
 }
 #endif
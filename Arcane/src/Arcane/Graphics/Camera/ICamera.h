@@ -11,6 +11,7 @@ namespace Arcane
 
 		virtual glm::mat4 GetViewMatrix() = 0;
 		virtual glm::mat4 GetProjectionMatrix() = 0;
+		virtual glm::mat4 GetUnjitteredProjectionMatrix() { return GetProjectionMatrix(); } // Only differs for cameras that jitter their projection for temporal anti-aliasing
 
 		virtual const glm::vec3& GetPosition() const { return m_Position; }
 		virtual const float GetNearPlane() const { return m_NearPlane; }
@@ -2,29 +2,31 @@
 #ifndef LIGHTPROBE_H
 #define LIGHTPROBE_H
 
+#ifndef SPHERICALHARMONICS_H
+#include <Arcane/Graphics/IBL/SphericalHarmonics.h>
+#endif
+
 namespace Arcane
 {
-	class Shader;
-	class Cubemap;
-
+	// Irradiance is stored as L2 spherical harmonics instead of a cubemap, the probe manager uploads every probe's coefficients into a single SSBO
 	class LightProbe {
 	public:
-		LightProbe(glm::vec3 &probePosition, glm::vec2 &probeResolution);
+		LightProbe(glm::vec3 &probePosition, float influenceRadius = PROBE_DEFAULT_INFLUENCE_RADIUS);
 		~LightProbe();
 
-		void Generate();
-
-		// Assumes the shader is bound
-		void Bind(Shader *shader);
+		// Setters
+		inline void SetIrradiance(const SHCoefficients &irradiance) { m_Irradiance = irradiance; m_Generated = true; }
 
 		// Getters
 		inline glm::vec3& GetPosition() { return m_Position; }
-		inline Cubemap* GetIrradianceMap() { return m_IrradianceMap; }
+		inline float GetInfluenceRadius() const { return m_InfluenceRadius; }
+		inline const SHCoefficients& GetIrradiance() const { return m_Irradiance; }
+		inline bool IsGenerated() const { return m_Generated; }
 	private:
-		Cubemap *m_IrradianceMap;
+		SHCoefficients m_Irradiance;
 
 		glm::vec3 m_Position;
-		glm::vec2 m_ProbeResolution;
+		float m_InfluenceRadius;
 		bool m_Generated;
 	};
 }
@@ -0,0 +1,171 @@
+#include "arcpch.h"
+#include "ProbeBakeCache.h"
+
+#include <Arcane/Graphics/IBL/ProbeManager.h>
+#include <Arcane/Graphics/IBL/LightProbe.h>
+#include <Arcane/Graphics/IBL/ReflectionProbe.h>
+#include <Arcane/Graphics/Texture/Cubemap.h>
+
+namespace Arcane
+{
+	static const char s_BakeMagic[4] = { 'A', 'R', 'C', 'P' };
+	static const uint32_t s_BakeVersion = 3;
+
+	bool ProbeBakeCache::LoadProbes(const std::string &filepath, std::size_t sceneHash, ProbeManager *probeManager)
+	{
+		std::ifstream ifs(filepath, std::ios::in | std::ios::binary);
+		if (!ifs)
+			return false;
+
+		BakeHeader header;
+		ifs.read(reinterpret_cast<char*>(&header), sizeof(BakeHeader));
+
+		// Anything that doesn't match the current scene and probe settings means the bake is stale
+		BakeHeader expectedHeader = CreateHeader(sceneHash, header.LightProbeCount, header.ReflectionProbeCount);
+		if (!ifs || std::memcmp(&header, &expectedHeader, sizeof(BakeHeader)) != 0)
+		{
+			ARC_LOG_INFO("Probe bake is out of date, probes will be re-baked: {0}", filepath);
+			return false;
+		}
+
+		// Read everything before creating any probes so a truncated file doesn't leave the probe manager half populated
+		struct BakedLightProbe
+		{
+			glm::vec3 Position;
+			float InfluenceRadius;
+			SHCoefficients Irradiance;
+		};
+		struct BakedReflectionProbe
+		{
+			glm::vec3 Position;
+			float InfluenceRadius;
+			std::vector<uint32_t> FaceData;
+		};
+		std::vector<BakedLightProbe> lightProbes(header.LightProbeCount);
+		std::vector<BakedReflectionProbe> reflectionProbes(header.ReflectionProbeCount);
+
+		for (BakedLightProbe &probe : lightProbes)
+		{
+			ifs.read(reinterpret_cast<char*>(&probe.Position), sizeof(glm::vec3));
+			ifs.read(reinterpret_cast<char*>(&probe.InfluenceRadius), sizeof(float));
+			ifs.read(reinterpret_cast<char*>(&probe.Irradiance), sizeof(SHCoefficients));
+		}
+
+		size_t reflectionProbeTexelCount = 0;
+		for (int mip = 0; mip < REFLECTION_PROBE_MIP_COUNT; mip++)
+		{
+			size_t mipResolution = glm::max(REFLECTION_PROBE_RESOLUTION >> mip, 1);
+			reflectionProbeTexelCount += 6 * mipResolution * mipResolution;
+		}
+		for (BakedReflectionProbe &probe : reflectionProbes)
+		{
+			probe.FaceData.resize(reflectionProbeTexelCount);
+			ifs.read(reinterpret_cast<char*>(&probe.Position), sizeof(glm::vec3));
+			ifs.read(reinterpret_cast<char*>(&probe.InfluenceRadius), sizeof(float));
+			ifs.read(reinterpret_cast<char*>(probe.FaceData.data()), probe.FaceData.size() * sizeof(uint32_t));
+		}
+
+		if (!ifs)
+		{
+			ARC_LOG_WARN("Probe bake is truncated, probes will be re-baked: {0}", filepath);
+			return false;
+		}
+
+		// Light probes only need their coefficients, reflection probe faces are uploaded straight into the probe cubemaps
+		for (BakedLightProbe &bakedProbe : lightProbes)
+		{
+			LightProbe *lightProbe = new LightProbe(bakedProbe.Position, bakedProbe.InfluenceRadius);
+			lightProbe->SetIrradiance(bakedProbe.Irradiance);
+			probeManager->AddProbe(lightProbe);
+		}
+
+		glm::vec2 reflectionProbeResolution(REFLECTION_PROBE_RESOLUTION, REFLECTION_PROBE_RESOLUTION);
+		for (BakedReflectionProbe &bakedProbe : reflectionProbes)
+		{
+			ReflectionProbe *reflectionProbe = new ReflectionProbe(bakedProbe.Position, reflectionProbeResolution, bakedProbe.InfluenceRadius);
+			reflectionProbe->Generate();
+
+			const uint32_t *faceData = bakedProbe.FaceData.data();
+			for (int mip = 0; mip < REFLECTION_PROBE_MIP_COUNT; mip++)
+			{
+				size_t mipResolution = glm::max(REFLECTION_PROBE_RESOLUTION >> mip, 1);
+				for (int i = 0; i < 6; i++)
+				{
+					reflectionProbe->GetPrefilterMap()->SetFaceData(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mip, GL_RGB, GL_UNSIGNED_INT_5_9_9_9_REV, faceData);
+					faceData += mipResolution * mipResolution;
+				}
+			}
+			probeManager->AddProbe(reflectionProbe);
+		}
+
+		ARC_LOG_INFO("Loaded {0} light probe(s) and {1} reflection probe(s) from probe bake: {2}", header.LightProbeCount, header.ReflectionProbeCount, filepath);
+		return true;
+	}
+
+	void ProbeBakeCache::SaveProbes(const std::string &filepath, std::size_t sceneHash, ProbeManager *probeManager)
+	{
+		std::filesystem::path bakePath(filepath);
+		if (bakePath.has_parent_path())
+		{
+			std::error_code error;
+			std::filesystem::create_directories(bakePath.parent_path(), error);
+		}
+
+		std::ofstream ofs(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!ofs)
+		{
+			ARC_LOG_WARN("Failed to write probe bake: {0}", filepath);
+			return;
+		}
+
+		const std::vector<LightProbe*> &lightProbes = probeManager->GetLightProbes();
+		const std::vector<ReflectionProbe*> &reflectionProbes = probeManager->GetReflectionProbes();
+		BakeHeader header = CreateHeader(sceneHash, static_cast<uint32_t>(lightProbes.size()), static_cast<uint32_t>(reflectionProbes.size()));
+		ofs.write(reinterpret_cast<const char*>(&header), sizeof(BakeHeader));
+
+		for (LightProbe *lightProbe : lightProbes)
+		{
+			float influenceRadius = lightProbe->GetInfluenceRadius();
+			ofs.write(reinterpret_cast<const char*>(&lightProbe->GetPosition()), sizeof(glm::vec3));
+			ofs.write(reinterpret_cast<const char*>(&influenceRadius), sizeof(float));
+			ofs.write(reinterpret_cast<const char*>(&lightProbe->GetIrradiance()), sizeof(SHCoefficients));
+		}
+
+		// The GPU packs the reflection probe faces into the shared exponent format while reading them back
+		std::vector<uint32_t> faceData;
+		for (ReflectionProbe *reflectionProbe : reflectionProbes)
+		{
+			float influenceRadius = reflectionProbe->GetInfluenceRadius();
+			ofs.write(reinterpret_cast<const char*>(&reflectionProbe->GetPosition()), sizeof(glm::vec3));
+			ofs.write(reinterpret_cast<const char*>(&influenceRadius), sizeof(float));
+
+			for (int mip = 0; mip < REFLECTION_PROBE_MIP_COUNT; mip++)
+			{
+				size_t mipResolution = glm::max(REFLECTION_PROBE_RESOLUTION >> mip, 1);
+				faceData.resize(mipResolution * mipResolution);
+				for (int i = 0; i < 6; i++)
+				{
+					reflectionProbe->GetPrefilterMap()->GetFaceData(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mip, GL_RGB, GL_UNSIGNED_INT_5_9_9_9_REV, faceData.data());
+					ofs.write(reinterpret_cast<const char*>(faceData.data()), faceData.size() * sizeof(uint32_t));
+				}
+			}
+		}
+
+		ARC_LOG_INFO("Saved {0} light probe(s) and {1} reflection probe(s) to probe bake: {2}", lightProbes.size(), reflectionProbes.size(), filepath);
+	}
+
+	ProbeBakeCache::BakeHeader ProbeBakeCache::CreateHeader(std::size_t sceneHash, uint32_t lightProbeCount, uint32_t reflectionProbeCount)
+	{
+		BakeHeader header;
+		std::memset(&header, 0, sizeof(BakeHeader)); // Padding is compared when validating so it needs to be zeroed
+		std::memcpy(header.Magic, s_BakeMagic, sizeof(s_BakeMagic));
+		header.Version = s_BakeVersion;
+		header.SceneHash = static_cast<uint64_t>(sceneHash);
+		header.LightProbeCoefficientCount = 9;
+		header.ReflectionProbeResolution = REFLECTION_PROBE_RESOLUTION;
+		header.ReflectionProbeMipCount = REFLECTION_PROBE_MIP_COUNT;
+		header.LightProbeCount = lightProbeCount;
+		header.ReflectionProbeCount = reflectionProbeCount;
+		return header;
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+#ifndef PROBEBAKECACHE_H
+#define PROBEBAKECACHE_H
+
+namespace Arcane
+{
+	class ProbeManager;
+
+	// Stores the scene's generated light and reflection probes on disk so they don't need to be rendered, projected, and importance sampled on every launch.
+	// Light probes are stored as their spherical harmonics coefficients. Reflection probe faces are stored in a shared exponent format (RGB9_E5) which halves the size compared to RGBA16F while keeping the HDR range.
+	// The bake is keyed by a hash of the scene's static content and the probe settings, any change to either is treated as a cache miss so the probes get re-baked
+	class ProbeBakeCache
+	{
+	public:
+		// Returns false if the bake is missing or stale, otherwise the probes are created and added to the probe manager
+		static bool LoadProbes(const std::string &filepath, std::size_t sceneHash, ProbeManager *probeManager);
+		static void SaveProbes(const std::string &filepath, std::size_t sceneHash, ProbeManager *probeManager);
+	private:
+		struct BakeHeader
+		{
+			char Magic[4];
+			uint32_t Version;
+			uint64_t SceneHash;
+			uint32_t LightProbeCoefficientCount;
+			uint32_t ReflectionProbeResolution;
+			uint32_t ReflectionProbeMipCount;
+			uint32_t LightProbeCount;
+			uint32_t ReflectionProbeCount;
+		};
+
+		static BakeHeader CreateHeader(std::size_t sceneHash, uint32_t lightProbeCount, uint32_t reflectionProbeCount);
+	};
+}
+#endif
@@ -4,11 +4,12 @@
 #include <Arcane/Graphics/Shader.h>
 #include <Arcane/Graphics/IBL/LightProbe.h>
 #include <Arcane/Graphics/IBL/ReflectionProbe.h>
+#include <Arcane/Graphics/Texture/Cubemap.h>
 
 namespace Arcane
 {
 	ProbeManager::ProbeManager(ProbeBlendSetting sceneProbeBlendSetting)
-		: m_ProbeBlendSetting(sceneProbeBlendSetting), m_LightProbeFallback(nullptr), m_ReflectionProbeFallback(nullptr)
+		: m_ProbeBlendSetting(sceneProbeBlendSetting), m_LightProbeIndex(PROBE_GRID_CELL_SIZE), m_ReflectionProbeIndex(PROBE_GRID_CELL_SIZE), m_LightProbeFallback(nullptr), m_ReflectionProbeFallback(nullptr), m_BoundReflectionProbe(nullptr), m_LightProbeBufferDirty(true), m_LightProbeGridMinCell(0), m_LightProbeGridSize(1)
 	{}
 
 	ProbeManager::~ProbeManager() {
@@ -26,51 +27,145 @@ namespace Arcane
 	}
 
 	void ProbeManager::AddProbe(LightProbe *probe) {
+		m_LightProbeIndex.Insert(static_cast<unsigned int>(m_LightProbes.size()), probe->GetPosition(), probe->GetInfluenceRadius());
 		m_LightProbes.push_back(probe);
+		m_LightProbeBufferDirty = true;
 	}
 
 	void ProbeManager::AddProbe(ReflectionProbe *probe) {
+		m_ReflectionProbeIndex.Insert(static_cast<unsigned int>(m_ReflectionProbes.size()), probe->GetPosition(), probe->GetInfluenceRadius());
 		m_ReflectionProbes.push_back(probe);
 	}
 
 	void ProbeManager::BindProbes(glm::vec3 &renderPosition, Shader *shader) {
-		// If simple blending is enabled just use the closest probe
-		if (m_ProbeBlendSetting == PROBES_SIMPLE) {
+		if (m_LightProbeBufferDirty) {
+			UploadLightProbes();
+		}
+		m_LightProbeBuffer.BindBase(LightProbeBufferBinding);
+
+		m_BoundReflectionProbe = nullptr;
+		SelectProbes(renderPosition, shader);
+	}
+
+	void ProbeManager::SelectProbes(const glm::vec3 &position, Shader *shader) {
+		// Light probe indices are into the probe buffer, so the fallback is at index 0 and scene probes are offset by one
+		glm::ivec4 lightProbeIndices(0);
+		glm::vec4 lightProbeWeights(1.0f, 0.0f, 0.0f, 0.0f);
+		ReflectionProbe *reflectionProbe = m_ReflectionProbeFallback;
+
+		if (m_ProbeBlendSetting != PROBES_DISABLED) {
+			// The last slot is kept for the fallback, so it can always fill in whatever the probes don't cover
+			unsigned int maxLightProbes = m_ProbeBlendSetting == PROBES_BLEND ? PROBE_MAX_BLEND_COUNT - 1 : 1;
+			ProbeQueryResult results[PROBE_MAX_BLEND_COUNT];
+
 			// Light Probes
-			if (m_LightProbes.size() > 0) {
-				unsigned int closestIndex = 0;
-				for (unsigned int i = 1; i < m_LightProbes.size(); i++) {
-					if (glm::length2(m_LightProbes[i]->GetPosition() - renderPosition) < glm::length2(m_LightProbes[closestIndex]->GetPosition() - renderPosition))
-						closestIndex = i;
+			unsigned int resultCount = m_LightProbeIndex.Query(position, results, maxLightProbes);
+			if (resultCount > 0) {
+				if (m_ProbeBlendSetting == PROBES_BLEND) {
+					// Normalize the weights if the probes fully cover the position, otherwise the fallback fills in the rest so there is no seam at the edge of the probes' influence
+					float totalWeight = 0.0f;
+					for (unsigned int i = 0; i < resultCount; i++) {
+						totalWeight += results[i].Weight;
+					}
+					bool normalize = totalWeight > 1.0f;
+					float normalization = normalize ? 1.0f / totalWeight : 1.0f;
+					float fallbackWeight = normalize ? 0.0f : 1.0f - totalWeight;
+
+					lightProbeWeights = glm::vec4(0.0f);
+					for (unsigned int i = 0; i < resultCount; i++) {
+						lightProbeIndices[i] = results[i].ProbeIndex + 1;
+						lightProbeWeights[i] = results[i].Weight * normalization;
+					}
+					lightProbeIndices[resultCount] = 0;
+					lightProbeWeights[resultCount] = fallbackWeight;
+				}
+				else {
+					lightProbeIndices[0] = results[0].ProbeIndex + 1;
 				}
-				m_LightProbes[closestIndex]->Bind(shader);
-			}
-			// Light probe fallback
-			else {
-				m_LightProbeFallback->Bind(shader);
 			}
 
-			// Reflection Probes
-			if (m_ReflectionProbes.size() > 0) {
-				unsigned int closestIndex = 0;
-				for (unsigned int i = 1; i < m_ReflectionProbes.size(); i++) {
-					if (glm::length2(m_ReflectionProbes[i]->GetPosition() - renderPosition) < glm::length2(m_ReflectionProbes[closestIndex]->GetPosition() - renderPosition))
-						closestIndex = i;
-				}
-				m_ReflectionProbes[closestIndex]->Bind(shader);
+			// Reflection Probes (cubemaps can't be blended cheaply, so the highest weighted probe is used)
+			if (m_ReflectionProbeIndex.Query(position, results, 1) > 0) {
+				reflectionProbe = m_ReflectionProbes[results[0].ProbeIndex];
 			}
-			// Reflection probe fallback
-			else {
-				m_ReflectionProbeFallback->Bind(shader);
+		}
+
+		shader->SetUniform("lightProbeIndices", lightProbeIndices);
+		shader->SetUniform("lightProbeWeights", lightProbeWeights);
+		if (reflectionProbe != m_BoundReflectionProbe) {
+			reflectionProbe->Bind(shader);
+			m_BoundReflectionProbe = reflectionProbe;
+		}
+	}
+
+	void ProbeManager::BindPerPixelProbes(const glm::vec3 &viewPosition, Shader *shader) {
+		m_LightProbeGridBuffer.BindBase(LightProbeGridBinding);
+		shader->SetUniform("lightProbeGridMin", glm::vec3(m_LightProbeGridMinCell) * m_LightProbeIndex.GetCellSize());
+		shader->SetUniform("lightProbeGridCellSize", m_LightProbeIndex.GetCellSize());
+		shader->SetUniform("lightProbeGridSize", m_LightProbeGridSize);
+
+		int lightProbeBlendCount = 0;
+		if (m_ProbeBlendSetting == PROBES_SIMPLE)
+			lightProbeBlendCount = 1;
+		else if (m_ProbeBlendSetting == PROBES_BLEND)
+			lightProbeBlendCount = PROBE_MAX_BLEND_COUNT - 1; // Same as SelectProbes, a slot is left for the fallback
+		shader->SetUniform("lightProbeBlendCount", lightProbeBlendCount);
+
+		// Cubemaps can't be looked up from a buffer, so the reflection probes whose influence is closest to the view are bound and each pixel picks the highest weighted of them
+		std::vector<std::pair<float, ReflectionProbe*>> reflectionCandidates;
+		if (m_ProbeBlendSetting != PROBES_DISABLED) {
+			reflectionCandidates.reserve(m_ReflectionProbes.size());
+			for (ReflectionProbe *probe : m_ReflectionProbes) {
+				float distanceToInfluence = glm::max(0.0f, glm::distance(viewPosition, probe->GetPosition()) - probe->GetInfluenceRadius());
+				reflectionCandidates.push_back({ distanceToInfluence, probe });
 			}
 		}
-		// If probes are disabled just use the skybox
-		else if (m_ProbeBlendSetting == PROBES_DISABLED) {
-			// Light probe fallback
-			m_LightProbeFallback->Bind(shader);
+		int candidateCount = glm::min(static_cast<int>(reflectionCandidates.size()), PROBE_MAX_PER_PIXEL_REFLECTION_PROBES);
+		std::partial_sort(reflectionCandidates.begin(), reflectionCandidates.begin() + candidateCount, reflectionCandidates.end(),
+			[](const std::pair<float, ReflectionProbe*> &a, const std::pair<float, ReflectionProbe*> &b) { return a.first < b.first; });
+
+		int textureUnits[PROBE_MAX_PER_PIXEL_REFLECTION_PROBES];
+		glm::vec4 positionRadii[PROBE_MAX_PER_PIXEL_REFLECTION_PROBES];
+		for (int i = 0; i < PROBE_MAX_PER_PIXEL_REFLECTION_PROBES; i++) {
+			// Unused slots still get the fallback bound so every sampler in the array is valid
+			ReflectionProbe *probe = i < candidateCount ? reflectionCandidates[i].second : m_ReflectionProbeFallback;
+			textureUnits[i] = PROBE_PER_PIXEL_REFLECTION_FIRST_UNIT + i;
+			probe->GetPrefilterMap()->Bind(textureUnits[i]);
+			positionRadii[i] = glm::vec4(probe->GetPosition(), i < candidateCount ? probe->GetInfluenceRadius() : 0.0f);
+		}
+		shader->SetUniformArray("reflectionProbeMaps", PROBE_MAX_PER_PIXEL_REFLECTION_PROBES, textureUnits);
+		shader->SetUniformArray("reflectionProbePositionRadii", PROBE_MAX_PER_PIXEL_REFLECTION_PROBES, positionRadii);
+		shader->SetUniform("reflectionProbeCount", candidateCount);
+	}
+
+	void ProbeManager::UploadLightProbes() {
+		std::vector<GPULightProbe> gpuLightProbes;
+		gpuLightProbes.reserve(m_LightProbes.size() + 1);
 
-			// Reflection probe fallback
-			m_ReflectionProbeFallback->Bind(shader);
+		auto addProbe = [&gpuLightProbes](LightProbe *probe, bool isFallback) {
+			GPULightProbe gpuProbe = {};
+			if (probe) {
+				const SHCoefficients &irradiance = probe->GetIrradiance();
+				for (int i = 0; i < 9; i++) {
+					gpuProbe.SHCoefficients[i] = glm::vec4(irradiance.Coefficients[i], 0.0f);
+				}
+				gpuProbe.PositionRadius = glm::vec4(probe->GetPosition(), isFallback ? 0.0f : probe->GetInfluenceRadius());
+			}
+			gpuLightProbes.push_back(gpuProbe);
+		};
+		addProbe(m_LightProbeFallback, true);
+		for (LightProbe *probe : m_LightProbes) {
+			addProbe(probe, false);
 		}
+
+		m_LightProbeBuffer.Upload(gpuLightProbes.data(), sizeof(GPULightProbe) * gpuLightProbes.size());
+		m_LightProbeBuffer.Unbind();
+
+		// Probes only get added alongside a probe buffer upload, so the grid is kept in sync here
+		std::vector<unsigned int> gridData;
+		m_LightProbeIndex.Flatten(m_LightProbeGridMinCell, m_LightProbeGridSize, gridData);
+		m_LightProbeGridBuffer.Upload(gridData.data(), sizeof(unsigned int) * gridData.size());
+		m_LightProbeGridBuffer.Unbind();
+		m_LightProbeBufferDirty = false;
 	}
 }
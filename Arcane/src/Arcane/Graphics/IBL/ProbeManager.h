@@ -2,17 +2,32 @@
 #ifndef PROBEMANAGER_H
 #define PROBEMANAGER_H
 
+#ifndef SHADERSTORAGEBUFFER_H
+#include <Arcane/Platform/OpenGL/ShaderStorageBuffer.h>
+#endif
+
+#ifndef PROBESPATIALINDEX_H
+#include <Arcane/Graphics/IBL/ProbeSpatialIndex.h>
+#endif
+
 namespace Arcane
 {
 	class Shader;
 	class LightProbe;
 	class ReflectionProbe;
 
+	// GPU representation of a light probe, this must match the std430 layout of LightProbe in the lighting shaders
+	struct GPULightProbe
+	{
+		glm::vec4 SHCoefficients[9]; // L2 spherical harmonics irradiance (rgb, w is unused)
+		glm::vec4 PositionRadius; // xyz = position, w = influence radius (0 for the fallback)
+	};
+
 	enum ProbeBlendSetting
 	{
 		PROBES_DISABLED, // Ignores probes and uses the skybox
-		PROBES_SIMPLE, // Uses the closest probe (no blending)
-		PROBES_BLEND // Blends adjacent probes (TODO: Make this work)
+		PROBES_SIMPLE, // Uses the closest probe whose influence contains the object (no blending)
+		PROBES_BLEND // Blends the light probes whose influence contains the object by their weights, reflections use the highest weighted probe
 	};
 
 	class ProbeManager {
@@ -23,21 +38,50 @@ namespace Arcane
 		void AddProbe(LightProbe *probe);
 		void AddProbe(ReflectionProbe *probe);
 
-		inline void SetLightProbeFallback(LightProbe *probe) { m_LightProbeFallback = probe; }
+		inline void SetLightProbeFallback(LightProbe *probe) { m_LightProbeFallback = probe; m_LightProbeBufferDirty = true; }
 		inline void SetReflectionProbeFallback(ReflectionProbe *probe) { m_ReflectionProbeFallback = probe; }
 
-		// Assumes shader is bound
+		inline const std::vector<LightProbe*>& GetLightProbes() const { return m_LightProbes; }
+		inline const std::vector<ReflectionProbe*>& GetReflectionProbes() const { return m_ReflectionProbes; }
+
+		// Needs to be called after a light probe's irradiance changes so the probe buffer gets re-uploaded
+		inline void MarkLightProbesDirty() { m_LightProbeBufferDirty = true; }
+
+		// Assumes shader is bound. Binds the probe buffer and selects the probes for the render position
 		void BindProbes(glm::vec3 &renderPosition, Shader *shader);
+
+		// Assumes shader is bound and BindProbes has already been called for it. Only selects the probes for the position, so it is cheap enough to call for every object
+		void SelectProbes(const glm::vec3 &position, Shader *shader);
+
+		// Assumes shader is bound and BindProbes has already been called for it. For shaders that select probes per pixel (the deferred lighting pass), binds the light probe grid
+		// and the reflection probes closest to the view position, the shader then picks from them the same way SelectProbes does
+		void BindPerPixelProbes(const glm::vec3 &viewPosition, Shader *shader);
+
+		// SSBO binding point used by the lighting shaders (follows the shadow atlas buffer)
+		static const unsigned int LightProbeBufferBinding = 5;
+		static const unsigned int LightProbeGridBinding = 10;
+	private:
+		void UploadLightProbes();
 	private:
 		ProbeBlendSetting m_ProbeBlendSetting;
 		
 		// Scene probes
 		std::vector<LightProbe*> m_LightProbes;
 		std::vector<ReflectionProbe*> m_ReflectionProbes;
+		ProbeSpatialIndex m_LightProbeIndex, m_ReflectionProbeIndex;
 
 		// Fallback probes
 		LightProbe *m_LightProbeFallback;
 		ReflectionProbe *m_ReflectionProbeFallback;
+		ReflectionProbe *m_BoundReflectionProbe; // Avoids rebinding the same cubemap when consecutive objects select the same reflection probe
+
+		// Every light probe's coefficients live in one buffer, the fallback is always at index 0 followed by the scene probes
+		ShaderStorageBuffer m_LightProbeBuffer;
+		bool m_LightProbeBufferDirty;
+
+		// The light probe spatial index flattened for per pixel lookups, uploaded alongside the probe buffer
+		ShaderStorageBuffer m_LightProbeGridBuffer;
+		glm::ivec3 m_LightProbeGridMinCell, m_LightProbeGridSize;
 	};
 }
 #endif
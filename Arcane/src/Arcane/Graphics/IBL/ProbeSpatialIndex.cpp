@@ -0,0 +1,133 @@
+#include "arcpch.h"
+#include "ProbeSpatialIndex.h"
+
+namespace Arcane
+{
+	ProbeSpatialIndex::ProbeSpatialIndex(float cellSize) : m_CellSize(cellSize)
+	{
+		ARC_ASSERT(cellSize > 0.0f, "Probe spatial index cell size needs to be > 0");
+	}
+
+	void ProbeSpatialIndex::Clear()
+	{
+		m_Cells.clear();
+	}
+
+	void ProbeSpatialIndex::Insert(unsigned int probeIndex, const glm::vec3 &position, float influenceRadius)
+	{
+		ProbeEntry entry = { probeIndex, position, influenceRadius };
+
+		// Conservatively insert into every cell the influence sphere's bounding box overlaps
+		glm::ivec3 minCell = GetCell(position - glm::vec3(influenceRadius));
+		glm::ivec3 maxCell = GetCell(position + glm::vec3(influenceRadius));
+		for (int z = minCell.z; z <= maxCell.z; z++)
+		{
+			for (int y = minCell.y; y <= maxCell.y; y++)
+			{
+				for (int x = minCell.x; x <= maxCell.x; x++)
+				{
+					m_Cells[GetCellKey(glm::ivec3(x, y, z))].push_back(entry);
+				}
+			}
+		}
+	}
+
+	unsigned int ProbeSpatialIndex::Query(const glm::vec3 &position, ProbeQueryResult *outResults, unsigned int maxResults) const
+	{
+		auto iter = m_Cells.find(GetCellKey(GetCell(position)));
+		if (iter == m_Cells.end() || maxResults == 0)
+			return 0;
+
+		unsigned int resultCount = 0;
+		for (const ProbeEntry &entry : iter->second)
+		{
+			float distance = glm::length(entry.Position - position);
+			if (distance >= entry.InfluenceRadius)
+				continue;
+
+			float falloff = 1.0f - (distance / entry.InfluenceRadius);
+			float weight = falloff * falloff;
+
+			// Insertion sort into the results, maxResults is small so this is cheaper than sorting everything afterwards
+			if (resultCount < maxResults)
+			{
+				resultCount++;
+			}
+			else if (weight <= outResults[resultCount - 1].Weight)
+			{
+				continue;
+			}
+
+			unsigned int insertIndex = resultCount - 1;
+			while (insertIndex > 0 && outResults[insertIndex - 1].Weight < weight)
+			{
+				outResults[insertIndex] = outResults[insertIndex - 1];
+				insertIndex--;
+			}
+			outResults[insertIndex] = { entry.ProbeIndex, weight };
+		}
+
+		return resultCount;
+	}
+
+	void ProbeSpatialIndex::Flatten(glm::ivec3 &outMinCell, glm::ivec3 &outGridSize, std::vector<unsigned int> &outGridData) const
+	{
+		outGridData.clear();
+		if (m_Cells.empty())
+		{
+			outMinCell = glm::ivec3(0);
+			outGridSize = glm::ivec3(1);
+			outGridData.push_back(0);
+			outGridData.push_back(0);
+			return;
+		}
+
+		// Cells are stored by key, so the bounds come from the probes that were inserted into them
+		glm::ivec3 minCell(std::numeric_limits<int>::max()), maxCell(std::numeric_limits<int>::min());
+		for (auto &[key, entries] : m_Cells)
+		{
+			for (const ProbeEntry &entry : entries)
+			{
+				minCell = glm::min(minCell, GetCell(entry.Position - glm::vec3(entry.InfluenceRadius)));
+				maxCell = glm::max(maxCell, GetCell(entry.Position + glm::vec3(entry.InfluenceRadius)));
+			}
+		}
+		outMinCell = minCell;
+		outGridSize = maxCell - minCell + glm::ivec3(1);
+
+		size_t cellCount = static_cast<size_t>(outGridSize.x) * outGridSize.y * outGridSize.z;
+		outGridData.resize(cellCount * 2, 0);
+		for (int z = 0; z < outGridSize.z; z++)
+		{
+			for (int y = 0; y < outGridSize.y; y++)
+			{
+				for (int x = 0; x < outGridSize.x; x++)
+				{
+					auto iter = m_Cells.find(GetCellKey(minCell + glm::ivec3(x, y, z)));
+					if (iter == m_Cells.end())
+						continue;
+
+					size_t cellIndex = x + y * static_cast<size_t>(outGridSize.x) + z * static_cast<size_t>(outGridSize.x) * outGridSize.y;
+					outGridData[cellIndex * 2] = static_cast<unsigned int>(outGridData.size());
+					outGridData[cellIndex * 2 + 1] = static_cast<unsigned int>(iter->second.size());
+					for (const ProbeEntry &entry : iter->second)
+					{
+						outGridData.push_back(entry.ProbeIndex);
+					}
+				}
+			}
+		}
+	}
+
+	glm::ivec3 ProbeSpatialIndex::GetCell(const glm::vec3 &position) const
+	{
+		return glm::ivec3(glm::floor(position / m_CellSize));
+	}
+
+	uint64_t ProbeSpatialIndex::GetCellKey(const glm::ivec3 &cell)
+	{
+		// 21 bits per axis is plenty for any reasonable cell size
+		const uint64_t mask = (1ull << 21) - 1;
+		return (static_cast<uint64_t>(cell.x) & mask) | ((static_cast<uint64_t>(cell.y) & mask) << 21) | ((static_cast<uint64_t>(cell.z) & mask) << 42);
+	}
+}
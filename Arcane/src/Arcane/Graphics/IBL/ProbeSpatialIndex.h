@@ -0,0 +1,46 @@
+#pragma once
+#ifndef PROBESPATIALINDEX_H
+#define PROBESPATIALINDEX_H
+
+namespace Arcane
+{
+	struct ProbeQueryResult
+	{
+		unsigned int ProbeIndex;
+		float Weight; // Not normalized, 1 at the probe's position and fades to 0 at the edge of it's influence
+	};
+
+	// Uniform grid over the probes in a scene. A probe is inserted into every cell it's influence sphere overlaps, so a lookup only needs to visit the single cell
+	// containing the query position. That keeps per object probe selection constant time no matter how many probes the scene has
+	class ProbeSpatialIndex
+	{
+	public:
+		ProbeSpatialIndex(float cellSize);
+
+		void Clear();
+		void Insert(unsigned int probeIndex, const glm::vec3 &position, float influenceRadius);
+
+		// Finds up to maxResults probes whose influence contains the position, sorted by weight (highest first). Returns the amount of results written
+		unsigned int Query(const glm::vec3 &position, ProbeQueryResult *outResults, unsigned int maxResults) const;
+
+		// Flattens the cells into a dense grid covering every non-empty cell so it can be uploaded for per pixel lookups. outGridData is (offset, count) for every cell
+		// (x fastest, then y, then z) followed by the probe indices, offsets index into outGridData. An index with no probes is a single empty cell
+		void Flatten(glm::ivec3 &outMinCell, glm::ivec3 &outGridSize, std::vector<unsigned int> &outGridData) const;
+
+		inline float GetCellSize() const { return m_CellSize; }
+	private:
+		struct ProbeEntry
+		{
+			unsigned int ProbeIndex;
+			glm::vec3 Position;
+			float InfluenceRadius;
+		};
+
+		glm::ivec3 GetCell(const glm::vec3 &position) const;
+		static uint64_t GetCellKey(const glm::ivec3 &cell);
+	private:
+		float m_CellSize;
+		std::unordered_map<uint64_t, std::vector<ProbeEntry>> m_Cells;
+	};
+}
+#endif
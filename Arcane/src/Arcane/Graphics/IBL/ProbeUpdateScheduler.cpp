@@ -0,0 +1,126 @@
+#include "arcpch.h"
+#include "ProbeUpdateScheduler.h"
+
+#include <Arcane/Graphics/IBL/ProbeManager.h>
+#include <Arcane/Graphics/IBL/LightProbe.h>
+#include <Arcane/Graphics/IBL/ReflectionProbe.h>
+#include <Arcane/Graphics/Lights/LightManager.h>
+
+namespace Arcane
+{
+	ProbeUpdateScheduler::ProbeUpdateScheduler() : m_UpdatesEnabled(true), m_BudgetMS(PROBE_UPDATE_GPU_BUDGET_MS), m_EstimatedStepCostMS(PROBE_UPDATE_GPU_BUDGET_MS),
+		m_StepsThisFrame(0), m_StaticCasterHash(0)
+	{}
+
+	void ProbeUpdateScheduler::SyncProbes(ProbeManager *probeManager, LightManager *lightManager)
+	{
+		// Static models changing invalidates every capture, only the probes added afterwards were captured with the new static models
+		std::size_t staticCasterHash = lightManager->GetStaticShadowCasterHash();
+		if (staticCasterHash != m_StaticCasterHash)
+		{
+			for (ProbeLightingState &state : m_LightProbeStates)
+				state.StaticContentChanged = true;
+			for (ProbeLightingState &state : m_ReflectionProbeStates)
+				state.StaticContentChanged = true;
+			m_StaticCasterHash = staticCasterHash;
+		}
+
+		const std::vector<LightProbe*> &lightProbes = probeManager->GetLightProbes();
+		for (size_t i = m_LightProbeStates.size(); i < lightProbes.size(); i++)
+		{
+			ProbeLightingState state;
+			lightManager->EstimateIncidentLight(lightProbes[i]->GetPosition(), lightProbes[i]->GetInfluenceRadius(), true, state.CapturedRadiance, state.CapturedDirection);
+			state.CurrentRadiance = state.CapturedRadiance;
+			state.CurrentDirection = state.CapturedDirection;
+			state.StaticContentChanged = false;
+			m_LightProbeStates.push_back(state);
+		}
+
+		const std::vector<ReflectionProbe*> &reflectionProbes = probeManager->GetReflectionProbes();
+		for (size_t i = m_ReflectionProbeStates.size(); i < reflectionProbes.size(); i++)
+		{
+			ProbeLightingState state;
+			lightManager->EstimateIncidentLight(reflectionProbes[i]->GetPosition(), reflectionProbes[i]->GetInfluenceRadius(), true, state.CapturedRadiance, state.CapturedDirection);
+			state.CurrentRadiance = state.CapturedRadiance;
+			state.CurrentDirection = state.CapturedDirection;
+			state.StaticContentChanged = false;
+			m_ReflectionProbeStates.push_back(state);
+		}
+	}
+
+	unsigned int ProbeUpdateScheduler::BeginFrame(double measuredGPUTimeMS, unsigned int measuredSteps)
+	{
+		m_StepsThisFrame = 0;
+
+		// Smooth the measured cost so a single slow frame doesn't throw off the estimate
+		if (measuredSteps > 0 && measuredGPUTimeMS >= 0.0)
+		{
+			float measuredStepCostMS = static_cast<float>(measuredGPUTimeMS) / measuredSteps;
+			m_EstimatedStepCostMS = glm::mix(m_EstimatedStepCostMS, measuredStepCostMS, 0.25f);
+		}
+
+		if (!m_UpdatesEnabled)
+			return 0;
+
+		// At least one step is always done so the probes keep converging even if a single step is over budget
+		if (m_EstimatedStepCostMS <= 0.0f)
+			return PROBE_UPDATE_MAX_STEPS_PER_FRAME;
+		return glm::clamp(static_cast<unsigned int>(m_BudgetMS / m_EstimatedStepCostMS), 1u, static_cast<unsigned int>(PROBE_UPDATE_MAX_STEPS_PER_FRAME));
+	}
+
+	bool ProbeUpdateScheduler::SelectNextProbe(ProbeManager *probeManager, LightManager *lightManager, const glm::vec3 &cameraPosition, ProbeUpdateRequest &outRequest)
+	{
+		if (!m_UpdatesEnabled)
+			return false;
+
+		float highestPriority = 0.0f;
+		auto considerProbe = [&](ProbeLightingState &state, const glm::vec3 &probePosition, float influenceRadius, bool isReflectionProbe, unsigned int probeIndex)
+		{
+			lightManager->EstimateIncidentLight(probePosition, influenceRadius, false, state.CurrentRadiance, state.CurrentDirection);
+
+			float change = state.StaticContentChanged ? 1.0f : CalculateLightingChange(state);
+			if (change < PROBE_UPDATE_CHANGE_THRESHOLD)
+				return;
+
+			// Probes the camera is inside of (or near) are the most noticeable
+			float priority = change / (1.0f + glm::distance(cameraPosition, probePosition) / influenceRadius);
+			if (priority > highestPriority)
+			{
+				highestPriority = priority;
+				outRequest.IsReflectionProbe = isReflectionProbe;
+				outRequest.ProbeIndex = probeIndex;
+			}
+		};
+
+		const std::vector<LightProbe*> &lightProbes = probeManager->GetLightProbes();
+		for (unsigned int i = 0; i < m_LightProbeStates.size(); i++)
+		{
+			considerProbe(m_LightProbeStates[i], lightProbes[i]->GetPosition(), lightProbes[i]->GetInfluenceRadius(), false, i);
+		}
+
+		const std::vector<ReflectionProbe*> &reflectionProbes = probeManager->GetReflectionProbes();
+		for (unsigned int i = 0; i < m_ReflectionProbeStates.size(); i++)
+		{
+			considerProbe(m_ReflectionProbeStates[i], reflectionProbes[i]->GetPosition(), reflectionProbes[i]->GetInfluenceRadius(), true, i);
+		}
+
+		return highestPriority > 0.0f;
+	}
+
+	void ProbeUpdateScheduler::BeginProbeUpdate(const ProbeUpdateRequest &request)
+	{
+		ProbeLightingState &state = request.IsReflectionProbe ? m_ReflectionProbeStates[request.ProbeIndex] : m_LightProbeStates[request.ProbeIndex];
+		state.CapturedRadiance = state.CurrentRadiance;
+		state.CapturedDirection = state.CurrentDirection;
+		state.StaticContentChanged = false;
+	}
+
+	float ProbeUpdateScheduler::CalculateLightingChange(const ProbeLightingState &state)
+	{
+		// Brightness change is relative so dim areas are just as responsive as bright ones, the direction change catches lights moving (ie time of day)
+		float radianceScale = glm::max(glm::max(glm::length(state.CapturedRadiance), glm::length(state.CurrentRadiance)), 0.001f);
+		float radianceChange = glm::length(state.CurrentRadiance - state.CapturedRadiance) / radianceScale;
+		float directionChange = glm::length(state.CurrentDirection - state.CapturedDirection) * 0.5f;
+		return radianceChange + directionChange;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef PROBEUPDATESCHEDULER_H
+#define PROBEUPDATESCHEDULER_H
+
+namespace Arcane
+{
+	class ProbeManager;
+	class LightManager;
+
+	struct ProbeUpdateRequest
+	{
+		bool IsReflectionProbe;
+		unsigned int ProbeIndex;
+	};
+
+	// Decides which probe should be re-captured at runtime and how much of the re-capture fits in a frame.
+	// Every probe remembers the lighting it was captured with, probes are then prioritised by how much that lighting has changed and how close they are to the camera.
+	// A re-capture is split into steps (a cube face or a mip) and the measured GPU time of a recent frame's steps is used to estimate how many steps fit in the budget
+	class ProbeUpdateScheduler
+	{
+	public:
+		ProbeUpdateScheduler();
+
+		// Starts tracking probes that were added to the probe manager since the last call. Probes are assumed to have been captured with the static lighting (like the bake)
+		void SyncProbes(ProbeManager *probeManager, LightManager *lightManager);
+
+		// Returns how many steps can be done this frame. measuredGPUTimeMS is the GPU time of a recent frame that did measuredSteps steps,
+		// measuredSteps should be zero if no new measurement is available (GPU timings are read back a few frames late)
+		unsigned int BeginFrame(double measuredGPUTimeMS, unsigned int measuredSteps);
+		inline void OnStepExecuted() { m_StepsThisFrame++; }
+		inline unsigned int GetStepsThisFrame() const { return m_StepsThisFrame; }
+
+		// Finds the probe whose lighting has changed the most, weighted by it's distance to the camera. Returns false if no probe needs to be re-captured
+		bool SelectNextProbe(ProbeManager *probeManager, LightManager *lightManager, const glm::vec3 &cameraPosition, ProbeUpdateRequest &outRequest);
+
+		// Records the lighting the selected probe is being re-captured with, so any further change is measured from this point
+		void BeginProbeUpdate(const ProbeUpdateRequest &request);
+
+		inline bool& GetUpdatesEnabledRef() { return m_UpdatesEnabled; }
+		inline float& GetBudgetRef() { return m_BudgetMS; }
+		inline float GetEstimatedStepCostMS() const { return m_EstimatedStepCostMS; }
+	private:
+		struct ProbeLightingState
+		{
+			glm::vec3 CapturedRadiance, CapturedDirection; // Lighting the probe was last captured with
+			glm::vec3 CurrentRadiance, CurrentDirection; // Updated every time probes are selected
+			bool StaticContentChanged; // Static models changed since the capture, so the probe needs to be re-captured no matter how the lighting changed
+		};
+
+		static float CalculateLightingChange(const ProbeLightingState &state);
+	private:
+		bool m_UpdatesEnabled;
+		float m_BudgetMS;
+		float m_EstimatedStepCostMS;
+		unsigned int m_StepsThisFrame;
+
+		std::vector<ProbeLightingState> m_LightProbeStates, m_ReflectionProbeStates;
+		std::size_t m_StaticCasterHash;
+	};
+}
+#endif
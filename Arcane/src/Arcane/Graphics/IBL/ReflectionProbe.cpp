@@ -9,8 +9,8 @@ namespace Arcane
 {
 	Texture* ReflectionProbe::s_BRDF_LUT = nullptr;
 
-	ReflectionProbe::ReflectionProbe(glm::vec3 &probePosition, glm::vec2 &probeResolution)
-		: m_Position(probePosition), m_ProbeResolution(probeResolution), m_Generated(false), m_PrefilterMap(nullptr)
+	ReflectionProbe::ReflectionProbe(glm::vec3 &probePosition, glm::vec2 &probeResolution, float influenceRadius)
+		: m_Position(probePosition), m_ProbeResolution(probeResolution), m_InfluenceRadius(influenceRadius), m_Generated(false), m_PrefilterMap(nullptr)
 	{}
 
 	ReflectionProbe::~ReflectionProbe() {
@@ -10,7 +10,7 @@ namespace Arcane
 
 	class ReflectionProbe {
 	public:
-		ReflectionProbe(glm::vec3 &probePosition, glm::vec2 &probeResolution);
+		ReflectionProbe(glm::vec3 &probePosition, glm::vec2 &probeResolution, float influenceRadius = PROBE_DEFAULT_INFLUENCE_RADIUS);
 		~ReflectionProbe();
 
 		void Generate();
@@ -20,10 +20,12 @@ namespace Arcane
 
 		// Getters
 		inline glm::vec3& GetPosition() { return m_Position; }
+		inline float GetInfluenceRadius() const { return m_InfluenceRadius; }
 		inline Cubemap* GetPrefilterMap() { return m_PrefilterMap; }
 		static inline Texture* GetBRDFLUT() { return s_BRDF_LUT; }
 
 		// Setters
+		inline void SwapPrefilterMap(ReflectionProbe *other) { std::swap(m_PrefilterMap, other->m_PrefilterMap); } // Lets a probe be re-generated into another probe and swapped in once it's finished
 		static void SetBRDFLUT(Texture *texture) { s_BRDF_LUT = texture; }
 	private:
 		Cubemap *m_PrefilterMap;
@@ -31,6 +33,7 @@ namespace Arcane
 
 		glm::vec3 m_Position;
 		glm::vec2 m_ProbeResolution;
+		float m_InfluenceRadius;
 		bool m_Generated;
 	};
 }
@@ -0,0 +1,183 @@
+#include "arcpch.h"
+#include "SphericalHarmonics.h"
+
+#include <Arcane/Core/Threads/ParallelFor.h>
+#include <Arcane/Graphics/Texture/Cubemap.h>
+
+#include <xmmintrin.h>
+
+namespace Arcane
+{
+	// Direction of a texel on a face is Base + s * SAxis + t * TAxis where (s, t) are the texel's coordinates in [-1, 1] (matches the OpenGL cubemap face layout)
+	struct CubemapFaceBasis
+	{
+		float Base[3], SAxis[3], TAxis[3];
+	};
+
+	static const CubemapFaceBasis s_CubemapFaceBases[6] =
+	{
+		{ {  1.0f,  0.0f,  0.0f }, {  0.0f, 0.0f, -1.0f }, { 0.0f, -1.0f,  0.0f } }, // +X
+		{ { -1.0f,  0.0f,  0.0f }, {  0.0f, 0.0f,  1.0f }, { 0.0f, -1.0f,  0.0f } }, // -X
+		{ {  0.0f,  1.0f,  0.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f,  0.0f,  1.0f } }, // +Y
+		{ {  0.0f, -1.0f,  0.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f,  0.0f, -1.0f } }, // -Y
+		{ {  0.0f,  0.0f,  1.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f, -1.0f,  0.0f } }, // +Z
+		{ {  0.0f,  0.0f, -1.0f }, { -1.0f, 0.0f,  0.0f }, { 0.0f, -1.0f,  0.0f } }, // -Z
+	};
+
+	SHCoefficients SphericalHarmonics::ProjectIrradiance(Cubemap *cubemap)
+	{
+		unsigned int faceResolution = cubemap->GetFaceWidth();
+		if (faceResolution == 0)
+		{
+			ARC_LOG_WARN("Tried to project a cubemap that hasn't been generated onto spherical harmonics");
+			return SHCoefficients();
+		}
+		size_t faceFloatCount = static_cast<size_t>(faceResolution) * faceResolution * 4;
+
+		std::vector<float> faceData(faceFloatCount * 6);
+		for (int i = 0; i < 6; i++)
+		{
+			cubemap->GetFaceData(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, GL_FLOAT, &faceData[faceFloatCount * i]);
+		}
+
+		return ConvolveWithCosineLobe(ProjectRadiance(faceData.data(), faceResolution));
+	}
+
+	SHCoefficients SphericalHarmonics::ProjectRadiance(const float *faceData, unsigned int faceResolution)
+	{
+		// Every row is projected independently so the threads never share any output, the rows are then summed in order so the result is deterministic
+		unsigned int rowCount = faceResolution * 6;
+		std::vector<RowProjection> rowProjections(rowCount);
+		ParallelFor(rowCount, [faceData, faceResolution, &rowProjections](unsigned int rowIndex)
+		{
+			unsigned int face = rowIndex / faceResolution;
+			unsigned int row = rowIndex % faceResolution;
+			const float *rowData = faceData + (static_cast<size_t>(rowIndex) * faceResolution * 4);
+			ProjectRow(rowData, face, row, faceResolution, rowProjections[rowIndex]);
+		}, 32);
+
+		double coefficients[9][3] = {};
+		double weightSum = 0.0;
+		for (const RowProjection &rowProjection : rowProjections)
+		{
+			for (int i = 0; i < 9; i++)
+			{
+				for (int channel = 0; channel < 3; channel++)
+					coefficients[i][channel] += rowProjection.Coefficients[i][channel];
+			}
+			weightSum += rowProjection.WeightSum;
+		}
+
+		// The solid angle weights only approximate the sphere, so normalize them to cover exactly 4pi
+		SHCoefficients result;
+		double normalization = weightSum > 0.0 ? (4.0 * glm::pi<double>()) / weightSum : 0.0;
+		for (int i = 0; i < 9; i++)
+		{
+			result.Coefficients[i] = glm::vec3(static_cast<float>(coefficients[i][0] * normalization), static_cast<float>(coefficients[i][1] * normalization), static_cast<float>(coefficients[i][2] * normalization));
+		}
+		return result;
+	}
+
+	SHCoefficients SphericalHarmonics::ConvolveWithCosineLobe(const SHCoefficients &radiance)
+	{
+		// Ramamoorthi and Hanrahan's cosine lobe band factors (pi, 2pi/3, pi/4) divided by pi, which is what the old irradiance convolution stored
+		const float bandFactors[3] = { 1.0f, 2.0f / 3.0f, 0.25f };
+
+		SHCoefficients irradiance;
+		irradiance.Coefficients[0] = radiance.Coefficients[0] * bandFactors[0];
+		for (int i = 1; i < 4; i++)
+			irradiance.Coefficients[i] = radiance.Coefficients[i] * bandFactors[1];
+		for (int i = 4; i < 9; i++)
+			irradiance.Coefficients[i] = radiance.Coefficients[i] * bandFactors[2];
+		return irradiance;
+	}
+
+	void SphericalHarmonics::ProjectRow(const float *rowData, unsigned int face, unsigned int row, unsigned int faceResolution, RowProjection &outProjection)
+	{
+		const CubemapFaceBasis &basis = s_CubemapFaceBases[face];
+		float texelSize = 2.0f / faceResolution;
+		float t = (row + 0.5f) * texelSize - 1.0f;
+
+		// Everything that only depends on the row is hoisted out of the loop, the direction is then rowBase + s * SAxis
+		const __m128 rowBaseX = _mm_set1_ps(basis.Base[0] + t * basis.TAxis[0]);
+		const __m128 rowBaseY = _mm_set1_ps(basis.Base[1] + t * basis.TAxis[1]);
+		const __m128 rowBaseZ = _mm_set1_ps(basis.Base[2] + t * basis.TAxis[2]);
+		const __m128 sAxisX = _mm_set1_ps(basis.SAxis[0]), sAxisY = _mm_set1_ps(basis.SAxis[1]), sAxisZ = _mm_set1_ps(basis.SAxis[2]);
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 texelArea = _mm_set1_ps(texelSize * texelSize);
+
+		__m128 accumulators[9][3];
+		for (int i = 0; i < 9; i++)
+		{
+			for (int channel = 0; channel < 3; channel++)
+				accumulators[i][channel] = _mm_setzero_ps();
+		}
+		__m128 weightAccumulator = _mm_setzero_ps();
+
+		for (unsigned int x = 0; x < faceResolution; x += 4)
+		{
+			// Load four RGBA texels and transpose them into a register per channel, texels past the end of the row (if the resolution isn't a multiple of four) get zero weight
+			alignas(16) float texels[4][4] = {};
+			alignas(16) float texelMask[4] = {};
+			alignas(16) float s[4] = {};
+			for (unsigned int lane = 0; lane < 4 && x + lane < faceResolution; lane++)
+			{
+				std::memcpy(texels[lane], rowData + (x + lane) * 4, sizeof(float) * 4);
+				texelMask[lane] = 1.0f;
+				s[lane] = (x + lane + 0.5f) * texelSize - 1.0f;
+			}
+			__m128 red = _mm_load_ps(texels[0]), green = _mm_load_ps(texels[1]), blue = _mm_load_ps(texels[2]), alpha = _mm_load_ps(texels[3]);
+			_MM_TRANSPOSE4_PS(red, green, blue, alpha);
+
+			// Direction to the texel (not normalized yet), length squared is 1 + s^2 + t^2 since the axes are orthonormal
+			__m128 sValues = _mm_load_ps(s);
+			__m128 dirX = _mm_add_ps(rowBaseX, _mm_mul_ps(sValues, sAxisX));
+			__m128 dirY = _mm_add_ps(rowBaseY, _mm_mul_ps(sValues, sAxisY));
+			__m128 dirZ = _mm_add_ps(rowBaseZ, _mm_mul_ps(sValues, sAxisZ));
+			__m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dirX, dirX), _mm_mul_ps(dirY, dirY)), _mm_mul_ps(dirZ, dirZ));
+			__m128 length = _mm_sqrt_ps(lengthSquared);
+			__m128 inverseLength = _mm_div_ps(one, length);
+			dirX = _mm_mul_ps(dirX, inverseLength);
+			dirY = _mm_mul_ps(dirY, inverseLength);
+			dirZ = _mm_mul_ps(dirZ, inverseLength);
+
+			// Solid angle subtended by the texel is roughly area / (1 + s^2 + t^2)^(3/2)
+			__m128 weight = _mm_mul_ps(_mm_div_ps(texelArea, _mm_mul_ps(lengthSquared, length)), _mm_load_ps(texelMask));
+			weightAccumulator = _mm_add_ps(weightAccumulator, weight);
+
+			// L2 real spherical harmonics basis
+			__m128 basisValues[9];
+			basisValues[0] = _mm_set1_ps(0.282095f);
+			basisValues[1] = _mm_mul_ps(_mm_set1_ps(0.488603f), dirY);
+			basisValues[2] = _mm_mul_ps(_mm_set1_ps(0.488603f), dirZ);
+			basisValues[3] = _mm_mul_ps(_mm_set1_ps(0.488603f), dirX);
+			basisValues[4] = _mm_mul_ps(_mm_set1_ps(1.092548f), _mm_mul_ps(dirX, dirY));
+			basisValues[5] = _mm_mul_ps(_mm_set1_ps(1.092548f), _mm_mul_ps(dirY, dirZ));
+			basisValues[6] = _mm_mul_ps(_mm_set1_ps(0.315392f), _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(3.0f), _mm_mul_ps(dirZ, dirZ)), one));
+			basisValues[7] = _mm_mul_ps(_mm_set1_ps(1.092548f), _mm_mul_ps(dirX, dirZ));
+			basisValues[8] = _mm_mul_ps(_mm_set1_ps(0.546274f), _mm_sub_ps(_mm_mul_ps(dirX, dirX), _mm_mul_ps(dirY, dirY)));
+
+			__m128 weightedRed = _mm_mul_ps(red, weight), weightedGreen = _mm_mul_ps(green, weight), weightedBlue = _mm_mul_ps(blue, weight);
+			for (int i = 0; i < 9; i++)
+			{
+				accumulators[i][0] = _mm_add_ps(accumulators[i][0], _mm_mul_ps(basisValues[i], weightedRed));
+				accumulators[i][1] = _mm_add_ps(accumulators[i][1], _mm_mul_ps(basisValues[i], weightedGreen));
+				accumulators[i][2] = _mm_add_ps(accumulators[i][2], _mm_mul_ps(basisValues[i], weightedBlue));
+			}
+		}
+
+		// Horizontal sums of the four lanes
+		auto horizontalSum = [](__m128 value)
+		{
+			alignas(16) float lanes[4];
+			_mm_store_ps(lanes, value);
+			return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		};
+		for (int i = 0; i < 9; i++)
+		{
+			for (int channel = 0; channel < 3; channel++)
+				outProjection.Coefficients[i][channel] = horizontalSum(accumulators[i][channel]);
+		}
+		outProjection.WeightSum = horizontalSum(weightAccumulator);
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+#ifndef SPHERICALHARMONICS_H
+#define SPHERICALHARMONICS_H
+
+namespace Arcane
+{
+	class Cubemap;
+
+	// Order 2 (L2) spherical harmonics, 9 RGB coefficients
+	struct SHCoefficients
+	{
+		glm::vec3 Coefficients[9];
+	};
+
+	// Projects captured cubemaps onto L2 spherical harmonics on the CPU. Rows of every face are spread across threads and each row is projected four texels at a time with SSE
+	class SphericalHarmonics
+	{
+	public:
+		// Reads the cubemap back and projects it, the result is already convolved with a cosine lobe (and divided by pi) so the shaders can evaluate it directly as diffuse irradiance
+		static SHCoefficients ProjectIrradiance(Cubemap *cubemap);
+
+		// faceData holds six faces of RGBA float texels in cubemap face order
+		static SHCoefficients ProjectRadiance(const float *faceData, unsigned int faceResolution);
+		static SHCoefficients ConvolveWithCosineLobe(const SHCoefficients &radiance);
+	private:
+		struct RowProjection
+		{
+			float Coefficients[9][3];
+			float WeightSum;
+		};
+
+		static void ProjectRow(const float *rowData, unsigned int face, unsigned int row, unsigned int faceResolution, RowProjection &outProjection);
+	};
+}
+#endif
@@ -14,24 +14,28 @@ namespace Arcane
 		shader->SetUniform(("dirLights[" + std::to_string(currentLightIndex) + "].lightColour").c_str(), lightComponent.LightColour);
 	}
 
-	void LightBindings::BindPointLight(const TransformComponent &transformComponent, const LightComponent &lightComponent, Shader *shader, int currentLightIndex)
+	GPUPointLight LightBindings::PackPointLight(const TransformComponent &transformComponent, const LightComponent &lightComponent)
 	{
-		ARC_ASSERT(currentLightIndex < MaxPointLights, "Exceeded Point Light Count");
-		shader->SetUniform(("pointLights[" + std::to_string(currentLightIndex) + "].position").c_str(), transformComponent.Translation);
-		shader->SetUniform(("pointLights[" + std::to_string(currentLightIndex) + "].intensity").c_str(), lightComponent.Intensity);
-		shader->SetUniform(("pointLights[" + std::to_string(currentLightIndex) + "].lightColour").c_str(), lightComponent.LightColour);
-		shader->SetUniform(("pointLights[" + std::to_string(currentLightIndex) + "].attenuationRadius").c_str(), lightComponent.AttenuationRange);
+		GPUPointLight pointLight = {};
+		pointLight.Position = transformComponent.Translation;
+		pointLight.AttenuationRadius = lightComponent.AttenuationRange;
+		pointLight.LightColour = lightComponent.LightColour;
+		pointLight.Intensity = lightComponent.Intensity;
+		pointLight.ShadowAtlasTileIndex = lightComponent.CastShadows ? lightComponent.ShadowAtlasTileIndex : -1;
+		return pointLight;
 	}
 
-	void LightBindings::BindSpotLight(const TransformComponent &transformComponent, const LightComponent &lightComponent, Shader *shader, int currentLightIndex)
+	GPUSpotLight LightBindings::PackSpotLight(const TransformComponent &transformComponent, const LightComponent &lightComponent)
 	{
-		ARC_ASSERT(currentLightIndex < MaxSpotLights, "Exceeded Spot Light Count");
-		shader->SetUniform(("spotLights[" + std::to_string(currentLightIndex) + "].position").c_str(), transformComponent.Translation);
-		shader->SetUniform(("spotLights[" + std::to_string(currentLightIndex) + "].direction").c_str(), transformComponent.GetForward());
-		shader->SetUniform(("spotLights[" + std::to_string(currentLightIndex) + "].intensity").c_str(), lightComponent.Intensity);
-		shader->SetUniform(("spotLights[" + std::to_string(currentLightIndex) + "].lightColour").c_str(), lightComponent.LightColour);
-		shader->SetUniform(("spotLights[" + std::to_string(currentLightIndex) + "].attenuationRadius").c_str(), lightComponent.AttenuationRange);
-		shader->SetUniform(("spotLights[" + std::to_string(currentLightIndex) + "].cutOff").c_str(), lightComponent.InnerCutOff);
-		shader->SetUniform(("spotLights[" + std::to_string(currentLightIndex) + "].outerCutOff").c_str(), lightComponent.OuterCutOff);
+		GPUSpotLight spotLight = {};
+		spotLight.Position = transformComponent.Translation;
+		spotLight.AttenuationRadius = lightComponent.AttenuationRange;
+		spotLight.Direction = transformComponent.GetForward();
+		spotLight.Intensity = lightComponent.Intensity;
+		spotLight.LightColour = lightComponent.LightColour;
+		spotLight.CutOff = lightComponent.InnerCutOff;
+		spotLight.OuterCutOff = lightComponent.OuterCutOff;
+		spotLight.ShadowAtlasTileIndex = lightComponent.CastShadows ? lightComponent.ShadowAtlasTileIndex : -1;
+		return spotLight;
 	}
 }
@@ -2,6 +2,10 @@
 #ifndef LIGHTBINDINGS_H
 #define LIGHTBINDINGS_H
 
+#ifndef LIGHTCLUSTERGRID_H
+#include <Arcane/Graphics/Lights/LightClusterGrid.h>
+#endif
+
 namespace Arcane
 {
 	class Shader;
@@ -12,12 +16,12 @@ namespace Arcane
 	{
 	public:
 		static void BindDirectionalLight(const TransformComponent &transformComponent, const LightComponent &lightComponent, Shader *shader, int currentLightIndex);
-		static void BindPointLight(const TransformComponent &transformComponent, const LightComponent &lightComponent, Shader *shader, int currentLightIndex);
-		static void BindSpotLight(const TransformComponent &transformComponent, const LightComponent &lightComponent, Shader *shader, int currentLightIndex);
+
+		// Point and spot lights are uploaded in SSBOs for clustered lighting so they aren't bound as uniforms and have no fixed limit
+		static GPUPointLight PackPointLight(const TransformComponent &transformComponent, const LightComponent &lightComponent);
+		static GPUSpotLight PackSpotLight(const TransformComponent &transformComponent, const LightComponent &lightComponent);
 
 		const static int MaxDirLights = 3;
-		const static int MaxPointLights = 6;
-		const static int MaxSpotLights = 6;
 	};
 }
 #endif
@@ -0,0 +1,310 @@
+#include "arcpch.h"
+#include "LightClusterGrid.h"
+
+#include <Arcane/Core/Threads/ParallelFor.h>
+#include <Arcane/Graphics/Shader.h>
+
+#include <xmmintrin.h>
+
+namespace Arcane
+{
+	static const unsigned int s_ClustersPerSlice = LIGHT_CLUSTER_GRID_X * LIGHT_CLUSTER_GRID_Y;
+	static const unsigned int s_ClusterCount = s_ClustersPerSlice * LIGHT_CLUSTER_GRID_Z;
+
+	LightClusterGrid::LightClusterGrid() : m_ClusterCount(s_ClusterCount), m_LightIndexCount(0), m_View(1.0f), m_CachedProjection(0.0f), m_CachedNearPlane(0.0f), m_CachedFarPlane(0.0f),
+		m_ClusterZParams(0.0f, 0.0f)
+	{
+		m_ClusterBounds.resize(s_ClusterCount);
+		m_SliceDepths.resize(LIGHT_CLUSTER_GRID_Z + 1);
+		m_SliceClusters.resize(LIGHT_CLUSTER_GRID_Z);
+		m_SliceLightIndices.resize(LIGHT_CLUSTER_GRID_Z);
+		m_Clusters.resize(s_ClusterCount, glm::uvec2(0, 0));
+
+		// Make sure every buffer has valid storage, even if a scene has no point or spot lights
+		m_PointLightBuffer.Allocate(sizeof(GPUPointLight));
+		m_SpotLightBuffer.Allocate(sizeof(GPUSpotLight));
+		m_ClusterBuffer.Allocate(sizeof(glm::uvec2) * s_ClusterCount);
+		m_LightIndexBuffer.Allocate(sizeof(unsigned int));
+		m_ClusterBuffer.Upload(&m_Clusters[0], sizeof(glm::uvec2) * s_ClusterCount);
+	}
+
+	LightClusterGrid::~LightClusterGrid() {}
+
+	void LightClusterGrid::Build(const glm::mat4 &view, const glm::mat4 &projection, float nearPlane, float farPlane, const std::vector<GPUPointLight> &pointLights, const std::vector<GPUSpotLight> &spotLights)
+	{
+		m_View = view;
+		if (projection != m_CachedProjection || nearPlane != m_CachedNearPlane || farPlane != m_CachedFarPlane)
+		{
+			BuildClusterBounds(projection, nearPlane, farPlane);
+		}
+
+		// Convert the lights to view space bounding spheres, and store their depth extents so each slice can quickly reject lights it can't overlap
+		m_PointLightSpheres.Clear();
+		m_PointLightMinDepth.clear();
+		m_PointLightMaxDepth.clear();
+		for (unsigned int i = 0; i < pointLights.size(); i++)
+		{
+			const GPUPointLight &light = pointLights[i];
+			glm::vec3 viewSpacePos = glm::vec3(view * glm::vec4(light.Position, 1.0f));
+
+			m_PointLightSpheres.Push(viewSpacePos, light.AttenuationRadius, i);
+			m_PointLightMinDepth.push_back(-viewSpacePos.z - light.AttenuationRadius);
+			m_PointLightMaxDepth.push_back(-viewSpacePos.z + light.AttenuationRadius);
+		}
+
+		std::vector<ViewSpaceCone> spotCones;
+		spotCones.reserve(spotLights.size());
+		m_SpotLightSpheres.Clear();
+		m_SpotLightMinDepth.clear();
+		m_SpotLightMaxDepth.clear();
+		for (unsigned int i = 0; i < spotLights.size(); i++)
+		{
+			const GPUSpotLight &light = spotLights[i];
+
+			ViewSpaceCone cone;
+			cone.Apex = glm::vec3(view * glm::vec4(light.Position, 1.0f));
+			cone.Direction = glm::normalize(glm::mat3(view) * light.Direction);
+			cone.Range = light.AttenuationRadius;
+			cone.CosAngle = glm::clamp(light.OuterCutOff, 0.0f, 1.0f);
+			cone.SinAngle = glm::sqrt(1.0f - cone.CosAngle * cone.CosAngle);
+			spotCones.push_back(cone);
+
+			// Tightest sphere that bounds the cone: for wide cones it is centered on the cone's cap, otherwise the sphere passes through the apex and the cap's rim
+			glm::vec3 center;
+			float radius;
+			if (cone.CosAngle < 0.70710678f)
+			{
+				center = cone.Apex + cone.Direction * (cone.CosAngle * cone.Range);
+				radius = cone.SinAngle * cone.Range;
+			}
+			else
+			{
+				float halfRangeOverCos = cone.Range / (2.0f * cone.CosAngle);
+				center = cone.Apex + cone.Direction * halfRangeOverCos;
+				radius = halfRangeOverCos;
+			}
+
+			m_SpotLightSpheres.Push(center, radius, i);
+			m_SpotLightMinDepth.push_back(-center.z - radius);
+			m_SpotLightMaxDepth.push_back(-center.z + radius);
+		}
+
+		// Every slice is independent so they can be culled in parallel, each one writes to its own output lists
+		ParallelFor(LIGHT_CLUSTER_GRID_Z, [this, &spotCones](unsigned int slice)
+		{
+			CullSlice(slice, spotCones);
+		});
+
+		// Flatten the per slice results into a single light index list
+		m_LightIndices.clear();
+		for (unsigned int slice = 0; slice < LIGHT_CLUSTER_GRID_Z; slice++)
+		{
+			unsigned int sliceOffset = static_cast<unsigned int>(m_LightIndices.size());
+			const std::vector<glm::uvec2> &sliceClusters = m_SliceClusters[slice];
+			for (unsigned int i = 0; i < s_ClustersPerSlice; i++)
+			{
+				m_Clusters[slice * s_ClustersPerSlice + i] = glm::uvec2(sliceClusters[i].x + sliceOffset, sliceClusters[i].y);
+			}
+
+			m_LightIndices.insert(m_LightIndices.end(), m_SliceLightIndices[slice].begin(), m_SliceLightIndices[slice].end());
+		}
+		m_LightIndexCount = static_cast<unsigned int>(m_LightIndices.size());
+
+		m_PointLightBuffer.Upload(pointLights.data(), sizeof(GPUPointLight) * pointLights.size());
+		m_SpotLightBuffer.Upload(spotLights.data(), sizeof(GPUSpotLight) * spotLights.size());
+		m_ClusterBuffer.Upload(&m_Clusters[0], sizeof(glm::uvec2) * m_Clusters.size());
+		m_LightIndexBuffer.Upload(m_LightIndices.data(), sizeof(unsigned int) * m_LightIndices.size());
+		m_LightIndexBuffer.Unbind();
+	}
+
+	void LightClusterGrid::Bind(Shader *shader)
+	{
+		m_PointLightBuffer.BindBase(PointLightBufferBinding);
+		m_SpotLightBuffer.BindBase(SpotLightBufferBinding);
+		m_ClusterBuffer.BindBase(ClusterBufferBinding);
+		m_LightIndexBuffer.BindBase(LightIndexBufferBinding);
+
+		shader->SetUniform("clusterGridSize", glm::ivec3(LIGHT_CLUSTER_GRID_X, LIGHT_CLUSTER_GRID_Y, LIGHT_CLUSTER_GRID_Z));
+		shader->SetUniform("clusterZParams", m_ClusterZParams);
+		shader->SetUniform("clusterView", m_View);
+		shader->SetUniform("clusterProjection", m_CachedProjection);
+	}
+
+	void LightClusterGrid::BuildClusterBounds(const glm::mat4 &projection, float nearPlane, float farPlane)
+	{
+		m_CachedProjection = projection;
+		m_CachedNearPlane = nearPlane;
+		m_CachedFarPlane = farPlane;
+
+		// Exponential slicing: depth(slice) = near * (far / near)^(slice / sliceCount)
+		float logFarOverNear = glm::log(farPlane / nearPlane);
+		for (unsigned int slice = 0; slice <= LIGHT_CLUSTER_GRID_Z; slice++)
+		{
+			m_SliceDepths[slice] = nearPlane * glm::pow(farPlane / nearPlane, static_cast<float>(slice) / LIGHT_CLUSTER_GRID_Z);
+		}
+		m_ClusterZParams.x = LIGHT_CLUSTER_GRID_Z / logFarOverNear;
+		m_ClusterZParams.y = (LIGHT_CLUSTER_GRID_Z * glm::log(nearPlane)) / logFarOverNear;
+
+		// Rays through the tile corners are found by unprojecting the corners onto the near plane, then the AABB is built from where the rays cross the slice's depth bounds
+		glm::mat4 inverseProjection = glm::inverse(projection);
+		auto unprojectToDepth = [&inverseProjection](glm::vec2 ndc, float depth) -> glm::vec3
+		{
+			glm::vec4 viewSpacePos = inverseProjection * glm::vec4(ndc, -1.0f, 1.0f);
+			glm::vec3 pointOnNear = glm::vec3(viewSpacePos) / viewSpacePos.w;
+			return pointOnNear * (depth / -pointOnNear.z);
+		};
+
+		for (unsigned int slice = 0; slice < LIGHT_CLUSTER_GRID_Z; slice++)
+		{
+			float sliceNear = m_SliceDepths[slice];
+			float sliceFar = m_SliceDepths[slice + 1];
+			for (unsigned int y = 0; y < LIGHT_CLUSTER_GRID_Y; y++)
+			{
+				for (unsigned int x = 0; x < LIGHT_CLUSTER_GRID_X; x++)
+				{
+					glm::vec2 ndcMin(-1.0f + (2.0f * x) / LIGHT_CLUSTER_GRID_X, -1.0f + (2.0f * y) / LIGHT_CLUSTER_GRID_Y);
+					glm::vec2 ndcMax(-1.0f + (2.0f * (x + 1)) / LIGHT_CLUSTER_GRID_X, -1.0f + (2.0f * (y + 1)) / LIGHT_CLUSTER_GRID_Y);
+
+					glm::vec3 minNear = unprojectToDepth(ndcMin, sliceNear);
+					glm::vec3 maxNear = unprojectToDepth(ndcMax, sliceNear);
+					glm::vec3 minFar = unprojectToDepth(ndcMin, sliceFar);
+					glm::vec3 maxFar = unprojectToDepth(ndcMax, sliceFar);
+
+					ClusterAABB &bounds = m_ClusterBounds[x + y * LIGHT_CLUSTER_GRID_X + slice * s_ClustersPerSlice];
+					bounds.Min = glm::vec4(glm::min(glm::min(minNear, maxNear), glm::min(minFar, maxFar)), 0.0f);
+					bounds.Max = glm::vec4(glm::max(glm::max(minNear, maxNear), glm::max(minFar, maxFar)), 0.0f);
+				}
+			}
+		}
+	}
+
+	void LightClusterGrid::CullSlice(unsigned int slice, const std::vector<ViewSpaceCone> &spotCones)
+	{
+		float sliceNear = m_SliceDepths[slice];
+		float sliceFar = m_SliceDepths[slice + 1];
+
+		LightSpheres slicePointLights, sliceSpotLights;
+		GatherSpheresInSlice(m_PointLightSpheres, m_PointLightMinDepth, m_PointLightMaxDepth, sliceNear, sliceFar, slicePointLights);
+		GatherSpheresInSlice(m_SpotLightSpheres, m_SpotLightMinDepth, m_SpotLightMaxDepth, sliceNear, sliceFar, sliceSpotLights);
+
+		std::vector<glm::uvec2> &sliceClusters = m_SliceClusters[slice];
+		std::vector<unsigned int> &sliceIndices = m_SliceLightIndices[slice];
+		sliceClusters.assign(s_ClustersPerSlice, glm::uvec2(0, 0));
+		sliceIndices.clear();
+
+		std::vector<unsigned int> pointIndices, spotIndices;
+		for (unsigned int i = 0; i < s_ClustersPerSlice; i++)
+		{
+			const ClusterAABB &bounds = m_ClusterBounds[slice * s_ClustersPerSlice + i];
+
+			pointIndices.clear();
+			spotIndices.clear();
+			CullSpheres(bounds, slicePointLights, pointIndices);
+			CullSpheres(bounds, sliceSpotLights, spotIndices);
+
+			// The bounding sphere of a spot light is loose, so refine the survivors with a cone test against the cluster's bounding sphere
+			glm::vec3 clusterCenter = glm::vec3(bounds.Min + bounds.Max) * 0.5f;
+			float clusterRadius = glm::length(glm::vec3(bounds.Max - bounds.Min)) * 0.5f;
+			spotIndices.erase(std::remove_if(spotIndices.begin(), spotIndices.end(), [&spotCones, &clusterCenter, clusterRadius](unsigned int spotIndex)
+			{
+				return !ConeIntersectsSphere(spotCones[spotIndex], clusterCenter, clusterRadius);
+			}), spotIndices.end());
+
+			unsigned int pointCount = std::min<unsigned int>(static_cast<unsigned int>(pointIndices.size()), LIGHT_CLUSTER_MAX_LIGHTS_PER_CLUSTER);
+			unsigned int spotCount = std::min<unsigned int>(static_cast<unsigned int>(spotIndices.size()), LIGHT_CLUSTER_MAX_LIGHTS_PER_CLUSTER - pointCount);
+
+			sliceClusters[i] = glm::uvec2(static_cast<unsigned int>(sliceIndices.size()), pointCount | (spotCount << 16));
+			sliceIndices.insert(sliceIndices.end(), pointIndices.begin(), pointIndices.begin() + pointCount);
+			sliceIndices.insert(sliceIndices.end(), spotIndices.begin(), spotIndices.begin() + spotCount);
+		}
+	}
+
+	void LightClusterGrid::GatherSpheresInSlice(const LightSpheres &allSpheres, const std::vector<float> &minDepth, const std::vector<float> &maxDepth, float sliceNear, float sliceFar, LightSpheres &outSpheres)
+	{
+		outSpheres.Clear();
+		for (unsigned int i = 0; i < minDepth.size(); i++)
+		{
+			if (minDepth[i] > sliceFar || maxDepth[i] < sliceNear)
+				continue;
+
+			outSpheres.X.push_back(allSpheres.X[i]);
+			outSpheres.Y.push_back(allSpheres.Y[i]);
+			outSpheres.Z.push_back(allSpheres.Z[i]);
+			outSpheres.Radius2.push_back(allSpheres.Radius2[i]);
+			outSpheres.LightIndex.push_back(allSpheres.LightIndex[i]);
+		}
+		outSpheres.Pad();
+	}
+
+	// Sphere vs AABB test for four lights at a time: squared distance from the sphere center to the box is compared against the squared radius
+	void LightClusterGrid::CullSpheres(const ClusterAABB &cluster, const LightSpheres &spheres, std::vector<unsigned int> &outIndices)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 minX = _mm_set1_ps(cluster.Min.x), minY = _mm_set1_ps(cluster.Min.y), minZ = _mm_set1_ps(cluster.Min.z);
+		const __m128 maxX = _mm_set1_ps(cluster.Max.x), maxY = _mm_set1_ps(cluster.Max.y), maxZ = _mm_set1_ps(cluster.Max.z);
+
+		for (size_t i = 0; i < spheres.X.size(); i += 4)
+		{
+			__m128 x = _mm_loadu_ps(&spheres.X[i]);
+			__m128 y = _mm_loadu_ps(&spheres.Y[i]);
+			__m128 z = _mm_loadu_ps(&spheres.Z[i]);
+			__m128 radius2 = _mm_loadu_ps(&spheres.Radius2[i]);
+
+			__m128 dx = _mm_max_ps(zero, _mm_max_ps(_mm_sub_ps(minX, x), _mm_sub_ps(x, maxX)));
+			__m128 dy = _mm_max_ps(zero, _mm_max_ps(_mm_sub_ps(minY, y), _mm_sub_ps(y, maxY)));
+			__m128 dz = _mm_max_ps(zero, _mm_max_ps(_mm_sub_ps(minZ, z), _mm_sub_ps(z, maxZ)));
+			__m128 distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+			int overlapMask = _mm_movemask_ps(_mm_cmple_ps(distance2, radius2));
+			while (overlapMask)
+			{
+				int lane = 0;
+				while (!(overlapMask & (1 << lane)))
+					lane++;
+				overlapMask &= ~(1 << lane);
+
+				outIndices.push_back(spheres.LightIndex[i + lane]);
+			}
+		}
+	}
+
+	bool LightClusterGrid::ConeIntersectsSphere(const ViewSpaceCone &cone, const glm::vec3 &sphereCenter, float sphereRadius)
+	{
+		glm::vec3 apexToCenter = sphereCenter - cone.Apex;
+		float apexToCenterLength2 = glm::dot(apexToCenter, apexToCenter);
+		float distanceAlongAxis = glm::dot(apexToCenter, cone.Direction);
+		float distanceToConeEdge = cone.CosAngle * glm::sqrt(glm::max(apexToCenterLength2 - distanceAlongAxis * distanceAlongAxis, 0.0f)) - distanceAlongAxis * cone.SinAngle;
+
+		bool outsideAngle = distanceToConeEdge > sphereRadius;
+		bool inFront = distanceAlongAxis > sphereRadius + cone.Range;
+		bool behind = distanceAlongAxis < -sphereRadius;
+		return !(outsideAngle || inFront || behind);
+	}
+
+	void LightClusterGrid::LightSpheres::Clear()
+	{
+		X.clear();
+		Y.clear();
+		Z.clear();
+		Radius2.clear();
+		LightIndex.clear();
+	}
+
+	void LightClusterGrid::LightSpheres::Push(const glm::vec3 &center, float radius, unsigned int lightIndex)
+	{
+		X.push_back(center.x);
+		Y.push_back(center.y);
+		Z.push_back(center.z);
+		Radius2.push_back(radius * radius);
+		LightIndex.push_back(lightIndex);
+	}
+
+	void LightClusterGrid::LightSpheres::Pad()
+	{
+		while (X.size() % 4 != 0)
+		{
+			Push(glm::vec3(0.0f), 0.0f, 0);
+			Radius2.back() = -1.0f; // A squared distance can never be less than or equal to a negative radius
+		}
+	}
+}
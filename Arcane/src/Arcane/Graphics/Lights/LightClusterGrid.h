@@ -0,0 +1,114 @@
+#pragma once
+#ifndef LIGHTCLUSTERGRID_H
+#define LIGHTCLUSTERGRID_H
+
+#ifndef SHADERSTORAGEBUFFER_H
+#include <Arcane/Platform/OpenGL/ShaderStorageBuffer.h>
+#endif
+
+namespace Arcane
+{
+	class Shader;
+
+	// GPU representations of the lights, these must match the std430 layout of the structs in the lighting shaders
+	struct GPUPointLight
+	{
+		glm::vec3 Position;
+		float AttenuationRadius;
+		glm::vec3 LightColour;
+		float Intensity;
+		int ShadowAtlasTileIndex; // First of the six cube face tiles in the shadow atlas, -1 if the light has no shadows
+		float Padding[3];
+	};
+
+	struct GPUSpotLight
+	{
+		glm::vec3 Position;
+		float AttenuationRadius;
+		glm::vec3 Direction;
+		float Intensity;
+		glm::vec3 LightColour;
+		float CutOff;
+		float OuterCutOff;
+		int ShadowAtlasTileIndex; // -1 if the light has no shadows
+		float Padding[2];
+	};
+
+	// Froxel grid (view frustum split into screen tiles and exponential depth slices) that is rebuilt on the CPU every time lights or the camera change.
+	// Each cluster stores an offset into a shared light index list followed by the amount of point lights and spot lights that overlap the cluster.
+	// So the lighting shaders only iterate the lights that can actually affect a fragment instead of every light in the scene
+	class LightClusterGrid
+	{
+	public:
+		LightClusterGrid();
+		~LightClusterGrid();
+
+		void Build(const glm::mat4 &view, const glm::mat4 &projection, float nearPlane, float farPlane, const std::vector<GPUPointLight> &pointLights, const std::vector<GPUSpotLight> &spotLights);
+		void Bind(Shader *shader);
+
+		inline unsigned int GetClusterCount() const { return m_ClusterCount; }
+		inline unsigned int GetLightIndexCount() const { return m_LightIndexCount; }
+
+		// SSBO binding points used by the lighting shaders
+		static const unsigned int PointLightBufferBinding = 0;
+		static const unsigned int SpotLightBufferBinding = 1;
+		static const unsigned int ClusterBufferBinding = 2;
+		static const unsigned int LightIndexBufferBinding = 3;
+	private:
+		struct ClusterAABB
+		{
+			glm::vec4 Min;
+			glm::vec4 Max;
+		};
+
+		// Structure of arrays for the view space light bounding spheres so four lights can be tested against a cluster at once
+		struct LightSpheres
+		{
+			std::vector<float> X, Y, Z, Radius2;
+			std::vector<unsigned int> LightIndex;
+
+			void Clear();
+			void Push(const glm::vec3 &center, float radius, unsigned int lightIndex);
+			void Pad(); // Pads to a multiple of four with spheres that never pass the overlap test
+		};
+
+		// Spot light cones stored in view space (used to refine the bounding sphere test)
+		struct ViewSpaceCone
+		{
+			glm::vec3 Apex;
+			glm::vec3 Direction;
+			float Range;
+			float CosAngle, SinAngle;
+		};
+
+		void BuildClusterBounds(const glm::mat4 &projection, float nearPlane, float farPlane);
+		void CullSlice(unsigned int slice, const std::vector<ViewSpaceCone> &spotCones);
+
+		static void GatherSpheresInSlice(const LightSpheres &allSpheres, const std::vector<float> &minDepth, const std::vector<float> &maxDepth, float sliceNear, float sliceFar, LightSpheres &outSpheres);
+		static void CullSpheres(const ClusterAABB &cluster, const LightSpheres &spheres, std::vector<unsigned int> &outIndices);
+		static bool ConeIntersectsSphere(const ViewSpaceCone &cone, const glm::vec3 &sphereCenter, float sphereRadius);
+	private:
+		unsigned int m_ClusterCount;
+		unsigned int m_LightIndexCount;
+
+		// Cluster bounds are only recalculated when the projection changes
+		glm::mat4 m_View;
+		glm::mat4 m_CachedProjection;
+		float m_CachedNearPlane, m_CachedFarPlane;
+		std::vector<ClusterAABB> m_ClusterBounds;
+		std::vector<float> m_SliceDepths; // View space depth (positive) of every slice boundary
+
+		// Per frame data
+		LightSpheres m_PointLightSpheres, m_SpotLightSpheres;
+		std::vector<float> m_PointLightMinDepth, m_PointLightMaxDepth, m_SpotLightMinDepth, m_SpotLightMaxDepth;
+		std::vector<std::vector<glm::uvec2>> m_SliceClusters;
+		std::vector<std::vector<unsigned int>> m_SliceLightIndices;
+		std::vector<glm::uvec2> m_Clusters;
+		std::vector<unsigned int> m_LightIndices;
+
+		glm::vec2 m_ClusterZParams; // Scale and bias used by the shaders to turn a view space depth into a slice
+
+		ShaderStorageBuffer m_PointLightBuffer, m_SpotLightBuffer, m_ClusterBuffer, m_LightIndexBuffer;
+	};
+}
+#endif
@@ -1,47 +1,42 @@
 #include "arcpch.h"
 #include "LightManager.h"
 
+#include <Arcane/Graphics/Camera/CubemapCamera.h>
+#include <Arcane/Graphics/Camera/ICamera.h>
 #include <Arcane/Graphics/Lights/LightBindings.h>
 #include <Arcane/Graphics/Shader.h>
-#include <Arcane/Graphics/Texture/Cubemap.h>
+#include <Arcane/Graphics/Renderer/RenderTargetPool.h>
 #include <Arcane/Scene/Components.h>
 #include <Arcane/Scene/Scene.h>
+#include <Arcane/Util/Loaders/AssetManager.h>
 
 namespace Arcane
 {
-	LightManager::LightManager(Scene *scene) : m_Scene(scene), m_DirectionalLightShadowFramebuffer(nullptr), m_SpotLightShadowFramebuffer(nullptr), m_PointLightShadowCubemap(nullptr),
-		m_ClosestDirectionalLightShadowCaster(nullptr), m_ClosestSpotLightShadowCaster(nullptr), m_ClosestPointLightShadowCaster(nullptr)
+	LightManager::LightManager(Scene *scene) : m_Scene(scene), m_ClosestDirectionalLightShadowCaster(nullptr), m_DirectionalLightShadowFramebuffer(nullptr), m_DirectionalLightStaticShadowFramebuffer(nullptr),
+		m_ShadowAtlas(SHADOW_ATLAS_RESOLUTION, SHADOW_ATLAS_MIN_TILE_RESOLUTION)
 	{
-
+		for (auto &entry : m_StaticCascadeCache)
+		{
+			entry.Valid = false;
+		}
 	}
 
 	LightManager::~LightManager()
 	{
-		delete m_DirectionalLightShadowFramebuffer;
-		delete m_SpotLightShadowFramebuffer;
-		delete m_PointLightShadowCubemap;
+		RenderTargetPool::Release(m_DirectionalLightShadowFramebuffer);
+		RenderTargetPool::Release(m_DirectionalLightStaticShadowFramebuffer);
 	}
 
 	void LightManager::Init()
 	{
+		UpdateStaticShadowCasterHash();
 		FindClosestDirectionalLightShadowCaster();
-		FindClosestSpotLightShadowCaster();
-		FindClosestPointLightShadowCaster();
+		UpdateShadowAtlas();
 
 		// Default framebuffers if a shadow isn't found. Hopefully save an allocation when we find one
 		if (!m_DirectionalLightShadowFramebuffer)
 		{
-			m_DirectionalLightShadowFramebuffer = new Framebuffer(SHADOWMAP_RESOLUTION_X_DEFAULT, SHADOWMAP_RESOLUTION_Y_DEFAULT, false);
-			m_DirectionalLightShadowFramebuffer->AddDepthStencilTexture(NormalizedDepthOnly, true).CreateFramebuffer();
-		}
-		if (!m_SpotLightShadowFramebuffer)
-		{
-			m_SpotLightShadowFramebuffer = new Framebuffer(SHADOWMAP_RESOLUTION_X_DEFAULT, SHADOWMAP_RESOLUTION_Y_DEFAULT, false);
-			m_SpotLightShadowFramebuffer->AddDepthStencilTexture(NormalizedDepthOnly, true).CreateFramebuffer();
-		}
-		if (!m_PointLightShadowCubemap)
-		{
-			ReallocateDepthCubemap(&m_PointLightShadowCubemap, glm::uvec2(SHADOWMAP_RESOLUTION_X_DEFAULT, SHADOWMAP_RESOLUTION_Y_DEFAULT));
+			ReallocateDirectionalShadowTargets(glm::uvec2(SHADOWMAP_RESOLUTION_X_DEFAULT, SHADOWMAP_RESOLUTION_Y_DEFAULT));
 		}
 	}
 
@@ -50,12 +45,13 @@ namespace Arcane
 	{
 		// Reset our pointers since it is possible no shadow caster exists anymore
 		m_ClosestDirectionalLightShadowCaster = nullptr;
-		m_ClosestSpotLightShadowCaster = nullptr;
-		m_ClosestPointLightShadowCaster = nullptr;
 		
+		UpdateStaticShadowCasterHash();
 		FindClosestDirectionalLightShadowCaster();
-		FindClosestSpotLightShadowCaster();
-		FindClosestPointLightShadowCaster();
+		UpdateShadowAtlas();
+
+		// Lights could have been moved or edited so every cached view's clusters need to be rebuilt before they are used
+		m_LightGeneration++;
 	}
 
 	// TODO: Should use camera component's position
@@ -96,138 +92,216 @@ namespace Arcane
 			glm::uvec2 requiredShadowResolution = GetShadowQualityResolution(m_ClosestDirectionalLightShadowCaster->ShadowResolution);
 			if (!m_DirectionalLightShadowFramebuffer || m_DirectionalLightShadowFramebuffer->GetWidth() != requiredShadowResolution.x || m_DirectionalLightShadowFramebuffer->GetHeight() != requiredShadowResolution.y)
 			{
-				ReallocateDepthTarget(&m_DirectionalLightShadowFramebuffer, requiredShadowResolution);
+				ReallocateDirectionalShadowTargets(requiredShadowResolution);
 			}
 		}
 	}
 
-	// TODO: Should use camera component's position
-	void LightManager::FindClosestSpotLightShadowCaster()
+	void LightManager::UpdateShadowAtlas()
 	{
-		float closestDistance2 = std::numeric_limits<float>::max();
-		int currentSpotLightIndex = -1;
-
-		// Prioritize the closest spot light to the camera as our spotlight shadow caster
+		struct ShadowAtlasRequest
+		{
+			LightComponent *Light;
+			TransformComponent *Transform;
+			unsigned int RequestHandle;
+		};
+		std::vector<ShadowAtlasRequest> requests;
+
+		// Request tiles for every spot and point shadow caster. Importance is based on roughly how much of the screen the light's influence covers,
+		// and the light's shadow quality is scaled down by it so far away lights don't eat up the atlas
+		m_ShadowAtlas.ClearRequests();
+		glm::vec3 cameraPosition = m_Scene->GetCamera()->GetPosition();
 		auto group = m_Scene->m_Registry.group<LightComponent>(entt::get<TransformComponent>);
 		for (auto entity : group)
 		{
 			auto&[transformComponent, lightComponent] = group.get<TransformComponent, LightComponent>(entity);
+			lightComponent.ShadowAtlasTileIndex = -1;
 
-			if (lightComponent.Type != LightType::LightType_Spot)
+			if (lightComponent.Type == LightType::LightType_Directional || !lightComponent.CastShadows)
 				continue;
 
-			currentSpotLightIndex++;
+			float distance = glm::distance(cameraPosition, transformComponent.Translation);
+			float screenCoverage = distance > lightComponent.AttenuationRange ? lightComponent.AttenuationRange / distance : 1.0f;
+			float resolutionScale = glm::max(screenCoverage, 0.125f);
 
-			if (!lightComponent.CastShadows)
+			unsigned int desiredResolution = static_cast<unsigned int>(GetShadowQualityResolution(lightComponent.ShadowResolution).x * resolutionScale);
+			unsigned int tileCount = lightComponent.Type == LightType::LightType_Point ? 6 : 1;
+			requests.push_back({ &lightComponent, &transformComponent, m_ShadowAtlas.AddRequest(screenCoverage, desiredResolution, tileCount) });
+		}
+		m_ShadowAtlas.Allocate();
+
+		// Now that every light has it's tiles, setup the matrices that are used to render and sample each tile
+		m_ShadowAtlasCasters.clear();
+		m_ShadowAtlasTiles.clear();
+		CubemapCamera cubemapCamera;
+		for (auto &request : requests)
+		{
+			LightComponent &lightComponent = *request.Light;
+			TransformComponent &transformComponent = *request.Transform;
+
+			glm::uvec4 viewport;
+			if (!m_ShadowAtlas.GetAllocation(request.RequestHandle, 0, viewport))
 				continue;
+			lightComponent.ShadowAtlasTileIndex = static_cast<int>(m_ShadowAtlasTiles.size());
 
-			float currentDistance2 = glm::distance2(m_Scene->GetCamera()->GetPosition(), transformComponent.Translation);
-			if (currentDistance2 < closestDistance2)
+			ShadowAtlasCaster caster;
+			caster.LightPosition = transformComponent.Translation;
+			caster.FarPlane = lightComponent.ShadowFarPlane;
+
+			GPUShadowAtlasTile tile = {};
+			tile.ShadowBias = lightComponent.ShadowBias;
+			tile.FarPlane = lightComponent.ShadowFarPlane;
+
+			if (lightComponent.Type == LightType::LightType_Spot)
 			{
-				closestDistance2 = currentDistance2;
-				m_ClosestSpotLightShadowCaster = &lightComponent;
-				m_ClosestSpotLightShadowCasterTransform = &transformComponent;
-				m_ClosestSpotLightIndex = currentSpotLightIndex;
+				float radius = lightComponent.AttenuationRange * glm::tan(glm::acos(lightComponent.OuterCutOff)); // Need to get spotlight's radius given it's range and angle so we can use it for the projection bounds
+				glm::mat4 spotLightProjection = glm::ortho(-radius, radius, -radius, radius, lightComponent.ShadowNearPlane, lightComponent.ShadowFarPlane);
+				glm::mat4 spotLightView = glm::lookAt(transformComponent.Translation, transformComponent.Translation + transformComponent.GetForward(), glm::vec3(0.0f, 1.0f, 0.0f));
+
+				caster.LightSpaceViewProjectionMatrix = spotLightProjection * spotLightView;
+				caster.Viewport = viewport;
+				caster.LinearDepth = false;
+				m_ShadowAtlasCasters.push_back(caster);
+
+				tile.LightSpaceViewProjectionMatrix = caster.LightSpaceViewProjectionMatrix;
+				tile.AtlasScaleBias = m_ShadowAtlas.GetAtlasScaleBias(viewport);
+				m_ShadowAtlasTiles.push_back(tile);
 			}
-		}
-
-		if (m_ClosestSpotLightShadowCaster)
-		{
-			// TODO:
-			// Ideally we won't be re-allocating everytime we encounter a different sized shadow map. This NEEDS to be solved if we ever allow multiple spot light shadow casters
-			// Just allocate the biggest and only render to a portion with glViewPort, and make sure when we sample the shadowmap we account for the smaller size as well
-			glm::uvec2 requiredShadowResolution = GetShadowQualityResolution(m_ClosestSpotLightShadowCaster->ShadowResolution);
-			if (!m_SpotLightShadowFramebuffer || m_SpotLightShadowFramebuffer->GetWidth() != requiredShadowResolution.x || m_SpotLightShadowFramebuffer->GetHeight() != requiredShadowResolution.y)
+			else
 			{
-				ReallocateDepthTarget(&m_SpotLightShadowFramebuffer, requiredShadowResolution);
+				// Point lights get six consecutive tiles in the same order as the cubemap faces
+				cubemapCamera.SetPosition(transformComponent.Translation);
+				cubemapCamera.SetNearFarPlane(lightComponent.ShadowNearPlane, lightComponent.ShadowFarPlane);
+				glm::mat4 pointLightProjection = cubemapCamera.GetProjectionMatrix();
+				for (unsigned int face = 0; face < 6; face++)
+				{
+					m_ShadowAtlas.GetAllocation(request.RequestHandle, face, viewport);
+					cubemapCamera.SwitchCameraToFace(face);
+
+					caster.LightSpaceViewProjectionMatrix = pointLightProjection * cubemapCamera.GetViewMatrix();
+					caster.Viewport = viewport;
+					caster.LinearDepth = true;
+					m_ShadowAtlasCasters.push_back(caster);
+
+					tile.LightSpaceViewProjectionMatrix = caster.LightSpaceViewProjectionMatrix;
+					tile.AtlasScaleBias = m_ShadowAtlas.GetAtlasScaleBias(viewport);
+					m_ShadowAtlasTiles.push_back(tile);
+				}
 			}
 		}
+
+		m_ShadowAtlas.UploadTiles(m_ShadowAtlasTiles);
 	}
 
-	// TODO: Should use camera component's position
-	void LightManager::FindClosestPointLightShadowCaster()
+	void LightManager::UpdateStaticShadowCasterHash()
 	{
-		float closestDistance2 = std::numeric_limits<float>::max();
-		int currentPointLightIndex = -1;
+		// Static casters shouldn't change often, so hashing their transforms every update is much cheaper than re-rendering them into every shadowmap
+		std::size_t hash = 0;
+		auto hashCombine = [&hash](std::size_t value)
+		{
+			hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		};
 
-		// Prioritize the closest point light to the camera as our pointlight shadow caster
-		auto group = m_Scene->m_Registry.group<LightComponent>(entt::get<TransformComponent>);
+		auto group = m_Scene->m_Registry.group<TransformComponent, MeshComponent>();
 		for (auto entity : group)
 		{
-			auto& [transformComponent, lightComponent] = group.get<TransformComponent, LightComponent>(entity);
-
-			if (lightComponent.Type != LightType::LightType_Point)
-				continue;
-
-			currentPointLightIndex++;
-
-			if (!lightComponent.CastShadows)
+			auto&[transformComponent, meshComponent] = group.get<TransformComponent, MeshComponent>(entity);
+			if (!meshComponent.IsStatic)
 				continue;
 
-			float currentDistance2 = glm::distance2(m_Scene->GetCamera()->GetPosition(), transformComponent.Translation);
-			if (currentDistance2 < closestDistance2)
+			hashCombine(std::hash<Model*>()(meshComponent.AssetModel));
+			hashCombine(std::hash<bool>()(meshComponent.ShouldBackfaceCull));
+			glm::mat4 transform = transformComponent.GetTransform();
+			for (int i = 0; i < 16; i++)
 			{
-				closestDistance2 = currentDistance2;
-				m_ClosestPointLightShadowCaster = &lightComponent;
-				m_ClosestPointLightShadowCasterTranform = &transformComponent;
-				m_ClosestPointLightIndex = currentPointLightIndex;
+				hashCombine(std::hash<float>()(glm::value_ptr(transform)[i]));
 			}
 		}
 
-		if (m_ClosestPointLightShadowCaster)
+		// Models that are still streaming in can't be cached yet, so keep re-rendering the static casters until loading finishes
+		if (AssetManager::GetInstance().AssetsInFlight())
 		{
-			// TODO:
-			// Ideally we won't be re-allocating everytime we encounter a different sized shadow map. This NEEDS to be solved if we ever allow multiple point light shadow casters
-			glm::uvec2 requiredShadowResolution = GetShadowQualityResolution(m_ClosestPointLightShadowCaster->ShadowResolution);
-			if (!m_PointLightShadowCubemap || m_PointLightShadowCubemap->GetFaceWidth() != requiredShadowResolution.x || m_PointLightShadowCubemap->GetFaceHeight() != requiredShadowResolution.y)
-			{
-				ReallocateDepthCubemap(&m_PointLightShadowCubemap, requiredShadowResolution);
-			}
+			hashCombine(++m_StaticShadowCasterLoadingUpdates);
 		}
+
+		m_StaticShadowCasterHash = hash;
 	}
 
-	void LightManager::ReallocateDepthTarget(Framebuffer **framebuffer, glm::uvec2 newResolution)
+	bool LightManager::RequiresStaticCascadeRender(int cascade, const glm::vec2 &lightSpaceOrigin, float texelSize, glm::mat4 &lightSpaceViewProjectionMatrix)
 	{
-		if (*framebuffer) // TODO: Can this ever be garbage data or nullptr? If it is just a nullptr this isn't needed. Ehh this function is temporary until this is improved anyways
+		StaticCascadeCacheEntry &entry = m_StaticCascadeCache[cascade];
+		glm::vec3 lightDir = GetDirectionalLightShadowCasterLightDir();
+		glm::vec2 lightNearFarPlane = GetDirectionalLightShadowCasterNearFarPlane();
+
+		// The origin is snapped to the texel grid so it only ever moves in whole texels, anything under half a texel is floating point error from the camera's matrices
+		if (entry.Valid && entry.StaticCasterHash == m_StaticShadowCasterHash && entry.TexelSize == texelSize && entry.LightNearFarPlane == lightNearFarPlane)
 		{
-			delete *framebuffer;
+			bool sameTexel = glm::all(glm::lessThan(glm::abs(lightSpaceOrigin - entry.LightSpaceOrigin), glm::vec2(texelSize * 0.5f)));
+			bool sameLightDir = glm::dot(lightDir, entry.LightDir) > 0.999999f;
+			if (sameTexel && sameLightDir)
+			{
+				lightSpaceViewProjectionMatrix = entry.LightSpaceViewProjectionMatrix;
+				return false;
+			}
 		}
 
-		*framebuffer = new Framebuffer(newResolution.x, newResolution.y, false);
-		(*framebuffer)->AddDepthStencilTexture(NormalizedDepthOnly, true).CreateFramebuffer();
+		entry.LightSpaceViewProjectionMatrix = lightSpaceViewProjectionMatrix;
+		entry.LightSpaceOrigin = lightSpaceOrigin;
+		entry.TexelSize = texelSize;
+		entry.LightDir = lightDir;
+		entry.LightNearFarPlane = lightNearFarPlane;
+		entry.StaticCasterHash = m_StaticShadowCasterHash;
+		entry.Valid = true;
+		return true;
 	}
 
-	void LightManager::ReallocateDepthCubemap(Cubemap** cubemap, glm::uvec2 newResolution)
+	void LightManager::ReallocateDirectionalShadowTargets(glm::uvec2 newResolution)
 	{
-		if (*cubemap) // TODO: Can this ever be garbage data or nullptr? If it is just a nullptr this isn't needed. Ehh this function is temporary until this is improved anyways
+		// The old targets stay in the pool for a while, so switching back to the previous quality doesn't allocate anything
+		RenderTargetPool::Release(m_DirectionalLightShadowFramebuffer);
+		RenderTargetPool::Release(m_DirectionalLightStaticShadowFramebuffer);
+
+		// Layer per shadow cascade
+		RenderTargetDesc desc;
+		desc.Width = newResolution.x;
+		desc.Height = newResolution.y;
+		desc.DepthType = RenderTargetDepthType::RenderTargetDepthType_TextureArray;
+		desc.DepthFormat = NormalizedDepthOnly;
+		desc.DepthLayerCount = SHADOW_CASCADE_COUNT;
+		desc.DepthBilinearFiltering = true;
+		m_DirectionalLightShadowFramebuffer = RenderTargetPool::Acquire(desc);
+		desc.DepthBilinearFiltering = false;
+		m_DirectionalLightStaticShadowFramebuffer = RenderTargetPool::Acquire(desc);
+
+		for (auto &entry : m_StaticCascadeCache)
 		{
-			delete *cubemap;
-		}
-
-		CubemapSettings depthCubemapSettings;
-		depthCubemapSettings.TextureFormat = GL_DEPTH_COMPONENT;
-		depthCubemapSettings.TextureMinificationFilterMode = GL_LINEAR;
-		depthCubemapSettings.TextureMagnificationFilterMode = GL_LINEAR;
-		*cubemap = new Cubemap(depthCubemapSettings);
-		for (int i = 0; i < 6; i++)
-		{
-			(*cubemap)->GenerateCubemapFace(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, newResolution.x, newResolution.y, GL_DEPTH_COMPONENT, nullptr);
+			entry.Valid = false;
 		}
 	}
 
-	void LightManager::BindLightingUniforms(Shader *shader)
+	void LightManager::BindLightingUniforms(Shader *shader, ICamera *camera)
 	{
-		BindLights(shader, false);
+		BindLights(shader, camera, false);
 	}
 
-	void LightManager::BindStaticLightingUniforms(Shader *shader)
+	void LightManager::BindStaticLightingUniforms(Shader *shader, ICamera *camera)
 	{
-		BindLights(shader, true);
+		BindLights(shader, camera, true);
 	}
 
-	void LightManager::BindLights(Shader *shader, bool bindOnlyStatic)
+	void LightManager::BindLights(Shader *shader, ICamera *camera, bool bindOnlyStatic)
 	{
-		int numDirLights = 0, numPointLights = 0, numSpotLights = 0;
+		glm::mat4 view = camera->GetViewMatrix();
+		glm::mat4 projection = camera->GetProjectionMatrix();
+		LightClusterCacheEntry *clusters = FindLightClusters(view, projection, bindOnlyStatic);
+		bool rebuildClusters = clusters->LightGeneration != m_LightGeneration;
+
+		int numDirLights = 0;
+		if (rebuildClusters)
+		{
+			clusters->PointLights.clear();
+			clusters->SpotLights.clear();
+		}
 
 		auto group = m_Scene->m_Registry.group<LightComponent>(entt::get<TransformComponent>);
 		for (auto entity : group)
@@ -244,20 +318,107 @@ namespace Arcane
 				LightBindings::BindDirectionalLight(transformComponent, lightComponent, shader, numDirLights++);
 				break;
 			case LightType::LightType_Point:
-				ARC_ASSERT(numPointLights < LightBindings::MaxPointLights, "Point light limit hit");
-				LightBindings::BindPointLight(transformComponent, lightComponent, shader, numPointLights++);
+				if (rebuildClusters)
+					clusters->PointLights.push_back(LightBindings::PackPointLight(transformComponent, lightComponent));
 				break;
 			case LightType::LightType_Spot:
-				ARC_ASSERT(numSpotLights < LightBindings::MaxSpotLights, "Spot light limit hit");
-				LightBindings::BindSpotLight(transformComponent, lightComponent, shader, numSpotLights++);
+				if (rebuildClusters)
+					clusters->SpotLights.push_back(LightBindings::PackSpotLight(transformComponent, lightComponent));
 				break;
 			}
 		}
 
+		if (rebuildClusters)
+		{
+			clusters->Grid.Build(view, projection, camera->GetNearPlane(), camera->GetFarPlane(), clusters->PointLights, clusters->SpotLights);
+			clusters->LightGeneration = m_LightGeneration;
+		}
+		clusters->Grid.Bind(shader);
+
 		numDirLights = std::min<int>(numDirLights, LightBindings::MaxDirLights);
-		numPointLights = std::min<int>(numPointLights, LightBindings::MaxPointLights);
-		numSpotLights = std::min<int>(numSpotLights, LightBindings::MaxSpotLights);
-		shader->SetUniform("numDirPointSpotLights", glm::ivec4(numDirLights, numPointLights, numSpotLights, 0));
+		shader->SetUniform("numDirPointSpotLights", glm::ivec4(numDirLights, static_cast<int>(clusters->PointLights.size()), static_cast<int>(clusters->SpotLights.size()), 0));
+	}
+
+	// Returns the entry already built for this view, otherwise the least recently used entry is handed over to it (and will be rebuilt)
+	LightManager::LightClusterCacheEntry* LightManager::FindLightClusters(const glm::mat4 &view, const glm::mat4 &projection, bool onlyStatic)
+	{
+		LightClusterCacheEntry *result = nullptr;
+		for (LightClusterCacheEntry &entry : m_LightClusterCache)
+		{
+			if (entry.LightGeneration != 0 && entry.OnlyStatic == onlyStatic && entry.View == view && entry.Projection == projection)
+			{
+				result = &entry;
+				break;
+			}
+		}
+
+		if (!result)
+		{
+			result = &m_LightClusterCache[0];
+			for (LightClusterCacheEntry &entry : m_LightClusterCache)
+			{
+				if (entry.LastUsed < result->LastUsed)
+					result = &entry;
+			}
+
+			result->View = view;
+			result->Projection = projection;
+			result->OnlyStatic = onlyStatic;
+			result->LightGeneration = 0;
+		}
+
+		result->LastUsed = ++m_LightClusterUseCounter;
+		return result;
+	}
+
+	void LightManager::EstimateIncidentLight(const glm::vec3 &position, float radius, bool onlyStatic, glm::vec3 &outRadiance, glm::vec3 &outDirection)
+	{
+		outRadiance = glm::vec3(0.0f);
+		outDirection = glm::vec3(0.0f);
+		float luminanceSum = 0.0f;
+
+		auto group = m_Scene->m_Registry.group<LightComponent>(entt::get<TransformComponent>);
+		for (auto entity : group)
+		{
+			auto&[transformComponent, lightComponent] = group.get<TransformComponent, LightComponent>(entity);
+
+			if (onlyStatic && !lightComponent.IsStatic)
+				continue;
+
+			glm::vec3 radiance = lightComponent.LightColour * lightComponent.Intensity;
+			glm::vec3 directionToLight;
+			if (lightComponent.Type == LightType::LightType_Directional)
+			{
+				directionToLight = -transformComponent.GetForward();
+			}
+			else
+			{
+				// Fade the light out by it's distance to the centre of the sphere, it is ignored once it can't reach any part of the sphere
+				glm::vec3 toLight = transformComponent.Translation - position;
+				float distance = glm::length(toLight);
+				float reach = lightComponent.AttenuationRange + radius;
+				if (distance >= reach)
+					continue;
+
+				float falloff = 1.0f - (distance / reach);
+				radiance *= falloff * falloff;
+				directionToLight = distance > 0.0f ? toLight / distance : glm::vec3(0.0f);
+
+				// Spot lights are weighted by how much they face the sphere so rotating them registers as a change
+				if (lightComponent.Type == LightType::LightType_Spot)
+				{
+					radiance *= glm::max(glm::dot(transformComponent.GetForward(), -directionToLight), 0.0f) * 0.5f + 0.5f;
+				}
+			}
+
+			float luminance = glm::dot(radiance, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+			outRadiance += radiance;
+			outDirection += directionToLight * luminance;
+			luminanceSum += luminance;
+		}
+
+		if (luminanceSum > 0.0f)
+			outDirection /= luminanceSum;
 	}
 
 	glm::uvec2 LightManager::GetShadowQualityResolution(ShadowQuality quality)
@@ -329,125 +490,4 @@ namespace Arcane
 
 		return m_ClosestDirectionalLightIndex;
 	}
-
-	glm::vec3 LightManager::GetSpotLightShadowCasterLightDir()
-	{
-		if (!m_ClosestSpotLightShadowCaster)
-		{
-			ARC_ASSERT(false, "Spotlight shadow caster does not exist in current scene - could not get light direction");
-			return glm::vec3(0.0f, -1.0f, 0.0f);
-		}
-
-		return m_ClosestSpotLightShadowCasterTransform->GetForward();
-	}
-
-	glm::vec3 LightManager::GetSpotLightShadowCasterLightPosition()
-	{
-		if (!m_ClosestSpotLightShadowCaster)
-		{
-			ARC_ASSERT(false, "Spotlight shadow caster does not exist in current scene - could not get light position");
-			return glm::vec3(0.0f, 0.0f, 0.0f);
-		}
-
-		return m_ClosestSpotLightShadowCasterTransform->Translation;
-	}
-
-	float LightManager::GetSpotLightShadowCasterOuterCutOffAngle()
-	{
-		if (!m_ClosestSpotLightShadowCaster)
-		{
-			ARC_ASSERT(false, "Spotlight shadow caster does not exist in current scene - could not get outer cutoff angle");
-			return 0.0f;
-		}
-
-		return glm::acos(m_ClosestSpotLightShadowCaster->OuterCutOff);
-	}
-
-	float LightManager::GetSpotLightShadowCasterAttenuationRange()
-	{
-		if (!m_ClosestSpotLightShadowCaster)
-		{
-			ARC_ASSERT(false, "Spotlight shadow caster does not exist in current scene - could not get attenuation range");
-			return 0.0f;
-		}
-
-		return m_ClosestSpotLightShadowCaster->AttenuationRange;
-	}
-
-	glm::vec2 LightManager::GetSpotLightShadowCasterNearFarPlane()
-	{
-		if (!m_ClosestSpotLightShadowCaster)
-		{
-			ARC_ASSERT(false, "Spotlight shadow caster does not exist in current scene - could not get near/far plane");
-			return glm::vec2(SHADOWMAP_NEAR_PLANE_DEFAULT, SHADOWMAP_FAR_PLANE_DEFAULT);
-		}
-
-		return glm::vec2(m_ClosestSpotLightShadowCaster->ShadowNearPlane, m_ClosestSpotLightShadowCaster->ShadowFarPlane);
-	}
-
-	float LightManager::GetSpotLightShadowCasterBias()
-	{
-		if (!m_ClosestSpotLightShadowCaster)
-		{
-			ARC_ASSERT(false, "Spotlight shadow caster does not exist in current scene - could not get bias");
-			return SHADOWMAP_BIAS_DEFAULT;
-		}
-
-		return m_ClosestSpotLightShadowCaster->ShadowBias;
-	}
-
-	int LightManager::GetSpotLightShadowCasterIndex()
-	{
-		if (!m_ClosestSpotLightShadowCaster)
-		{
-			ARC_ASSERT(false, "Spotlight shadow caster does not exist in current scene - could not get index");
-			return -1;
-		}
-
-		return m_ClosestSpotLightIndex;
-	}
-
-	glm::vec3 LightManager::GetPointLightShadowCasterLightPosition()
-	{
-		if (!m_ClosestPointLightShadowCaster)
-		{
-			ARC_ASSERT(false, "Point light shadow caster does not exist in current scene - could not get light position");
-			return glm::vec3(0.0f, 0.0f, 0.0f);
-		}
-
-		return m_ClosestPointLightShadowCasterTranform->Translation;
-	}
-
-	glm::vec2 LightManager::GetPointLightShadowCasterNearFarPlane()
-	{
-		if (!m_ClosestPointLightShadowCaster)
-		{
-			ARC_ASSERT(false, "Point light shadow caster does not exist in current scene - could not get near/far plane");
-			return glm::vec2(SHADOWMAP_NEAR_PLANE_DEFAULT, SHADOWMAP_FAR_PLANE_DEFAULT);
-		}
-
-		return glm::vec2(m_ClosestPointLightShadowCaster->ShadowNearPlane, m_ClosestPointLightShadowCaster->ShadowFarPlane);
-	}
-
-	float LightManager::GetPointLightShadowCasterBias()
-	{
-		if (!m_ClosestPointLightShadowCaster)
-		{
-			ARC_ASSERT(false, "Point light shadow caster does not exist in current scene - could not get bias");
-			return SHADOWMAP_BIAS_DEFAULT;
-		}
-
-		return m_ClosestPointLightShadowCaster->ShadowBias;
-	}
-
-	int LightManager::GetPointLightShadowCasterIndex()
-	{
-		if (!m_ClosestPointLightShadowCaster)
-		{
-			ARC_ASSERT(false, "Point light shadow caster does not exist in current scene - could not get index");
-			return -1;
-		}
-
-		return m_ClosestPointLightIndex;
-	}
 }
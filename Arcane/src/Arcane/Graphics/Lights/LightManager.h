@@ -2,10 +2,18 @@
 #ifndef LIGHTMANAGER_H
 #define LIGHTMANAGER_H
 
+#ifndef LIGHTCLUSTERGRID_H
+#include <Arcane/Graphics/Lights/LightClusterGrid.h>
+#endif
+
+#ifndef SHADOWATLAS_H
+#include <Arcane/Graphics/Lights/ShadowAtlas.h>
+#endif
+
 namespace Arcane
 {
+	class ICamera;
 	class Framebuffer;
-	class Cubemap;
 	struct LightComponent;
 	struct TransformComponent;
 	class Scene;
@@ -29,6 +37,16 @@ namespace Arcane
 		ShadowQualitySize
 	};
 
+	// A single tile of the shadow atlas that needs to be rendered by the shadowmap pass
+	struct ShadowAtlasCaster
+	{
+		glm::mat4 LightSpaceViewProjectionMatrix;
+		glm::uvec4 Viewport;
+		glm::vec3 LightPosition;
+		float FarPlane;
+		bool LinearDepth; // Point lights store linear depth so the shadow test can be done on the distance to the light
+	};
+
 	class LightManager
 	{
 	public:
@@ -38,44 +56,39 @@ namespace Arcane
 		void Init();
 		void Update();
 
-		void BindLightingUniforms(Shader *shader);
-		void BindStaticLightingUniforms(Shader *shader);
+		// The camera is needed so the point and spot lights can be clustered for the view that is being rendered
+		void BindLightingUniforms(Shader *shader, ICamera *camera);
+		void BindStaticLightingUniforms(Shader *shader, ICamera *camera);
 
 		static glm::uvec2 GetShadowQualityResolution(ShadowQuality quality);
 
 		// Getters for directional light shadow caster
 		inline bool HasDirectionalLightShadowCaster() const { return m_ClosestDirectionalLightShadowCaster != nullptr; }
 		Framebuffer* GetDirectionalLightShadowCasterFramebuffer() { return m_DirectionalLightShadowFramebuffer; }
+		Framebuffer* GetDirectionalLightStaticShadowFramebuffer() { return m_DirectionalLightStaticShadowFramebuffer; }
 		glm::vec3 GetDirectionalLightShadowCasterLightDir();
 		glm::vec2 GetDirectionalLightShadowCasterNearFarPlane();
 		float GetDirectionalLightShadowCasterBias();
 		int GetDirectionalLightShadowCasterIndex();
 
-		// Getters for spot light shadow caster
-		inline bool HasSpotLightShadowCaster() const { return m_ClosestSpotLightShadowCaster != nullptr; }
-		Framebuffer* GetSpotLightShadowCasterFramebuffer() { return m_SpotLightShadowFramebuffer; }
-		glm::vec3 GetSpotLightShadowCasterLightDir();
-		glm::vec3 GetSpotLightShadowCasterLightPosition();
-		float GetSpotLightShadowCasterOuterCutOffAngle(); // Returns outer cutoff angle in radians
-		float GetSpotLightShadowCasterAttenuationRange();
-		glm::vec2 GetSpotLightShadowCasterNearFarPlane();
-		float GetSpotLightShadowCasterBias();
-		int GetSpotLightShadowCasterIndex();
-
-		// Getters for point light shadow caster
-		inline bool HasPointlightShadowCaster() const { return m_ClosestPointLightShadowCaster != nullptr; }
-		Cubemap* GetPointLightShadowCasterCubemap() { return m_PointLightShadowCubemap; }
-		glm::vec3 GetPointLightShadowCasterLightPosition();
-		glm::vec2 GetPointLightShadowCasterNearFarPlane();
-		float GetPointLightShadowCasterBias();
-		int GetPointLightShadowCasterIndex();
+		// Static shadow casters are cached and only need to be re-rendered when this hash changes or the cascade moves to a different texel, resizes or the light turns.
+		// If the cached cascade is still valid the matrix is replaced with the one it was rendered with, so the static and dynamic casters always line up
+		inline std::size_t GetStaticShadowCasterHash() const { return m_StaticShadowCasterHash; }
+		bool RequiresStaticCascadeRender(int cascade, const glm::vec2 &lightSpaceOrigin, float texelSize, glm::mat4 &lightSpaceViewProjectionMatrix); // The cascade is considered cached after this call
+
+		// Spot and point light shadow casters all share the shadow atlas
+		inline ShadowAtlas* GetShadowAtlas() { return &m_ShadowAtlas; }
+		inline const std::vector<ShadowAtlasCaster>& GetShadowAtlasCasters() const { return m_ShadowAtlasCasters; }
+
+		// Rough estimate of the light reaching a sphere, used to detect when something baked from the lighting (ie probes) has changed enough to be refreshed.
+		// Radiance is the sum of every light's contribution and the direction is the average direction the light arrives from, weighted by luminance
+		void EstimateIncidentLight(const glm::vec3 &position, float radius, bool onlyStatic, glm::vec3 &outRadiance, glm::vec3 &outDirection);
 	private:
 		void FindClosestDirectionalLightShadowCaster();
-		void FindClosestSpotLightShadowCaster();
-		void FindClosestPointLightShadowCaster();
-		void BindLights(Shader *shader, bool bindOnlyStatic);
-		void ReallocateDepthTarget(Framebuffer **framebuffer, glm::uvec2 newResolution);
-		void ReallocateDepthCubemap(Cubemap** cubemap, glm::uvec2 newResolution);
+		void UpdateShadowAtlas();
+		void UpdateStaticShadowCasterHash();
+		void BindLights(Shader *shader, ICamera *camera, bool bindOnlyStatic);
+		void ReallocateDirectionalShadowTargets(glm::uvec2 newResolution);
 	private:
 		Scene *m_Scene;
 
@@ -85,17 +98,43 @@ namespace Arcane
 		int m_ClosestDirectionalLightIndex = 0;
 		Framebuffer *m_DirectionalLightShadowFramebuffer;
 
-		// Spot Light Shadows (keeps track of closest one so passes can use these framebuffers for the shadows)
-		LightComponent *m_ClosestSpotLightShadowCaster;
-		TransformComponent *m_ClosestSpotLightShadowCasterTransform;
-		int m_ClosestSpotLightIndex = 0;
-		Framebuffer *m_SpotLightShadowFramebuffer;
-
-		// Point Light Shadows (keeps track of closest one so passes can use these framebuffers for the shadows)
-		LightComponent* m_ClosestPointLightShadowCaster;
-		TransformComponent* m_ClosestPointLightShadowCasterTranform;
-		int m_ClosestPointLightIndex = 0;
-		Cubemap *m_PointLightShadowCubemap;
+		// Static casters are rendered into their own cascades that are copied into the directional shadowmap before the dynamic casters are rendered
+		struct StaticCascadeCacheEntry
+		{
+			glm::mat4 LightSpaceViewProjectionMatrix;
+			glm::vec2 LightSpaceOrigin;
+			float TexelSize;
+			glm::vec3 LightDir;
+			glm::vec2 LightNearFarPlane;
+			std::size_t StaticCasterHash;
+			bool Valid;
+		};
+		Framebuffer *m_DirectionalLightStaticShadowFramebuffer;
+		StaticCascadeCacheEntry m_StaticCascadeCache[SHADOW_CASCADE_COUNT];
+		std::size_t m_StaticShadowCasterHash = 0;
+		std::size_t m_StaticShadowCasterLoadingUpdates = 0;
+
+		// Spot and point light shadows are given tiles in the atlas based on their importance every update
+		ShadowAtlas m_ShadowAtlas;
+		std::vector<ShadowAtlasCaster> m_ShadowAtlasCasters;
+		std::vector<GPUShadowAtlasTile> m_ShadowAtlasTiles;
+
+		// Clustered point and spot lights. Every view rendered in a frame (main camera, water captures, probe faces) keeps it's own grid,
+		// so a grid is only rebuilt when the lights change instead of every time a different view binds the lights
+		struct LightClusterCacheEntry
+		{
+			LightClusterGrid Grid;
+			std::vector<GPUPointLight> PointLights;
+			std::vector<GPUSpotLight> SpotLights;
+			glm::mat4 View, Projection;
+			bool OnlyStatic = false;
+			std::uint64_t LightGeneration = 0; // Compared with m_LightGeneration, zero means the entry has never been built
+			std::uint64_t LastUsed = 0;
+		};
+		LightClusterCacheEntry* FindLightClusters(const glm::mat4 &view, const glm::mat4 &projection, bool onlyStatic);
+
+		LightClusterCacheEntry m_LightClusterCache[LIGHT_CLUSTER_CACHED_VIEW_COUNT];
+		std::uint64_t m_LightGeneration = 1, m_LightClusterUseCounter = 0;
 	};
 }
 #endif
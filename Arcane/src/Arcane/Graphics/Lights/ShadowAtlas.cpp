@@ -0,0 +1,147 @@
+#include "arcpch.h"
+#include "ShadowAtlas.h"
+
+#include <Arcane/Graphics/Shader.h>
+
+namespace Arcane
+{
+	ShadowAtlas::ShadowAtlas(unsigned int resolution, unsigned int minTileResolution) : m_Allocator(resolution, minTileResolution), m_Framebuffer(nullptr), m_StaticFramebuffer(nullptr), m_FramebufferResolution(0), m_StaticFramebufferResolution(0)
+	{
+		m_TileBuffer.Allocate(sizeof(GPUShadowAtlasTile));
+	}
+
+	ShadowAtlas::~ShadowAtlas()
+	{
+		RenderTargetPool::Release(m_Framebuffer);
+		RenderTargetPool::Release(m_StaticFramebuffer);
+	}
+
+	unsigned int ShadowAtlas::AddRequest(float importance, unsigned int desiredTileResolution, unsigned int tileCount)
+	{
+		return m_Allocator.AddRequest(importance, desiredTileResolution, tileCount);
+	}
+
+	void ShadowAtlas::Allocate()
+	{
+		m_Allocator.Allocate();
+
+		// Every tile in the atlas is rewritten each frame, so it can simply be swapped for a target of the new size. The pool keeps the old one around for a while
+		// in case the tiles go back to their previous size
+		unsigned int resolution = m_Allocator.GetUsedResolution();
+		if (resolution != m_FramebufferResolution)
+		{
+			RenderTargetPool::Release(m_Framebuffer);
+			m_Framebuffer = resolution > 0 ? RenderTargetPool::Acquire(GetAtlasDesc(resolution, true)) : nullptr;
+			m_FramebufferResolution = resolution;
+		}
+
+		// The static atlas is only held while there are tiles to cache and covers the same region, but it's contents have to survive a resize.
+		// So the part both sizes share is copied over, and only the cached tiles that no longer fit are lost
+		if (resolution != m_StaticFramebufferResolution)
+		{
+			Framebuffer *staticFramebuffer = resolution > 0 ? RenderTargetPool::Acquire(GetAtlasDesc(resolution, false)) : nullptr;
+			unsigned int sharedResolution = glm::min(resolution, m_StaticFramebufferResolution);
+			if (sharedResolution > 0)
+			{
+				glCopyImageSubData(m_StaticFramebuffer->GetDepthStencilTexture()->GetTextureId(), GL_TEXTURE_2D, 0, 0, 0, 0,
+								   staticFramebuffer->GetDepthStencilTexture()->GetTextureId(), GL_TEXTURE_2D, 0, 0, 0, 0, sharedResolution, sharedResolution, 1);
+			}
+			RenderTargetPool::Release(m_StaticFramebuffer);
+			m_StaticFramebuffer = staticFramebuffer;
+			m_StaticFramebufferResolution = resolution;
+
+			for (StaticTileCacheEntry &entry : m_StaticTileCache)
+			{
+				if (entry.Viewport.x + entry.Viewport.z > sharedResolution || entry.Viewport.y + entry.Viewport.w > sharedResolution)
+					entry.Valid = false;
+			}
+		}
+	}
+
+	void ShadowAtlas::ClearRequests()
+	{
+		m_Allocator.ClearRequests();
+	}
+
+	bool ShadowAtlas::GetAllocation(unsigned int requestHandle, unsigned int tileIndex, glm::uvec4 &outViewport) const
+	{
+		return m_Allocator.GetAllocation(requestHandle, tileIndex, outViewport);
+	}
+
+	glm::vec4 ShadowAtlas::GetAtlasScaleBias(const glm::uvec4 &viewport) const
+	{
+		float inverseResolution = 1.0f / m_FramebufferResolution;
+		return glm::vec4(viewport.z * inverseResolution, viewport.w * inverseResolution, viewport.x * inverseResolution, viewport.y * inverseResolution);
+	}
+
+	bool ShadowAtlas::RequiresStaticTileRender(unsigned int tileIndex, const glm::mat4 &lightSpaceViewProjectionMatrix, const glm::uvec4 &viewport, std::size_t staticCasterHash)
+	{
+		if (tileIndex >= m_StaticTileCache.size())
+		{
+			m_StaticTileCache.resize(tileIndex + 1, StaticTileCacheEntry{ glm::mat4(1.0f), glm::uvec4(0), 0, false });
+		}
+
+		StaticTileCacheEntry &entry = m_StaticTileCache[tileIndex];
+		if (entry.Valid && entry.Viewport == viewport && entry.StaticCasterHash == staticCasterHash && entry.LightSpaceViewProjectionMatrix == lightSpaceViewProjectionMatrix)
+			return false;
+
+		// The tile is about to be re-rendered, so any other cached tile that overlaps it in the static atlas is lost
+		for (unsigned int i = 0; i < m_StaticTileCache.size(); i++)
+		{
+			StaticTileCacheEntry &other = m_StaticTileCache[i];
+			if (i == tileIndex || !other.Valid)
+				continue;
+
+			bool overlaps = viewport.x < other.Viewport.x + other.Viewport.z && other.Viewport.x < viewport.x + viewport.z &&
+							viewport.y < other.Viewport.y + other.Viewport.w && other.Viewport.y < viewport.y + viewport.w;
+			if (overlaps)
+				other.Valid = false;
+		}
+
+		entry.LightSpaceViewProjectionMatrix = lightSpaceViewProjectionMatrix;
+		entry.Viewport = viewport;
+		entry.StaticCasterHash = staticCasterHash;
+		entry.Valid = true;
+		return true;
+	}
+
+	void ShadowAtlas::CopyStaticTile(const glm::uvec4 &viewport)
+	{
+		glCopyImageSubData(m_StaticFramebuffer->GetDepthStencilTexture()->GetTextureId(), GL_TEXTURE_2D, 0, viewport.x, viewport.y, 0,
+						   m_Framebuffer->GetDepthStencilTexture()->GetTextureId(), GL_TEXTURE_2D, 0, viewport.x, viewport.y, 0, viewport.z, viewport.w, 1);
+	}
+
+	void ShadowAtlas::UploadTiles(const std::vector<GPUShadowAtlasTile> &tiles)
+	{
+		m_TileBuffer.Upload(tiles.data(), sizeof(GPUShadowAtlasTile) * tiles.size());
+		m_TileBuffer.Unbind();
+	}
+
+	void ShadowAtlas::Bind(Shader *shader, int textureUnit)
+	{
+		m_TileBuffer.BindBase(TileBufferBinding);
+
+		// Without an atlas no light has a tile, so the shaders never sample it
+		if (m_Framebuffer)
+		{
+			m_Framebuffer->GetDepthStencilTexture()->Bind(textureUnit);
+		}
+		else
+		{
+			glActiveTexture(GL_TEXTURE0 + textureUnit);
+			glBindTexture(GL_TEXTURE_2D, 0);
+		}
+		shader->SetUniform("shadowAtlas", textureUnit);
+	}
+
+	RenderTargetDesc ShadowAtlas::GetAtlasDesc(unsigned int resolution, bool bilinearFiltering)
+	{
+		RenderTargetDesc desc;
+		desc.Width = resolution;
+		desc.Height = resolution;
+		desc.DepthType = RenderTargetDepthType::RenderTargetDepthType_Texture;
+		desc.DepthFormat = NormalizedDepthOnly;
+		desc.DepthBilinearFiltering = bilinearFiltering;
+		return desc;
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+#ifndef SHADOWATLAS_H
+#define SHADOWATLAS_H
+
+#ifndef RENDERTARGETPOOL_H
+#include <Arcane/Graphics/Renderer/RenderTargetPool.h>
+#endif
+
+#ifndef SHADERSTORAGEBUFFER_H
+#include <Arcane/Platform/OpenGL/ShaderStorageBuffer.h>
+#endif
+
+#ifndef ATLASALLOCATOR_H
+#include <Arcane/Graphics/Renderer/AtlasAllocator.h>
+#endif
+
+namespace Arcane
+{
+	class Shader;
+
+	// GPU representation of a tile in the atlas, this must match the std430 layout of ShadowAtlasTile in the lighting shaders
+	struct GPUShadowAtlasTile
+	{
+		glm::mat4 LightSpaceViewProjectionMatrix;
+		glm::vec4 AtlasScaleBias; // xy = scale, zw = offset of the tile in atlas UV space
+		float ShadowBias;
+		float FarPlane; // Only used for point lights since they store linear depth
+		float Padding[2];
+	};
+
+	// One depth texture that is shared by every spot and point light shadow caster. Every frame lights request tiles with an importance and the AtlasAllocator
+	// decides which tiles fit and where they go. The texture is leased from the RenderTargetPool at the size of the region the tiles actually use, so a scene
+	// without spot or point shadows doesn't hold an atlas at all. Static casters are cached in a second atlas, so a tile only needs it's static casters
+	// re-rendered when the light or the static casters change.
+	// The static atlas is sized to the same region, so it is also only held while tiles are allocated
+	class ShadowAtlas
+	{
+	public:
+		ShadowAtlas(unsigned int resolution, unsigned int minTileResolution);
+		~ShadowAtlas();
+
+		// Returns a handle that can be used to query the allocation once Allocate() has been called. Point lights should request six tiles (one per cube face)
+		unsigned int AddRequest(float importance, unsigned int desiredTileResolution, unsigned int tileCount);
+		void Allocate();
+		void ClearRequests();
+
+		// Returns false if the request was dropped because it couldn't fit in the atlas. Viewport is (x, y, width, height) in texels
+		bool GetAllocation(unsigned int requestHandle, unsigned int tileIndex, glm::uvec4 &outViewport) const;
+		glm::vec4 GetAtlasScaleBias(const glm::uvec4 &viewport) const;
+
+		// Returns true if the tile's static casters need to be rendered into the static atlas. The tile is considered cached after this call
+		bool RequiresStaticTileRender(unsigned int tileIndex, const glm::mat4 &lightSpaceViewProjectionMatrix, const glm::uvec4 &viewport, std::size_t staticCasterHash);
+		void CopyStaticTile(const glm::uvec4 &viewport); // Copies the cached static depth into the atlas, dynamic casters are then rendered on top
+
+		void UploadTiles(const std::vector<GPUShadowAtlasTile> &tiles);
+		void Bind(Shader *shader, int textureUnit);
+
+		// Both are null while no tiles are allocated
+		inline Framebuffer* GetFramebuffer() { return m_Framebuffer; }
+		inline Framebuffer* GetStaticFramebuffer() { return m_StaticFramebuffer; }
+		inline unsigned int GetResolution() const { return m_FramebufferResolution; }
+
+		// SSBO binding point used by the lighting shaders (follows the clustered lighting buffers)
+		static const unsigned int TileBufferBinding = 4;
+	private:
+		struct StaticTileCacheEntry
+		{
+			glm::mat4 LightSpaceViewProjectionMatrix;
+			glm::uvec4 Viewport;
+			std::size_t StaticCasterHash;
+			bool Valid;
+		};
+
+		static RenderTargetDesc GetAtlasDesc(unsigned int resolution, bool bilinearFiltering);
+	private:
+		AtlasAllocator m_Allocator;
+		Framebuffer *m_Framebuffer, *m_StaticFramebuffer;
+		unsigned int m_FramebufferResolution, m_StaticFramebufferResolution;
+		ShaderStorageBuffer m_TileBuffer;
+
+		std::vector<StaticTileCacheEntry> m_StaticTileCache;
+	};
+}
+#endif
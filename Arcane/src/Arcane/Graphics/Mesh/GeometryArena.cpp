@@ -0,0 +1,278 @@
+#include "arcpch.h"
+#include "GeometryArena.h"
+
+#include <Arcane/Animation/AnimationData.h>
+
+namespace Arcane
+{
+	std::vector<GeometryArena::Layout> GeometryArena::s_Layouts;
+	unsigned int GeometryArena::s_DrawIndexBuffer = 0;
+	GeometryArenaStats GeometryArena::s_Stats;
+
+	void GeometryArena::Shutdown()
+	{
+		for (Layout &layout : s_Layouts)
+		{
+			glDeleteVertexArrays(1, &layout.VAO);
+			glDeleteBuffers(1, &layout.VBO);
+			glDeleteBuffers(1, &layout.IBO);
+		}
+		s_Layouts.clear();
+
+		if (s_DrawIndexBuffer)
+		{
+			glDeleteBuffers(1, &s_DrawIndexBuffer);
+			s_DrawIndexBuffer = 0;
+		}
+	}
+
+	GeometryAllocation GeometryArena::Allocate(unsigned int layoutBits, const void *vertexData, unsigned int vertexCount, const unsigned int *indexData, unsigned int indexCount)
+	{
+		GeometryAllocation allocation;
+		int layoutIndex = FindOrCreateLayout(layoutBits);
+		Layout &layout = s_Layouts[layoutIndex];
+
+		// Grow until it fits, existing allocations keep their offsets since the old contents are copied to the start of the new buffer
+		unsigned int baseVertex;
+		while (!layout.Vertices.Allocate(vertexCount, baseVertex))
+		{
+			unsigned int newCapacity = glm::max(layout.Vertices.Capacity * 2, layout.Vertices.Capacity + vertexCount);
+			GrowBuffer(layout.VBO, static_cast<size_t>(layout.Vertices.Capacity) * layout.Stride, static_cast<size_t>(newCapacity) * layout.Stride);
+			layout.Vertices.Grow(newCapacity);
+
+			glBindVertexArray(layout.VAO);
+			glBindVertexBuffer(0, layout.VBO, 0, layout.Stride);
+			glBindVertexArray(0);
+		}
+		unsigned int firstIndex;
+		while (!layout.Indices.Allocate(indexCount, firstIndex))
+		{
+			unsigned int newCapacity = glm::max(layout.Indices.Capacity * 2, layout.Indices.Capacity + indexCount);
+			GrowBuffer(layout.IBO, static_cast<size_t>(layout.Indices.Capacity) * sizeof(unsigned int), static_cast<size_t>(newCapacity) * sizeof(unsigned int));
+			layout.Indices.Grow(newCapacity);
+
+			glBindVertexArray(layout.VAO);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, layout.IBO);
+			glBindVertexArray(0);
+		}
+
+		// Uploaded through the copy target so the element array binding of whatever VAO is bound is left alone
+		glBindBuffer(GL_COPY_WRITE_BUFFER, layout.VBO);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(baseVertex) * layout.Stride, static_cast<GLsizeiptr>(vertexCount) * layout.Stride, vertexData);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, layout.IBO);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(firstIndex) * sizeof(unsigned int), static_cast<GLsizeiptr>(indexCount) * sizeof(unsigned int), indexData);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		layout.AllocationCount++;
+		allocation.LayoutIndex = layoutIndex;
+		allocation.BaseVertex = baseVertex;
+		allocation.VertexCount = vertexCount;
+		allocation.FirstIndex = firstIndex;
+		allocation.IndexCount = indexCount;
+		return allocation;
+	}
+
+	void GeometryArena::Free(GeometryAllocation &allocation)
+	{
+		if (!allocation.IsValid())
+			return;
+
+		Layout &layout = s_Layouts[allocation.LayoutIndex];
+		layout.Vertices.Free(allocation.BaseVertex, allocation.VertexCount);
+		layout.Indices.Free(allocation.FirstIndex, allocation.IndexCount);
+		layout.AllocationCount--;
+
+		allocation = GeometryAllocation();
+	}
+
+	unsigned int GeometryArena::GetVertexArray(int layoutIndex)
+	{
+		return s_Layouts[layoutIndex].VAO;
+	}
+
+	const GeometryArenaStats& GeometryArena::GetStats()
+	{
+		s_Stats = GeometryArenaStats();
+		s_Stats.LayoutCount = static_cast<unsigned int>(s_Layouts.size());
+		for (const Layout &layout : s_Layouts)
+		{
+			s_Stats.AllocationCount += layout.AllocationCount;
+			s_Stats.VertexBytesUsed += static_cast<size_t>(layout.Vertices.UsedCount) * layout.Stride;
+			s_Stats.VertexBytesCapacity += static_cast<size_t>(layout.Vertices.Capacity) * layout.Stride;
+			s_Stats.IndexBytesUsed += static_cast<size_t>(layout.Indices.UsedCount) * sizeof(unsigned int);
+			s_Stats.IndexBytesCapacity += static_cast<size_t>(layout.Indices.Capacity) * sizeof(unsigned int);
+		}
+		return s_Stats;
+	}
+
+	int GeometryArena::FindOrCreateLayout(unsigned int layoutBits)
+	{
+		for (int i = 0; i < static_cast<int>(s_Layouts.size()); i++)
+		{
+			if (s_Layouts[i].LayoutBits == layoutBits)
+				return i;
+		}
+
+		// Instance N of an indirect draw reads N from here, a draw's base instance is the index of it's per draw data so this stands in for gl_DrawID (which needs GL 4.6)
+		if (!s_DrawIndexBuffer)
+		{
+			std::vector<unsigned int> drawIndices(RENDERER_MAX_INDIRECT_DRAWS);
+			for (unsigned int i = 0; i < RENDERER_MAX_INDIRECT_DRAWS; i++)
+				drawIndices[i] = i;
+
+			glGenBuffers(1, &s_DrawIndexBuffer);
+			glBindBuffer(GL_ARRAY_BUFFER, s_DrawIndexBuffer);
+			glBufferData(GL_ARRAY_BUFFER, drawIndices.size() * sizeof(unsigned int), &drawIndices[0], GL_STATIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+
+		Layout layout;
+		layout.LayoutBits = layoutBits;
+		layout.Stride = GetStride(layoutBits);
+		layout.AllocationCount = 0;
+		layout.Vertices.Grow(GEOMETRY_ARENA_MIN_VERTICES);
+		layout.Indices.Grow(GEOMETRY_ARENA_MIN_INDICES);
+
+		glGenVertexArrays(1, &layout.VAO);
+		glGenBuffers(1, &layout.VBO);
+		glGenBuffers(1, &layout.IBO);
+
+		glBindVertexArray(layout.VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, layout.VBO);
+		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(layout.Vertices.Capacity) * layout.Stride, nullptr, GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, layout.IBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(layout.Indices.Capacity) * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+
+		// Separate attribute formats and buffer bindings, so growing the vertex buffer only has to re-point binding 0
+		glBindVertexBuffer(0, layout.VBO, 0, layout.Stride);
+		unsigned int offset = 0;
+		auto addAttribute = [&](unsigned int location, int componentCount, bool isInteger)
+		{
+			glEnableVertexAttribArray(location);
+			if (isInteger)
+				glVertexAttribIFormat(location, componentCount, GL_INT, offset);
+			else
+				glVertexAttribFormat(location, componentCount, GL_FLOAT, GL_FALSE, offset);
+			glVertexAttribBinding(location, 0);
+			offset += componentCount * 4;
+		};
+		addAttribute(0, 3, false);
+		if (layoutBits & GeometryLayout_Normals)
+			addAttribute(1, 3, false);
+		if (layoutBits & GeometryLayout_UVs)
+			addAttribute(2, 2, false);
+		if (layoutBits & GeometryLayout_Tangents)
+			addAttribute(3, 3, false);
+		if (layoutBits & GeometryLayout_Bitangents)
+			addAttribute(4, 3, false);
+		if (layoutBits & GeometryLayout_BoneData)
+		{
+			addAttribute(5, MaxBonesPerVertex, true);
+			addAttribute(6, MaxBonesPerVertex, false);
+		}
+
+		glBindVertexBuffer(1, s_DrawIndexBuffer, 0, sizeof(unsigned int));
+		glVertexBindingDivisor(1, 1);
+		glEnableVertexAttribArray(7);
+		glVertexAttribIFormat(7, 1, GL_UNSIGNED_INT, 0);
+		glVertexAttribBinding(7, 1);
+
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		s_Layouts.push_back(layout);
+		return static_cast<int>(s_Layouts.size()) - 1;
+	}
+
+	void GeometryArena::GrowBuffer(unsigned int &buffer, size_t oldSizeBytes, size_t newSizeBytes)
+	{
+		unsigned int newBuffer;
+		glGenBuffers(1, &newBuffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, newSizeBytes, nullptr, GL_STATIC_DRAW);
+		glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSizeBytes);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		glDeleteBuffers(1, &buffer);
+		buffer = newBuffer;
+	}
+
+	unsigned int GeometryArena::GetStride(unsigned int layoutBits)
+	{
+		unsigned int componentCount = 3;
+		if (layoutBits & GeometryLayout_Normals)
+			componentCount += 3;
+		if (layoutBits & GeometryLayout_UVs)
+			componentCount += 2;
+		if (layoutBits & GeometryLayout_Tangents)
+			componentCount += 3;
+		if (layoutBits & GeometryLayout_Bitangents)
+			componentCount += 3;
+		if (layoutBits & GeometryLayout_BoneData)
+			componentCount += 2 * MaxBonesPerVertex;
+
+		return componentCount * sizeof(float);
+	}
+
+	bool GeometryArena::FreeList::Allocate(unsigned int count, unsigned int &outOffset)
+	{
+		for (auto iter = FreeRanges.begin(); iter != FreeRanges.end(); ++iter)
+		{
+			if (iter->Count < count)
+				continue;
+
+			outOffset = iter->Offset;
+			iter->Offset += count;
+			iter->Count -= count;
+			if (iter->Count == 0)
+				FreeRanges.erase(iter);
+
+			UsedCount += count;
+			return true;
+		}
+		return false;
+	}
+
+	void GeometryArena::FreeList::Free(unsigned int offset, unsigned int count)
+	{
+		if (count == 0)
+			return;
+		UsedCount -= count;
+
+		auto next = std::lower_bound(FreeRanges.begin(), FreeRanges.end(), offset, [](const Range &range, unsigned int value) { return range.Offset < value; });
+		bool mergesPrevious = next != FreeRanges.begin() && (next - 1)->Offset + (next - 1)->Count == offset;
+		bool mergesNext = next != FreeRanges.end() && offset + count == next->Offset;
+
+		if (mergesPrevious && mergesNext)
+		{
+			(next - 1)->Count += count + next->Count;
+			FreeRanges.erase(next);
+		}
+		else if (mergesPrevious)
+		{
+			(next - 1)->Count += count;
+		}
+		else if (mergesNext)
+		{
+			next->Offset = offset;
+			next->Count += count;
+		}
+		else
+		{
+			FreeRanges.insert(next, { offset, count });
+		}
+	}
+
+	void GeometryArena::FreeList::Grow(unsigned int newCapacity)
+	{
+		unsigned int addedCount = newCapacity - Capacity;
+		unsigned int oldCapacity = Capacity;
+		Capacity = newCapacity;
+
+		// The new space is handed to Free so it merges with a free range at the end of the old buffer, the used count is put back since nothing was actually released
+		UsedCount += addedCount;
+		Free(oldCapacity, addedCount);
+	}
+}
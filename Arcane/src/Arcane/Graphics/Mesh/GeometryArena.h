@@ -0,0 +1,81 @@
+#pragma once
+#ifndef GEOMETRYARENA_H
+#define GEOMETRYARENA_H
+
+namespace Arcane
+{
+	// Attributes a mesh's interleaved vertices contain on top of positions, every combination gets it's own arena
+	enum GeometryLayoutBits : unsigned int
+	{
+		GeometryLayout_Normals = 1 << 0,
+		GeometryLayout_UVs = 1 << 1,
+		GeometryLayout_Tangents = 1 << 2,
+		GeometryLayout_Bitangents = 1 << 3,
+		GeometryLayout_BoneData = 1 << 4
+	};
+
+	// Where a mesh's vertices and indices live in it's layout's arena, drawn with glDrawElementsBaseVertex (or as a command of a multi-draw indirect)
+	struct GeometryAllocation
+	{
+		int LayoutIndex = -1;
+		unsigned int BaseVertex = 0, VertexCount = 0;
+		unsigned int FirstIndex = 0, IndexCount = 0;
+
+		inline bool IsValid() const { return LayoutIndex != -1; }
+	};
+
+	struct GeometryArenaStats
+	{
+		unsigned int LayoutCount = 0, AllocationCount = 0;
+		size_t VertexBytesUsed = 0, VertexBytesCapacity = 0;
+		size_t IndexBytesUsed = 0, IndexBytesCapacity = 0;
+	};
+
+	// Indexed, interleaved meshes don't own their own buffers, their vertices and indices are sub-allocated out of one large vertex and index buffer shared by every mesh
+	// with the same vertex layout. So a whole layout is drawn with one VAO, which is what lets many meshes be submitted together with glMultiDrawElementsIndirect.
+	// A layout's buffers grow (and get copied over on the GPU) when they run out of room, allocations keep their offsets so the meshes already in the arena are unaffected
+	class GeometryArena
+	{
+	public:
+		static void Shutdown();
+
+		static GeometryAllocation Allocate(unsigned int layoutBits, const void *vertexData, unsigned int vertexCount, const unsigned int *indexData, unsigned int indexCount);
+		static void Free(GeometryAllocation &allocation);
+
+		// Also has the layout's index buffer bound, and the draw index buffer (attribute 7, one per instance) that indirect draws use to find their per draw data
+		static unsigned int GetVertexArray(int layoutIndex);
+
+		static const GeometryArenaStats& GetStats();
+	private:
+		// First fit free list over a buffer measured in elements (vertices or indices), neighbouring free ranges are merged when a range is freed
+		struct FreeList
+		{
+			struct Range
+			{
+				unsigned int Offset, Count;
+			};
+			std::vector<Range> FreeRanges; // Sorted by offset
+			unsigned int Capacity = 0, UsedCount = 0;
+
+			bool Allocate(unsigned int count, unsigned int &outOffset);
+			void Free(unsigned int offset, unsigned int count);
+			void Grow(unsigned int newCapacity);
+		};
+		struct Layout
+		{
+			unsigned int LayoutBits, Stride;
+			unsigned int VAO, VBO, IBO;
+			FreeList Vertices, Indices;
+			unsigned int AllocationCount;
+		};
+
+		static int FindOrCreateLayout(unsigned int layoutBits);
+		static void GrowBuffer(unsigned int &buffer, size_t oldSizeBytes, size_t newSizeBytes);
+		static unsigned int GetStride(unsigned int layoutBits);
+	private:
+		static std::vector<Layout> s_Layouts;
+		static unsigned int s_DrawIndexBuffer;
+		static GeometryArenaStats s_Stats;
+	};
+}
+#endif
@@ -19,7 +19,7 @@ namespace Arcane
 		// Texture unit 0 is reserved for the directional shadowmap
 		// Texture unit 1 is reserved for the spotlight shadowmap
 		// Texture unit 2 is reserved for the pointlight shadowmap
-		// Texture unit 3 is reserved for the irradianceMap used for indirect diffuse IBL
+		// Texture unit 3 is unused (light probes are spherical harmonics stored in an SSBO)
 		// Texture unit 4 is reserved for the prefilterMap
 		// Texture unit 5 is reserved for the brdfLUT
 		int currentTextureUnit = 6;
@@ -8,6 +8,7 @@ namespace Arcane
 	class Texture;
 
 	class Material {
+		friend class MaterialBuffer;
 	public:
 		Material();
 
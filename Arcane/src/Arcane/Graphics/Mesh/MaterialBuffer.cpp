@@ -0,0 +1,327 @@
+#include "arcpch.h"
+#include "MaterialBuffer.h"
+
+#include <Arcane/Graphics/Mesh/Material.h>
+#include <Arcane/Graphics/Shader.h>
+#include <Arcane/Graphics/Texture/Texture.h>
+#include <Arcane/Graphics/Renderer/Renderer.h>
+#include <Arcane/Util/Loaders/AssetManager.h>
+
+namespace Arcane
+{
+	// Matches the flags in the geometry pass shaders
+	enum MaterialFlags : int
+	{
+		MaterialFlag_HasAlbedoTexture = 1 << 0,
+		MaterialFlag_HasMetallicTexture = 1 << 1,
+		MaterialFlag_HasRoughnessTexture = 1 << 2,
+		MaterialFlag_HasDisplacement = 1 << 3
+	};
+
+	MaterialTexturePath MaterialBuffer::s_TexturePath = MaterialTexturePath::MaterialTexturePath_TextureArrays;
+	unsigned int MaterialBuffer::s_MaterialSSBO = 0;
+	unsigned int MaterialBuffer::s_MaterialCapacity = 0;
+	std::vector<MaterialBuffer::GPUMaterial> MaterialBuffer::s_Materials;
+	std::unordered_map<const Material*, int> MaterialBuffer::s_MaterialIndices;
+	unsigned int MaterialBuffer::s_UploadedCount = 0;
+	std::unordered_map<unsigned int, glm::uvec2> MaterialBuffer::s_TextureReferences;
+	std::vector<MaterialBuffer::TextureArrayBucket> MaterialBuffer::s_Buckets;
+	bool MaterialBuffer::s_BucketLimitWarned = false;
+	MaterialBufferStats MaterialBuffer::s_Stats;
+
+	void MaterialBuffer::Init()
+	{
+		s_TexturePath = (MATERIAL_ALLOW_BINDLESS && GLEW_ARB_bindless_texture) ? MaterialTexturePath::MaterialTexturePath_Bindless : MaterialTexturePath::MaterialTexturePath_TextureArrays;
+		ARC_LOG_INFO("Material textures are referenced with {0}", s_TexturePath == MaterialTexturePath::MaterialTexturePath_Bindless ? "bindless handles" : "texture arrays");
+
+		// Always bound and always big enough for last frame's material indices, so a pass that doesn't use materials (ie a depth pre-pass) never reads outside of it
+		s_MaterialCapacity = MATERIAL_BUFFER_INITIAL_CAPACITY;
+		glGenBuffers(1, &s_MaterialSSBO);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, s_MaterialSSBO);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, s_MaterialCapacity * sizeof(GPUMaterial), nullptr, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 9, s_MaterialSSBO);
+	}
+
+	void MaterialBuffer::Shutdown()
+	{
+		if (s_TexturePath == MaterialTexturePath::MaterialTexturePath_Bindless)
+		{
+			for (auto &[textureId, reference] : s_TextureReferences)
+			{
+				glMakeTextureHandleNonResidentARB(static_cast<GLuint64>(reference.x) | (static_cast<GLuint64>(reference.y) << 32));
+			}
+		}
+		s_TextureReferences.clear();
+
+		for (TextureArrayBucket &bucket : s_Buckets)
+		{
+			glDeleteTextures(1, &bucket.TextureId);
+		}
+		s_Buckets.clear();
+
+		glDeleteBuffers(1, &s_MaterialSSBO);
+		s_MaterialSSBO = 0;
+		s_Materials.clear();
+		s_MaterialIndices.clear();
+	}
+
+	void MaterialBuffer::BeginFrame()
+	{
+		s_Materials.clear();
+		s_MaterialIndices.clear();
+		s_UploadedCount = 0;
+	}
+
+	void MaterialBuffer::AddMaterial(const Material &material)
+	{
+		if (s_MaterialIndices.find(&material) != s_MaterialIndices.end())
+			return;
+
+		GPUMaterial gpuMaterial = {};
+		gpuMaterial.AlbedoColour = material.m_AlbedoColour;
+		gpuMaterial.MetallicValue = material.m_MetallicValue;
+		gpuMaterial.RoughnessValue = material.m_RoughnessValue;
+		gpuMaterial.ParallaxStrength = material.m_ParallaxStrength;
+		gpuMaterial.MinMaxDisplacementSteps = glm::vec2(material.m_ParallaxMinSteps, material.m_ParallaxMaxSteps);
+
+		// Same fallbacks as BindMaterialInformation, normal and AO maps are always sampled so they fall back to the default textures
+		if (GetTextureReference(material.m_AlbedoMap, gpuMaterial.Textures[0]))
+			gpuMaterial.Flags |= MaterialFlag_HasAlbedoTexture;
+		if (!GetTextureReference(material.m_NormalMap, gpuMaterial.Textures[1]))
+			GetTextureReference(AssetManager::GetDefaultNormalTexture(), gpuMaterial.Textures[1]);
+		if (GetTextureReference(material.m_MetallicMap, gpuMaterial.Textures[2]))
+			gpuMaterial.Flags |= MaterialFlag_HasMetallicTexture;
+		if (GetTextureReference(material.m_RoughnessMap, gpuMaterial.Textures[3]))
+			gpuMaterial.Flags |= MaterialFlag_HasRoughnessTexture;
+		if (!GetTextureReference(material.m_AmbientOcclusionMap, gpuMaterial.Textures[4]))
+			GetTextureReference(AssetManager::GetDefaultAOTexture(), gpuMaterial.Textures[4]);
+		if (GetTextureReference(material.m_DisplacementMap, gpuMaterial.Textures[5]))
+			gpuMaterial.Flags |= MaterialFlag_HasDisplacement;
+
+		s_MaterialIndices[&material] = static_cast<int>(s_Materials.size());
+		s_Materials.push_back(gpuMaterial);
+	}
+
+	int MaterialBuffer::GetMaterialIndex(const Material &material)
+	{
+		auto iter = s_MaterialIndices.find(&material);
+		ARC_ASSERT(iter != s_MaterialIndices.end(), "Material wasn't added to the material buffer this frame");
+		if (iter == s_MaterialIndices.end())
+			return 0;
+		return iter->second;
+	}
+
+	void MaterialBuffer::Bind(Shader *shader)
+	{
+		unsigned int materialCount = static_cast<unsigned int>(s_Materials.size());
+		if (materialCount > s_UploadedCount)
+		{
+			// The first upload of the frame orphans the buffer so last frame's draws don't have to finish first, growing re-uploads everything
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, s_MaterialSSBO);
+			if (materialCount > s_MaterialCapacity || s_UploadedCount == 0)
+			{
+				while (s_MaterialCapacity < materialCount)
+					s_MaterialCapacity *= 2;
+				glBufferData(GL_SHADER_STORAGE_BUFFER, s_MaterialCapacity * sizeof(GPUMaterial), nullptr, GL_DYNAMIC_DRAW);
+				s_UploadedCount = 0;
+			}
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, s_UploadedCount * sizeof(GPUMaterial), (materialCount - s_UploadedCount) * sizeof(GPUMaterial), &s_Materials[s_UploadedCount]);
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+			s_UploadedCount = materialCount;
+		}
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 9, s_MaterialSSBO);
+
+		if (s_TexturePath == MaterialTexturePath::MaterialTexturePath_TextureArrays)
+		{
+			int textureUnits[MATERIAL_TEXTURE_ARRAY_MAX_BUCKETS];
+			for (int i = 0; i < MATERIAL_TEXTURE_ARRAY_MAX_BUCKETS; i++)
+			{
+				textureUnits[i] = MATERIAL_TEXTURE_ARRAY_FIRST_UNIT + i;
+				if (i < static_cast<int>(s_Buckets.size()))
+				{
+					glActiveTexture(GL_TEXTURE0 + textureUnits[i]);
+					glBindTexture(GL_TEXTURE_2D_ARRAY, s_Buckets[i].TextureId);
+				}
+			}
+			shader->SetUniformArray("materialTextureArrays", MATERIAL_TEXTURE_ARRAY_MAX_BUCKETS, textureUnits);
+		}
+	}
+
+	void MaterialBuffer::OnTextureDeleted(unsigned int textureId)
+	{
+		auto iter = s_TextureReferences.find(textureId);
+		if (iter == s_TextureReferences.end())
+			return;
+
+		glm::uvec2 reference = iter->second;
+		if (s_TexturePath == MaterialTexturePath::MaterialTexturePath_Bindless)
+		{
+			glMakeTextureHandleNonResidentARB(static_cast<GLuint64>(reference.x) | (static_cast<GLuint64>(reference.y) << 32));
+		}
+		else
+		{
+			s_Buckets[reference.x].FreeLayers.push_back(reference.y);
+		}
+		s_TextureReferences.erase(iter);
+	}
+
+	std::vector<std::string> MaterialBuffer::GetShaderDefines()
+	{
+		if (s_TexturePath == MaterialTexturePath::MaterialTexturePath_Bindless)
+			return { "MATERIAL_BINDLESS" };
+		return {};
+	}
+
+	const MaterialBufferStats& MaterialBuffer::GetStats()
+	{
+		s_Stats = MaterialBufferStats();
+		s_Stats.TexturePath = s_TexturePath;
+		s_Stats.MaterialCount = static_cast<unsigned int>(s_Materials.size());
+		s_Stats.TextureCount = static_cast<unsigned int>(s_TextureReferences.size());
+		s_Stats.BucketCount = static_cast<unsigned int>(s_Buckets.size());
+		for (const TextureArrayBucket &bucket : s_Buckets)
+		{
+			// Rough estimate, assumes 4 bytes per texel and a third extra for the mips
+			size_t layerBytes = static_cast<size_t>(bucket.Width) * bucket.Height * 4;
+			if (bucket.MipCount > 1)
+				layerBytes += layerBytes / 3;
+			s_Stats.BucketBytes += layerBytes * bucket.LayerCapacity;
+		}
+		return s_Stats;
+	}
+
+	bool MaterialBuffer::GetTextureReference(const Texture *texture, glm::uvec2 &outReference)
+	{
+		if (!texture || !texture->IsGenerated())
+			return false;
+
+		auto iter = s_TextureReferences.find(texture->GetTextureId());
+		if (iter != s_TextureReferences.end())
+		{
+			outReference = iter->second;
+			return true;
+		}
+
+		if (s_TexturePath == MaterialTexturePath::MaterialTexturePath_Bindless)
+		{
+			// Creating the handle locks the texture's sampling settings, nothing changes them once a texture has been generated
+			GLuint64 handle = glGetTextureHandleARB(texture->GetTextureId());
+			glMakeTextureHandleResidentARB(handle);
+			outReference = glm::uvec2(static_cast<unsigned int>(handle & 0xFFFFFFFF), static_cast<unsigned int>(handle >> 32));
+		}
+		else if (!AddToTextureArray(texture, outReference))
+		{
+			return false;
+		}
+
+		s_TextureReferences[texture->GetTextureId()] = outReference;
+		return true;
+	}
+
+	bool MaterialBuffer::AddToTextureArray(const Texture *texture, glm::uvec2 &outReference)
+	{
+		const TextureSettings &settings = texture->GetTextureSettings();
+		unsigned int width = texture->GetWidth(), height = texture->GetHeight();
+		unsigned int mipCount = settings.HasMips ? static_cast<unsigned int>(std::floor(std::log2(glm::max(width, height)))) + 1 : 1;
+		float anisotropyLevel = glm::min<float>(settings.TextureAnisotropyLevel, Renderer::GetRendererData().MaxAnisotropy);
+
+		// Everything that changes how the texture is sampled is part of the bucket, so a texture samples the same out of an array as it does on it's own
+		int bucketIndex = -1;
+		for (int i = 0; i < static_cast<int>(s_Buckets.size()); i++)
+		{
+			const TextureArrayBucket &bucket = s_Buckets[i];
+			if (bucket.Width == width && bucket.Height == height && bucket.MipCount == mipCount && bucket.Format == settings.TextureFormat &&
+				bucket.WrapS == settings.TextureWrapSMode && bucket.WrapT == settings.TextureWrapTMode && bucket.MinFilter == settings.TextureMinificationFilterMode &&
+				bucket.MagFilter == settings.TextureMagnificationFilterMode && bucket.AnisotropyLevel == anisotropyLevel && bucket.MipBias == settings.MipBias)
+			{
+				bucketIndex = i;
+				break;
+			}
+		}
+		if (bucketIndex == -1)
+		{
+			if (s_Buckets.size() >= MATERIAL_TEXTURE_ARRAY_MAX_BUCKETS)
+			{
+				if (!s_BucketLimitWarned)
+				{
+					ARC_LOG_WARN("Material texture arrays are full ({0} buckets), textures of new sizes or formats will render without their texture", MATERIAL_TEXTURE_ARRAY_MAX_BUCKETS);
+					s_BucketLimitWarned = true;
+				}
+				return false;
+			}
+
+			TextureArrayBucket bucket;
+			bucket.Width = width;
+			bucket.Height = height;
+			bucket.MipCount = mipCount;
+			bucket.Format = settings.TextureFormat;
+			bucket.WrapS = settings.TextureWrapSMode;
+			bucket.WrapT = settings.TextureWrapTMode;
+			bucket.MinFilter = settings.TextureMinificationFilterMode;
+			bucket.MagFilter = settings.TextureMagnificationFilterMode;
+			bucket.AnisotropyLevel = anisotropyLevel;
+			bucket.MipBias = settings.MipBias;
+			bucket.LayerCapacity = MATERIAL_TEXTURE_ARRAY_INITIAL_LAYERS;
+			bucket.LayerCount = 0;
+			AllocateBucketStorage(bucket);
+
+			s_Buckets.push_back(bucket);
+			bucketIndex = static_cast<int>(s_Buckets.size()) - 1;
+		}
+
+		TextureArrayBucket &bucket = s_Buckets[bucketIndex];
+		unsigned int layer;
+		if (!bucket.FreeLayers.empty())
+		{
+			layer = bucket.FreeLayers.back();
+			bucket.FreeLayers.pop_back();
+		}
+		else
+		{
+			if (bucket.LayerCount == bucket.LayerCapacity)
+				GrowBucket(bucket, bucket.LayerCapacity * 2);
+			layer = bucket.LayerCount++;
+		}
+
+		for (unsigned int mip = 0; mip < mipCount; mip++)
+		{
+			glCopyImageSubData(texture->GetTextureId(), GL_TEXTURE_2D, mip, 0, 0, 0, bucket.TextureId, GL_TEXTURE_2D_ARRAY, mip, 0, 0, layer, glm::max(width >> mip, 1u), glm::max(height >> mip, 1u), 1);
+		}
+
+		outReference = glm::uvec2(static_cast<unsigned int>(bucketIndex), layer);
+		return true;
+	}
+
+	void MaterialBuffer::GrowBucket(TextureArrayBucket &bucket, unsigned int newLayerCapacity)
+	{
+		unsigned int oldTextureId = bucket.TextureId;
+		bucket.LayerCapacity = newLayerCapacity;
+		AllocateBucketStorage(bucket);
+
+		for (unsigned int mip = 0; mip < bucket.MipCount; mip++)
+		{
+			glCopyImageSubData(oldTextureId, GL_TEXTURE_2D_ARRAY, mip, 0, 0, 0, bucket.TextureId, GL_TEXTURE_2D_ARRAY, mip, 0, 0, 0, glm::max(bucket.Width >> mip, 1u), glm::max(bucket.Height >> mip, 1u), bucket.LayerCount);
+		}
+		glDeleteTextures(1, &oldTextureId);
+	}
+
+	void MaterialBuffer::AllocateBucketStorage(TextureArrayBucket &bucket)
+	{
+		glGenTextures(1, &bucket.TextureId);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, bucket.TextureId);
+		for (unsigned int mip = 0; mip < bucket.MipCount; mip++)
+		{
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, mip, bucket.Format, glm::max(bucket.Width >> mip, 1u), glm::max(bucket.Height >> mip, 1u), bucket.LayerCapacity, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		}
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, bucket.MipCount - 1);
+
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, bucket.WrapS);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, bucket.WrapT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, bucket.MinFilter);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, bucket.MagFilter);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_LOD_BIAS, bucket.MipBias);
+		glTexParameterf(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_ANISOTROPY_EXT, bucket.AnisotropyLevel);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+#ifndef MATERIALBUFFER_H
+#define MATERIALBUFFER_H
+
+namespace Arcane
+{
+	class Material;
+	class Shader;
+	class Texture;
+
+	enum class MaterialTexturePath : int
+	{
+		MaterialTexturePath_Bindless, // ARB_bindless_texture handles stored directly in the material
+		MaterialTexturePath_TextureArrays // Textures are copied into texture arrays bucketed by size and format, the material stores the bucket and layer
+	};
+
+	struct MaterialBufferStats
+	{
+		MaterialTexturePath TexturePath = MaterialTexturePath::MaterialTexturePath_TextureArrays;
+		unsigned int MaterialCount = 0; // Materials used so far this frame
+		unsigned int TextureCount = 0; // Textures with a bindless handle or a texture array layer
+		unsigned int BucketCount = 0; // Only used by the texture array path
+		size_t BucketBytes = 0;
+	};
+
+	// Every material drawn by a MaterialBufferRequired pass is packed into an SSBO (binding 9) instead of being bound as textures and uniforms for each mesh, so a draw only
+	// needs the index of it's material. Materials are re-packed the first time they are used each frame since the editor can change them (and textures finish streaming) at any time.
+	// Textures are referenced with bindless handles when the driver supports them, otherwise they are copied once into a layer of a texture array that shares their size, format,
+	// and sampling settings, the arrays are bound to MATERIAL_TEXTURE_ARRAY_FIRST_UNIT onwards
+	class MaterialBuffer
+	{
+	public:
+		static void Init();
+		static void Shutdown();
+
+		static void BeginFrame();
+
+		static void AddMaterial(const Material &material); // Packs the material if it hasn't been used yet this frame
+		static int GetMaterialIndex(const Material &material); // Only valid for materials added this frame
+		static void Bind(Shader *shader); // Uploads the materials that were added since the last bind
+
+		static void OnTextureDeleted(unsigned int textureId);
+
+		static inline MaterialTexturePath GetTexturePath() { return s_TexturePath; }
+		static std::vector<std::string> GetShaderDefines(); // Selects the shader's texture path
+		static const MaterialBufferStats& GetStats();
+	private:
+		// Matches the std430 layout of MaterialData in the shaders
+		struct GPUMaterial
+		{
+			glm::vec4 AlbedoColour;
+			float MetallicValue, RoughnessValue, ParallaxStrength;
+			int Flags;
+			glm::vec2 MinMaxDisplacementSteps;
+			glm::vec2 Padding;
+			glm::uvec2 Textures[6]; // Bindless handle (low bits, high bits) or (bucket, layer)
+		};
+		struct TextureArrayBucket
+		{
+			unsigned int Width, Height, MipCount;
+			GLenum Format;
+			GLenum WrapS, WrapT, MinFilter, MagFilter;
+			float AnisotropyLevel;
+			int MipBias;
+
+			unsigned int TextureId;
+			unsigned int LayerCapacity;
+			std::vector<unsigned int> FreeLayers;
+			unsigned int LayerCount;
+		};
+
+		static bool GetTextureReference(const Texture *texture, glm::uvec2 &outReference);
+		static bool AddToTextureArray(const Texture *texture, glm::uvec2 &outReference);
+		static void GrowBucket(TextureArrayBucket &bucket, unsigned int newLayerCapacity);
+		static void AllocateBucketStorage(TextureArrayBucket &bucket);
+	private:
+		static MaterialTexturePath s_TexturePath;
+		static unsigned int s_MaterialSSBO;
+		static unsigned int s_MaterialCapacity;
+
+		static std::vector<GPUMaterial> s_Materials;
+		static std::unordered_map<const Material*, int> s_MaterialIndices;
+		static unsigned int s_UploadedCount;
+
+		static std::unordered_map<unsigned int, glm::uvec2> s_TextureReferences; // Texture id -> handle or (bucket, layer)
+		static std::vector<TextureArrayBucket> s_Buckets;
+		static bool s_BucketLimitWarned;
+
+		static MaterialBufferStats s_Stats;
+	};
+}
+#endif
@@ -20,6 +20,14 @@ namespace Arcane
 
 	void Mesh::Draw() const
 	{
+		if (m_GeometryAllocation.IsValid())
+		{
+			glBindVertexArray(GeometryArena::GetVertexArray(m_GeometryAllocation.LayoutIndex));
+			glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(m_GeometryAllocation.IndexCount), GL_UNSIGNED_INT, (void*)(m_GeometryAllocation.FirstIndex * sizeof(unsigned int)), static_cast<GLint>(m_GeometryAllocation.BaseVertex));
+			glBindVertexArray(0);
+			return;
+		}
+
 		glBindVertexArray(m_VAO);
 		if (m_Indices.size() > 0) {
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IBO);
@@ -167,6 +175,24 @@ namespace Arcane
 
 	void Mesh::GenerateGpuData()
 	{
+		if (m_IsInterleaved && m_Indices.size() > 0 && m_BufferData.size() > 0)
+		{
+			unsigned int layoutBits = 0;
+			if (m_Normals.size() > 0)
+				layoutBits |= GeometryLayout_Normals;
+			if (m_UVs.size() > 0)
+				layoutBits |= GeometryLayout_UVs;
+			if (m_Tangents.size() > 0)
+				layoutBits |= GeometryLayout_Tangents;
+			if (m_Bitangents.size() > 0)
+				layoutBits |= GeometryLayout_Bitangents;
+			if (m_BoneData.size() > 0)
+				layoutBits |= GeometryLayout_BoneData;
+
+			m_GeometryAllocation = GeometryArena::Allocate(layoutBits, &m_BufferData[0], static_cast<unsigned int>(m_Positions.size()), &m_Indices[0], static_cast<unsigned int>(m_Indices.size()));
+			return;
+		}
+
 		glGenVertexArrays(1, &m_VAO);
 		glGenBuffers(1, &m_VBO);
 		glGenBuffers(1, &m_IBO);
@@ -270,4 +296,18 @@ namespace Arcane
 
 		glBindVertexArray(0);
 	}
+
+	void Mesh::ReleaseGpuData()
+	{
+		if (m_GeometryAllocation.IsValid())
+		{
+			GeometryArena::Free(m_GeometryAllocation);
+			return;
+		}
+
+		glDeleteVertexArrays(1, &m_VAO);
+		glDeleteBuffers(1, &m_VBO);
+		glDeleteBuffers(1, &m_IBO);
+		m_VAO = m_VBO = m_IBO = 0;
+	}
 }
@@ -10,6 +10,10 @@
 #include <Arcane/Animation/AnimationData.h>
 #endif
 
+#ifndef GEOMETRYARENA_H
+#include <Arcane/Graphics/Mesh/GeometryArena.h>
+#endif
+
 namespace Arcane
 {
 	class Mesh
@@ -33,13 +37,18 @@ namespace Arcane
 		Mesh(std::vector<glm::vec3> &&positions, std::vector<glm::vec2> &&uvs, std::vector<glm::vec3> &&normals, std::vector<glm::vec3> &&tangents, std::vector<glm::vec3> &&bitangents, std::vector<VertexBoneData> &&boneWeights, std::vector<unsigned int> &&indices);
 		
 		void LoadData(bool interleaved = true);
-		void GenerateGpuData(); // Commits all of the buffers and their attributes to the GPU driver
+		void GenerateGpuData(); // Commits all of the buffers and their attributes to the GPU driver (indexed interleaved meshes are placed in the geometry arena)
+		void ReleaseGpuData(); // Meshes are copied around by value so this is never done automatically, only call it once nothing can draw the mesh anymore
 
 		void Draw() const;
 
 		inline Material& GetMaterial() { return m_Material; }
+		inline const std::vector<glm::vec3>& GetPositions() const { return m_Positions; }
+		inline const std::vector<unsigned int>& GetIndices() const { return m_Indices; }
+		inline const GeometryAllocation& GetGeometryAllocation() const { return m_GeometryAllocation; }
 	protected:
-		unsigned int m_VAO, m_VBO, m_IBO;
+		unsigned int m_VAO, m_VBO, m_IBO; // Only used by meshes that aren't in the geometry arena
+		GeometryAllocation m_GeometryAllocation;
 		Material m_Material;
 
 		std::vector<glm::vec3> m_Positions;
@@ -2,6 +2,7 @@
 #include "Model.h"
 
 #include <Arcane/Graphics/Shader.h>
+#include <Arcane/Graphics/Mesh/MaterialBuffer.h>
 #include <Arcane/Util/Loaders/AssetManager.h>
 #include <Arcane/Animation/AnimationData.h>
 #include <assimp/scene.h>
@@ -10,7 +11,7 @@
 
 namespace Arcane
 {
-	Model::Model() : m_BoneCount(0)
+	Model::Model() : m_BoneCount(0), m_BoundsMin(0.0f), m_BoundsMax(0.0f)
 	{
 		m_Meshes.resize(0);
 	}
@@ -18,11 +19,13 @@ namespace Arcane
 	Model::Model(const Mesh &mesh) : m_BoneCount(0)
 	{
 		m_Meshes.push_back(mesh);
+		CalculateBounds();
 	}
 
 	Model::Model(const std::vector<Mesh> &meshes) : m_BoneCount(0)
 	{
 		m_Meshes = meshes;
+		CalculateBounds();
 	}
 
 	void Model::Draw(Shader *shader, RenderPassType pass) const
@@ -32,6 +35,9 @@ namespace Arcane
 			if (pass == MaterialRequired) {
 				m_Meshes[i].m_Material.BindMaterialInformation(shader);
 			}
+			else if (pass == MaterialBufferRequired) {
+				shader->SetUniform("materialIndex", MaterialBuffer::GetMaterialIndex(m_Meshes[i].m_Material));
+			}
 			m_Meshes[i].Draw();
 		}
 	}
@@ -51,6 +57,7 @@ namespace Arcane
 		m_Name = path.substr(path.find_last_of("/\\") + 1);
 
 		ProcessNode(scene->mRootNode, scene);
+		CalculateBounds();
 	}
 
 	void Model::GenerateGpuData()
@@ -61,6 +68,27 @@ namespace Arcane
 		}
 	}
 
+	void Model::CalculateBounds()
+	{
+		m_BoundsMin = glm::vec3(std::numeric_limits<float>::max());
+		m_BoundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+		for (auto &mesh : m_Meshes)
+		{
+			for (auto &position : mesh.m_Positions)
+			{
+				m_BoundsMin = glm::min(m_BoundsMin, position);
+				m_BoundsMax = glm::max(m_BoundsMax, position);
+			}
+		}
+
+		// Empty models get an empty box at the origin
+		if (m_BoundsMin.x > m_BoundsMax.x)
+		{
+			m_BoundsMin = glm::vec3(0.0f);
+			m_BoundsMax = glm::vec3(0.0f);
+		}
+	}
+
 	void Model::ProcessNode(aiNode *node, const aiScene *scene)
 	{
 		// Process all of the node's meshes (if any)
@@ -41,6 +41,10 @@ namespace Arcane
 
 		inline const auto& GetGlobalInverseTransform() const { return m_GlobalInverseTransform; }
 
+		// Local space bounding box of every mesh in the model (bind pose for skinned models)
+		inline const glm::vec3& GetBoundsMin() const { return m_BoundsMin; }
+		inline const glm::vec3& GetBoundsMax() const { return m_BoundsMax; }
+
 		static inline glm::mat4 ConvertAssimpMatrixToGLM(const aiMatrix4x4& aiMat)
 		{
 			return glm::transpose(glm::make_mat4(&aiMat.a1));
@@ -48,6 +52,7 @@ namespace Arcane
 	private:
 		void LoadModel(const std::string &path);
 		void GenerateGpuData();
+		void CalculateBounds();
 
 		void ProcessNode(aiNode *node, const aiScene *scene);
 		void ProcessMesh(aiMesh *mesh, const aiScene *scene);
@@ -57,6 +62,7 @@ namespace Arcane
 		std::unordered_map<std::string, BoneData> m_BoneDataMap;
 		glm::mat4 m_GlobalInverseTransform; // Used by animation for bone related data to move it back to the origin
 		int m_BoneCount;
+		glm::vec3 m_BoundsMin, m_BoundsMax;
 
 		std::string m_Directory;
 		std::string m_Name;
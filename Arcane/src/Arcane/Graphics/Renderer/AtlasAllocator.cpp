@@ -0,0 +1,168 @@
+#include "arcpch.h"
+#include "AtlasAllocator.h"
+
+namespace Arcane
+{
+	AtlasAllocator::AtlasAllocator(unsigned int resolution, unsigned int minTileResolution) : m_Resolution(resolution), m_MinTileResolution(minTileResolution), m_UsedResolution(0)
+	{
+		ARC_ASSERT((resolution & (resolution - 1)) == 0 && (minTileResolution & (minTileResolution - 1)) == 0, "Atlas and it's minimum tile resolution need to be a power of two");
+		ARC_ASSERT(minTileResolution <= resolution, "Atlas minimum tile resolution can't be larger than the atlas");
+	}
+
+	unsigned int AtlasAllocator::AddRequest(float importance, unsigned int desiredTileResolution, unsigned int tileCount)
+	{
+		// Round down to a power of two so the tile lines up with the Morton placement
+		unsigned int tileResolution = m_MinTileResolution;
+		while (tileResolution * 2 <= desiredTileResolution && tileResolution * 2 <= m_Resolution)
+			tileResolution *= 2;
+
+		TileRequest request;
+		request.Importance = importance;
+		request.TileResolution = tileResolution;
+		request.TileCount = tileCount;
+		request.FirstViewport = 0;
+		request.Allocated = true;
+		m_Requests.push_back(request);
+
+		return static_cast<unsigned int>(m_Requests.size() - 1);
+	}
+
+	void AtlasAllocator::Allocate()
+	{
+		unsigned int cellsPerAxis = m_Resolution / m_MinTileResolution;
+		unsigned int cellCapacity = cellsPerAxis * cellsPerAxis;
+
+		// Least important requests are at the front so they are the first to be shrunk
+		std::vector<unsigned int> requestsByImportance(m_Requests.size());
+		for (unsigned int i = 0; i < m_Requests.size(); i++)
+			requestsByImportance[i] = i;
+		std::sort(requestsByImportance.begin(), requestsByImportance.end(), [this](unsigned int a, unsigned int b)
+		{
+			return m_Requests[a].Importance < m_Requests[b].Importance;
+		});
+
+		unsigned int usedCells = 0;
+		for (auto &request : m_Requests)
+			usedCells += GetRequestCellCount(request);
+
+		while (usedCells > cellCapacity)
+		{
+			// Halve the least important request that can still shrink, otherwise drop the least important request entirely
+			TileRequest *requestToShrink = nullptr;
+			for (unsigned int requestIndex : requestsByImportance)
+			{
+				TileRequest &request = m_Requests[requestIndex];
+				if (request.Allocated && request.TileResolution > m_MinTileResolution)
+				{
+					requestToShrink = &request;
+					break;
+				}
+			}
+
+			if (requestToShrink)
+			{
+				usedCells -= GetRequestCellCount(*requestToShrink);
+				requestToShrink->TileResolution /= 2;
+				usedCells += GetRequestCellCount(*requestToShrink);
+			}
+			else
+			{
+				for (unsigned int requestIndex : requestsByImportance)
+				{
+					TileRequest &request = m_Requests[requestIndex];
+					if (request.Allocated)
+					{
+						usedCells -= GetRequestCellCount(request);
+						request.Allocated = false;
+						break;
+					}
+				}
+			}
+		}
+
+		// Place every tile, largest first. Each tile covers a square block of cells that starts on a multiple of it's cell count along the Morton curve
+		// since the larger tiles that came before it were all multiples of it's size, so the tiles never overlap and never leave gaps
+		m_Viewports.clear();
+		std::vector<std::pair<unsigned int, unsigned int>> tilesToPlace; // (request index, tile index)
+		for (unsigned int i = 0; i < m_Requests.size(); i++)
+		{
+			TileRequest &request = m_Requests[i];
+			request.FirstViewport = static_cast<unsigned int>(m_Viewports.size());
+			if (!request.Allocated)
+				continue;
+
+			for (unsigned int tile = 0; tile < request.TileCount; tile++)
+			{
+				tilesToPlace.push_back(std::make_pair(i, tile));
+				m_Viewports.push_back(glm::uvec4(0));
+			}
+		}
+		std::stable_sort(tilesToPlace.begin(), tilesToPlace.end(), [this](const std::pair<unsigned int, unsigned int> &a, const std::pair<unsigned int, unsigned int> &b)
+		{
+			return m_Requests[a.first].TileResolution > m_Requests[b.first].TileResolution;
+		});
+
+		unsigned int mortonCursor = 0;
+		for (auto &tileToPlace : tilesToPlace)
+		{
+			const TileRequest &request = m_Requests[tileToPlace.first];
+			unsigned int cellsPerTileAxis = request.TileResolution / m_MinTileResolution;
+
+			glm::uvec2 cell(CompactMortonBits(mortonCursor), CompactMortonBits(mortonCursor >> 1));
+			m_Viewports[request.FirstViewport + tileToPlace.second] = glm::uvec4(cell * m_MinTileResolution, request.TileResolution, request.TileResolution);
+			mortonCursor += cellsPerTileAxis * cellsPerTileAxis;
+		}
+
+		// The first 4^n cells along the Morton curve form a 2^n square at the origin
+		m_UsedResolution = 0;
+		if (mortonCursor > 0)
+		{
+			unsigned int usedCellsPerAxis = 1;
+			while (usedCellsPerAxis * usedCellsPerAxis < mortonCursor)
+				usedCellsPerAxis *= 2;
+			m_UsedResolution = usedCellsPerAxis * m_MinTileResolution;
+		}
+	}
+
+	void AtlasAllocator::ClearRequests()
+	{
+		m_Requests.clear();
+		m_Viewports.clear();
+		m_UsedResolution = 0;
+	}
+
+	bool AtlasAllocator::GetAllocation(unsigned int requestHandle, unsigned int tileIndex, glm::uvec4 &outViewport) const
+	{
+		if (requestHandle >= m_Requests.size() || !m_Requests[requestHandle].Allocated || tileIndex >= m_Requests[requestHandle].TileCount)
+			return false;
+
+		outViewport = m_Viewports[m_Requests[requestHandle].FirstViewport + tileIndex];
+		return true;
+	}
+
+	glm::vec4 AtlasAllocator::GetAtlasScaleBias(const glm::uvec4 &viewport) const
+	{
+		float inverseResolution = 1.0f / m_Resolution;
+		return glm::vec4(viewport.z * inverseResolution, viewport.w * inverseResolution, viewport.x * inverseResolution, viewport.y * inverseResolution);
+	}
+
+	unsigned int AtlasAllocator::GetRequestCellCount(const TileRequest &request) const
+	{
+		if (!request.Allocated)
+			return 0;
+
+		unsigned int cellsPerTileAxis = request.TileResolution / m_MinTileResolution;
+		return cellsPerTileAxis * cellsPerTileAxis * request.TileCount;
+	}
+
+	// Extracts every other bit of a Morton code, giving the x coordinate (or y if the code is shifted by one first)
+	unsigned int AtlasAllocator::CompactMortonBits(unsigned int code)
+	{
+		code &= 0x55555555;
+		code = (code ^ (code >> 1)) & 0x33333333;
+		code = (code ^ (code >> 2)) & 0x0f0f0f0f;
+		code = (code ^ (code >> 4)) & 0x00ff00ff;
+		code = (code ^ (code >> 8)) & 0x0000ffff;
+		return code;
+	}
+}
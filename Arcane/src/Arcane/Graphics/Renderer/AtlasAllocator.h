@@ -0,0 +1,48 @@
+#pragma once
+#ifndef ATLASALLOCATOR_H
+#define ATLASALLOCATOR_H
+
+namespace Arcane
+{
+	// Hands out square, power of two sized tiles of a fixed size atlas. Every frame requests are added with an importance, then Allocate() shrinks the least important
+	// requests (and drops them as a last resort) until everything fits. Tiles are placed largest first along a Morton curve, which guarantees a perfect packing without
+	// having to search for free space. Used by any atlas that should never need to be reallocated (ie the shadow atlas and the water capture atlases)
+	class AtlasAllocator
+	{
+	public:
+		AtlasAllocator(unsigned int resolution, unsigned int minTileResolution);
+
+		// Returns a handle that can be used to query the allocation once Allocate() has been called. Requests with multiple tiles always have every tile at the same resolution
+		unsigned int AddRequest(float importance, unsigned int desiredTileResolution, unsigned int tileCount);
+		void Allocate();
+		void ClearRequests();
+
+		// Returns false if the request was dropped because it couldn't fit in the atlas. Viewport is (x, y, width, height) in texels
+		bool GetAllocation(unsigned int requestHandle, unsigned int tileIndex, glm::uvec4 &outViewport) const;
+		glm::vec4 GetAtlasScaleBias(const glm::uvec4 &viewport) const; // xy = scale, zw = offset of the tile in atlas UV space
+
+		inline unsigned int GetResolution() const { return m_Resolution; }
+		inline unsigned int GetUsedResolution() const { return m_UsedResolution; } // Tiles are packed from the origin, so only this square at the origin is used (zero if nothing was allocated)
+		inline unsigned int GetMinTileResolution() const { return m_MinTileResolution; }
+	private:
+		struct TileRequest
+		{
+			float Importance;
+			unsigned int TileResolution;
+			unsigned int TileCount;
+			unsigned int FirstViewport;
+			bool Allocated;
+		};
+
+		unsigned int GetRequestCellCount(const TileRequest &request) const;
+		static unsigned int CompactMortonBits(unsigned int code);
+	private:
+		unsigned int m_Resolution;
+		unsigned int m_MinTileResolution;
+		unsigned int m_UsedResolution;
+
+		std::vector<TileRequest> m_Requests;
+		std::vector<glm::uvec4> m_Viewports;
+	};
+}
+#endif
@@ -0,0 +1,35 @@
+#include "arcpch.h"
+#include "DynamicResolution.h"
+
+namespace Arcane
+{
+	DynamicResolution::DynamicResolution() : m_Enabled(true), m_TargetFrameTimeMS(DYNAMIC_RESOLUTION_TARGET_FRAME_TIME_MS_DEFAULT), m_MinScale(DYNAMIC_RESOLUTION_MIN_SCALE_DEFAULT),
+		m_RenderScale(1.0f), m_SmoothedFrameTimeMS(0.0f)
+	{}
+
+	float DynamicResolution::Update(double previousFrameGPUTimeMS)
+	{
+		if (!m_Enabled)
+		{
+			m_RenderScale = 1.0f;
+			return m_RenderScale;
+		}
+
+		// Without a measurement there is nothing to adjust towards, so the scale is left where it is
+		if (previousFrameGPUTimeMS <= 0.0)
+			return m_RenderScale;
+
+		// Smooth the measured time so a single slow frame doesn't change the resolution
+		float measuredFrameTimeMS = static_cast<float>(previousFrameGPUTimeMS);
+		m_SmoothedFrameTimeMS = m_SmoothedFrameTimeMS > 0.0f ? glm::mix(m_SmoothedFrameTimeMS, measuredFrameTimeMS, 0.25f) : measuredFrameTimeMS;
+
+		// Some of the frame (shadows, post processing) doesn't scale with the resolution, so only half of the estimated change is taken each frame
+		float desiredScale = m_RenderScale * std::sqrt(m_TargetFrameTimeMS / m_SmoothedFrameTimeMS);
+		float scale = glm::mix(m_RenderScale, desiredScale, 0.5f);
+
+		const float steps = static_cast<float>(DYNAMIC_RESOLUTION_SCALE_STEPS);
+		scale = std::round(scale * steps) / steps;
+		m_RenderScale = glm::clamp(scale, glm::min(m_MinScale, 1.0f), 1.0f);
+		return m_RenderScale;
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+#ifndef DYNAMICRESOLUTION_H
+#define DYNAMICRESOLUTION_H
+
+namespace Arcane
+{
+	// Picks the fraction of the render resolution the main view is drawn at so the GPU frame time stays around a target.
+	// Shading cost is assumed to follow the pixel count (the scale squared), the estimate is smoothed and every step is only partly taken so the scale doesn't oscillate
+	class DynamicResolution
+	{
+	public:
+		DynamicResolution();
+
+		// Returns the render scale for this frame. previousFrameGPUTimeMS should be the GPU time of the whole previous frame, negative if it couldn't be measured
+		float Update(double previousFrameGPUTimeMS);
+
+		inline float GetRenderScale() const { return m_RenderScale; }
+		inline float GetSmoothedFrameTimeMS() const { return m_SmoothedFrameTimeMS; }
+
+		inline bool& GetEnabledRef() { return m_Enabled; }
+		inline float& GetTargetFrameTimeRef() { return m_TargetFrameTimeMS; }
+		inline float& GetMinScaleRef() { return m_MinScale; }
+	private:
+		bool m_Enabled;
+		float m_TargetFrameTimeMS;
+		float m_MinScale;
+
+		float m_RenderScale;
+		float m_SmoothedFrameTimeMS;
+	};
+}
+#endif
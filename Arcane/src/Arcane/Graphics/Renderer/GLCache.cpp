@@ -8,6 +8,7 @@ namespace Arcane
 	GLCache::GLCache() : m_ActiveShaderID(0) {
 		// Initialize cache values to ensure garbage data doesn't mess with my GL state
 		m_DepthTest = false;
+		m_DepthFunc = GL_LESS;
 		m_StencilTest = false;
 		m_Blend = false;
 		m_Cull = false;
@@ -0,0 +1,76 @@
+#include "arcpch.h"
+#include "HiZBuffer.h"
+
+#include <Arcane/Graphics/Shader.h>
+#include <Arcane/Graphics/Renderer/GLCache.h>
+#include <Arcane/Graphics/Renderer/Renderer.h>
+#include <Arcane/Util/Loaders/ShaderLoader.h>
+
+namespace Arcane
+{
+	HiZBuffer::HiZBuffer(unsigned int width, unsigned int height) : m_Framebuffer(width, height, false), m_MipCount(1), m_BaseSize(width, height)
+	{
+		m_GLCache = GLCache::GetInstance();
+		m_DownsampleShader = ShaderLoader::LoadShader("HiZ_Generation.glsl");
+
+		while ((glm::max(width, height) >> m_MipCount) > 0)
+			m_MipCount++;
+
+		// Texels are always fetched directly, filtering would blend depths that don't exist in the scene
+		TextureSettings pyramidSettings;
+		pyramidSettings.TextureFormat = GL_RG32F;
+		pyramidSettings.TextureWrapSMode = GL_CLAMP_TO_EDGE;
+		pyramidSettings.TextureWrapTMode = GL_CLAMP_TO_EDGE;
+		pyramidSettings.TextureMinificationFilterMode = GL_NEAREST_MIPMAP_NEAREST;
+		pyramidSettings.TextureMagnificationFilterMode = GL_NEAREST;
+		pyramidSettings.TextureAnisotropyLevel = 1.0f;
+		pyramidSettings.HasMips = true;
+		m_PyramidTexture.SetTextureSettings(pyramidSettings);
+		m_PyramidTexture.Generate2DTexture(width, height, GL_RG, GL_FLOAT);
+	}
+
+	HiZBuffer::~HiZBuffer() {}
+
+	void HiZBuffer::Build(Texture *depthTexture, unsigned int width, unsigned int height)
+	{
+		m_BaseSize = glm::ivec2(glm::min(width, m_Framebuffer.GetWidth()), glm::min(height, m_Framebuffer.GetHeight()));
+
+		m_GLCache->SetShader(m_DownsampleShader);
+		m_GLCache->SetDepthTest(false);
+		m_GLCache->SetBlend(false);
+		m_GLCache->SetFaceCull(true);
+		m_GLCache->SetCullFace(GL_BACK);
+		m_Framebuffer.Bind();
+
+		// Base mip is a straight copy of the depth buffer
+		m_Framebuffer.SetColorAttachment(m_PyramidTexture.GetTextureId(), GL_TEXTURE_2D, 0);
+		glViewport(0, 0, m_BaseSize.x, m_BaseSize.y);
+		m_DownsampleShader->SetUniform("sourceIsDepth", true);
+		m_DownsampleShader->SetUniform("sourceTexture", 0);
+		depthTexture->Bind(0);
+		Renderer::DrawNdcPlane();
+
+		// Every other mip reduces the one above it. Only the mip being read is made visible to the sampler so it never overlaps the mip being written
+		m_DownsampleShader->SetUniform("sourceIsDepth", false);
+		m_PyramidTexture.Bind(0);
+		for (unsigned int mip = 1; mip < m_MipCount; mip++)
+		{
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, mip - 1);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mip - 1);
+
+			glm::ivec2 sourceSize = glm::max(m_BaseSize >> static_cast<int>(mip - 1), glm::ivec2(1, 1));
+			glm::ivec2 mipSize = glm::max(m_BaseSize >> static_cast<int>(mip), glm::ivec2(1, 1));
+			m_DownsampleShader->SetUniform("sourceSize", sourceSize);
+
+			m_Framebuffer.SetColorAttachment(m_PyramidTexture.GetTextureId(), GL_TEXTURE_2D, mip);
+			glViewport(0, 0, mipSize.x, mipSize.y);
+			Renderer::DrawNdcPlane();
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_MipCount - 1);
+
+		m_Framebuffer.SetColorAttachment(0, GL_TEXTURE_2D);
+		m_Framebuffer.Unbind();
+		m_GLCache->SetDepthTest(true);
+	}
+}
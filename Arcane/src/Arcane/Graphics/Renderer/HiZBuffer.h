@@ -0,0 +1,40 @@
+#pragma once
+#ifndef HIZBUFFER_H
+#define HIZBUFFER_H
+
+#ifndef FRAMEBUFFER_H
+#include <Arcane/Platform/OpenGL/Framebuffer/Framebuffer.h>
+#endif
+
+namespace Arcane
+{
+	class Shader;
+	class GLCache;
+
+	// Hierarchical depth pyramid built from a depth buffer, every texel stores the closest (r) and furthest (g) depth of the area of the screen it covers.
+	// Ray marches and occlusion tests walk the coarser mips so they can step over large parts of the screen with a single texel fetch
+	class HiZBuffer
+	{
+	public:
+		HiZBuffer(unsigned int width, unsigned int height);
+		~HiZBuffer();
+
+		// Depth texture should be the same resolution as the pyramid's base mip. Only the bottom left width x height of it is reduced (dynamic resolution),
+		// every mip below covers the same part of the screen and is floor(size / 2) of the one above it
+		void Build(Texture *depthTexture, unsigned int width, unsigned int height);
+
+		inline Texture* GetTexture() { return &m_PyramidTexture; }
+		inline unsigned int GetMipCount() const { return m_MipCount; }
+		inline glm::ivec2 GetBaseSize() const { return m_BaseSize; } // Size of the part of the base mip built by the last Build
+
+	private:
+		GLCache *m_GLCache;
+		Shader *m_DownsampleShader;
+
+		Framebuffer m_Framebuffer; // Every mip is attached to this framebuffer in turn while it is rendered
+		Texture m_PyramidTexture;
+		unsigned int m_MipCount;
+		glm::ivec2 m_BaseSize;
+	};
+}
+#endif
@@ -0,0 +1,180 @@
+#include "arcpch.h"
+#include "HiZOcclusionCuller.h"
+
+#include <Arcane/Graphics/Renderer/HiZBuffer.h>
+
+namespace Arcane
+{
+	HiZOcclusionCuller::HiZOcclusionCuller() : m_NextReadback(0), m_ViewProjection(1.0f), m_BaseSize(0, 0), m_ReadbackMip(0) {}
+
+	HiZOcclusionCuller::~HiZOcclusionCuller()
+	{
+		for (int i = 0; i < s_ReadbackCount; i++)
+		{
+			if (m_Readbacks[i].Fence)
+				glDeleteSync(m_Readbacks[i].Fence);
+			if (m_Readbacks[i].PixelBuffer)
+				glDeleteBuffers(1, &m_Readbacks[i].PixelBuffer);
+		}
+	}
+
+	void HiZOcclusionCuller::QueueReadback(HiZBuffer *hiZBuffer, const glm::mat4 &viewProjection)
+	{
+		// If the GPU still hasn't finished the oldest readback then this frame's is skipped, the culling will just use older depth for a little longer
+		Readback &readback = m_Readbacks[m_NextReadback];
+		if (readback.Fence)
+			return;
+
+		// Read back the first mip that is small enough to be cheap to copy and walk on the CPU. The whole mip is copied but only the part that was built (dynamic resolution) is used
+		Texture *pyramid = hiZBuffer->GetTexture();
+		readback.BaseSize = hiZBuffer->GetBaseSize();
+		readback.Mip = 0;
+		while (readback.Mip + 1 < static_cast<int>(hiZBuffer->GetMipCount()) && (readback.BaseSize.x >> readback.Mip) > OCCLUSION_CULLING_READBACK_MAX_WIDTH)
+			readback.Mip++;
+		readback.Size = glm::max(readback.BaseSize >> readback.Mip, glm::ivec2(1, 1));
+		readback.MipSize = glm::max(glm::ivec2(pyramid->GetWidth(), pyramid->GetHeight()) >> readback.Mip, glm::ivec2(1, 1));
+		readback.ViewProjection = viewProjection;
+
+		if (!readback.PixelBuffer)
+			glGenBuffers(1, &readback.PixelBuffer);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.PixelBuffer);
+		unsigned int requiredSize = readback.MipSize.x * readback.MipSize.y * 2 * sizeof(float);
+		if (readback.BufferSize < requiredSize)
+		{
+			glBufferData(GL_PIXEL_PACK_BUFFER, requiredSize, nullptr, GL_STREAM_READ);
+			readback.BufferSize = requiredSize;
+		}
+
+		// With a pack buffer bound the copy is queued on the GPU instead of being returned immediately
+		pyramid->Bind();
+		glGetTexImage(GL_TEXTURE_2D, readback.Mip, GL_RG, GL_FLOAT, nullptr);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		readback.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_NextReadback = (m_NextReadback + 1) % s_ReadbackCount;
+	}
+
+	void HiZOcclusionCuller::Update()
+	{
+		// Walk from the oldest readback to the newest so the most recent finished one ends up being used
+		for (int i = 0; i < s_ReadbackCount; i++)
+		{
+			Readback &readback = m_Readbacks[(m_NextReadback + i) % s_ReadbackCount];
+			if (!readback.Fence)
+				continue;
+
+			GLenum status = glClientWaitSync(readback.Fence, 0, 0);
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+				break; // Newer readbacks can't have finished before this one
+
+			glDeleteSync(readback.Fence);
+			readback.Fence = nullptr;
+
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.PixelBuffer);
+			const float *minMaxDepthData = static_cast<const float*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, readback.MipSize.x * readback.MipSize.y * 2 * sizeof(float), GL_MAP_READ_BIT));
+			if (minMaxDepthData)
+			{
+				BuildDepthMips(minMaxDepthData, readback.Size.x, readback.Size.y, readback.MipSize.x);
+				glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+				m_ViewProjection = readback.ViewProjection;
+				m_BaseSize = readback.BaseSize;
+				m_ReadbackMip = readback.Mip;
+			}
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		}
+	}
+
+	bool HiZOcclusionCuller::IsOccluded(const glm::mat4 &transform, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax) const
+	{
+		if (m_FurthestDepthMips.empty())
+			return false;
+
+		// Find the box's screen space rectangle and closest depth as it would have been seen when the pyramid was rendered
+		glm::mat4 modelViewProjection = m_ViewProjection * transform;
+		glm::vec2 screenMin(1.0f), screenMax(0.0f);
+		float closestDepth = 1.0f;
+		for (int corner = 0; corner < 8; corner++)
+		{
+			glm::vec4 clipCorner = modelViewProjection * glm::vec4((corner & 1) ? boundsMax.x : boundsMin.x, (corner & 2) ? boundsMax.y : boundsMin.y, (corner & 4) ? boundsMax.z : boundsMin.z, 1.0f);
+			if (clipCorner.w <= 0.0f || clipCorner.z < -clipCorner.w)
+				return false;
+
+			glm::vec3 ndcCorner = glm::vec3(clipCorner) / clipCorner.w;
+			glm::vec2 screenCorner = glm::vec2(ndcCorner) * 0.5f + 0.5f;
+			screenMin = glm::min(screenMin, screenCorner);
+			screenMax = glm::max(screenMax, screenCorner);
+			closestDepth = glm::min(closestDepth, ndcCorner.z * 0.5f + 0.5f);
+		}
+
+		// Anything that was off screen has no depth to be tested against
+		if (screenMin.x < 0.0f || screenMin.y < 0.0f || screenMax.x > 1.0f || screenMax.y > 1.0f)
+			return false;
+
+		// The GPU pyramid folds odd rows/columns into the last texel of the next mip, so texels are found by halving and clamping the same way
+		glm::ivec2 minTexel = glm::min(glm::ivec2(screenMin * glm::vec2(m_BaseSize)), m_BaseSize - 1) >> m_ReadbackMip;
+		glm::ivec2 maxTexel = glm::min(glm::ivec2(screenMax * glm::vec2(m_BaseSize)), m_BaseSize - 1) >> m_ReadbackMip;
+		minTexel = glm::min(minTexel, m_MipSizes[0] - 1);
+		maxTexel = glm::min(maxTexel, m_MipSizes[0] - 1);
+
+		// Move down the pyramid until the rectangle only touches a couple of texels in each direction
+		int mip = 0;
+		while (mip + 1 < static_cast<int>(m_FurthestDepthMips.size()) && (maxTexel.x - minTexel.x > 1 || maxTexel.y - minTexel.y > 1))
+		{
+			mip++;
+			minTexel = glm::min(minTexel >> 1, m_MipSizes[mip] - 1);
+			maxTexel = glm::min(maxTexel >> 1, m_MipSizes[mip] - 1);
+		}
+
+		const std::vector<float> &furthestDepth = m_FurthestDepthMips[mip];
+		int mipWidth = m_MipSizes[mip].x;
+		for (int y = minTexel.y; y <= maxTexel.y; y++)
+		{
+			for (int x = minTexel.x; x <= maxTexel.x; x++)
+			{
+				if (closestDepth <= furthestDepth[y * mipWidth + x])
+					return false;
+			}
+		}
+		return true;
+	}
+
+	void HiZOcclusionCuller::BuildDepthMips(const float *minMaxDepthData, int width, int height, int rowStride)
+	{
+		m_FurthestDepthMips.clear();
+		m_MipSizes.clear();
+
+		// Only the furthest depth (g) is needed, a box is hidden if it's closest point is behind the furthest depth of everything it covers
+		std::vector<float> baseMip(width * height);
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				baseMip[y * width + x] = minMaxDepthData[(y * rowStride + x) * 2 + 1];
+			}
+		}
+		m_FurthestDepthMips.push_back(std::move(baseMip));
+		m_MipSizes.push_back(glm::ivec2(width, height));
+
+		while (width > 1 || height > 1)
+		{
+			int nextWidth = glm::max(width >> 1, 1), nextHeight = glm::max(height >> 1, 1);
+			std::vector<float> nextMip(nextWidth * nextHeight, 0.0f);
+			const std::vector<float> &previousMip = m_FurthestDepthMips.back();
+			for (int y = 0; y < height; y++)
+			{
+				int nextY = glm::min(y >> 1, nextHeight - 1);
+				for (int x = 0; x < width; x++)
+				{
+					float &nextTexel = nextMip[nextY * nextWidth + glm::min(x >> 1, nextWidth - 1)];
+					nextTexel = glm::max(nextTexel, previousMip[y * width + x]);
+				}
+			}
+
+			m_FurthestDepthMips.push_back(std::move(nextMip));
+			m_MipSizes.push_back(glm::ivec2(nextWidth, nextHeight));
+			width = nextWidth;
+			height = nextHeight;
+		}
+	}
+}
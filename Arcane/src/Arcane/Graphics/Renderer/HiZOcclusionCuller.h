@@ -0,0 +1,59 @@
+#pragma once
+#ifndef HIZOCCLUSIONCULLER_H
+#define HIZOCCLUSIONCULLER_H
+
+#ifndef IOCCLUSIONCULLER_H
+#include <Arcane/Graphics/Renderer/IOcclusionCuller.h>
+#endif
+
+namespace Arcane
+{
+	class HiZBuffer;
+
+	// Culls meshes that were hidden in a previous frame's depth pyramid. A coarse mip of the pyramid is copied into a pixel buffer after it is built and only read on the CPU
+	// once the GPU has signalled the copy is finished, so culling never waits on the GPU. The boxes are projected with the view projection the pyramid was rendered with,
+	// which makes the results a frame or two late but never wrong for anything that was on screen (anything that wasn't is never culled)
+	class HiZOcclusionCuller : public IOcclusionCuller
+	{
+	public:
+		HiZOcclusionCuller();
+		virtual ~HiZOcclusionCuller() override;
+
+		// Should be called once the pyramid has been built for the frame, viewProjection is the camera the depth was rendered with
+		void QueueReadback(HiZBuffer *hiZBuffer, const glm::mat4 &viewProjection);
+
+		// Picks up any readbacks that the GPU has finished, never blocks
+		void Update();
+
+		// Tests a model space bounding box, boxes crossing the near plane or leaving the screen are always treated as visible
+		virtual bool IsOccluded(const glm::mat4 &transform, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax) const override;
+
+		inline bool HasDepth() const { return !m_FurthestDepthMips.empty(); }
+	private:
+		void BuildDepthMips(const float *minMaxDepthData, int width, int height, int rowStride);
+	private:
+		static const int s_ReadbackCount = 3; // Enough for the GPU to be a couple of frames behind without a readback being skipped
+
+		struct Readback
+		{
+			unsigned int PixelBuffer = 0;
+			unsigned int BufferSize = 0;
+			GLsync Fence = nullptr;
+			glm::mat4 ViewProjection;
+			glm::ivec2 BaseSize;
+			glm::ivec2 Size; // Part of the read back mip that was built
+			glm::ivec2 MipSize;
+			int Mip = 0;
+		};
+		Readback m_Readbacks[s_ReadbackCount];
+		int m_NextReadback; // Also the oldest readback that may still be in flight
+
+		// CPU side pyramid of the furthest depth built from the most recent finished readback, mip 0 is the mip that was read back from the GPU
+		std::vector<std::vector<float>> m_FurthestDepthMips;
+		std::vector<glm::ivec2> m_MipSizes;
+		glm::mat4 m_ViewProjection;
+		glm::ivec2 m_BaseSize;
+		int m_ReadbackMip;
+	};
+}
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+#ifndef IOCCLUSIONCULLER_H
+#define IOCCLUSIONCULLER_H
+
+namespace Arcane
+{
+	// Anything that can tell the renderer a mesh is hidden, see Renderer::BeginOcclusionCulling
+	class IOcclusionCuller
+	{
+	public:
+		virtual ~IOcclusionCuller() {}
+
+		// Tests a model space bounding box placed in the world by transform, should only return true if the box is definitely hidden
+		virtual bool IsOccluded(const glm::mat4 &transform, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax) const = 0;
+	};
+}
+#endif
@@ -0,0 +1,192 @@
+#include "arcpch.h"
+#include "RenderGraph.h"
+
+#ifdef ARC_DEV_BUILD
+#include <Arcane/Platform/OpenGL/GPUTimerManager.h>
+#endif
+
+namespace Arcane
+{
+	RenderGraph::RenderGraph() {}
+
+	RenderGraph::~RenderGraph() {}
+
+	void RenderGraph::Reset()
+	{
+		m_Nodes.clear();
+		m_Transients.clear();
+		m_Outputs.clear();
+	}
+
+	void RenderGraph::DeclareTransient(const std::string &name, const RenderTargetDesc &desc)
+	{
+		m_Transients[name] = { desc, -1, -1, nullptr };
+	}
+
+	RenderGraphNode& RenderGraph::AddNode(const std::string &name, const std::function<void()> &execute, bool enabled)
+	{
+		RenderGraphNode node;
+		node.Name = name;
+		node.Execute = execute;
+		node.Enabled = enabled;
+		node.HasSideEffects = false;
+		node.Culled = false;
+
+		m_Nodes.push_back(node);
+		return m_Nodes.back();
+	}
+
+	void RenderGraph::MarkOutput(const std::string &resource)
+	{
+		m_Outputs.push_back(resource);
+	}
+
+	void RenderGraph::Execute()
+	{
+		CullNodes();
+		AllocateTransients();
+
+		for (RenderGraphNode &node : m_Nodes)
+		{
+			if (node.Culled)
+				continue;
+
+#ifdef ARC_DEV_BUILD
+			auto iter = m_NodeTimers.find(node.Name);
+			if (iter == m_NodeTimers.end())
+				iter = m_NodeTimers.emplace(node.Name, GPUTimerManager::CreateGPUTimer(node.Name + " (GPU)")).first;
+
+			GPUTimerManager::BeginQuery(iter->second);
+			node.Execute();
+			GPUTimerManager::EndQuery(iter->second);
+#else
+			node.Execute();
+#endif
+		}
+	}
+
+	Framebuffer* RenderGraph::GetTransient(const std::string &name)
+	{
+		auto iter = m_Transients.find(name);
+		ARC_ASSERT(iter != m_Transients.end() && iter->second.Target, "Render graph transient was never declared or no executing node uses it");
+		if (iter == m_Transients.end())
+			return nullptr;
+		return iter->second.Target;
+	}
+
+	// Walks the nodes backwards keeping track of which resources are still needed by a later node. A node only survives if it's enabled and writes one of them (or has side effects),
+	// a node that reads what it writes (ie draws on top of the lit scene) leaves that resource needed so the node that produced it before survives too
+	void RenderGraph::CullNodes()
+	{
+		std::unordered_set<std::string> neededResources(m_Outputs.begin(), m_Outputs.end());
+
+		m_Stats.NodeCount = static_cast<unsigned int>(m_Nodes.size());
+		m_Stats.CulledNodeCount = 0;
+		m_CulledNodes.clear();
+		for (auto node = m_Nodes.rbegin(); node != m_Nodes.rend(); ++node)
+		{
+			bool isNeeded = node->HasSideEffects;
+			for (const std::string &resource : node->Writes)
+			{
+				isNeeded |= neededResources.find(resource) != neededResources.end();
+			}
+
+			node->Culled = !node->Enabled || !isNeeded;
+			m_CulledNodes[node->Name] = node->Culled;
+			if (node->Culled)
+			{
+				m_Stats.CulledNodeCount++;
+				continue;
+			}
+
+			for (const std::string &resource : node->Writes)
+			{
+				if (std::find(node->Reads.begin(), node->Reads.end(), resource) == node->Reads.end())
+					neededResources.erase(resource);
+			}
+			for (const std::string &resource : node->Reads)
+			{
+				neededResources.insert(resource);
+			}
+		}
+	}
+
+	// A transient lives from the first node that uses it to the last one, once it's last node is done it's framebuffer can be given to any later transient of the same description
+	void RenderGraph::AllocateTransients()
+	{
+		for (int i = 0; i < static_cast<int>(m_Nodes.size()); i++)
+		{
+			const RenderGraphNode &node = m_Nodes[i];
+			if (node.Culled)
+				continue;
+
+			auto markUse = [&](const std::string &resource)
+			{
+				auto iter = m_Transients.find(resource);
+				if (iter == m_Transients.end())
+					return;
+
+				Transient &transient = iter->second;
+				if (transient.FirstUse == -1)
+					transient.FirstUse = i;
+				transient.LastUse = i;
+			};
+			for (const std::string &resource : node.Reads)
+				markUse(resource);
+			for (const std::string &resource : node.Writes)
+				markUse(resource);
+		}
+
+		m_LeasedTargets.clear();
+		m_Stats.TransientCount = 0;
+		m_Stats.RequestedBytes = 0;
+		for (int i = 0; i < static_cast<int>(m_Nodes.size()); i++)
+		{
+			for (auto &[name, transient] : m_Transients)
+			{
+				if (transient.FirstUse != i)
+					continue;
+
+				LeasedTarget *match = nullptr;
+				for (LeasedTarget &leasedTarget : m_LeasedTargets)
+				{
+					if (!leasedTarget.InUse && leasedTarget.Desc == transient.Desc)
+					{
+						match = &leasedTarget;
+						break;
+					}
+				}
+				if (!match)
+				{
+					m_LeasedTargets.push_back({ transient.Desc, RenderTargetPool::AcquireForFrame(transient.Desc), false });
+					match = &m_LeasedTargets.back();
+				}
+
+				match->InUse = true;
+				transient.Target = match->Target;
+
+				m_Stats.TransientCount++;
+				m_Stats.RequestedBytes += RenderTargetPool::GetSizeBytes(transient.Desc);
+			}
+
+			for (auto &[name, transient] : m_Transients)
+			{
+				if (transient.LastUse != i)
+					continue;
+
+				for (LeasedTarget &leasedTarget : m_LeasedTargets)
+				{
+					if (leasedTarget.Target == transient.Target)
+						leasedTarget.InUse = false;
+				}
+			}
+		}
+
+		m_Stats.PhysicalTargetCount = static_cast<unsigned int>(m_LeasedTargets.size());
+		m_Stats.AllocatedBytes = 0;
+		for (const LeasedTarget &leasedTarget : m_LeasedTargets)
+		{
+			m_Stats.AllocatedBytes += RenderTargetPool::GetSizeBytes(leasedTarget.Desc);
+		}
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#ifndef RENDERGRAPH_H
+#define RENDERGRAPH_H
+
+#include <deque>
+
+#ifndef RENDERTARGETPOOL_H
+#include <Arcane/Graphics/Renderer/RenderTargetPool.h>
+#endif
+
+namespace Arcane
+{
+	class GPUTimer;
+
+	struct RenderGraphNode
+	{
+		std::string Name;
+		std::function<void()> Execute;
+		std::vector<std::string> Reads, Writes;
+		bool Enabled;
+		bool HasSideEffects; // Never culled, ie it writes something outside of the graph (the swapchain, buffers read next frame)
+		bool Culled;
+
+		inline RenderGraphNode& Read(const std::string &resource) { Reads.push_back(resource); return *this; }
+		inline RenderGraphNode& Write(const std::string &resource) { Writes.push_back(resource); return *this; }
+		inline RenderGraphNode& SetHasSideEffects() { HasSideEffects = true; return *this; }
+	};
+
+	struct RenderGraphStats
+	{
+		unsigned int NodeCount = 0, CulledNodeCount = 0;
+		unsigned int TransientCount = 0, PhysicalTargetCount = 0;
+		size_t RequestedBytes = 0; // What the transients would take if each had it's own framebuffer
+		size_t AllocatedBytes = 0; // What the framebuffers they were given actually take
+	};
+
+	// The frame is described every frame as a list of nodes in execution order, along with the named resources each node reads and writes. The data itself is still passed
+	// between the node functions as usual, the names are only used to find out what depends on what. Before anything executes, disabled nodes and nodes whose writes are never
+	// read by a later node (or the graph's outputs) are culled, then every transient is given a framebuffer for the span of nodes that use it. Transients with the same description
+	// whose spans don't overlap share a framebuffer, which is leased from the render target pool for the frame
+	class RenderGraph
+	{
+	public:
+		RenderGraph();
+		~RenderGraph();
+
+		void Reset(); // Clears the nodes so the next frame's graph can be described
+		void DeclareTransient(const std::string &name, const RenderTargetDesc &desc);
+		RenderGraphNode& AddNode(const std::string &name, const std::function<void()> &execute, bool enabled = true); // The node can be held and configured until the graph is reset
+		void MarkOutput(const std::string &resource);
+		void Execute();
+
+		Framebuffer* GetTransient(const std::string &name); // Only valid while a node that reads or writes it is executing
+
+		inline const RenderGraphStats& GetStats() const { return m_Stats; }
+		inline bool IsNodeCulled(const std::string &nodeName) const { auto iter = m_CulledNodes.find(nodeName); return iter != m_CulledNodes.end() && iter->second; }
+	private:
+		void CullNodes();
+		void AllocateTransients();
+	private:
+		struct Transient
+		{
+			RenderTargetDesc Desc;
+			int FirstUse, LastUse; // Node indices, -1 if no node that executes uses it
+			Framebuffer *Target;
+		};
+		struct LeasedTarget
+		{
+			RenderTargetDesc Desc;
+			Framebuffer *Target;
+			bool InUse;
+		};
+
+		std::deque<RenderGraphNode> m_Nodes; // A deque so the node references AddNode hands out stay valid as more nodes are added
+		std::unordered_map<std::string, Transient> m_Transients;
+		std::vector<std::string> m_Outputs;
+		std::vector<LeasedTarget> m_LeasedTargets; // This frame's, the pool gives the same framebuffers back every frame as long as the graph's shape doesn't change
+
+		std::unordered_map<std::string, bool> m_CulledNodes; // Result of the last executed graph, for the editor
+		RenderGraphStats m_Stats;
+
+#ifdef ARC_DEV_BUILD
+		std::unordered_map<std::string, GPUTimer*> m_NodeTimers; // Created the first time a node executes, so every node shows up with the other timers
+#endif
+	};
+}
+#endif
@@ -0,0 +1,170 @@
+#include "arcpch.h"
+#include "RenderTargetPool.h"
+
+namespace Arcane
+{
+	std::vector<RenderTargetPool::PooledTarget> RenderTargetPool::s_Targets;
+	uint64_t RenderTargetPool::s_FrameIndex = 0;
+	RenderTargetPoolStats RenderTargetPool::s_Stats;
+	unsigned int RenderTargetPool::s_CreatedThisFrame = 0, RenderTargetPool::s_DestroyedThisFrame = 0;
+
+	void RenderTargetPool::Shutdown()
+	{
+		for (PooledTarget &pooledTarget : s_Targets)
+		{
+			delete pooledTarget.Target;
+		}
+		s_Targets.clear();
+		s_Stats = RenderTargetPoolStats();
+	}
+
+	void RenderTargetPool::EndOfFrameUpdate()
+	{
+		for (PooledTarget &pooledTarget : s_Targets)
+		{
+			if (pooledTarget.Leased)
+				pooledTarget.LastUsedFrame = s_FrameIndex;
+			if (pooledTarget.FrameLease)
+			{
+				pooledTarget.Leased = false;
+				pooledTarget.FrameLease = false;
+			}
+		}
+
+		// Only a framebuffer nothing has asked for in a while is deleted, so switching between a couple of resolutions or passes that run every few frames doesn't cause any churn
+		for (auto iter = s_Targets.begin(); iter != s_Targets.end();)
+		{
+			if (!iter->Leased && s_FrameIndex - iter->LastUsedFrame > RENDER_TARGET_POOL_IDLE_FRAMES)
+			{
+				delete iter->Target;
+				iter = s_Targets.erase(iter);
+				s_DestroyedThisFrame++;
+			}
+			else
+			{
+				++iter;
+			}
+		}
+
+		s_Stats.TargetCount = static_cast<unsigned int>(s_Targets.size());
+		s_Stats.LeasedCount = 0;
+		s_Stats.TotalBytes = 0;
+		s_Stats.LeasedBytes = 0;
+		for (const PooledTarget &pooledTarget : s_Targets)
+		{
+			size_t bytes = GetSizeBytes(pooledTarget.Desc);
+			s_Stats.TotalBytes += bytes;
+			if (pooledTarget.Leased)
+			{
+				s_Stats.LeasedCount++;
+				s_Stats.LeasedBytes += bytes;
+			}
+		}
+		s_Stats.CreatedLastFrame = s_CreatedThisFrame;
+		s_Stats.DestroyedLastFrame = s_DestroyedThisFrame;
+		s_CreatedThisFrame = 0;
+		s_DestroyedThisFrame = 0;
+
+		s_FrameIndex++;
+	}
+
+	Framebuffer* RenderTargetPool::Acquire(const RenderTargetDesc &desc)
+	{
+		return AcquireInternal(desc)->Target;
+	}
+
+	Framebuffer* RenderTargetPool::AcquireForFrame(const RenderTargetDesc &desc)
+	{
+		PooledTarget *pooledTarget = AcquireInternal(desc);
+		pooledTarget->FrameLease = true;
+		return pooledTarget->Target;
+	}
+
+	void RenderTargetPool::Release(Framebuffer *framebuffer)
+	{
+		if (!framebuffer)
+			return;
+
+		for (PooledTarget &pooledTarget : s_Targets)
+		{
+			if (pooledTarget.Target == framebuffer)
+			{
+				ARC_ASSERT(pooledTarget.Leased && !pooledTarget.FrameLease, "Render target was released but it isn't leased (or it is only leased for the frame)");
+				pooledTarget.Leased = false;
+				pooledTarget.LastUsedFrame = s_FrameIndex;
+				return;
+			}
+		}
+		ARC_ASSERT(false, "Released a framebuffer that didn't come from the render target pool");
+	}
+
+	RenderTargetPool::PooledTarget* RenderTargetPool::AcquireInternal(const RenderTargetDesc &desc)
+	{
+		for (PooledTarget &pooledTarget : s_Targets)
+		{
+			if (!pooledTarget.Leased && pooledTarget.Desc == desc)
+			{
+				pooledTarget.Leased = true;
+				pooledTarget.LastUsedFrame = s_FrameIndex;
+				return &pooledTarget;
+			}
+		}
+
+		s_Targets.push_back({ desc, CreateTarget(desc), true, false, s_FrameIndex });
+		s_CreatedThisFrame++;
+		return &s_Targets.back();
+	}
+
+	Framebuffer* RenderTargetPool::CreateTarget(const RenderTargetDesc &desc)
+	{
+		Framebuffer *framebuffer = new Framebuffer(desc.Width, desc.Height, desc.Multisampled);
+		if (desc.HasColour)
+			framebuffer->AddColorTexture(desc.ColourFormat);
+
+		switch (desc.DepthType)
+		{
+		case RenderTargetDepthType::RenderTargetDepthType_Texture:
+			framebuffer->AddDepthStencilTexture(desc.DepthFormat, desc.DepthBilinearFiltering);
+			break;
+		case RenderTargetDepthType::RenderTargetDepthType_TextureArray:
+			framebuffer->AddDepthStencilTextureArray(desc.DepthFormat, desc.DepthLayerCount, desc.DepthBilinearFiltering);
+			break;
+		case RenderTargetDepthType::RenderTargetDepthType_RBO:
+			framebuffer->AddDepthStencilRBO(desc.DepthFormat);
+			break;
+		case RenderTargetDepthType::RenderTargetDepthType_None:
+			break;
+		}
+
+		framebuffer->CreateFramebuffer();
+		return framebuffer;
+	}
+
+	// Estimate of what the driver allocates, depth without stencil is assumed to be stored in 32 bits
+	size_t RenderTargetPool::GetSizeBytes(const RenderTargetDesc &desc)
+	{
+		size_t colourBytesPerPixel = 0;
+		if (desc.HasColour)
+		{
+			switch (desc.ColourFormat)
+			{
+			case NormalizedSingleChannel8: colourBytesPerPixel = 1; break;
+			case Normalized8: colourBytesPerPixel = 4; break;
+			case Normalized16: colourBytesPerPixel = 8; break;
+			case FloatingPoint16: colourBytesPerPixel = 8; break;
+			case FloatingPoint32: colourBytesPerPixel = 16; break;
+			}
+		}
+
+		size_t depthBytesPerPixel = 0;
+		if (desc.DepthType != RenderTargetDepthType::RenderTargetDepthType_None)
+		{
+			depthBytesPerPixel = desc.DepthFormat == FloatingPointDepthStencil ? 8 : 4;
+			if (desc.DepthType == RenderTargetDepthType::RenderTargetDepthType_TextureArray)
+				depthBytesPerPixel *= desc.DepthLayerCount;
+		}
+
+		size_t sampleCount = desc.Multisampled ? MSAA_SAMPLE_AMOUNT : 1;
+		return static_cast<size_t>(desc.Width) * static_cast<size_t>(desc.Height) * (colourBytesPerPixel + depthBytesPerPixel) * sampleCount;
+	}
+}
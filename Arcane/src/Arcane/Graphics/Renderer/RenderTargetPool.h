@@ -0,0 +1,82 @@
+#pragma once
+#ifndef RENDERTARGETPOOL_H
+#define RENDERTARGETPOOL_H
+
+#ifndef FRAMEBUFFER_H
+#include <Arcane/Platform/OpenGL/Framebuffer/Framebuffer.h>
+#endif
+
+namespace Arcane
+{
+	enum class RenderTargetDepthType : int
+	{
+		RenderTargetDepthType_None,
+		RenderTargetDepthType_Texture,
+		RenderTargetDepthType_TextureArray, // Layered, a layer per shadow cascade
+		RenderTargetDepthType_RBO
+	};
+
+	// Everything that decides what a framebuffer is created with, any framebuffer in the pool with an equal description can be handed out for it
+	struct RenderTargetDesc
+	{
+		unsigned int Width = 0, Height = 0;
+		bool Multisampled = false;
+
+		bool HasColour = false;
+		ColorAttachmentFormat ColourFormat = FloatingPoint16;
+
+		RenderTargetDepthType DepthType = RenderTargetDepthType::RenderTargetDepthType_None;
+		DepthStencilAttachmentFormat DepthFormat = NormalizedDepthOnly;
+		unsigned int DepthLayerCount = 1; // Only used by texture array depth
+		bool DepthBilinearFiltering = false;
+
+		inline bool operator==(const RenderTargetDesc &other) const
+		{
+			return Width == other.Width && Height == other.Height && Multisampled == other.Multisampled && HasColour == other.HasColour && (!HasColour || ColourFormat == other.ColourFormat) &&
+				DepthType == other.DepthType && (DepthType == RenderTargetDepthType::RenderTargetDepthType_None || (DepthFormat == other.DepthFormat && DepthLayerCount == other.DepthLayerCount && DepthBilinearFiltering == other.DepthBilinearFiltering));
+		}
+	};
+
+	struct RenderTargetPoolStats
+	{
+		unsigned int TargetCount = 0, LeasedCount = 0;
+		size_t TotalBytes = 0, LeasedBytes = 0;
+		unsigned int CreatedLastFrame = 0, DestroyedLastFrame = 0; // Both stay at zero once the renderer has reached a steady state
+	};
+
+	// Every framebuffer that isn't tied to a single pass for the whole session is leased from here by it's description instead of being created and deleted by the feature that uses it.
+	// Released framebuffers are kept for any later request with the same description (another pass, or the same one going back to a previous resolution) and only deleted once
+	// they have gone unused for RENDER_TARGET_POOL_IDLE_FRAMES. Anything that changes a leased framebuffer's attachments has to restore them before releasing it
+	class RenderTargetPool
+	{
+	public:
+		static void Shutdown();
+
+		static void EndOfFrameUpdate(); // Returns the frame leases and trims idle framebuffers
+
+		// Acquire is kept until it's released, AcquireForFrame is returned to the pool automatically at the end of the frame
+		static Framebuffer* Acquire(const RenderTargetDesc &desc);
+		static Framebuffer* AcquireForFrame(const RenderTargetDesc &desc);
+		static void Release(Framebuffer *framebuffer);
+
+		static inline const RenderTargetPoolStats& GetStats() { return s_Stats; }
+		static size_t GetSizeBytes(const RenderTargetDesc &desc);
+	private:
+		struct PooledTarget
+		{
+			RenderTargetDesc Desc;
+			Framebuffer *Target;
+			bool Leased, FrameLease;
+			uint64_t LastUsedFrame;
+		};
+
+		static PooledTarget* AcquireInternal(const RenderTargetDesc &desc);
+		static Framebuffer* CreateTarget(const RenderTargetDesc &desc);
+	private:
+		static std::vector<PooledTarget> s_Targets;
+		static uint64_t s_FrameIndex;
+		static RenderTargetPoolStats s_Stats;
+		static unsigned int s_CreatedThisFrame, s_DestroyedThisFrame;
+	};
+}
+#endif
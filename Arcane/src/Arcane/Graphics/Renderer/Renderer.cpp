@@ -8,6 +8,10 @@
 #include <Arcane/Graphics/Mesh/Common/Quad.h>
 #include <Arcane/Graphics/Camera/ICamera.h>
 #include <Arcane/Animation/PoseAnimator.h>
+#include <Arcane/Graphics/IBL/ProbeManager.h>
+#include <Arcane/Graphics/Renderer/IOcclusionCuller.h>
+#include <Arcane/Graphics/Mesh/GeometryArena.h>
+#include <Arcane/Graphics/Mesh/MaterialBuffer.h>
 
 namespace Arcane
 {
@@ -20,9 +24,26 @@ namespace Arcane
 	std::deque<MeshDrawCallInfo> Renderer::s_TransparentMeshDrawCallQueue;
 	std::deque<MeshDrawCallInfo> Renderer::s_TransparentSkinnedMeshDrawCallQueue;
 	std::deque<QuadDrawCallInfo> Renderer::s_QuadDrawCallQueue;
+	std::vector<glm::mat4> Renderer::s_CullingLayers;
+	bool Renderer::s_CullingLayersNearPlane = true;
+	bool Renderer::s_CaptureCullingActive = false;
+	Renderer::CaptureCullingData Renderer::s_CaptureCulling = {};
+	ProbeManager* Renderer::s_ProbeSelectionManager = nullptr;
+	const IOcclusionCuller* Renderer::s_OcclusionCuller = nullptr;
+	bool Renderer::s_MotionVectorsActive = false;
+	glm::mat4 Renderer::s_MotionViewProjection(1.0f);
+	glm::mat4 Renderer::s_MotionPreviousViewProjection(1.0f);
+	bool Renderer::s_MultiDrawIndirectActive = false;
+	unsigned int Renderer::s_IndirectCommandBuffer = 0;
+	unsigned int Renderer::s_IndirectDrawDataBuffer = 0;
+	std::vector<Renderer::IndirectDraw> Renderer::s_IndirectDraws;
+	std::vector<Renderer::DrawElementsIndirectCommand> Renderer::s_IndirectCommands;
+	std::vector<Renderer::IndirectDrawData> Renderer::s_IndirectDrawData;
 	unsigned int Renderer::m_CurrentDrawCallCount = 0;
 	unsigned int Renderer::m_CurrentMeshesDrawnCount = 0;
 	unsigned int Renderer::m_CurrentQuadsDrawnCount = 0;
+	unsigned int Renderer::m_CurrentMeshesOccludedCount = 0;
+	unsigned int Renderer::m_CurrentIndirectMeshesDrawnCount = 0;
 
 	void Renderer::Init()
 	{
@@ -35,11 +56,26 @@ namespace Arcane
 
 		s_NdcPlane = new Quad();
 		s_NdcCube = new Cube();
+
+		// Re-filled for every chunk of a multi-draw indirect flush
+		glGenBuffers(1, &s_IndirectCommandBuffer);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, s_IndirectCommandBuffer);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, RENDERER_MAX_INDIRECT_DRAWS * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+		glGenBuffers(1, &s_IndirectDrawDataBuffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, s_IndirectDrawDataBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, RENDERER_MAX_INDIRECT_DRAWS * sizeof(IndirectDrawData), nullptr, GL_STREAM_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+		MaterialBuffer::Init();
 	}
 
 	void Renderer::Shutdown()
 	{
-
+		glDeleteBuffers(1, &s_IndirectCommandBuffer);
+		glDeleteBuffers(1, &s_IndirectDrawDataBuffer);
+		MaterialBuffer::Shutdown();
 	}
 
 	void Renderer::BeginFrame()
@@ -47,6 +83,10 @@ namespace Arcane
 		m_CurrentDrawCallCount = 0;
 		m_CurrentMeshesDrawnCount = 0;
 		m_CurrentQuadsDrawnCount = 0;
+		m_CurrentMeshesOccludedCount = 0;
+		m_CurrentIndirectMeshesDrawnCount = 0;
+
+		MaterialBuffer::BeginFrame();
 	}
 
 	void Renderer::EndFrame()
@@ -54,6 +94,8 @@ namespace Arcane
 		s_RendererData.DrawCallCount = m_CurrentDrawCallCount;
 		s_RendererData.MeshesDrawnCount = m_CurrentMeshesDrawnCount;
 		s_RendererData.QuadsDrawnCount = m_CurrentQuadsDrawnCount;
+		s_RendererData.MeshesOccludedCount = m_CurrentMeshesOccludedCount;
+		s_RendererData.IndirectMeshesDrawnCount = m_CurrentIndirectMeshesDrawnCount;
 	}
 
 	void Renderer::QueueQuad(const glm::vec3 &position, const glm::vec2 &size, const Texture *texture)
@@ -67,28 +109,47 @@ namespace Arcane
 		s_QuadDrawCallQueue.emplace_back(QuadDrawCallInfo{ texture, transform });
 	}
 
-	void Renderer::QueueMesh(Model *model, const glm::mat4 &transform, PoseAnimator *animator/*= nullptr*/, bool isTransparent/*= false*/, bool cullBackface/*= true*/)
+	void Renderer::QueueMesh(Model *model, const glm::mat4 &transform, PoseAnimator *animator/*= nullptr*/, bool isTransparent/*= false*/, bool cullBackface/*= true*/, const glm::mat4 *previousTransform/*= nullptr*/)
 	{
+		// Skinned meshes can animate outside of their bind pose bounds so they are never culled
+		int layerMask = -1;
+		if (!s_CullingLayers.empty() && !animator)
+		{
+			layerMask = CalculateLayerMask(model, transform);
+			if (layerMask == 0)
+				return;
+		}
+		if (s_CaptureCullingActive && !animator && IsCulledByCapture(model, transform))
+		{
+			return;
+		}
+		if (s_OcclusionCuller && !animator && s_OcclusionCuller->IsOccluded(transform, model->GetBoundsMin(), model->GetBoundsMax()))
+		{
+			m_CurrentMeshesOccludedCount++;
+			return;
+		}
+
+		const glm::mat4 &lastTransform = previousTransform ? *previousTransform : transform;
 		if (isTransparent)
 		{
 			if (animator)
 			{
-				s_TransparentSkinnedMeshDrawCallQueue.emplace_back(MeshDrawCallInfo{ model, animator, transform, cullBackface });
+				s_TransparentSkinnedMeshDrawCallQueue.emplace_back(MeshDrawCallInfo{ model, animator, transform, lastTransform, cullBackface, layerMask });
 			}
 			else
 			{
-				s_TransparentMeshDrawCallQueue.emplace_back(MeshDrawCallInfo{ model, nullptr, transform, cullBackface });
+				s_TransparentMeshDrawCallQueue.emplace_back(MeshDrawCallInfo{ model, nullptr, transform, lastTransform, cullBackface, layerMask });
 			}
 		}
 		else
 		{
 			if (animator)
 			{
-				s_OpaqueSkinnedMeshDrawCallQueue.emplace_back(MeshDrawCallInfo{ model, animator, transform, cullBackface });
+				s_OpaqueSkinnedMeshDrawCallQueue.emplace_back(MeshDrawCallInfo{ model, animator, transform, lastTransform, cullBackface, layerMask });
 			}
 			else
 			{
-				s_OpaqueMeshDrawCallQueue.emplace_back(MeshDrawCallInfo{ model, nullptr, transform, cullBackface });
+				s_OpaqueMeshDrawCallQueue.emplace_back(MeshDrawCallInfo{ model, nullptr, transform, lastTransform, cullBackface, layerMask });
 			}
 		}
 	}
@@ -100,6 +161,8 @@ namespace Arcane
 			s_GLCache->SetShader(skinnedShader);
 			BindModelCameraInfo(camera, skinnedShader);
 			SetupOpaqueRenderState();
+			if (renderPassType == MaterialBufferRequired)
+				BindQueuedMaterials(s_OpaqueSkinnedMeshDrawCallQueue, skinnedShader);
 
 			while (!s_OpaqueSkinnedMeshDrawCallQueue.empty())
 			{
@@ -124,6 +187,15 @@ namespace Arcane
 			s_GLCache->SetShader(shader);
 			BindModelCameraInfo(camera, shader);
 			SetupOpaqueRenderState();
+			if (renderPassType == MaterialBufferRequired)
+				BindQueuedMaterials(s_OpaqueMeshDrawCallQueue, shader);
+
+			bool indirectPass = renderPassType == NoMaterialRequired || (renderPassType == MaterialBufferRequired && !s_ProbeSelectionManager);
+			if (s_MultiDrawIndirectActive && indirectPass)
+			{
+				FlushOpaqueNonSkinnedMeshesIndirect(shader, renderPassType);
+				return;
+			}
 
 			while (!s_OpaqueMeshDrawCallQueue.empty())
 			{
@@ -140,6 +212,121 @@ namespace Arcane
 		}
 	}
 
+	void Renderer::FlushOpaqueNonSkinnedMeshesIndirect(Shader *shader, RenderPassType renderPassType)
+	{
+		// Every mesh of every queued model becomes a draw, meshes that aren't in the geometry arena are drawn one at a time like usual
+		s_IndirectDraws.clear();
+		while (!s_OpaqueMeshDrawCallQueue.empty())
+		{
+			MeshDrawCallInfo &current = s_OpaqueMeshDrawCallQueue.front();
+
+			// The normal matrix is only read by passes that shade, so it's only worked out once per model when they need it
+			glm::mat3 normalMatrix(1.0f);
+			if (renderPassType == MaterialBufferRequired)
+				normalMatrix = glm::mat3(glm::transpose(glm::inverse(current.transform)));
+
+			bool modelMatrixBound = false;
+			for (Mesh &mesh : current.model->GetMeshes())
+			{
+				int materialIndex = renderPassType == MaterialBufferRequired ? MaterialBuffer::GetMaterialIndex(mesh.GetMaterial()) : 0;
+
+				const GeometryAllocation &allocation = mesh.GetGeometryAllocation();
+				if (!allocation.IsValid())
+				{
+					if (!modelMatrixBound)
+					{
+						s_GLCache->SetFaceCull(current.cullBackface);
+						SetupModelMatrix(shader, current, renderPassType);
+						modelMatrixBound = true;
+					}
+					if (renderPassType == MaterialBufferRequired)
+						shader->SetUniform("materialIndex", materialIndex);
+					mesh.Draw();
+					m_CurrentDrawCallCount++;
+					continue;
+				}
+
+				IndirectDraw draw;
+				draw.LayoutIndex = allocation.LayoutIndex;
+				draw.CullBackface = current.cullBackface;
+				draw.Command = { allocation.IndexCount, 1, allocation.FirstIndex, static_cast<int>(allocation.BaseVertex), 0 };
+				draw.DrawData.Model = current.transform;
+				draw.DrawData.PreviousModel = current.previousTransform;
+				for (int column = 0; column < 3; column++)
+				{
+					draw.DrawData.NormalMatrix[column] = glm::vec4(normalMatrix[column], 0.0f);
+				}
+				draw.DrawData.LayerMask = current.layerMask;
+				draw.DrawData.MaterialIndex = materialIndex;
+				s_IndirectDraws.push_back(draw);
+			}
+			m_CurrentMeshesDrawnCount++;
+
+			s_OpaqueMeshDrawCallQueue.pop_front();
+		}
+		if (s_IndirectDraws.empty())
+			return;
+
+		// Draws that share a vertex layout and cull mode end up next to each other so each run of them is a single multi-draw
+		std::sort(s_IndirectDraws.begin(), s_IndirectDraws.end(),
+			[](const IndirectDraw &a, const IndirectDraw &b) -> bool
+			{
+				if (a.LayoutIndex != b.LayoutIndex)
+					return a.LayoutIndex < b.LayoutIndex;
+				return a.CullBackface < b.CullBackface;
+			});
+
+		shader->SetUniform("drawIndirect", 1);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, s_IndirectCommandBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, s_IndirectDrawDataBuffer);
+		size_t drawCount = s_IndirectDraws.size();
+		for (size_t chunkStart = 0; chunkStart < drawCount; chunkStart += RENDERER_MAX_INDIRECT_DRAWS)
+		{
+			size_t chunkCount = glm::min(drawCount - chunkStart, static_cast<size_t>(RENDERER_MAX_INDIRECT_DRAWS));
+
+			s_IndirectCommands.clear();
+			s_IndirectDrawData.clear();
+			for (size_t i = 0; i < chunkCount; i++)
+			{
+				const IndirectDraw &draw = s_IndirectDraws[chunkStart + i];
+				s_IndirectCommands.push_back(draw.Command);
+				s_IndirectCommands.back().BaseInstance = static_cast<unsigned int>(i);
+				s_IndirectDrawData.push_back(draw.DrawData);
+			}
+
+			// Orphaned before every upload so the driver doesn't have to wait on the multi-draws still reading the last chunk
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, RENDERER_MAX_INDIRECT_DRAWS * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+			glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, chunkCount * sizeof(DrawElementsIndirectCommand), &s_IndirectCommands[0]);
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, s_IndirectDrawDataBuffer);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, RENDERER_MAX_INDIRECT_DRAWS * sizeof(IndirectDrawData), nullptr, GL_STREAM_DRAW);
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, chunkCount * sizeof(IndirectDrawData), &s_IndirectDrawData[0]);
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+			size_t runStart = 0;
+			while (runStart < chunkCount)
+			{
+				const IndirectDraw &first = s_IndirectDraws[chunkStart + runStart];
+				size_t runEnd = runStart + 1;
+				while (runEnd < chunkCount && s_IndirectDraws[chunkStart + runEnd].LayoutIndex == first.LayoutIndex && s_IndirectDraws[chunkStart + runEnd].CullBackface == first.CullBackface)
+				{
+					runEnd++;
+				}
+
+				s_GLCache->SetFaceCull(first.CullBackface);
+				glBindVertexArray(GeometryArena::GetVertexArray(first.LayoutIndex));
+				glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)(runStart * sizeof(DrawElementsIndirectCommand)), static_cast<GLsizei>(runEnd - runStart), 0);
+				m_CurrentDrawCallCount++;
+
+				runStart = runEnd;
+			}
+		}
+		glBindVertexArray(0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		shader->SetUniform("drawIndirect", 0);
+
+		m_CurrentIndirectMeshesDrawnCount += static_cast<unsigned int>(drawCount);
+	}
+
 	void Renderer::FlushTransparentSkinnedMeshes(ICamera *camera, RenderPassType renderPassType, Shader *skinnedShader)
 	{
 		// Sort from back to front, does not account for rotations, scaling, or animation
@@ -148,6 +335,8 @@ namespace Arcane
 			s_GLCache->SetShader(skinnedShader);
 			BindModelCameraInfo(camera, skinnedShader);
 			SetupTransparentRenderState();
+			if (renderPassType == MaterialBufferRequired)
+				BindQueuedMaterials(s_TransparentSkinnedMeshDrawCallQueue, skinnedShader);
 
 			std::sort(s_TransparentSkinnedMeshDrawCallQueue.begin(), s_TransparentSkinnedMeshDrawCallQueue.end(),
 				[camera](MeshDrawCallInfo &a, MeshDrawCallInfo &b) -> bool
@@ -178,6 +367,8 @@ namespace Arcane
 			s_GLCache->SetShader(shader);
 			BindModelCameraInfo(camera, shader);
 			SetupTransparentRenderState();
+			if (renderPassType == MaterialBufferRequired)
+				BindQueuedMaterials(s_TransparentMeshDrawCallQueue, shader);
 
 			std::sort(s_TransparentMeshDrawCallQueue.begin(), s_TransparentMeshDrawCallQueue.end(),
 				[camera](MeshDrawCallInfo &a, MeshDrawCallInfo &b) -> bool
@@ -224,6 +415,78 @@ namespace Arcane
 		}
 	}
 
+	void Renderer::BeginLayerCulling(const glm::mat4 *layerViewProjections, int layerCount, bool cullNearPlane/*= true*/)
+	{
+		ARC_ASSERT(layerCount > 0 && layerCount <= 32, "Layer culling only supports between 1 and 32 layers");
+
+		s_CullingLayers.assign(layerViewProjections, layerViewProjections + layerCount);
+		s_CullingLayersNearPlane = cullNearPlane;
+	}
+
+	void Renderer::EndLayerCulling()
+	{
+		s_CullingLayers.clear();
+	}
+
+	void Renderer::BeginCaptureCulling(ICamera *camera, const glm::vec4 &clipPlane, float minScreenSize)
+	{
+		const glm::mat4 &projection = camera->GetProjectionMatrix();
+
+		s_CaptureCulling.ViewProjection = projection * camera->GetViewMatrix();
+		s_CaptureCulling.ClipPlane = clipPlane;
+		s_CaptureCulling.ViewPosition = camera->GetPosition();
+		s_CaptureCulling.ProjectionScale = projection[1][1];
+		s_CaptureCulling.MinScreenSize = minScreenSize;
+		s_CaptureCullingActive = true;
+	}
+
+	void Renderer::EndCaptureCulling()
+	{
+		s_CaptureCullingActive = false;
+	}
+
+	void Renderer::BeginProbeSelection(ProbeManager *probeManager)
+	{
+		s_ProbeSelectionManager = probeManager;
+	}
+
+	void Renderer::EndProbeSelection()
+	{
+		s_ProbeSelectionManager = nullptr;
+	}
+
+	void Renderer::BeginOcclusionCulling(const IOcclusionCuller *occlusionCuller)
+	{
+		s_OcclusionCuller = occlusionCuller;
+	}
+
+	void Renderer::EndOcclusionCulling()
+	{
+		s_OcclusionCuller = nullptr;
+	}
+
+	void Renderer::BeginMotionVectors(const glm::mat4 &viewProjection, const glm::mat4 &previousViewProjection)
+	{
+		s_MotionViewProjection = viewProjection;
+		s_MotionPreviousViewProjection = previousViewProjection;
+		s_MotionVectorsActive = true;
+	}
+
+	void Renderer::EndMotionVectors()
+	{
+		s_MotionVectorsActive = false;
+	}
+
+	void Renderer::BeginMultiDrawIndirect()
+	{
+		s_MultiDrawIndirectActive = true;
+	}
+
+	void Renderer::EndMultiDrawIndirect()
+	{
+		s_MultiDrawIndirectActive = false;
+	}
+
 	void Renderer::DrawNdcPlane()
 	{
 		s_NdcPlane->Draw();
@@ -246,6 +509,11 @@ namespace Arcane
 		shader->SetUniform("viewPos", camera->GetPosition());
 		shader->SetUniform("view", camera->GetViewMatrix());
 		shader->SetUniform("projection", camera->GetProjectionMatrix());
+		if (s_MotionVectorsActive)
+		{
+			shader->SetUniform("currentViewProjection", s_MotionViewProjection);
+			shader->SetUniform("previousViewProjection", s_MotionPreviousViewProjection);
+		}
 	}
 
 	void Renderer::BindQuadCameraInfo(ICamera *camera, Shader *shader)
@@ -264,12 +532,38 @@ namespace Arcane
 		}
 #endif
 		shader->SetUniform("model", drawCallInfo.transform);
+		if (s_MotionVectorsActive)
+		{
+			shader->SetUniform("previousModel", drawCallInfo.previousTransform);
+		}
+		if (!s_CullingLayers.empty())
+		{
+			shader->SetUniform("layerMask", drawCallInfo.layerMask);
+		}
 
-		if (pass == MaterialRequired)
+		if (pass == MaterialRequired || pass == MaterialBufferRequired)
 		{
 			glm::mat3 normalMatrix = glm::mat3(glm::transpose(glm::inverse(drawCallInfo.transform)));
 			shader->SetUniform("normalMatrix", normalMatrix);
+
+			if (s_ProbeSelectionManager)
+			{
+				glm::vec3 boundsCenter = (drawCallInfo.model->GetBoundsMin() + drawCallInfo.model->GetBoundsMax()) * 0.5f;
+				s_ProbeSelectionManager->SelectProbes(glm::vec3(drawCallInfo.transform * glm::vec4(boundsCenter, 1.0f)), shader);
+			}
+		}
+	}
+
+	void Renderer::BindQueuedMaterials(const std::deque<MeshDrawCallInfo> &queue, Shader *shader)
+	{
+		for (const MeshDrawCallInfo &drawCallInfo : queue)
+		{
+			for (Mesh &mesh : drawCallInfo.model->GetMeshes())
+			{
+				MaterialBuffer::AddMaterial(mesh.GetMaterial());
+			}
 		}
+		MaterialBuffer::Bind(shader);
 	}
 
 	void Renderer::SetupModelMatrix(Shader *shader, QuadDrawCallInfo &drawCallInfo)
@@ -290,7 +584,84 @@ namespace Arcane
 		{
 			const std::vector<glm::mat4> &matrices = drawCallInfo.animator->GetFinalBoneMatrices();
 			shader->SetUniformArray("bonesMatrices", static_cast<int>(matrices.size()), &matrices[0]);
+			if (s_MotionVectorsActive)
+			{
+				const std::vector<glm::mat4> &previousMatrices = drawCallInfo.animator->GetPreviousFinalBoneMatrices();
+				shader->SetUniformArray("previousBonesMatrices", static_cast<int>(previousMatrices.size()), &previousMatrices[0]);
+			}
+		}
+	}
+
+	int Renderer::CalculateLayerMask(Model *model, const glm::mat4 &transform)
+	{
+		const glm::vec3 &boundsMin = model->GetBoundsMin();
+		const glm::vec3 &boundsMax = model->GetBoundsMax();
+
+		int layerMask = 0;
+		for (int layer = 0; layer < static_cast<int>(s_CullingLayers.size()); layer++)
+		{
+			if (!IsBoxOutsideClipSpace(s_CullingLayers[layer] * transform, boundsMin, boundsMax, s_CullingLayersNearPlane))
+			{
+				layerMask |= 1 << layer;
+			}
+		}
+
+		return layerMask;
+	}
+
+	bool Renderer::IsCulledByCapture(Model *model, const glm::mat4 &transform)
+	{
+		const glm::vec3 &boundsMin = model->GetBoundsMin();
+		const glm::vec3 &boundsMax = model->GetBoundsMax();
+
+		if (IsBoxOutsideClipSpace(s_CaptureCulling.ViewProjection * transform, boundsMin, boundsMax, true))
+			return true;
+
+		// The clip plane discards everything with a negative distance, so the mesh can be skipped if every corner is on that side
+		bool clippedByPlane = true;
+		for (int corner = 0; corner < 8 && clippedByPlane; corner++)
+		{
+			glm::vec4 localCorner((corner & 1) ? boundsMax.x : boundsMin.x, (corner & 2) ? boundsMax.y : boundsMin.y, (corner & 4) ? boundsMax.z : boundsMin.z, 1.0f);
+			clippedByPlane = glm::dot(transform * localCorner, s_CaptureCulling.ClipPlane) < 0.0f;
+		}
+		if (clippedByPlane)
+			return true;
+
+		// Estimate how much of the capture's height the world space bounding sphere covers, the camera being inside of the sphere always passes
+		glm::vec3 worldCenter = glm::vec3(transform * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.0f));
+		float maxScale = glm::max(glm::length(glm::vec3(transform[0])), glm::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+		float radius = glm::length(boundsMax - boundsMin) * 0.5f * maxScale;
+		float distance = glm::distance(worldCenter, s_CaptureCulling.ViewPosition);
+		if (distance <= radius)
+			return false;
+
+		return (radius * s_CaptureCulling.ProjectionScale) / distance < s_CaptureCulling.MinScreenSize;
+	}
+
+	bool Renderer::IsBoxOutsideClipSpace(const glm::mat4 &modelViewProjection, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax, bool testNearPlane)
+	{
+		// Test the box's corners against the clip planes in homogeneous space (-w <= xyz <= w), this works for perspective projections even when some corners are behind the camera.
+		// The box is only outside if every corner is outside the same plane
+		int cornersOutsidePlane[6] = { 0, 0, 0, 0, 0, 0 }; // -x, +x, -y, +y, -z (near), +z (far)
+		for (int corner = 0; corner < 8; corner++)
+		{
+			glm::vec4 localCorner((corner & 1) ? boundsMax.x : boundsMin.x, (corner & 2) ? boundsMax.y : boundsMin.y, (corner & 4) ? boundsMax.z : boundsMin.z, 1.0f);
+			glm::vec4 clipCorner = modelViewProjection * localCorner;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				cornersOutsidePlane[axis * 2] += clipCorner[axis] < -clipCorner.w ? 1 : 0;
+				cornersOutsidePlane[axis * 2 + 1] += clipCorner[axis] > clipCorner.w ? 1 : 0;
+			}
+		}
+
+		for (int plane = 0; plane < 6; plane++)
+		{
+			if (plane == 4 && !testNearPlane)
+				continue;
+			if (cornersOutsidePlane[plane] == 8)
+				return true;
 		}
+		return false;
 	}
 
 	void Renderer::SetupOpaqueRenderState()
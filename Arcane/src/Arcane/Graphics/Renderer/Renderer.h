@@ -17,6 +17,8 @@ namespace Arcane
 	class Cube;
 	class Quad;
 	class PoseAnimator;
+	class ProbeManager;
+	class IOcclusionCuller;
 
 	struct RendererData
 	{
@@ -28,6 +30,8 @@ namespace Arcane
 		unsigned int DrawCallCount;
 		unsigned int MeshesDrawnCount;
 		unsigned int QuadsDrawnCount;
+		unsigned int MeshesOccludedCount; // Queued meshes rejected by occlusion culling
+		unsigned int IndirectMeshesDrawnCount; // Meshes submitted through multi-draw indirect, each multi-draw only counts as one draw call
 	};
 
 	// TODO: Should eventually have a render ID and we can order drawcalls to avoid changing GPU state (shaders etc)
@@ -37,7 +41,9 @@ namespace Arcane
 		Model *model = nullptr;
 		PoseAnimator *animator = nullptr;
 		glm::mat4 transform;
+		glm::mat4 previousTransform; // Same as transform if the mesh wasn't rendered last frame
 		bool cullBackface;
+		int layerMask = -1; // Bit per layer the mesh overlaps when layer culling is active (all bits set otherwise)
 	};
 	struct QuadDrawCallInfo
 	{
@@ -54,7 +60,7 @@ namespace Arcane
 		static void BeginFrame();
 		static void EndFrame();
 
-		static void QueueMesh(Model *model, const glm::mat4 &transform, PoseAnimator *animator = nullptr, bool isTransparent = false, bool cullBackface = true);
+		static void QueueMesh(Model *model, const glm::mat4 &transform, PoseAnimator *animator = nullptr, bool isTransparent = false, bool cullBackface = true, const glm::mat4 *previousTransform = nullptr);
 		static void QueueQuad(const glm::vec3 &position, const glm::vec2 &size, const Texture *texture); // TODO: Should use batch rendering to efficiently render quads together
 		static void QueueQuad(const glm::mat4 &transform, const Texture *texture); // TODO: Should use batch rendering to efficiently render quads together
 
@@ -64,6 +70,36 @@ namespace Arcane
 		static void FlushTransparentNonSkinnedMeshes(ICamera *camera, RenderPassType renderPassType, Shader *shader);
 		static void FlushQuads(ICamera *camera, Shader *shader);
 
+		// Layered rendering (ie shadow cascades) - While active, queued meshes are tested against every layer's view projection and meshes outside of every layer are culled.
+		// The layers each mesh overlaps are passed to the shader's "layerMask" uniform so a geometry shader can skip the layers it doesn't touch
+		static void BeginLayerCulling(const glm::mat4 *layerViewProjections, int layerCount, bool cullNearPlane = true);
+		static void EndLayerCulling();
+
+		// Capture culling (ie planar water reflections/refractions) - While active, queued meshes are culled if they are outside of the camera's view projection,
+		// entirely on the clipped side of the clip plane, or if their bounding sphere covers less than minScreenSize of the capture's height
+		static void BeginCaptureCulling(ICamera *camera, const glm::vec4 &clipPlane, float minScreenSize);
+		static void EndCaptureCulling();
+
+		// Per mesh probe selection - While active, the light and reflection probes used by each mesh are selected from the centre of it's world space bounds
+		// instead of the probes bound for the whole pass, so meshes that are far apart can be lit by different probes in the same flush
+		static void BeginProbeSelection(ProbeManager *probeManager);
+		static void EndProbeSelection();
+
+		// Occlusion culling - While active, queued non-skinned meshes are tested against the culler's depth and are not queued if they are hidden
+		static void BeginOcclusionCulling(const IOcclusionCuller *occlusionCuller);
+		static void EndOcclusionCulling();
+
+		// Motion vectors - While active, flushed meshes also get last frame's model and bone matrices along with the unjittered view projections for both frames,
+		// so the shader can output how far each pixel has moved on screen since the previous frame
+		static void BeginMotionVectors(const glm::mat4 &viewProjection, const glm::mat4 &previousViewProjection);
+		static void EndMotionVectors();
+
+		// Multi-draw indirect - While active, NoMaterialRequired and MaterialBufferRequired flushes of opaque non-skinned meshes submit every mesh that lives in the geometry arena with
+		// glMultiDrawElementsIndirect, one multi-draw per vertex layout and face cull mode. The shader has to support it's "drawIndirect" path and read the per draw matrices, layer mask
+		// and material index from the draw data buffer. Flushes with per mesh probe selection active still draw one mesh at a time, probes can't be picked per draw yet
+		static void BeginMultiDrawIndirect();
+		static void EndMultiDrawIndirect();
+
 		static void DrawNdcPlane();
 		static void DrawNdcCube();
 
@@ -74,6 +110,11 @@ namespace Arcane
 		static void SetupModelMatrix(Shader *shader, MeshDrawCallInfo &drawCallInfo, RenderPassType pass);
 		static void SetupModelMatrix(Shader *shader, QuadDrawCallInfo &drawCallInfo);
 		static void SetupBoneMatrices(Shader *shader, MeshDrawCallInfo &drawCallInfo);
+		static void BindQueuedMaterials(const std::deque<MeshDrawCallInfo> &queue, Shader *shader); // Packs every material the queue will draw before the first draw uses the material buffer
+		static int CalculateLayerMask(Model *model, const glm::mat4 &transform);
+		static bool IsCulledByCapture(Model *model, const glm::mat4 &transform);
+		static bool IsBoxOutsideClipSpace(const glm::mat4 &modelViewProjection, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax, bool testNearPlane);
+		static void FlushOpaqueNonSkinnedMeshesIndirect(Shader *shader, RenderPassType renderPassType);
 		static void SetupOpaqueRenderState();
 		static void SetupTransparentRenderState();
 		static void SetupQuadRenderState();
@@ -90,9 +131,61 @@ namespace Arcane
 		static std::deque<MeshDrawCallInfo> s_TransparentSkinnedMeshDrawCallQueue;
 		static std::deque<QuadDrawCallInfo> s_QuadDrawCallQueue;
 
+		static std::vector<glm::mat4> s_CullingLayers;
+		static bool s_CullingLayersNearPlane;
+
+		struct CaptureCullingData
+		{
+			glm::mat4 ViewProjection;
+			glm::vec4 ClipPlane;
+			glm::vec3 ViewPosition;
+			float ProjectionScale; // Projection's [1][1] term, used to estimate the screen size of a bounding sphere
+			float MinScreenSize;
+		};
+		static bool s_CaptureCullingActive;
+		static CaptureCullingData s_CaptureCulling;
+
+		static ProbeManager *s_ProbeSelectionManager;
+
+		static const IOcclusionCuller *s_OcclusionCuller;
+
+		static bool s_MotionVectorsActive;
+		static glm::mat4 s_MotionViewProjection, s_MotionPreviousViewProjection;
+
+		// Matches the layout glMultiDrawElementsIndirect reads, the base instance is used as the index into the draw data buffer
+		struct DrawElementsIndirectCommand
+		{
+			unsigned int Count, InstanceCount, FirstIndex;
+			int BaseVertex;
+			unsigned int BaseInstance;
+		};
+		struct IndirectDrawData // std430 layout (binding 8)
+		{
+			glm::mat4 Model;
+			glm::mat4 PreviousModel;
+			glm::vec4 NormalMatrix[3]; // std430 mat3, every column is padded to a vec4
+			int LayerMask;
+			int MaterialIndex;
+			int Padding[2];
+		};
+		struct IndirectDraw
+		{
+			int LayoutIndex;
+			bool CullBackface;
+			DrawElementsIndirectCommand Command;
+			IndirectDrawData DrawData;
+		};
+		static bool s_MultiDrawIndirectActive;
+		static unsigned int s_IndirectCommandBuffer, s_IndirectDrawDataBuffer;
+		static std::vector<IndirectDraw> s_IndirectDraws;
+		static std::vector<DrawElementsIndirectCommand> s_IndirectCommands;
+		static std::vector<IndirectDrawData> s_IndirectDrawData;
+
 		static unsigned int m_CurrentDrawCallCount;
 		static unsigned int m_CurrentMeshesDrawnCount;
 		static unsigned int m_CurrentQuadsDrawnCount;
+		static unsigned int m_CurrentMeshesOccludedCount;
+		static unsigned int m_CurrentIndirectMeshesDrawnCount;
 	};
 }
 #endif
@@ -3,6 +3,7 @@
 
 #include <Arcane/Graphics/Window.h>
 #include <Arcane/Graphics/Shader.h>
+#include <Arcane/Graphics/Mesh/MaterialBuffer.h>
 #include <Arcane/Graphics/Camera/ICamera.h>
 #include <Arcane/Graphics/Renderer/GLCache.h>
 #include <Arcane/Graphics/Renderer/Renderer.h>
@@ -12,18 +13,18 @@
 
 namespace Arcane
 {
-	DeferredGeometryPass::DeferredGeometryPass(Scene *scene) : RenderPass(scene), m_AllocatedGBuffer(true)
+	DeferredGeometryPass::DeferredGeometryPass(Scene *scene) : RenderPass(scene), m_AllocatedGBuffer(true), m_PreviousViewProjection(1.0f), m_PreviousViewProjectionValid(false), m_OcclusionCullingMode(OcclusionCullingMode::OcclusionCullingMode_HiZ), m_OccluderPrepassEnabled(true)
 	{
-		m_ModelShader = ShaderLoader::LoadShader("deferred/PBR_Model_GeometryPass.glsl");
-		m_SkinnedModelShader = ShaderLoader::LoadShader("deferred/PBR_Skinned_Model_GeometryPass.glsl");
+		m_ModelShader = ShaderLoader::LoadShader("deferred/PBR_Model_GeometryPass.glsl", MaterialBuffer::GetShaderDefines());
+		m_SkinnedModelShader = ShaderLoader::LoadShader("deferred/PBR_Skinned_Model_GeometryPass.glsl", MaterialBuffer::GetShaderDefines());
 		m_TerrainShader = ShaderLoader::LoadShader("deferred/PBR_Terrain_GeometryPass.glsl");
 
 		m_GBuffer = new GBuffer(Window::GetRenderResolutionWidth(), Window::GetRenderResolutionHeight());
 	}
 
-	DeferredGeometryPass::DeferredGeometryPass(Scene *scene, GBuffer *customGBuffer) : RenderPass(scene), m_AllocatedGBuffer(false), m_GBuffer(customGBuffer)
+	DeferredGeometryPass::DeferredGeometryPass(Scene *scene, GBuffer *customGBuffer) : RenderPass(scene), m_AllocatedGBuffer(false), m_GBuffer(customGBuffer), m_PreviousViewProjection(1.0f), m_PreviousViewProjectionValid(false), m_OcclusionCullingMode(OcclusionCullingMode::OcclusionCullingMode_HiZ), m_OccluderPrepassEnabled(true)
 	{
-		m_ModelShader = ShaderLoader::LoadShader("deferred/PBR_Model_GeometryPass.glsl");
+		m_ModelShader = ShaderLoader::LoadShader("deferred/PBR_Model_GeometryPass.glsl", MaterialBuffer::GetShaderDefines());
 		m_TerrainShader = ShaderLoader::LoadShader("deferred/PBR_Terrain_GeometryPass.glsl");
 	}
 
@@ -36,7 +37,11 @@ namespace Arcane
 
 	GeometryPassOutput DeferredGeometryPass::ExecuteGeometryPass(ICamera *camera, bool renderOnlyStatic)
 	{
-		glViewport(0, 0, m_GBuffer->GetWidth(), m_GBuffer->GetHeight());
+		// Our own GBuffer is the main view, so with dynamic resolution only part of it is rendered to
+		if (m_AllocatedGBuffer)
+			glViewport(0, 0, Window::GetScaledDimension(m_GBuffer->GetWidth()), Window::GetScaledDimension(m_GBuffer->GetHeight()));
+		else
+			glViewport(0, 0, m_GBuffer->GetWidth(), m_GBuffer->GetHeight());
 		m_GBuffer->Bind();
 		m_GBuffer->ClearAll();
 		m_GLCache->SetBlend(false);
@@ -50,6 +55,50 @@ namespace Arcane
 		// Setup
 		Terrain *terrain = m_ActiveScene->GetTerrain();
 
+		// Motion vectors ignore the projection jitter, so a still camera looking at a still scene has no motion. Without a previous frame nothing has moved
+		glm::mat4 viewProjection = camera->GetUnjitteredProjectionMatrix() * camera->GetViewMatrix();
+		glm::mat4 previousViewProjection = m_PreviousViewProjectionValid ? m_PreviousViewProjection : viewProjection;
+		Renderer::BeginMotionVectors(viewProjection, previousViewProjection);
+		m_GLCache->SetShader(m_TerrainShader);
+		m_TerrainShader->SetUniform("currentViewProjection", viewProjection);
+		m_TerrainShader->SetUniform("previousViewProjection", previousViewProjection);
+
+		// Opaque non-skinned meshes in the geometry arena are filled with one multi-draw per vertex layout, each draw reads it's matrices and material index from the draw data
+		Renderer::BeginMultiDrawIndirect();
+
+		// Meshes hidden in the last depth pyramid that has made it back from the GPU, or behind this frame's software rasterized occluders, aren't queued.
+		// Readbacks are always picked up so switching modes never finds a stale pyramid waiting
+		m_HiZOcclusionCuller.Update();
+		if (m_OcclusionCullingMode == OcclusionCullingMode::OcclusionCullingMode_HiZ)
+		{
+			Renderer::BeginOcclusionCulling(&m_HiZOcclusionCuller);
+		}
+		else if (m_OcclusionCullingMode == OcclusionCullingMode::OcclusionCullingMode_Software)
+		{
+			m_OcclusionRasterizer.BeginFrame(camera->GetProjectionMatrix() * camera->GetViewMatrix());
+			m_ActiveScene->AddOccludersToRasterizer(&m_OcclusionRasterizer, camera->GetPosition());
+			m_OcclusionRasterizer.Rasterize();
+			Renderer::BeginOcclusionCulling(&m_OcclusionRasterizer);
+		}
+
+		// Occluder depth pre-pass, lays down the depth of the terrain and flagged occluders so everything they hide is rejected by the depth test before it is shaded.
+		// The same shaders as the fill are used so the depth matches exactly, which lets the fill re-draw the occluders with an equal depth test
+		if (m_OccluderPrepassEnabled)
+		{
+			m_GLCache->SetColourMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+			m_ActiveScene->AddModelsToRenderer(ModelFilterType::StaticOccluderModels);
+			Renderer::FlushOpaqueNonSkinnedMeshes(camera, RenderPassType::MaterialBufferRequired, m_ModelShader); // The shader always reads it's material, so it still needs a valid index
+
+			m_GLCache->SetShader(m_TerrainShader);
+			m_TerrainShader->SetUniform("view", camera->GetViewMatrix());
+			m_TerrainShader->SetUniform("projection", camera->GetProjectionMatrix());
+			terrain->Draw(m_TerrainShader, NoMaterialRequired);
+
+			m_GLCache->SetColourMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+			m_GLCache->SetDepthFunc(GL_LEQUAL);
+		}
+
 		// Setup model renderer for opaque objects only
 		if (renderOnlyStatic)
 		{
@@ -59,12 +108,13 @@ namespace Arcane
 		{
 			m_ActiveScene->AddModelsToRenderer(ModelFilterType::OpaqueModels);
 		}
+		Renderer::EndOcclusionCulling();
 
 		// Render opaque objects (use stencil to denote models for the deferred lighting pass)
 		m_GLCache->SetStencilWriteMask(0xFF);
 		m_GLCache->SetStencilFunc(GL_ALWAYS, StencilValue::ModelStencilValue, 0xFF);
-		Renderer::FlushOpaqueSkinnedMeshes(camera, RenderPassType::MaterialRequired, m_SkinnedModelShader);
-		Renderer::FlushOpaqueNonSkinnedMeshes(camera, RenderPassType::MaterialRequired, m_ModelShader);
+		Renderer::FlushOpaqueSkinnedMeshes(camera, RenderPassType::MaterialBufferRequired, m_SkinnedModelShader);
+		Renderer::FlushOpaqueNonSkinnedMeshes(camera, RenderPassType::MaterialBufferRequired, m_ModelShader);
 		m_GLCache->SetStencilWriteMask(0x00);
 
 		// Setup terrain information
@@ -78,8 +128,14 @@ namespace Arcane
 		terrain->Draw(m_TerrainShader, MaterialRequired);
 		m_GLCache->SetStencilWriteMask(0x00);
 
+		Renderer::EndMultiDrawIndirect();
+		Renderer::EndMotionVectors();
+		m_PreviousViewProjection = viewProjection;
+		m_PreviousViewProjectionValid = true;
+
 		// Reset state
 		m_GLCache->SetStencilTest(false);
+		m_GLCache->SetDepthFunc(GL_LESS);
 
 		// Render pass output
 		GeometryPassOutput passOutput;
@@ -10,6 +10,14 @@
 #include <Arcane/Graphics/Renderer/Renderpass/RenderPassType.h>
 #endif
 
+#ifndef HIZOCCLUSIONCULLER_H
+#include <Arcane/Graphics/Renderer/HiZOcclusionCuller.h>
+#endif
+
+#ifndef SOFTWAREOCCLUSIONRASTERIZER_H
+#include <Arcane/Graphics/Renderer/SoftwareOcclusionRasterizer.h>
+#endif
+
 namespace Arcane
 {
 	class Shader;
@@ -17,6 +25,14 @@ namespace Arcane
 	class ICamera;
 	class GBuffer;
 
+	enum class OcclusionCullingMode : int
+	{
+		OcclusionCullingMode_None,
+		OcclusionCullingMode_HiZ,		// Tested against the GPU depth pyramid read back from a previous frame
+		OcclusionCullingMode_Software,	// Tested against the occluders rasterized on the CPU this frame
+		OcclusionCullingModeSize
+	};
+
 	class DeferredGeometryPass : public RenderPass {
 	public:
 		DeferredGeometryPass(Scene *scene);
@@ -24,10 +40,26 @@ namespace Arcane
 		virtual ~DeferredGeometryPass() override;
 
 		GeometryPassOutput ExecuteGeometryPass(ICamera *camera, bool renderOnlyStatic);
+
+		inline HiZOcclusionCuller* GetHiZOcclusionCuller() { return &m_HiZOcclusionCuller; }
+		inline const SoftwareOcclusionRasterizer* GetOcclusionRasterizer() const { return &m_OcclusionRasterizer; }
+		inline OcclusionCullingMode& GetOcclusionCullingModeRef() { return m_OcclusionCullingMode; }
+		inline bool& GetOccluderPrepassEnabledRef() { return m_OccluderPrepassEnabled; }
 	private:
 		bool m_AllocatedGBuffer;
 		GBuffer *m_GBuffer;
 		Shader *m_ModelShader, *m_SkinnedModelShader, *m_TerrainShader;
+
+		// Unjittered view projection of the last frame rendered by this pass, motion vectors are measured from it
+		glm::mat4 m_PreviousViewProjection;
+		bool m_PreviousViewProjectionValid;
+
+		HiZOcclusionCuller m_HiZOcclusionCuller; // Fed with the depth pyramid once it has been built for the frame, see MasterRenderPass
+		SoftwareOcclusionRasterizer m_OcclusionRasterizer;
+
+		// Tweaks
+		OcclusionCullingMode m_OcclusionCullingMode;
+		bool m_OccluderPrepassEnabled;
 	};
 }
 #endif
@@ -33,11 +33,14 @@ namespace Arcane
 		}
 	}
 
-	LightingPassOutput DeferredLightingPass::ExecuteLightingPass(ShadowmapPassOutput &inputShadowmapData, GBuffer *inputGbuffer, PreLightingPassOutput &preLightingOutput, ICamera *camera, bool useIBL)
+	LightingPassOutput DeferredLightingPass::ExecuteLightingPass(ShadowmapPassOutput &inputShadowmapData, GBuffer *inputGbuffer, PreLightingPassOutput &preLightingOutput, ScreenSpaceReflectionPassOutput &ssrOutput, ICamera *camera, bool useIBL)
 	{
-		// Framebuffer setup
-		glViewport(0, 0, m_Framebuffer->GetWidth(), m_Framebuffer->GetHeight());
-		glViewport(0, 0, m_Framebuffer->GetWidth(), m_Framebuffer->GetHeight());
+		// Framebuffer setup, our own framebuffer is the main view so with dynamic resolution only part of it (and the GBuffer) is used
+		float renderScale = m_AllocatedFramebuffer ? Window::GetRenderScale() : 1.0f;
+		if (m_AllocatedFramebuffer)
+			glViewport(0, 0, Window::GetScaledDimension(m_Framebuffer->GetWidth()), Window::GetScaledDimension(m_Framebuffer->GetHeight()));
+		else
+			glViewport(0, 0, m_Framebuffer->GetWidth(), m_Framebuffer->GetHeight());
 		m_Framebuffer->Bind();
 		m_Framebuffer->ClearAll();
 		m_GLCache->SetDepthTest(false);
@@ -57,10 +60,11 @@ namespace Arcane
 		ProbeManager *probeManager = m_ActiveScene->GetProbeManager();
 
 		m_GLCache->SetShader(m_LightingShader);
-		lightManager->BindLightingUniforms(m_LightingShader);
+		lightManager->BindLightingUniforms(m_LightingShader, camera);
 		m_LightingShader->SetUniform("viewPos", camera->GetPosition());
 		m_LightingShader->SetUniform("viewInverse", glm::inverse(camera->GetViewMatrix()));
 		m_LightingShader->SetUniform("projectionInverse", glm::inverse(camera->GetProjectionMatrix()));
+		m_LightingShader->SetUniform("renderScale", renderScale);
 
 		// Bind GBuffer data
 		inputGbuffer->GetAlbedo()->Bind(6);
@@ -78,6 +82,14 @@ namespace Arcane
 		inputGbuffer->GetDepthStencilTexture()->Bind(10);
 		m_LightingShader->SetUniform("depthTexture", 10);
 
+		// Screen space reflections replace the reflection probe wherever they hit
+		m_LightingShader->SetUniform("ssrEnabled", ssrOutput.reflectionTexture != nullptr);
+		if (ssrOutput.reflectionTexture)
+		{
+			ssrOutput.reflectionTexture->Bind(11);
+			m_LightingShader->SetUniform("ssrTexture", 11);
+		}
+
 		// Shadowmap code
 		BindShadowmap(m_LightingShader, inputShadowmapData);
 
@@ -86,6 +98,7 @@ namespace Arcane
 		// IBL Bindings
 		glm::vec3 cameraPosition = camera->GetPosition();
 		probeManager->BindProbes(cameraPosition, m_LightingShader); // TODO: Should use camera component
+		probeManager->BindPerPixelProbes(cameraPosition, m_LightingShader);
 
 		// Perform lighting on the terrain (turn IBL off)
 		m_LightingShader->SetUniform("computeIBL", 0);
@@ -120,32 +133,19 @@ namespace Arcane
 		LightManager *lightManager = m_ActiveScene->GetLightManager();
 
 		bool hasDirShadowMap = shadowmapData.directionalShadowmapFramebuffer != nullptr;
-		bool hasSpotShadowMap = shadowmapData.spotLightShadowmapFramebuffer != nullptr;
 
 		shader->SetUniform("dirLightShadowData.lightShadowIndex", hasDirShadowMap ? lightManager->GetDirectionalLightShadowCasterIndex() : -1);
-		shader->SetUniform("spotLightShadowData.lightShadowIndex", hasSpotShadowMap ? lightManager->GetSpotLightShadowCasterIndex() : -1);
-		shader->SetUniform("pointLightShadowData.lightShadowIndex", shadowmapData.hasPointLightShadows ? lightManager->GetPointLightShadowCasterIndex() : -1);
 
 		if (hasDirShadowMap)
 		{
 			shadowmapData.directionalShadowmapFramebuffer->GetDepthStencilTexture()->Bind(0);
 			shader->SetUniform("dirLightShadowmap", 0);
-			shader->SetUniform("dirLightShadowData.lightSpaceViewProjectionMatrix", shadowmapData.directionalLightViewProjMatrix);
-			shader->SetUniform("dirLightShadowData.shadowBias", shadowmapData.directionalShadowmapBias);
+			shader->SetUniformArray("dirLightShadowData.lightSpaceViewProjectionMatrices[0]", shadowmapData.directionalShadowmapCascadeCount, shadowmapData.directionalLightViewProjMatrices);
+			shader->SetUniform("dirLightShadowData.cascadeShadowBiases", shadowmapData.directionalShadowmapCascadeBiases);
+			shader->SetUniform("dirLightShadowData.cascadeCount", shadowmapData.directionalShadowmapCascadeCount);
 		}
-		if (hasSpotShadowMap)
-		{
-			shadowmapData.spotLightShadowmapFramebuffer->GetDepthStencilTexture()->Bind(1);
-			shader->SetUniform("spotLightShadowmap", 1);
-			shader->SetUniform("spotLightShadowData.lightSpaceViewProjectionMatrix", shadowmapData.spotLightViewProjMatrix);
-			shader->SetUniform("spotLightShadowData.shadowBias", shadowmapData.spotLightShadowmapBias);
-		}
-		if (shadowmapData.hasPointLightShadows)
-		{
-			shader->SetUniform("pointLightShadowData.shadowBias", shadowmapData.pointLightShadowmapBias);
-			shader->SetUniform("pointLightShadowData.farPlane", shadowmapData.pointLightFarPlane);
-		}
-		shader->SetUniform("pointLightShadowCubemap", 2);
-		shadowmapData.pointLightShadowCubemap->Bind(2); // Must be bound even if there is no point light shadows. Thanks OpenGL Driver!
+
+		// Spot and point lights store the index of their shadow atlas tile, so the atlas just needs to be bound
+		lightManager->GetShadowAtlas()->Bind(shader, 1);
 	}
 }
@@ -22,7 +22,9 @@ namespace Arcane
 		DeferredLightingPass(Scene *scene, Framebuffer *framebuffer);
 		virtual ~DeferredLightingPass() override;
 
-		LightingPassOutput ExecuteLightingPass(ShadowmapPassOutput &inputShadowmapData, GBuffer *inputGbuffer, PreLightingPassOutput &preLightingOutput, ICamera *camera, bool useIBL);
+		LightingPassOutput ExecuteLightingPass(ShadowmapPassOutput &inputShadowmapData, GBuffer *inputGbuffer, PreLightingPassOutput &preLightingOutput, ScreenSpaceReflectionPassOutput &ssrOutput, ICamera *camera, bool useIBL);
+
+		inline Framebuffer* GetFramebuffer() { return m_Framebuffer; }
 	private:
 		void BindShadowmap(Shader *shader, ShadowmapPassOutput &shadowmapData);
 	private:
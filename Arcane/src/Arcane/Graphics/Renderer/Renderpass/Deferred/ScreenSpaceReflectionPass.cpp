@@ -0,0 +1,83 @@
+#include "arcpch.h"
+#include "ScreenSpaceReflectionPass.h"
+
+#include <Arcane/Graphics/Window.h>
+#include <Arcane/Graphics/Shader.h>
+#include <Arcane/Graphics/Camera/ICamera.h>
+#include <Arcane/Graphics/Renderer/GLCache.h>
+#include <Arcane/Graphics/Renderer/Renderer.h>
+#include <Arcane/Scene/Scene.h>
+#include <Arcane/Util/Loaders/ShaderLoader.h>
+
+namespace Arcane
+{
+	ScreenSpaceReflectionPass::ScreenSpaceReflectionPass(Scene *scene) : RenderPass(scene), m_HiZBuffer(Window::GetRenderResolutionWidth(), Window::GetRenderResolutionHeight()), m_PreviousViewProjection(1.0f), m_PreviousRenderScale(1.0f),
+		m_Enabled(true), m_MaxIterations(SSR_MAX_ITERATIONS_DEFAULT), m_Thickness(SSR_THICKNESS_DEFAULT), m_MaxRoughness(SSR_MAX_ROUGHNESS_DEFAULT)
+	{
+		m_ReflectionShader = ShaderLoader::LoadShader("post_process/ssr/SSR.glsl");
+	}
+
+	ScreenSpaceReflectionPass::~ScreenSpaceReflectionPass() {}
+
+	ScreenSpaceReflectionPassOutput ScreenSpaceReflectionPass::ExecuteScreenSpaceReflectionPass(GBuffer *inputGbuffer, Texture *previousSceneColour, ICamera *camera, Framebuffer *reflectionTarget)
+	{
+		ScreenSpaceReflectionPassOutput passOutput;
+
+		// The pyramid is built once per frame and shared with the water, so it is built even if the glossy reflections are disabled
+		float renderScale = Window::GetRenderScale();
+		m_HiZBuffer.Build(inputGbuffer->GetDepthStencilTexture(), Window::GetScaledDimension(inputGbuffer->GetWidth()), Window::GetScaledDimension(inputGbuffer->GetHeight()));
+		passOutput.hiZBuffer = &m_HiZBuffer;
+
+		glm::mat4 viewProjection = camera->GetProjectionMatrix() * camera->GetViewMatrix();
+		if (!m_Enabled)
+		{
+			m_PreviousViewProjection = viewProjection;
+			m_PreviousRenderScale = renderScale;
+			return passOutput;
+		}
+
+		glViewport(0, 0, Window::GetScaledDimension(reflectionTarget->GetWidth()), Window::GetScaledDimension(reflectionTarget->GetHeight()));
+		reflectionTarget->Bind();
+		m_GLCache->SetDepthTest(false);
+		m_GLCache->SetBlend(false);
+		m_GLCache->SetFaceCull(true);
+		m_GLCache->SetCullFace(GL_BACK);
+
+		m_GLCache->SetShader(m_ReflectionShader);
+		m_ReflectionShader->SetUniform("view", camera->GetViewMatrix());
+		m_ReflectionShader->SetUniform("projection", camera->GetProjectionMatrix());
+		m_ReflectionShader->SetUniform("viewInverse", glm::inverse(camera->GetViewMatrix()));
+		m_ReflectionShader->SetUniform("projectionInverse", glm::inverse(camera->GetProjectionMatrix()));
+		m_ReflectionShader->SetUniform("previousViewProjection", m_PreviousViewProjection);
+		m_ReflectionShader->SetUniform("nearPlane", camera->GetNearPlane());
+		m_ReflectionShader->SetUniform("hiZMaxLevel", static_cast<int>(m_HiZBuffer.GetMipCount() - 1));
+		m_ReflectionShader->SetUniform("hiZBaseSize", m_HiZBuffer.GetBaseSize());
+		m_ReflectionShader->SetUniform("renderScale", renderScale);
+		m_ReflectionShader->SetUniform("previousRenderScale", m_PreviousRenderScale);
+		m_ReflectionShader->SetUniform("maxIterations", m_MaxIterations);
+		m_ReflectionShader->SetUniform("thickness", m_Thickness);
+		m_ReflectionShader->SetUniform("maxRoughness", m_MaxRoughness);
+
+		inputGbuffer->GetNormal()->Bind(0);
+		m_ReflectionShader->SetUniform("normalTexture", 0);
+		inputGbuffer->GetMaterialInfo()->Bind(1);
+		m_ReflectionShader->SetUniform("materialInfoTexture", 1);
+		inputGbuffer->GetDepthStencilTexture()->Bind(2);
+		m_ReflectionShader->SetUniform("depthTexture", 2);
+		m_HiZBuffer.GetTexture()->Bind(3);
+		m_ReflectionShader->SetUniform("hiZBuffer", 3);
+		previousSceneColour->Bind(4);
+		m_ReflectionShader->SetUniform("previousSceneColour", 4);
+
+		Renderer::DrawNdcPlane();
+
+		// Reset unusual state
+		m_GLCache->SetDepthTest(true);
+
+		m_PreviousViewProjection = viewProjection;
+		m_PreviousRenderScale = renderScale;
+
+		passOutput.reflectionTexture = reflectionTarget->GetColourTexture();
+		return passOutput;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#ifndef SCREENSPACEREFLECTIONPASS_H
+#define SCREENSPACEREFLECTIONPASS_H
+
+#ifndef RENDERPASS_H
+#include <Arcane/Graphics/Renderer/Renderpass/RenderPass.h>
+#endif
+
+#ifndef RENDERPASSTYPE_H
+#include <Arcane/Graphics/Renderer/Renderpass/RenderPassType.h>
+#endif
+
+#ifndef HIZBUFFER_H
+#include <Arcane/Graphics/Renderer/HiZBuffer.h>
+#endif
+
+namespace Arcane
+{
+	class Shader;
+	class Scene;
+	class ICamera;
+
+	// Traces reflections for glossy surfaces in the GBuffer against a min/max depth pyramid of the GBuffer's depth.
+	// This runs before the lighting pass, so hits are reprojected into the previous frame's lit scene. The lighting pass then blends the hits over the reflection probe
+	class ScreenSpaceReflectionPass : public RenderPass
+	{
+	public:
+		ScreenSpaceReflectionPass(Scene *scene);
+		virtual ~ScreenSpaceReflectionPass() override;
+
+		ScreenSpaceReflectionPassOutput ExecuteScreenSpaceReflectionPass(GBuffer *inputGbuffer, Texture *previousSceneColour, ICamera *camera, Framebuffer *reflectionTarget); // reflectionTarget is a half resolution transient of the render graph, reflections of glossy surfaces are blurry enough that it isn't noticeable
+
+		inline bool& GetEnabledRef() { return m_Enabled; }
+		inline int& GetMaxIterationsRef() { return m_MaxIterations; }
+		inline float& GetThicknessRef() { return m_Thickness; }
+		inline float& GetMaxRoughnessRef() { return m_MaxRoughness; }
+	private:
+		Shader *m_ReflectionShader;
+
+		HiZBuffer m_HiZBuffer;
+
+		glm::mat4 m_PreviousViewProjection;
+		float m_PreviousRenderScale; // The previous frame's lit scene only covers this much of it's framebuffer
+
+		// Tweaks
+		bool m_Enabled;
+		int m_MaxIterations;
+		float m_Thickness;
+		float m_MaxRoughness;
+	};
+}
+#endif
@@ -41,11 +41,55 @@ namespace Arcane
 		m_TerrainShader = ShaderLoader::LoadShader("forward/PBR_Terrain.glsl");
 	}
 
+	void ForwardLightingPass::SetReducedQuality(bool choice, float textureLodBias/*= 0.0f*/)
+	{
+		m_ReducedQuality = choice;
+		m_TextureLodBias = textureLodBias;
+		if (!choice)
+		{
+			Init();
+			return;
+		}
+
+		std::vector<std::string> defines = { "REDUCED_QUALITY" };
+		m_ModelShader = ShaderLoader::LoadShader("forward/PBR_Model.glsl", defines);
+		m_SkinnedModelShader = ShaderLoader::LoadShader("forward/PBR_Skinned_Model.glsl", defines);
+		m_TerrainShader = ShaderLoader::LoadShader("forward/PBR_Terrain.glsl", defines);
+	}
+
+	void ForwardLightingPass::SetCustomFramebuffer(Framebuffer *customFramebuffer)
+	{
+		ARC_ASSERT(!m_AllocatedFramebuffer, "Forward lighting pass owns it's framebuffer, it can't be replaced with a custom framebuffer");
+		m_Framebuffer = customFramebuffer;
+	}
+
+	void ForwardLightingPass::SetViewport(const glm::uvec4 &viewport)
+	{
+		m_UseCustomViewport = true;
+		m_CustomViewport = viewport;
+	}
+
+	void ForwardLightingPass::ResetViewport()
+	{
+		m_UseCustomViewport = false;
+	}
+
 	LightingPassOutput ForwardLightingPass::ExecuteOpaqueLightingPass(ShadowmapPassOutput &inputShadowmapData, ICamera *camera, bool renderOnlyStatic, bool useIBL)
 	{
-		glViewport(0, 0, m_Framebuffer->GetWidth(), m_Framebuffer->GetHeight());
 		m_Framebuffer->Bind();
-		m_Framebuffer->ClearAll();
+		SetupViewport(m_Framebuffer);
+		if (m_UseCustomViewport)
+		{
+			// Only clear our region, the rest of the framebuffer can belong to other atlas tiles
+			glEnable(GL_SCISSOR_TEST);
+			glScissor(m_CustomViewport.x, m_CustomViewport.y, m_CustomViewport.z, m_CustomViewport.w);
+			m_Framebuffer->ClearAll();
+			glDisable(GL_SCISSOR_TEST);
+		}
+		else
+		{
+			m_Framebuffer->ClearAll();
+		}
 		if (m_Framebuffer->IsMultisampled()) {
 			m_GLCache->SetMultisample(true);
 		}
@@ -60,7 +104,7 @@ namespace Arcane
 
 		// Lighting setup
 		auto lightBindFunction = &LightManager::BindLightingUniforms;
-		if (renderOnlyStatic)
+		if (renderOnlyStatic && !m_IncludeDynamicLights)
 			lightBindFunction = &LightManager::BindStaticLightingUniforms;
 
 		// Render terrain
@@ -74,7 +118,9 @@ namespace Arcane
 		{
 			m_TerrainShader->SetUniform("usesClipPlane", false);
 		}
-		(lightManager->*lightBindFunction) (m_TerrainShader);
+		(lightManager->*lightBindFunction) (m_TerrainShader, camera);
+		if (m_ReducedQuality)
+			m_TerrainShader->SetUniform("textureLodBias", m_TextureLodBias);
 		m_TerrainShader->SetUniform("viewPos", camera->GetPosition());
 		m_TerrainShader->SetUniform("view", camera->GetViewMatrix());
 		m_TerrainShader->SetUniform("projection", camera->GetProjectionMatrix());
@@ -104,7 +150,9 @@ namespace Arcane
 			{
 				m_SkinnedModelShader->SetUniform("usesClipPlane", false);
 			}
-			(lightManager->*lightBindFunction) (m_SkinnedModelShader);
+			(lightManager->*lightBindFunction) (m_SkinnedModelShader, camera);
+			if (m_ReducedQuality)
+				m_SkinnedModelShader->SetUniform("textureLodBias", m_TextureLodBias);
 
 			// Shadowmap code
 			BindShadowmap(m_SkinnedModelShader, inputShadowmapData);
@@ -121,7 +169,9 @@ namespace Arcane
 				m_SkinnedModelShader->SetUniform("computeIBL", 0);
 			}
 
+			Renderer::BeginProbeSelection(probeManager);
 			Renderer::FlushOpaqueSkinnedMeshes(camera, RenderPassType::MaterialRequired, m_SkinnedModelShader);
+			Renderer::EndProbeSelection();
 		}
 
 		// Bind data to non-skinned shader and render non-skinned models
@@ -136,7 +186,9 @@ namespace Arcane
 			{
 				m_ModelShader->SetUniform("usesClipPlane", false);
 			}
-			(lightManager->*lightBindFunction) (m_ModelShader);
+			(lightManager->*lightBindFunction) (m_ModelShader, camera);
+			if (m_ReducedQuality)
+				m_ModelShader->SetUniform("textureLodBias", m_TextureLodBias);
 
 			// Shadowmap code
 			BindShadowmap(m_ModelShader, inputShadowmapData);
@@ -153,7 +205,9 @@ namespace Arcane
 				m_ModelShader->SetUniform("computeIBL", 0);
 			}
 
+			Renderer::BeginProbeSelection(probeManager);
 			Renderer::FlushOpaqueNonSkinnedMeshes(camera, RenderPassType::MaterialRequired, m_ModelShader);
+			Renderer::EndProbeSelection();
 		}
 
 		// Render pass output
@@ -164,8 +218,8 @@ namespace Arcane
 
 	LightingPassOutput ForwardLightingPass::ExecuteTransparentLightingPass(ShadowmapPassOutput &inputShadowmapData, Framebuffer *inputFramebuffer, ICamera *camera, bool renderOnlyStatic, bool useIBL)
 	{
-		glViewport(0, 0, inputFramebuffer->GetWidth(), inputFramebuffer->GetHeight());
 		inputFramebuffer->Bind();
+		SetupViewport(inputFramebuffer);
 		if (inputFramebuffer->IsMultisampled())
 		{
 			m_GLCache->SetMultisample(true);
@@ -186,7 +240,7 @@ namespace Arcane
 
 		// Lighting setup
 		auto lightBindFunction = &LightManager::BindLightingUniforms;
-		if (renderOnlyStatic)
+		if (renderOnlyStatic && !m_IncludeDynamicLights)
 			lightBindFunction = &LightManager::BindStaticLightingUniforms;
 
 		// Render transparent objects since we are in the transparent pass
@@ -212,7 +266,9 @@ namespace Arcane
 			{
 				m_SkinnedModelShader->SetUniform("usesClipPlane", false);
 			}
-			(lightManager->*lightBindFunction) (m_SkinnedModelShader);
+			(lightManager->*lightBindFunction) (m_SkinnedModelShader, camera);
+			if (m_ReducedQuality)
+				m_SkinnedModelShader->SetUniform("textureLodBias", m_TextureLodBias);
 
 			// Shadowmap code
 			BindShadowmap(m_SkinnedModelShader, inputShadowmapData);
@@ -229,7 +285,9 @@ namespace Arcane
 				m_SkinnedModelShader->SetUniform("computeIBL", 0);
 			}
 
+			Renderer::BeginProbeSelection(probeManager);
 			Renderer::FlushTransparentSkinnedMeshes(camera, RenderPassType::MaterialRequired, m_SkinnedModelShader);
+			Renderer::EndProbeSelection();
 		}
 
 		// Bind data to non-skinned shader and render non-skinned models
@@ -244,7 +302,9 @@ namespace Arcane
 			{
 				m_ModelShader->SetUniform("usesClipPlane", false);
 			}
-			(lightManager->*lightBindFunction) (m_ModelShader);
+			(lightManager->*lightBindFunction) (m_ModelShader, camera);
+			if (m_ReducedQuality)
+				m_ModelShader->SetUniform("textureLodBias", m_TextureLodBias);
 
 			// Shadowmap code
 			BindShadowmap(m_ModelShader, inputShadowmapData);
@@ -261,7 +321,9 @@ namespace Arcane
 				m_ModelShader->SetUniform("computeIBL", 0);
 			}
 
+			Renderer::BeginProbeSelection(probeManager);
 			Renderer::FlushTransparentNonSkinnedMeshes(camera, RenderPassType::MaterialRequired, m_ModelShader);
+			Renderer::EndProbeSelection();
 		}
 
 		// Render pass output
@@ -275,32 +337,31 @@ namespace Arcane
 		LightManager *lightManager = m_ActiveScene->GetLightManager();
 
 		bool hasDirShadowMap = shadowmapData.directionalShadowmapFramebuffer != nullptr;
-		bool hasSpotShadowMap = shadowmapData.spotLightShadowmapFramebuffer != nullptr;
 
 		shader->SetUniform("dirLightShadowData.lightShadowIndex", hasDirShadowMap ? lightManager->GetDirectionalLightShadowCasterIndex() : -1);
-		shader->SetUniform("spotLightShadowData.lightShadowIndex", hasSpotShadowMap ? lightManager->GetSpotLightShadowCasterIndex() : -1);
-		shader->SetUniform("pointLightShadowData.lightShadowIndex", shadowmapData.hasPointLightShadows ? lightManager->GetPointLightShadowCasterIndex() : -1);
 
 		if (hasDirShadowMap)
 		{
 			shadowmapData.directionalShadowmapFramebuffer->GetDepthStencilTexture()->Bind(0);
 			shader->SetUniform("dirLightShadowmap", 0);
-			shader->SetUniform("dirLightShadowData.lightSpaceViewProjectionMatrix", shadowmapData.directionalLightViewProjMatrix);
-			shader->SetUniform("dirLightShadowData.shadowBias", shadowmapData.directionalShadowmapBias);
+			shader->SetUniformArray("dirLightShadowData.lightSpaceViewProjectionMatrices[0]", shadowmapData.directionalShadowmapCascadeCount, shadowmapData.directionalLightViewProjMatrices);
+			shader->SetUniform("dirLightShadowData.cascadeShadowBiases", shadowmapData.directionalShadowmapCascadeBiases);
+			shader->SetUniform("dirLightShadowData.cascadeCount", shadowmapData.directionalShadowmapCascadeCount);
 		}
-		if (hasSpotShadowMap)
+
+		// Spot and point lights store the index of their shadow atlas tile, so the atlas just needs to be bound
+		lightManager->GetShadowAtlas()->Bind(shader, 1);
+	}
+
+	void ForwardLightingPass::SetupViewport(Framebuffer *framebuffer)
+	{
+		if (m_UseCustomViewport)
 		{
-			shadowmapData.spotLightShadowmapFramebuffer->GetDepthStencilTexture()->Bind(1);
-			shader->SetUniform("spotLightShadowmap", 1);
-			shader->SetUniform("spotLightShadowData.lightSpaceViewProjectionMatrix", shadowmapData.spotLightViewProjMatrix);
-			shader->SetUniform("spotLightShadowData.shadowBias", shadowmapData.spotLightShadowmapBias);
+			glViewport(m_CustomViewport.x, m_CustomViewport.y, m_CustomViewport.z, m_CustomViewport.w);
 		}
-		if (shadowmapData.hasPointLightShadows)
+		else
 		{
-			shader->SetUniform("pointLightShadowData.shadowBias", shadowmapData.pointLightShadowmapBias);
-			shader->SetUniform("pointLightShadowData.farPlane", shadowmapData.pointLightFarPlane);
+			glViewport(0, 0, framebuffer->GetWidth(), framebuffer->GetHeight());
 		}
-		shader->SetUniform("pointLightShadowCubemap", 2);
-		shadowmapData.pointLightShadowCubemap->Bind(2); // Must be bound even if there is no point light shadows. Thanks OpenGL Driver!
 	}
 }
@@ -25,12 +25,31 @@ namespace Arcane
 
 		LightingPassOutput ExecuteOpaqueLightingPass(ShadowmapPassOutput &inputShadowmapData, ICamera *camera, bool renderOnlyStatic, bool useIBL);
 		LightingPassOutput ExecuteTransparentLightingPass(ShadowmapPassOutput &inputShadowmapData, Framebuffer *inputFramebuffer, ICamera *camera, bool renderOnlyStatic, bool useIBL);
+
+		// Static only renders normally only use static lights, runtime probe updates need every light so lighting changes (ie time of day) end up in the probes
+		inline void SetIncludeDynamicLights(bool choice) { m_IncludeDynamicLights = choice; }
+
+		// Secondary views (ie planar water reflections) can use the reduced quality shader variants, which skip parallax/normal mapping, take a single shadow tap, and bias texture mips
+		void SetReducedQuality(bool choice, float textureLodBias = 0.0f);
+
+		// Only valid for passes that were given a custom framebuffer, allows the pass to be kept around while the target gets reallocated
+		void SetCustomFramebuffer(Framebuffer *customFramebuffer);
+
+		// Restricts rendering (and clearing) to a region of the framebuffer, used to render into a tile of an atlas. Viewport is (x, y, width, height)
+		void SetViewport(const glm::uvec4 &viewport);
+		void ResetViewport();
 	private:
 		void Init();
 
 		void BindShadowmap(Shader *shader, ShadowmapPassOutput &shadowmapData);
+		void SetupViewport(Framebuffer *framebuffer);
 	private:
 		bool m_AllocatedFramebuffer;
+		bool m_IncludeDynamicLights = false;
+		bool m_ReducedQuality = false;
+		float m_TextureLodBias = 0.0f;
+		bool m_UseCustomViewport = false;
+		glm::uvec4 m_CustomViewport;
 		Framebuffer *m_Framebuffer;
 		Shader *m_ModelShader, *m_SkinnedModelShader, *m_TerrainShader;
 	};
@@ -3,51 +3,71 @@
 
 #include <Arcane/Scene/Scene.h>
 #include <Arcane/Graphics/IBL/ProbeManager.h>
+#include <Arcane/Graphics/IBL/ProbeBakeCache.h>
 #include <Arcane/Graphics/IBL/LightProbe.h>
 #include <Arcane/Graphics/IBL/ReflectionProbe.h>
+#include <Arcane/Graphics/IBL/SphericalHarmonics.h>
 #include <Arcane/Graphics/Shader.h>
 #include <Arcane/Graphics/Skybox.h>
-#include <Arcane/Graphics/Renderer/Renderpass/Forward/ForwardLightingPass.h>
-#include <Arcane/Graphics/Renderer/Renderpass/ShadowmapPass.h>
+#include <Arcane/Graphics/Camera/ICamera.h>
 #include <Arcane/Graphics/Renderer/GLCache.h>
 #include <Arcane/Graphics/Renderer/Renderer.h>
+#include <Arcane/Util/Loaders/AssetManager.h>
 #include <Arcane/Util/Loaders/ShaderLoader.h>
 
 namespace Arcane
 {
 	ForwardProbePass::ForwardProbePass(Scene *scene) : RenderPass(scene),
-		m_SceneCaptureDirLightShadowFramebuffer(IBL_CAPTURE_RESOLUTION, IBL_CAPTURE_RESOLUTION, false), m_SceneCaptureSpotLightShadowFramebuffer(IBL_CAPTURE_RESOLUTION, IBL_CAPTURE_RESOLUTION, false), m_SceneCapturePointLightDepthCubemap(),
-		m_SceneCaptureLightingFramebuffer(IBL_CAPTURE_RESOLUTION, IBL_CAPTURE_RESOLUTION, false), m_LightProbeConvolutionFramebuffer(LIGHT_PROBE_RESOLUTION, LIGHT_PROBE_RESOLUTION, false), m_ReflectionProbeSamplingFramebuffer(REFLECTION_PROBE_RESOLUTION, REFLECTION_PROBE_RESOLUTION, false)
+		m_SceneCaptureShadowPass(scene), m_SceneCaptureLightingPass(scene, nullptr), m_BakeSavePending(false), m_UpdateStep(-1), m_CaptureReadbackFence(nullptr)
 	{
 		m_SceneCaptureSettings.TextureFormat = GL_RGBA16F;
 		m_SceneCaptureCubemap.SetCubemapSettings(m_SceneCaptureSettings);
 
-		CubemapSettings depthCubemapSettings;
-		depthCubemapSettings.TextureFormat = GL_DEPTH_COMPONENT;
-		depthCubemapSettings.TextureMinificationFilterMode = GL_LINEAR;
-		depthCubemapSettings.TextureMagnificationFilterMode = GL_LINEAR;
-		m_SceneCapturePointLightDepthCubemap.SetCubemapSettings(depthCubemapSettings);
+		m_SceneCaptureDirLightShadowDesc.Width = IBL_CAPTURE_RESOLUTION;
+		m_SceneCaptureDirLightShadowDesc.Height = IBL_CAPTURE_RESOLUTION;
+		m_SceneCaptureDirLightShadowDesc.DepthType = RenderTargetDepthType::RenderTargetDepthType_TextureArray;
+		m_SceneCaptureDirLightShadowDesc.DepthFormat = NormalizedDepthOnly;
+		m_SceneCaptureDirLightShadowDesc.DepthLayerCount = SHADOW_CASCADE_COUNT;
+		m_SceneCaptureDirLightShadowDesc.DepthBilinearFiltering = true;
+
+		m_SceneCaptureLightingDesc.Width = IBL_CAPTURE_RESOLUTION;
+		m_SceneCaptureLightingDesc.Height = IBL_CAPTURE_RESOLUTION;
+		m_SceneCaptureLightingDesc.HasColour = true;
+		m_SceneCaptureLightingDesc.ColourFormat = FloatingPoint16;
+		m_SceneCaptureLightingDesc.DepthType = RenderTargetDepthType::RenderTargetDepthType_RBO;
+		m_SceneCaptureLightingDesc.DepthFormat = NormalizedDepthOnly;
+
+		m_ReflectionProbeSamplingDesc.Width = REFLECTION_PROBE_RESOLUTION;
+		m_ReflectionProbeSamplingDesc.Height = REFLECTION_PROBE_RESOLUTION;
+		m_ReflectionProbeSamplingDesc.HasColour = true;
+		m_ReflectionProbeSamplingDesc.ColourFormat = FloatingPoint16;
 
-		m_SceneCaptureDirLightShadowFramebuffer.AddDepthStencilTexture(NormalizedDepthOnly, true).CreateFramebuffer();
-		m_SceneCaptureSpotLightShadowFramebuffer.AddDepthStencilTexture(NormalizedDepthOnly, true).CreateFramebuffer();
-		m_SceneCaptureLightingFramebuffer.AddColorTexture(FloatingPoint16).AddDepthStencilRBO(NormalizedDepthOnly).CreateFramebuffer();
-		m_LightProbeConvolutionFramebuffer.AddColorTexture(FloatingPoint16).CreateFramebuffer();
-		m_ReflectionProbeSamplingFramebuffer.AddColorTexture(FloatingPoint16).CreateFramebuffer();
-
-		for (int i = 0; i < 6; i++)
-		{
-			m_SceneCapturePointLightDepthCubemap.GenerateCubemapFace(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, IBL_CAPTURE_RESOLUTION, IBL_CAPTURE_RESOLUTION, GL_DEPTH_COMPONENT, nullptr);
-		}
 		for (int i = 0; i < 6; i++)
 		{
 			m_SceneCaptureCubemap.GenerateCubemapFace(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, IBL_CAPTURE_RESOLUTION, IBL_CAPTURE_RESOLUTION, GL_RGB, nullptr);
 		}
 
-		m_ConvolutionShader = ShaderLoader::LoadShader("LightProbe_Convolution.glsl");
 		m_ImportanceSamplingShader = ShaderLoader::LoadShader("ReflectionProbe_ImportanceSampling.glsl");
+
+		// Runtime update resources
+		glm::vec3 origin(0.0f, 0.0f, 0.0f);
+		glm::vec2 reflectionProbeResolution(REFLECTION_PROBE_RESOLUTION, REFLECTION_PROBE_RESOLUTION);
+		m_UpdateStagingReflectionProbe = new ReflectionProbe(origin, reflectionProbeResolution);
+		m_UpdateStagingReflectionProbe->Generate();
+
+		glGenBuffers(1, &m_CaptureReadbackBuffer);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, m_CaptureReadbackBuffer);
+		glBufferData(GL_PIXEL_PACK_BUFFER, 6 * IBL_CAPTURE_RESOLUTION * IBL_CAPTURE_RESOLUTION * 4 * sizeof(float), nullptr, GL_STREAM_READ);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 	}
 
-	ForwardProbePass::~ForwardProbePass() {}
+	ForwardProbePass::~ForwardProbePass() {
+		delete m_UpdateStagingReflectionProbe;
+
+		if (m_CaptureReadbackFence)
+			glDeleteSync(m_CaptureReadbackFence);
+		glDeleteBuffers(1, &m_CaptureReadbackBuffer);
+	}
 
 	void ForwardProbePass::pregenerateIBL() {
 		generateBRDFLUT();
@@ -55,10 +75,24 @@ namespace Arcane
 	}
 
 	void ForwardProbePass::pregenerateProbes() {
+		// Skip probe generation entirely if the scene's static content hasn't changed since the probes were last baked
+		ProbeManager *probeManager = m_ActiveScene->GetProbeManager();
+		std::size_t sceneHash = m_ActiveScene->CalculateStaticContentHash();
+		if (ProbeBakeCache::LoadProbes(PROBE_BAKE_FILEPATH, sceneHash, probeManager))
+			return;
+
 		// Temp for now, just generate a probe so we have something
 		glm::vec3 probePosition = glm::vec3(-32.60f, 10.0f, 48.48f);
 		generateLightProbe(probePosition);
 		generateReflectionProbe(probePosition);
+
+		// The hash includes models that are still loading, so a capture missing them can't be saved. It gets re-captured and saved once everything has loaded
+		if (AssetManager::GetInstance().AssetsInFlight())
+		{
+			m_BakeSavePending = true;
+			return;
+		}
+		ProbeBakeCache::SaveProbes(PROBE_BAKE_FILEPATH, sceneHash, probeManager);
 	}
 
 	void ForwardProbePass::generateBRDFLUT() {
@@ -105,70 +139,19 @@ namespace Arcane
 		m_CubemapCamera.SetPosition(origin);
 
 
-		// Light probe generation
-		LightProbe *fallbackLightProbe = new LightProbe(origin, glm::vec2(LIGHT_PROBE_RESOLUTION, LIGHT_PROBE_RESOLUTION));
-		fallbackLightProbe->Generate();
-
-		m_GLCache->SetShader(m_ConvolutionShader);
-		m_GLCache->SetFaceCull(false);
-		m_GLCache->SetDepthTest(false); // Important cause the depth buffer isn't cleared so it has zero depth
-
-		m_ConvolutionShader->SetUniform("projection", m_CubemapCamera.GetProjectionMatrix());
-		m_ActiveScene->GetSkybox()->GetSkyboxCubemap()->Bind(0);
-		m_ConvolutionShader->SetUniform("sceneCaptureCubemap", 0);
-
-		m_LightProbeConvolutionFramebuffer.Bind();
-		glViewport(0, 0, m_LightProbeConvolutionFramebuffer.GetWidth(), m_LightProbeConvolutionFramebuffer.GetHeight());
-		for (int i = 0; i < 6; i++) {
-			// Setup the camera's view
-			m_CubemapCamera.SwitchCameraToFace(i);
-			m_ConvolutionShader->SetUniform("view", m_CubemapCamera.GetViewMatrix());
-
-			// Convolute the scene's capture and store it in the Light Probe's cubemap
-			m_LightProbeConvolutionFramebuffer.SetColorAttachment(fallbackLightProbe->GetIrradianceMap()->GetCubemapID(), GL_TEXTURE_CUBE_MAP_POSITIVE_X + i);
-			Renderer::DrawNdcCube(); // Since we are sampling a cubemap, just use a cube
-		}
-		m_LightProbeConvolutionFramebuffer.SetColorAttachment(0, GL_TEXTURE_CUBE_MAP_POSITIVE_X);
-		m_GLCache->SetFaceCull(true);
-		m_GLCache->SetDepthTest(true);
+		// Light probe generation (the skybox is projected straight onto spherical harmonics)
+		LightProbe *fallbackLightProbe = new LightProbe(origin);
+		fallbackLightProbe->SetIrradiance(SphericalHarmonics::ProjectIrradiance(m_ActiveScene->GetSkybox()->GetSkyboxCubemap()));
 
 
 		// Reflection probe generation
 		ReflectionProbe *fallbackReflectionProbe = new ReflectionProbe(origin, glm::vec2(REFLECTION_PROBE_RESOLUTION, REFLECTION_PROBE_RESOLUTION));
 		fallbackReflectionProbe->Generate();
 
-		// Take the capture and perform importance sampling on the cubemap's mips that represent increased roughness levels
-		m_GLCache->SetShader(m_ImportanceSamplingShader);
-		m_GLCache->SetFaceCull(false);
-		m_GLCache->SetDepthTest(false); // Important cause the depth buffer isn't cleared so it has zero depth
-
-		m_ImportanceSamplingShader->SetUniform("projection", m_CubemapCamera.GetProjectionMatrix());
-		m_ActiveScene->GetSkybox()->GetSkyboxCubemap()->Bind(0);
-		m_ImportanceSamplingShader->SetUniform("sceneCaptureCubemap", 0);
-
-		m_ReflectionProbeSamplingFramebuffer.Bind();
+		// Perform importance sampling on the skybox for the cubemap's mips that represent increased roughness levels
 		for (int mip = 0; mip < REFLECTION_PROBE_MIP_COUNT; mip++) {
-			// Calculate the size of this mip and resize
-			unsigned int mipWidth = m_ReflectionProbeSamplingFramebuffer.GetWidth() >> mip;
-			unsigned int mipHeight = m_ReflectionProbeSamplingFramebuffer.GetHeight() >> mip;
-
-			glViewport(0, 0, mipWidth, mipHeight);
-
-			float mipRoughnessLevel = (float)mip / (float)(REFLECTION_PROBE_MIP_COUNT - 1);
-			m_ImportanceSamplingShader->SetUniform("roughness", mipRoughnessLevel);
-			for (int i = 0; i < 6; i++) {
-				// Setup the camera's view
-				m_CubemapCamera.SwitchCameraToFace(i);
-				m_ImportanceSamplingShader->SetUniform("view", m_CubemapCamera.GetViewMatrix());
-
-				// Importance sample the scene's capture and store it in the Reflection Probe's cubemap
-				m_ReflectionProbeSamplingFramebuffer.SetColorAttachment(fallbackReflectionProbe->GetPrefilterMap()->GetCubemapID(), GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mip);
-				Renderer::DrawNdcCube(); // Since we are sampling a cubemap, just use a cube
-			}
-			m_ReflectionProbeSamplingFramebuffer.SetColorAttachment(0, GL_TEXTURE_CUBE_MAP_POSITIVE_X);
+			prefilterReflectionProbeMip(m_ActiveScene->GetSkybox()->GetSkyboxCubemap(), fallbackReflectionProbe->GetPrefilterMap(), mip);
 		}
-		m_GLCache->SetFaceCull(true);
-		m_GLCache->SetDepthTest(true);
 
 
 		probeManager->SetLightProbeFallback(fallbackLightProbe);
@@ -176,117 +159,213 @@ namespace Arcane
 	}
 
 	void ForwardProbePass::generateLightProbe(glm::vec3 &probePosition) {
-		LightProbe *lightProbe = new LightProbe(probePosition, glm::vec2(LIGHT_PROBE_RESOLUTION, LIGHT_PROBE_RESOLUTION));
-		lightProbe->Generate();
+		LightProbe *lightProbe = new LightProbe(probePosition);
+		captureLightProbe(lightProbe);
 
-		// Initialize step before rendering to the probe's cubemap
-		m_CubemapCamera.SetPosition(probePosition);
-		ShadowmapPass shadowPass(m_ActiveScene, &m_SceneCaptureDirLightShadowFramebuffer, &m_SceneCaptureSpotLightShadowFramebuffer, &m_SceneCapturePointLightDepthCubemap);
-		ForwardLightingPass lightingPass(m_ActiveScene, &m_SceneCaptureLightingFramebuffer); // Use our framebuffer when rendering
+		ProbeManager *probeManager = m_ActiveScene->GetProbeManager();
+		probeManager->AddProbe(lightProbe);
+	}
 
-		// Render the scene to the probe's cubemap
-		for (int i = 0; i < 6; i++) {
-			// Setup the camera's view
-			m_CubemapCamera.SwitchCameraToFace(i);
+	void ForwardProbePass::generateReflectionProbe(glm::vec3 &probePosition) {
+		ReflectionProbe *reflectionProbe = new ReflectionProbe(probePosition, glm::vec2(REFLECTION_PROBE_RESOLUTION, REFLECTION_PROBE_RESOLUTION));
+		reflectionProbe->Generate();
+		captureReflectionProbe(reflectionProbe);
 
-			// Shadow pass
-			ShadowmapPassOutput shadowpassOutput = shadowPass.GenerateShadowmaps(&m_CubemapCamera, true);
+		ProbeManager *probeManager = m_ActiveScene->GetProbeManager();
+		probeManager->AddProbe(reflectionProbe);
+	}
 
-			// Light pass
-			m_SceneCaptureLightingFramebuffer.Bind();
-			m_SceneCaptureLightingFramebuffer.SetColorAttachment(m_SceneCaptureCubemap.GetCubemapID(), GL_TEXTURE_CUBE_MAP_POSITIVE_X + i);
-			LightingPassOutput output = lightingPass.ExecuteOpaqueLightingPass(shadowpassOutput, &m_CubemapCamera, true, false);
-			lightingPass.ExecuteTransparentLightingPass(shadowpassOutput, output.outputFramebuffer, &m_CubemapCamera, true, false);
+	void ForwardProbePass::captureLightProbe(LightProbe *lightProbe) {
+		// Render the scene to the probe's cubemap
+		m_CubemapCamera.SetPosition(lightProbe->GetPosition());
+		for (int i = 0; i < 6; i++) {
+			captureSceneFace(i, false);
 		}
-		m_SceneCaptureLightingFramebuffer.SetColorAttachment(0, GL_TEXTURE_CUBE_MAP_POSITIVE_X);
 
-		// Take the capture and apply convolution for the irradiance map (indirect diffuse)
-		m_GLCache->SetShader(m_ConvolutionShader);
-		m_GLCache->SetFaceCull(false);
-		m_GLCache->SetDepthTest(false); // Important cause the depth buffer isn't cleared so it has zero depth
-
-		m_ConvolutionShader->SetUniform("projection", m_CubemapCamera.GetProjectionMatrix());
-		m_SceneCaptureCubemap.Bind(0);
-		m_ConvolutionShader->SetUniform("sceneCaptureCubemap", 0);
+		// Project the capture onto spherical harmonics, the projection also convolves it into irradiance (indirect diffuse)
+		lightProbe->SetIrradiance(SphericalHarmonics::ProjectIrradiance(&m_SceneCaptureCubemap));
+	}
 
-		m_LightProbeConvolutionFramebuffer.Bind();
-		glViewport(0, 0, m_LightProbeConvolutionFramebuffer.GetWidth(), m_LightProbeConvolutionFramebuffer.GetHeight());
+	void ForwardProbePass::captureReflectionProbe(ReflectionProbe *reflectionProbe) {
+		// Render the scene to the probe's cubemap
+		m_CubemapCamera.SetPosition(reflectionProbe->GetPosition());
 		for (int i = 0; i < 6; i++) {
-			// Setup the camera's view
-			m_CubemapCamera.SwitchCameraToFace(i);
-			m_ConvolutionShader->SetUniform("view", m_CubemapCamera.GetViewMatrix());
+			captureSceneFace(i, false);
+		}
 
-			// Convolute the scene's capture and store it in the Light Probe's cubemap
-			m_LightProbeConvolutionFramebuffer.SetColorAttachment(lightProbe->GetIrradianceMap()->GetCubemapID(), GL_TEXTURE_CUBE_MAP_POSITIVE_X + i);
-			Renderer::DrawNdcCube(); // Since we are sampling a cubemap, just use a cube
+		// Take the capture and perform importance sampling on the cubemap's mips that represent increased roughness levels
+		for (int mip = 0; mip < REFLECTION_PROBE_MIP_COUNT; mip++) {
+			prefilterReflectionProbeMip(&m_SceneCaptureCubemap, reflectionProbe->GetPrefilterMap(), mip);
 		}
-		m_LightProbeConvolutionFramebuffer.SetColorAttachment(0, GL_TEXTURE_CUBE_MAP_POSITIVE_X);
-		m_GLCache->SetFaceCull(true);
-		m_GLCache->SetDepthTest(true);
+	}
 
+	void ForwardProbePass::finishPendingBake() {
+		// Same captures as pregenerateProbes, just into the probes it already created
 		ProbeManager *probeManager = m_ActiveScene->GetProbeManager();
-		probeManager->AddProbe(lightProbe);
+		for (LightProbe *lightProbe : probeManager->GetLightProbes()) {
+			captureLightProbe(lightProbe);
+		}
+		probeManager->MarkLightProbesDirty();
+		for (ReflectionProbe *reflectionProbe : probeManager->GetReflectionProbes()) {
+			captureReflectionProbe(reflectionProbe);
+		}
+
+		ProbeBakeCache::SaveProbes(PROBE_BAKE_FILEPATH, m_ActiveScene->CalculateStaticContentHash(), probeManager);
+		m_BakeSavePending = false;
 	}
 
-	void ForwardProbePass::generateReflectionProbe(glm::vec3 &probePosition) {
-		ReflectionProbe *reflectionProbe = new ReflectionProbe(probePosition, glm::vec2(REFLECTION_PROBE_RESOLUTION, REFLECTION_PROBE_RESOLUTION));
-		reflectionProbe->Generate();
+	unsigned int ForwardProbePass::updateProbes(ICamera *camera, double measuredUpdateGPUTimeMS, unsigned int measuredUpdateSteps) {
+		ProbeManager *probeManager = m_ActiveScene->GetProbeManager();
+		LightManager *lightManager = m_ActiveScene->GetLightManager();
+		m_UpdateScheduler.SyncProbes(probeManager, lightManager);
 
-		// Initialize step before rendering to the probe's cubemap
-		m_CubemapCamera.SetPosition(probePosition);
-		ShadowmapPass shadowPass(m_ActiveScene, &m_SceneCaptureDirLightShadowFramebuffer, &m_SceneCaptureSpotLightShadowFramebuffer, &m_SceneCapturePointLightDepthCubemap);
-		ForwardLightingPass lightingPass(m_ActiveScene, &m_SceneCaptureLightingFramebuffer); // Use our framebuffer when rendering
+		// Waits for a runtime update to finish since it shares the capture cubemap
+		if (m_BakeSavePending && m_UpdateStep < 0 && !AssetManager::GetInstance().AssetsInFlight()) {
+			finishPendingBake();
+			return 0;
+		}
 
-		// Render the scene to the probe's cubemap
-		for (int i = 0; i < 6; i++) {
-			// Setup the camera's view
-			m_CubemapCamera.SwitchCameraToFace(i);
+		unsigned int stepBudget = m_UpdateScheduler.BeginFrame(measuredUpdateGPUTimeMS, measuredUpdateSteps);
+		for (unsigned int i = 0; i < stepBudget; i++) {
+			if (m_UpdateStep < 0) {
+				if (!m_UpdateScheduler.SelectNextProbe(probeManager, lightManager, camera->GetPosition(), m_UpdateRequest))
+					break;
+
+				m_UpdateScheduler.BeginProbeUpdate(m_UpdateRequest);
+				m_UpdateStep = 0;
+			}
 
-			// Shadow pass
-			ShadowmapPassOutput shadowpassOutput = shadowPass.GenerateShadowmaps(&m_CubemapCamera, true);
+			if (!executeProbeUpdateStep())
+				break;
+			m_UpdateScheduler.OnStepExecuted();
 
-			// Light pass
-			m_SceneCaptureLightingFramebuffer.Bind();
-			m_SceneCaptureLightingFramebuffer.SetColorAttachment(m_SceneCaptureCubemap.GetCubemapID(), GL_TEXTURE_CUBE_MAP_POSITIVE_X + i);
-			LightingPassOutput output = lightingPass.ExecuteOpaqueLightingPass(shadowpassOutput, &m_CubemapCamera, true, false);
-			lightingPass.ExecuteTransparentLightingPass(shadowpassOutput, output.outputFramebuffer, &m_CubemapCamera, true, false);
+			// Only finish one probe per frame, so the probe selection isn't repeated within a frame
+			if (m_UpdateStep < 0)
+				break;
 		}
-		m_SceneCaptureLightingFramebuffer.SetColorAttachment(0, GL_TEXTURE_CUBE_MAP_POSITIVE_X);
+		return m_UpdateScheduler.GetStepsThisFrame();
+	}
 
-		// Take the capture and perform importance sampling on the cubemap's mips that represent increased roughness levels
+	void ForwardProbePass::captureSceneFace(int face, bool includeDynamicLights) {
+		// Setup the camera's view
+		m_CubemapCamera.SwitchCameraToFace(face);
+
+		Framebuffer *shadowFramebuffer = RenderTargetPool::Acquire(m_SceneCaptureDirLightShadowDesc);
+		Framebuffer *lightingFramebuffer = RenderTargetPool::Acquire(m_SceneCaptureLightingDesc);
+		m_SceneCaptureShadowPass.SetCustomDirectionalLightShadowFramebuffer(shadowFramebuffer);
+		m_SceneCaptureLightingPass.SetCustomFramebuffer(lightingFramebuffer);
+
+		// Shadow pass
+		ShadowmapPassOutput shadowpassOutput = m_SceneCaptureShadowPass.GenerateShadowmaps(&m_CubemapCamera, true);
+
+		// Light pass (only static models are captured, but runtime updates use every light so lighting changes show up in the probes)
+		m_SceneCaptureLightingPass.SetIncludeDynamicLights(includeDynamicLights);
+		lightingFramebuffer->Bind();
+		lightingFramebuffer->SetColorAttachment(m_SceneCaptureCubemap.GetCubemapID(), GL_TEXTURE_CUBE_MAP_POSITIVE_X + face);
+		LightingPassOutput output = m_SceneCaptureLightingPass.ExecuteOpaqueLightingPass(shadowpassOutput, &m_CubemapCamera, true, false);
+		m_SceneCaptureLightingPass.ExecuteTransparentLightingPass(shadowpassOutput, output.outputFramebuffer, &m_CubemapCamera, true, false);
+		lightingFramebuffer->SetColorAttachment(lightingFramebuffer->GetColourTexture()->GetTextureId(), GL_TEXTURE_2D); // Pooled targets have to be given back as they were created
+		m_SceneCaptureLightingPass.SetIncludeDynamicLights(false);
+
+		RenderTargetPool::Release(shadowFramebuffer);
+		RenderTargetPool::Release(lightingFramebuffer);
+	}
+
+	void ForwardProbePass::prefilterReflectionProbeMip(Cubemap *sceneCapture, Cubemap *prefilterMap, int mip) {
 		m_GLCache->SetShader(m_ImportanceSamplingShader);
 		m_GLCache->SetFaceCull(false);
 		m_GLCache->SetDepthTest(false); // Important cause the depth buffer isn't cleared so it has zero depth
 
 		m_ImportanceSamplingShader->SetUniform("projection", m_CubemapCamera.GetProjectionMatrix());
-		m_SceneCaptureCubemap.Bind(0);
+		sceneCapture->Bind(0);
 		m_ImportanceSamplingShader->SetUniform("sceneCaptureCubemap", 0);
 
-		m_ReflectionProbeSamplingFramebuffer.Bind();
-		for (int mip = 0; mip < REFLECTION_PROBE_MIP_COUNT; mip++) {
-			// Calculate the size of this mip and resize
-			unsigned int mipWidth = m_ReflectionProbeSamplingFramebuffer.GetWidth() >> mip;
-			unsigned int mipHeight = m_ReflectionProbeSamplingFramebuffer.GetHeight() >> mip;
-
-			glViewport(0, 0, mipWidth, mipHeight);
-			
-			float mipRoughnessLevel = (float)mip / (float)(REFLECTION_PROBE_MIP_COUNT - 1);
-			m_ImportanceSamplingShader->SetUniform("roughness", mipRoughnessLevel);
-			for (int i = 0; i < 6; i++) {
-				// Setup the camera's view
-				m_CubemapCamera.SwitchCameraToFace(i);
-				m_ImportanceSamplingShader->SetUniform("view", m_CubemapCamera.GetViewMatrix());
-
-				// Importance sample the scene's capture and store it in the Reflection Probe's cubemap
-				m_ReflectionProbeSamplingFramebuffer.SetColorAttachment(reflectionProbe->GetPrefilterMap()->GetCubemapID(), GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mip);
-				Renderer::DrawNdcCube(); // Since we are sampling a cubemap, just use a cube
-			}
-			m_ReflectionProbeSamplingFramebuffer.SetColorAttachment(0, GL_TEXTURE_CUBE_MAP_POSITIVE_X);
+		// Calculate the size of this mip and resize
+		Framebuffer *samplingFramebuffer = RenderTargetPool::Acquire(m_ReflectionProbeSamplingDesc);
+		samplingFramebuffer->Bind();
+		unsigned int mipWidth = samplingFramebuffer->GetWidth() >> mip;
+		unsigned int mipHeight = samplingFramebuffer->GetHeight() >> mip;
+		glViewport(0, 0, mipWidth, mipHeight);
+
+		float mipRoughnessLevel = (float)mip / (float)(REFLECTION_PROBE_MIP_COUNT - 1);
+		m_ImportanceSamplingShader->SetUniform("roughness", mipRoughnessLevel);
+		for (int i = 0; i < 6; i++) {
+			// Setup the camera's view
+			m_CubemapCamera.SwitchCameraToFace(i);
+			m_ImportanceSamplingShader->SetUniform("view", m_CubemapCamera.GetViewMatrix());
+
+			// Importance sample the scene's capture and store it in the Reflection Probe's cubemap
+			samplingFramebuffer->SetColorAttachment(prefilterMap->GetCubemapID(), GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mip);
+			Renderer::DrawNdcCube(); // Since we are sampling a cubemap, just use a cube
 		}
+		samplingFramebuffer->SetColorAttachment(samplingFramebuffer->GetColourTexture()->GetTextureId(), GL_TEXTURE_2D);
+		RenderTargetPool::Release(samplingFramebuffer);
+
 		m_GLCache->SetFaceCull(true);
 		m_GLCache->SetDepthTest(true);
+	}
 
+	bool ForwardProbePass::executeProbeUpdateStep() {
 		ProbeManager *probeManager = m_ActiveScene->GetProbeManager();
-		probeManager->AddProbe(reflectionProbe);
+		LightProbe *lightProbe = m_UpdateRequest.IsReflectionProbe ? nullptr : probeManager->GetLightProbes()[m_UpdateRequest.ProbeIndex];
+		ReflectionProbe *reflectionProbe = m_UpdateRequest.IsReflectionProbe ? probeManager->GetReflectionProbes()[m_UpdateRequest.ProbeIndex] : nullptr;
+
+		// Capture a face of the scene around the probe
+		if (m_UpdateStep < 6) {
+			m_CubemapCamera.SetPosition(reflectionProbe ? reflectionProbe->GetPosition() : lightProbe->GetPosition());
+			captureSceneFace(m_UpdateStep, true);
+
+			if (lightProbe && m_UpdateStep == 5) {
+				beginCaptureReadback();
+			}
+			m_UpdateStep++;
+			return true;
+		}
+
+		// Light probes project the capture onto spherical harmonics once the readback has finished, so the CPU never waits on the GPU
+		if (lightProbe) {
+			GLenum waitResult = glClientWaitSync(m_CaptureReadbackFence, 0, 0);
+			if (waitResult != GL_ALREADY_SIGNALED && waitResult != GL_CONDITION_SATISFIED)
+				return false;
+			glDeleteSync(m_CaptureReadbackFence);
+			m_CaptureReadbackFence = nullptr;
+
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, m_CaptureReadbackBuffer);
+			const float *faceData = static_cast<const float*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, 6 * IBL_CAPTURE_RESOLUTION * IBL_CAPTURE_RESOLUTION * 4 * sizeof(float), GL_MAP_READ_BIT));
+			if (faceData) {
+				lightProbe->SetIrradiance(SphericalHarmonics::ConvolveWithCosineLobe(SphericalHarmonics::ProjectRadiance(faceData, IBL_CAPTURE_RESOLUTION)));
+				probeManager->MarkLightProbesDirty();
+				glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			}
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+			m_UpdateStep = -1;
+			return true;
+		}
+
+		// Reflection probes prefilter a mip of the capture per step, once every mip is done the staging cubemap is swapped in
+		int mip = m_UpdateStep - 6;
+		prefilterReflectionProbeMip(&m_SceneCaptureCubemap, m_UpdateStagingReflectionProbe->GetPrefilterMap(), mip);
+		m_UpdateStep++;
+
+		if (mip == REFLECTION_PROBE_MIP_COUNT - 1) {
+			reflectionProbe->SwapPrefilterMap(m_UpdateStagingReflectionProbe);
+			m_UpdateStep = -1;
+		}
+		return true;
+	}
+
+	void ForwardProbePass::beginCaptureReadback() {
+		// Copies the capture into the readback buffer on the GPU's timeline, the fence lets a later frame know when it can be mapped without stalling
+		size_t faceSize = IBL_CAPTURE_RESOLUTION * IBL_CAPTURE_RESOLUTION * 4 * sizeof(float);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, m_CaptureReadbackBuffer);
+		for (int i = 0; i < 6; i++) {
+			m_SceneCaptureCubemap.GetFaceData(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, GL_FLOAT, reinterpret_cast<void*>(faceSize * i));
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		if (m_CaptureReadbackFence)
+			glDeleteSync(m_CaptureReadbackFence);
+		m_CaptureReadbackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 	}
 }
@@ -14,14 +14,29 @@
 #include <Arcane/Graphics/Renderer/Renderpass/RenderPass.h>
 #endif
 
-#ifndef FRAMEBUFFER_H
-#include <Arcane/Platform/OpenGL/Framebuffer/Framebuffer.h>
+#ifndef RENDERTARGETPOOL_H
+#include <Arcane/Graphics/Renderer/RenderTargetPool.h>
+#endif
+
+#ifndef SHADOWMAPPASS_H
+#include <Arcane/Graphics/Renderer/Renderpass/ShadowmapPass.h>
+#endif
+
+#ifndef FORWARDLIGHTINGPASS_H
+#include <Arcane/Graphics/Renderer/Renderpass/Forward/ForwardLightingPass.h>
+#endif
+
+#ifndef PROBEUPDATESCHEDULER_H
+#include <Arcane/Graphics/IBL/ProbeUpdateScheduler.h>
 #endif
 
 namespace Arcane
 {
 	class Shader;
 	class Scene;
+	class ICamera;
+	class LightProbe;
+	class ReflectionProbe;
 
 	class ForwardProbePass : public RenderPass {
 	public:
@@ -33,17 +48,47 @@ namespace Arcane
 
 		void generateLightProbe(glm::vec3& probePosition);
 		void generateReflectionProbe(glm::vec3& probePosition);
+
+		// Re-captures the probes whose lighting has changed, spread over multiple frames. measuredUpdateGPUTimeMS is how long a recent frame's update took on the GPU
+		// and measuredUpdateSteps how many steps that frame did (zero if there is no new measurement). Returns the amount of steps done this frame
+		unsigned int updateProbes(ICamera *camera, double measuredUpdateGPUTimeMS, unsigned int measuredUpdateSteps);
+
+		inline ProbeUpdateScheduler* GetUpdateScheduler() { return &m_UpdateScheduler; }
 	private:
 		void generateBRDFLUT();
 		void generateFallbackProbes();
+
+		// Captures the static scene at the probe's position, the same as the bake does
+		void captureLightProbe(LightProbe *lightProbe);
+		void captureReflectionProbe(ReflectionProbe *reflectionProbe);
+		void finishPendingBake();
+
+		// Assumes the cubemap camera is already at the probe's position
+		void captureSceneFace(int face, bool includeDynamicLights);
+		void prefilterReflectionProbeMip(Cubemap *sceneCapture, Cubemap *prefilterMap, int mip);
+
+		bool executeProbeUpdateStep(); // Returns false if the step has to wait for the GPU
+		void beginCaptureReadback();
 	private:
-		Framebuffer m_SceneCaptureDirLightShadowFramebuffer, m_SceneCaptureSpotLightShadowFramebuffer, m_SceneCaptureLightingFramebuffer, m_LightProbeConvolutionFramebuffer, m_ReflectionProbeSamplingFramebuffer;
-		Cubemap m_SceneCapturePointLightDepthCubemap;
+		// Capture targets are only leased from the render target pool while a face is captured or a mip is prefiltered, so they get trimmed once the probes stop updating
+		RenderTargetDesc m_SceneCaptureDirLightShadowDesc, m_SceneCaptureLightingDesc, m_ReflectionProbeSamplingDesc;
 		CubemapCamera m_CubemapCamera;
 		CubemapSettings m_SceneCaptureSettings;
 		Cubemap m_SceneCaptureCubemap;
+		ShadowmapPass m_SceneCaptureShadowPass;
+		ForwardLightingPass m_SceneCaptureLightingPass;
+
+		Shader *m_ImportanceSamplingShader;
+
+		bool m_BakeSavePending; // The bake was captured while assets were still loading, so it's re-captured and saved once they finish
 
-		Shader *m_ConvolutionShader, *m_ImportanceSamplingShader;
+		// Runtime probe updates. Steps 0-5 capture a face each, then light probes project the capture and reflection probes prefilter a mip per step
+		ProbeUpdateScheduler m_UpdateScheduler;
+		ProbeUpdateRequest m_UpdateRequest;
+		int m_UpdateStep; // -1 when no probe is being updated
+		ReflectionProbe *m_UpdateStagingReflectionProbe; // Prefiltered into, then swapped with the probe being updated so it never shows a half updated set of mips
+		GLuint m_CaptureReadbackBuffer;
+		GLsync m_CaptureReadbackFence;
 	};
 }
 #endif
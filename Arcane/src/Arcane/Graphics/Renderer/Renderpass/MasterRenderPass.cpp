@@ -8,22 +8,18 @@
 #include <Arcane/Util/Loaders/ShaderLoader.h>
 #include <Arcane/Scene/Scene.h>
 
-#ifdef ARC_DEV_BUILD
-#include <Arcane/Platform/OpenGL/GPUTimerManager.h>
-#endif
-
 namespace Arcane
 {
 	MasterRenderPass::MasterRenderPass(Scene *scene) : m_ActiveScene(scene),
-		m_ShadowmapPass(scene), m_PostProcessPass(scene), m_WaterPass(scene), m_EnvironmentProbePass(scene),
-		m_DeferredGeometryPass(scene), m_DeferredLightingPass(scene),
+		m_ShadowmapPass(scene), m_PostProcessPass(scene), m_WaterPass(scene), m_EditorPass(scene),
 #if FORWARD_RENDER
 		m_ForwardLightingPass(scene, true),
 #else
 		m_ForwardLightingPass(scene, false),
 #endif
-		m_RenderToSwapchain(true),
-		m_EditorPass(scene)
+		m_EnvironmentProbePass(scene),
+		m_DeferredGeometryPass(scene), m_DeferredLightingPass(scene), m_ScreenSpaceReflectionPass(scene),
+		m_RenderToSwapchain(true)
 	{
 		m_GLCache = GLCache::GetInstance();
 
@@ -36,150 +32,195 @@ namespace Arcane
 
 		m_EnvironmentProbePass.pregenerateIBL();
 		m_EnvironmentProbePass.pregenerateProbes();
-
-#ifdef ARC_DEV_BUILD
-	#if FORWARD_RENDER
-		m_ShadowPassTimer = GPUTimerManager::CreateGPUTimer(std::string("Shadow Map Generation Pass (GPU)"));
-		m_ForwardOpaquePassTimer = GPUTimerManager::CreateGPUTimer(std::string("Forward Opaque Pass (GPU)"));
-		m_WaterPassTimer = GPUTimerManager::CreateGPUTimer(std::string("Water Pass (GPU)"));
-		m_ForwardTransparentPassTimer = GPUTimerManager::CreateGPUTimer(std::string("Forward Transparent Pass (GPU)"));
-		m_PostProcessPassTimer = GPUTimerManager::CreateGPUTimer(std::string("Post Process Pass (GPU)"));
-		m_EditorPassTimer = GPUTimerManager::CreateGPUTimer(std::string("Editor Pass (GPU)"));
-	#else
-		m_ShadowPassTimer = GPUTimerManager::CreateGPUTimer(std::string("Shadow Map Generation Pass (GPU)"));
-		m_DeferredGeometryPassTimer = GPUTimerManager::CreateGPUTimer(std::string("Deferred Geometry Pass (GPU)"));
-		m_SSAOPassTimer = GPUTimerManager::CreateGPUTimer(std::string("SSAO Pass (GPU)"));
-		m_DeferredLightingPassTimer = GPUTimerManager::CreateGPUTimer(std::string("Deferred Lighting Pass (GPU)"));
-		m_WaterPassTimer = GPUTimerManager::CreateGPUTimer(std::string("Water Pass (GPU)"));
-		m_PostGBufferForwardPassTimer = GPUTimerManager::CreateGPUTimer(std::string("Post GBuffer Forward Transparent Pass (GPU)"));
-		m_PostProcessPassTimer = GPUTimerManager::CreateGPUTimer(std::string("Post Process Pass (GPU)"));
-		m_EditorPassTimer = GPUTimerManager::CreateGPUTimer(std::string("Editor Pass (GPU)"));
-	#endif
-#endif
 	}
 
 	void MasterRenderPass::Render() {
-#if FORWARD_RENDER
-		/* Forward Rendering */
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_ShadowPassTimer);
-#endif
-		ShadowmapPassOutput shadowmapOutput = m_ShadowmapPass.GenerateShadowmaps(m_ActiveScene->GetCamera(), false);
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_ShadowPassTimer);
-#endif
+		FPSCamera *camera = m_ActiveScene->GetCamera();
 
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_ForwardOpaquePassTimer);
-#endif
-		LightingPassOutput lightingOutput = m_ForwardLightingPass.ExecuteOpaqueLightingPass(shadowmapOutput, m_ActiveScene->GetCamera(), false, true);
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_ForwardOpaquePassTimer);
-#endif
+		m_FrameTimer.BeginFrame();
 
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_WaterPassTimer);
-#endif
-		WaterPassOutput waterOutput = m_WaterPass.ExecuteWaterPass(shadowmapOutput, lightingOutput.outputFramebuffer, m_ActiveScene->GetCamera());
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_WaterPassTimer);
-#endif
+		// Pass outputs are handed between the nodes through these, the graph only tracks them by name to know which nodes are needed
+		ShadowmapPassOutput shadowmapOutput;
+		Framebuffer *sceneFramebuffer = nullptr;
+		Texture *hdrSceneTexture = nullptr, *bloomTexture = nullptr;
+		Framebuffer *postProcessedFramebuffer = nullptr;
+		EditorPassOutput editorOutput;
 
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_ForwardTransparentPassTimer);
-#endif
-		LightingPassOutput postTransparencyOutput = m_ForwardLightingPass.ExecuteTransparentLightingPass(shadowmapOutput, waterOutput.outputFramebuffer, m_ActiveScene->GetCamera(), false, true);
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_ForwardTransparentPassTimer);
-#endif
+		m_RenderGraph.Reset();
 
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_PostProcessPassTimer);
-#endif
-		PostProcessPassOutput postProcessOutput = m_PostProcessPass.ExecutePostProcessPass(postTransparencyOutput.outputFramebuffer);
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_PostProcessPassTimer);
-#endif
+		/* Time-sliced probe updates (timed on their own in every build so the update can stay within it's GPU budget) */
+		m_RenderGraph.AddNode("Probe Update Pass", [&]()
+		{
+			m_ProbeUpdateTimer.BeginFrame();
+			unsigned int measuredSteps = m_ProbeUpdateTimer.HasNewResult() ? m_ProbeUpdateTimer.GetLatestFrameWorkCount() : 0;
+			unsigned int steps = m_EnvironmentProbePass.updateProbes(camera, m_ProbeUpdateTimer.GetLatestFrameTimeMS(), measuredSteps);
+			m_ProbeUpdateTimer.EndFrame(steps);
+		}).SetHasSideEffects();
 
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_EditorPassTimer);
-#endif
-		Framebuffer *extraFramebuffer = postProcessOutput.outFramebuffer == m_PostProcessPass.GetFullRenderTarget() ? m_PostProcessPass.GetTonemappedNonLinearTarget() : m_PostProcessPass.GetFullRenderTarget();
-		EditorPassOutput editorOutput = m_EditorPass.ExecuteEditorPass(postProcessOutput.outFramebuffer, m_PostProcessPass.GetResolveRenderTarget(), extraFramebuffer, m_ActiveScene->GetCamera());
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_EditorPassTimer);
-#endif
+#if FORWARD_RENDER
+		/* Forward Rendering */
+		m_RenderGraph.AddNode("Shadow Map Generation Pass", [&]()
+		{
+			shadowmapOutput = m_ShadowmapPass.GenerateShadowmaps(camera, false);
+		}).Write("Shadowmaps");
+
+		m_RenderGraph.AddNode("Forward Opaque Pass", [&]()
+		{
+			sceneFramebuffer = m_ForwardLightingPass.ExecuteOpaqueLightingPass(shadowmapOutput, camera, false, true).outputFramebuffer;
+		}).Read("Shadowmaps").Write("SceneColour");
 
+		m_RenderGraph.AddNode("Water Pass", [&]()
+		{
+			sceneFramebuffer = m_WaterPass.ExecuteWaterPass(shadowmapOutput, sceneFramebuffer, camera).outputFramebuffer;
+		}, m_WaterPass.HasVisibleWater()).Read("Shadowmaps").Read("SceneColour").Write("SceneColour");
+
+		m_RenderGraph.AddNode("Forward Transparent Pass", [&]()
+		{
+			sceneFramebuffer = m_ForwardLightingPass.ExecuteTransparentLightingPass(shadowmapOutput, sceneFramebuffer, camera, false, true).outputFramebuffer;
+		}).Read("Shadowmaps").Read("SceneColour").Write("SceneColour");
 
+		m_RenderGraph.AddNode("Post Process Resolve Pass", [&]()
+		{
+			hdrSceneTexture = m_PostProcessPass.ExecuteResolvePass(sceneFramebuffer);
+		}).Read("SceneColour").Write("ResolvedSceneColour");
 #else
 		/* Deferred Rendering */
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_ShadowPassTimer);
-#endif
-		ShadowmapPassOutput shadowmapOutput = m_ShadowmapPass.GenerateShadowmaps(m_ActiveScene->GetCamera(), false);
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_ShadowPassTimer);
-#endif
+		GeometryPassOutput geometryOutput;
+		PreLightingPassOutput preLightingOutput;
+		ScreenSpaceReflectionPassOutput ssrOutput;
+
+		// Pick the resolution the main view is rendered at from how long the GPU took on the latest frame that has finished. Everything up to the TAA resolve (or upscale)
+		// only renders into that part of it's targets
+		Window::SetRenderScale(m_DynamicResolution.Update(m_FrameTimer.GetLatestFrameTimeMS()));
+		m_ForwardLightingPass.SetViewport(glm::uvec4(0, 0, Window::GetScaledRenderResolutionWidth(), Window::GetScaledRenderResolutionHeight()));
+
+		// Everything up to the TAA resolve is rendered with the jittered projection, the editor is drawn on top of the resolved frame so it is left unjittered
+		camera->SetProjectionJitter(m_PostProcessPass.GetTemporalAAJitter());
+
+		// Half resolution targets only needed between a couple of nodes, the raw AO is done with before the reflections are traced so they share a framebuffer
+		RenderTargetDesc halfResolutionDesc;
+		halfResolutionDesc.Width = (unsigned int)(Window::GetRenderResolutionWidth() * 0.5f);
+		halfResolutionDesc.Height = (unsigned int)(Window::GetRenderResolutionHeight() * 0.5f);
+		halfResolutionDesc.HasColour = true;
+		halfResolutionDesc.ColourFormat = FloatingPoint16;
+		m_RenderGraph.DeclareTransient("SSAORaw", halfResolutionDesc);
+		m_RenderGraph.DeclareTransient("SSRReflection", halfResolutionDesc);
+
+		m_RenderGraph.AddNode("Shadow Map Generation Pass", [&]()
+		{
+			shadowmapOutput = m_ShadowmapPass.GenerateShadowmaps(camera, false);
+		}).Write("Shadowmaps");
 
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_DeferredGeometryPassTimer);
-#endif
-		GeometryPassOutput geometryOutput = m_DeferredGeometryPass.ExecuteGeometryPass(m_ActiveScene->GetCamera(), false);
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_DeferredGeometryPassTimer);
-#endif
+		m_RenderGraph.AddNode("Deferred Geometry Pass", [&]()
+		{
+			geometryOutput = m_DeferredGeometryPass.ExecuteGeometryPass(camera, false);
+		}).Write("GBuffer");
 
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_SSAOPassTimer);
-#endif
-		PreLightingPassOutput preLightingOutput = m_PostProcessPass.ExecutePreLightingPass(geometryOutput.outputGBuffer, m_ActiveScene->GetCamera());
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_SSAOPassTimer);
-#endif
+		m_RenderGraph.AddNode("SSAO Pass", [&]()
+		{
+			preLightingOutput = m_PostProcessPass.ExecutePreLightingPass(geometryOutput.outputGBuffer, camera, m_RenderGraph.GetTransient("SSAORaw"));
+		}).Read("GBuffer").Write("SSAORaw").Write("SSAO");
 
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_DeferredLightingPassTimer);
-#endif
-		LightingPassOutput deferredLightingOutput = m_DeferredLightingPass.ExecuteLightingPass(shadowmapOutput, geometryOutput.outputGBuffer, preLightingOutput, m_ActiveScene->GetCamera(), true);
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_DeferredLightingPassTimer);
-#endif
+		// Also builds the depth pyramid occlusion culling reads back in later frames, so it always runs
+		m_RenderGraph.AddNode("SSR Pass", [&]()
+		{
+			// The lighting pass hasn't run yet so it's framebuffer still holds the previous frame's lit scene
+			ssrOutput = m_ScreenSpaceReflectionPass.ExecuteScreenSpaceReflectionPass(geometryOutput.outputGBuffer, m_DeferredLightingPass.GetFramebuffer()->GetColourTexture(), camera, m_RenderGraph.GetTransient("SSRReflection"));
+			m_DeferredGeometryPass.GetHiZOcclusionCuller()->QueueReadback(ssrOutput.hiZBuffer, camera->GetProjectionMatrix() * camera->GetViewMatrix());
+		}).Read("GBuffer").Write("SSRReflection").Write("HiZBuffer").SetHasSideEffects();
 
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_WaterPassTimer);
-#endif
-		WaterPassOutput waterOutput = m_WaterPass.ExecuteWaterPass(shadowmapOutput, deferredLightingOutput.outputFramebuffer, m_ActiveScene->GetCamera());
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_WaterPassTimer);
-#endif
+		m_RenderGraph.AddNode("Deferred Lighting Pass", [&]()
+		{
+			sceneFramebuffer = m_DeferredLightingPass.ExecuteLightingPass(shadowmapOutput, geometryOutput.outputGBuffer, preLightingOutput, ssrOutput, camera, true).outputFramebuffer;
+		}).Read("Shadowmaps").Read("GBuffer").Read("SSAO").Read("SSRReflection").Write("SceneColour");
 
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_PostGBufferForwardPassTimer);
-#endif
-		LightingPassOutput postGBufferForward = m_ForwardLightingPass.ExecuteTransparentLightingPass(shadowmapOutput, waterOutput.outputFramebuffer, m_ActiveScene->GetCamera(), false, true);
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_PostGBufferForwardPassTimer);
-#endif
+		m_RenderGraph.AddNode("Water Pass", [&]()
+		{
+			sceneFramebuffer = m_WaterPass.ExecuteWaterPass(shadowmapOutput, sceneFramebuffer, camera, ssrOutput.hiZBuffer).outputFramebuffer;
+		}, m_WaterPass.HasVisibleWater()).Read("Shadowmaps").Read("HiZBuffer").Read("SceneColour").Write("SceneColour");
 
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_PostProcessPassTimer);
-#endif
-		PostProcessPassOutput postProcessOutput = m_PostProcessPass.ExecutePostProcessPass(postGBufferForward.outputFramebuffer);
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_PostProcessPassTimer);
-#endif
+		m_RenderGraph.AddNode("Post GBuffer Forward Transparent Pass", [&]()
+		{
+			sceneFramebuffer = m_ForwardLightingPass.ExecuteTransparentLightingPass(shadowmapOutput, sceneFramebuffer, camera, false, true).outputFramebuffer;
+		}).Read("Shadowmaps").Read("SceneColour").Write("SceneColour");
 
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::BeginQuery(m_EditorPassTimer);
-#endif
-		Framebuffer *extraFramebuffer = postProcessOutput.outFramebuffer == m_PostProcessPass.GetFullRenderTarget() ? m_PostProcessPass.GetTonemappedNonLinearTarget() : m_PostProcessPass.GetFullRenderTarget();
-		EditorPassOutput editorOutput = m_EditorPass.ExecuteEditorPass(postProcessOutput.outFramebuffer, m_PostProcessPass.GetResolveRenderTarget(), extraFramebuffer, m_ActiveScene->GetCamera());
-#ifdef ARC_DEV_BUILD
-		GPUTimerManager::EndQuery(m_EditorPassTimer);
-#endif
+		m_RenderGraph.AddNode("Post Process Resolve Pass", [&]()
+		{
+			hdrSceneTexture = m_PostProcessPass.ExecuteResolvePass(sceneFramebuffer, geometryOutput.outputGBuffer, camera);
 
+			camera->SetProjectionJitter(glm::vec2(0.0f, 0.0f));
+			Window::SetRenderScale(1.0f);
+		}).Read("SceneColour").Read("GBuffer").Write("ResolvedSceneColour");
 #endif
 
+		// Everything after the resolve is at the full render resolution. The bloom chain is only needed until the uber pass has added it to the scene and the tonemapped frame
+		// only until FXAA or the editor have read it, so they are transients. The bloom's half resolution target can reuse the framebuffer the SSAO or SSR had, and the editor's
+		// highlight can reuse the tonemapped frame's once FXAA is done with it
+		bool bloomEnabled = m_PostProcessPass.GetBloomEnabledRef();
+		bool fxaaEnabled = m_PostProcessPass.GetFxaaEnabledRef();
+		const char *bloomChainNames[PostProcessPass::BloomChainLength] = { "BloomHalf", "BloomQuarter", "BloomEighth" };
+		for (int i = 0; i < PostProcessPass::BloomChainLength; i++)
+		{
+			RenderTargetDesc bloomDesc;
+			bloomDesc.Width = (unsigned int)(Window::GetRenderResolutionWidth() * (0.5f / (1 << i)));
+			bloomDesc.Height = (unsigned int)(Window::GetRenderResolutionHeight() * (0.5f / (1 << i)));
+			bloomDesc.HasColour = true;
+			bloomDesc.ColourFormat = FloatingPoint16;
+			m_RenderGraph.DeclareTransient(bloomChainNames[i], bloomDesc);
+		}
+
+		// The editor draws it's debug quads with depth into whichever of these ends up being the output
+		RenderTargetDesc displayDesc;
+		displayDesc.Width = Window::GetRenderResolutionWidth();
+		displayDesc.Height = Window::GetRenderResolutionHeight();
+		displayDesc.HasColour = true;
+		displayDesc.ColourFormat = Normalized8;
+		displayDesc.DepthType = RenderTargetDepthType::RenderTargetDepthType_RBO;
+		displayDesc.DepthFormat = NormalizedDepthOnly;
+		m_RenderGraph.DeclareTransient("TonemappedColour", displayDesc);
+		m_RenderGraph.DeclareTransient("FxaaColour", displayDesc);
+		m_RenderGraph.DeclareTransient("EditorHighlight", displayDesc);
+		m_RenderGraph.DeclareTransient("EditorColour", displayDesc);
+
+		m_RenderGraph.AddNode("Bloom Pass", [&]()
+		{
+			Framebuffer *bloomChain[PostProcessPass::BloomChainLength];
+			for (int i = 0; i < PostProcessPass::BloomChainLength; i++)
+			{
+				bloomChain[i] = m_RenderGraph.GetTransient(bloomChainNames[i]);
+			}
+			bloomTexture = m_PostProcessPass.Bloom(hdrSceneTexture, bloomChain);
+		}, bloomEnabled).Read("ResolvedSceneColour").Write("BloomHalf").Write("BloomQuarter").Write("BloomEighth");
+
+		// Converts the scene from HDR (linear) -> SDR (sRGB) and applies every effect that only needs the current pixel
+		RenderGraphNode &uberNode = m_RenderGraph.AddNode("Uber Post Process Pass", [&]()
+		{
+			postProcessedFramebuffer = m_RenderGraph.GetTransient("TonemappedColour");
+			m_PostProcessPass.UberPostProcess(postProcessedFramebuffer, hdrSceneTexture, bloomTexture);
+		}).Read("ResolvedSceneColour").Write("TonemappedColour");
+		if (bloomEnabled)
+			uberNode.Read("BloomHalf");
+
+		// Effects that need the neighbouring pixels of the tonemapped frame still need their own pass
+		m_RenderGraph.AddNode("FXAA Pass", [&]()
+		{
+			Framebuffer *fxaaTarget = m_RenderGraph.GetTransient("FxaaColour");
+			m_PostProcessPass.Fxaa(fxaaTarget, postProcessedFramebuffer->GetColourTexture());
+			postProcessedFramebuffer = fxaaTarget;
+		}, fxaaEnabled).Read("TonemappedColour").Write("FxaaColour");
+
+		// The last node, so nothing can be given the framebuffer it outputs before it's copied to the swapchain and shown by the editor
+		m_RenderGraph.AddNode("Editor Pass", [&]()
+		{
+			editorOutput = m_EditorPass.ExecuteEditorPass(postProcessedFramebuffer, m_RenderGraph.GetTransient("EditorHighlight"), m_RenderGraph.GetTransient("EditorColour"), camera);
+		}).Read(fxaaEnabled ? "FxaaColour" : "TonemappedColour").Write("EditorHighlight").Write("EditorColour").Write("FinalColour");
+
+		m_RenderGraph.MarkOutput("FinalColour");
+		m_RenderGraph.Execute();
+
+		// Motion vectors next frame are measured from where everything was this frame
+		m_ActiveScene->StorePreviousTransforms();
+
 		// Finally render the scene to the window's swapchain
 		m_FinalOutputTexture = editorOutput.outFramebuffer->GetColourTexture();
 		if (m_RenderToSwapchain)
@@ -191,5 +232,7 @@ namespace Arcane
 			m_FinalOutputTexture->Bind(0);
 			Renderer::DrawNdcPlane();
 		}
+
+		m_FrameTimer.EndFrame();
 	}
 }
@@ -10,6 +10,10 @@
 #include <Arcane/Graphics/Renderer/Renderpass/Deferred/DeferredLightingPass.h>
 #endif
 
+#ifndef SCREENSPACEREFLECTIONPASS_H
+#include <Arcane/Graphics/Renderer/Renderpass/Deferred/ScreenSpaceReflectionPass.h>
+#endif
+
 #ifndef FORWARDPROBEPASS_H
 #include <Arcane/Graphics/Renderer/Renderpass/Forward/ForwardProbePass.h>
 #endif
@@ -34,9 +38,20 @@
 #include <Arcane/Graphics/Renderer/Renderpass/ShadowmapPass.h>
 #endif
 
+#ifndef DYNAMICRESOLUTION_H
+#include <Arcane/Graphics/Renderer/DynamicResolution.h>
+#endif
+
+#ifndef RENDERGRAPH_H
+#include <Arcane/Graphics/Renderer/RenderGraph.h>
+#endif
+
+#ifndef GPUFRAMETIMER_H
+#include <Arcane/Platform/OpenGL/GPUFrameTimer.h>
+#endif
+
 namespace Arcane
 {
-	class GPUTimer;
 	class Scene;
 	class Shader;
 
@@ -53,6 +68,11 @@ namespace Arcane
 		inline Texture* GetFinalOutputTexture() { return m_FinalOutputTexture; }
 		inline PostProcessPass* GetPostProcessPass() { return &m_PostProcessPass; }
 		inline EditorPass* GetEditorPass() { return &m_EditorPass; }
+		inline ForwardProbePass* GetEnvironmentProbePass() { return &m_EnvironmentProbePass; }
+		inline ScreenSpaceReflectionPass* GetScreenSpaceReflectionPass() { return &m_ScreenSpaceReflectionPass; }
+		inline DeferredGeometryPass* GetDeferredGeometryPass() { return &m_DeferredGeometryPass; }
+		inline DynamicResolution* GetDynamicResolution() { return &m_DynamicResolution; }
+		inline RenderGraph* GetRenderGraph() { return &m_RenderGraph; }
 	private:
 		GLCache *m_GLCache;
 		Scene *m_ActiveScene;
@@ -73,17 +93,15 @@ namespace Arcane
 		// Deferred passes
 		DeferredGeometryPass m_DeferredGeometryPass;
 		DeferredLightingPass m_DeferredLightingPass;
+		ScreenSpaceReflectionPass m_ScreenSpaceReflectionPass;
 
 		// Controls
 		bool m_RenderToSwapchain;
+		DynamicResolution m_DynamicResolution;
+		GPUFrameTimer m_FrameTimer; // Times everything Render does in every build, dynamic resolution is driven by it
+		GPUFrameTimer m_ProbeUpdateTimer; // Times the probe update node in every build, the update's GPU budget is driven by it
 
-#ifdef ARC_DEV_BUILD
-	#if FORWARD_RENDER
-		GPUTimer *m_ShadowPassTimer, *m_ForwardOpaquePassTimer, *m_WaterPassTimer, *m_ForwardTransparentPassTimer, *m_PostProcessPassTimer, *m_EditorPassTimer;
-	#else
-		GPUTimer *m_ShadowPassTimer, *m_DeferredGeometryPassTimer, *m_SSAOPassTimer, *m_DeferredLightingPassTimer, *m_WaterPassTimer, *m_PostGBufferForwardPassTimer, *m_PostProcessPassTimer, *m_EditorPassTimer;
-	#endif
-#endif
+		RenderGraph m_RenderGraph; // Rebuilt every frame, it keeps the transient render target pool and a GPU timer per node between frames
 	};
 }
 #endif
@@ -13,40 +13,39 @@
 
 namespace Arcane
 {
-	PostProcessPass::PostProcessPass(Scene *scene) : RenderPass(scene), m_SsaoRenderTarget((unsigned int)(Window::GetRenderResolutionWidth() * 0.5f), (unsigned int)(Window::GetRenderResolutionHeight() * 0.5f), false), m_SsaoBlurRenderTarget((unsigned int)(Window::GetRenderResolutionWidth() * 0.5f), (unsigned int)(Window::GetRenderResolutionHeight() * 0.5f), false),
-		m_TonemappedNonLinearTarget(Window::GetRenderResolutionWidth(), Window::GetRenderResolutionHeight(), false), m_ResolveRenderTarget(Window::GetRenderResolutionWidth(), Window::GetRenderResolutionHeight(), false), m_BrightPassRenderTarget(Window::GetRenderResolutionWidth(), Window::GetRenderResolutionHeight(), false),
-		m_BloomFullRenderTarget(Window::GetRenderResolutionWidth(), Window::GetRenderResolutionHeight(), false), m_BloomHalfRenderTarget((unsigned int)(Window::GetRenderResolutionWidth() * 0.5f), (unsigned int)(Window::GetRenderResolutionHeight() * 0.5f), false), m_BloomQuarterRenderTarget((unsigned int)(Window::GetRenderResolutionWidth() * 0.25f), (unsigned int)(Window::GetRenderResolutionHeight() * 0.25f), false), m_BloomEightRenderTarget((unsigned int)(Window::GetRenderResolutionWidth() * 0.125f), (unsigned int)(Window::GetRenderResolutionHeight() * 0.125f), false),
-		m_FullRenderTarget(Window::GetRenderResolutionWidth(), Window::GetRenderResolutionHeight(), false), m_HalfRenderTarget((unsigned int)(Window::GetRenderResolutionWidth() * 0.5f), (unsigned int)(Window::GetRenderResolutionHeight() * 0.5f), false), m_QuarterRenderTarget((unsigned int)(Window::GetRenderResolutionWidth() * 0.25f), (unsigned int)(Window::GetRenderResolutionHeight() * 0.25f), false), m_EighthRenderTarget((unsigned int)(Window::GetRenderResolutionWidth() * 0.125f), (unsigned int)(Window::GetRenderResolutionHeight() * 0.125f), false),
-		m_VignetteTexture(nullptr), m_SsaoNoiseTexture(), m_EffectsTimer()
+	static_assert(SSAO_KERNEL_SIZE <= 64, "The SSAO shader's kernel block only holds 64 samples");
+	static_assert(SSAO_KERNEL_SIZE % SSAO_SAMPLES_PER_FRAME == 0, "Temporal SSAO splits the kernel into equal slices");
+
+	PostProcessPass::PostProcessPass(Scene *scene) : RenderPass(scene), m_SsaoTemporalEvenRenderTarget((unsigned int)(Window::GetRenderResolutionWidth() * 0.5f), (unsigned int)(Window::GetRenderResolutionHeight() * 0.5f), false),
+		m_SsaoTemporalOddRenderTarget((unsigned int)(Window::GetRenderResolutionWidth() * 0.5f), (unsigned int)(Window::GetRenderResolutionHeight() * 0.5f), false), m_SsaoUpsampleRenderTarget(Window::GetRenderResolutionWidth(), Window::GetRenderResolutionHeight(), false),
+		m_ResolveRenderTarget(Window::GetRenderResolutionWidth(), Window::GetRenderResolutionHeight(), false),
+		m_TaaEvenRenderTarget(Window::GetRenderResolutionWidth(), Window::GetRenderResolutionHeight(), false), m_TaaOddRenderTarget(Window::GetRenderResolutionWidth(), Window::GetRenderResolutionHeight(), false), m_UpscaleRenderTarget(Window::GetRenderResolutionWidth(), Window::GetRenderResolutionHeight(), false),
+		m_VignetteTexture(nullptr), m_SsaoKernelBuffer(), m_SsaoNoiseTexture(), m_SsaoPreviousViewProjection(1.0f), m_SsaoPreviousRenderScale(1.0f), m_SsaoFrameIndex(0), m_SsaoHistoryValid(false), m_TaaPreviousViewProjection(1.0f), m_TaaFrameIndex(0), m_TaaHistoryValid(false), m_LuminanceHistogramBuffer(), m_ExposureBuffer(), m_LastExposureUpdateTime(0.0), m_ExposureHistoryValid(false), m_EffectsTimer()
 	{
 		// Shader setup
-		m_TonemapGammaCorrectShader = ShaderLoader::LoadShader("TonemapGammaCorrect.glsl");
 		m_FxaaShader = ShaderLoader::LoadShader("post_process/fxaa/FXAA.glsl");
+		m_TaaShader = ShaderLoader::LoadShader("post_process/taa/TAA.glsl");
+		m_UpscaleShader = ShaderLoader::LoadShader("post_process/upscale/Upscale.glsl");
 		m_SsaoShader = ShaderLoader::LoadShader("post_process/ssao/SSAO.glsl");
-		m_SsaoBlurShader = ShaderLoader::LoadShader("post_process/ssao/SSAO_Blur.glsl");
-		m_BloomBrightPassShader = ShaderLoader::LoadShader("post_process/bloom/BloomBrightPass.glsl");
-		m_BloomGaussianBlurShader = ShaderLoader::LoadShader("post_process/bloom/BloomGaussianBlur.glsl");
-		m_BloomComposite = ShaderLoader::LoadShader("post_process/bloom/Composite.glsl");
-		m_VignetteShader = ShaderLoader::LoadShader("post_process/vignette/vignette.glsl");
-		m_ChromaticAberrationShader = ShaderLoader::LoadShader("post_process/chromatic_aberration/ChromaticAberration.glsl");
-		m_FilmGrainShader = ShaderLoader::LoadShader("post_process/film_grain/FilmGrain.glsl");
+		m_SsaoTemporalShader = ShaderLoader::LoadShader("post_process/ssao/SSAO_Temporal.glsl");
+		m_SsaoUpsampleShader = ShaderLoader::LoadShader("post_process/ssao/SSAO_Upsample.glsl");
+		m_BloomDownsampleShader = ShaderLoader::LoadShader("post_process/bloom/BloomDownsample.glsl");
+		m_BloomUpsampleShader = ShaderLoader::LoadShader("post_process/bloom/BloomUpsample.glsl");
+		m_BloomDownsampleComputeShader = ShaderLoader::LoadShader("compute/Bloom_Downsample.glsl");
+		m_BloomUpsampleComputeShader = ShaderLoader::LoadShader("compute/Bloom_Upsample.glsl");
+		m_SceneLuminanceShader = ShaderLoader::LoadShader("compute/Scene_Luminance.glsl");
+		m_ExposureAdaptationShader = ShaderLoader::LoadShader("compute/Exposure_Adaptation.glsl");
+		m_UberShaders.fill(nullptr);
+		GetUberShader(UberEffect_Bloom); // Default effects, compiled up front so the first frame doesn't have to
 
 		// Framebuffer setup
-		m_SsaoRenderTarget.AddColorTexture(NormalizedSingleChannel8).CreateFramebuffer();
-		m_SsaoBlurRenderTarget.AddColorTexture(NormalizedSingleChannel8).CreateFramebuffer();
-		m_TonemappedNonLinearTarget.AddColorTexture(Normalized8).AddDepthStencilRBO(NormalizedDepthOnly).CreateFramebuffer();
+		m_SsaoTemporalEvenRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
+		m_SsaoTemporalOddRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
+		m_SsaoUpsampleRenderTarget.AddColorTexture(NormalizedSingleChannel8).CreateFramebuffer();
 		m_ResolveRenderTarget.AddColorTexture(FloatingPoint16).AddDepthStencilRBO(NormalizedDepthOnly).CreateFramebuffer();
-
-		m_FullRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
-		m_HalfRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
-		m_QuarterRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
-		m_EighthRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
-
-		m_BrightPassRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
-		m_BloomFullRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
-		m_BloomHalfRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
-		m_BloomQuarterRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
-		m_BloomEightRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
+		m_TaaEvenRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
+		m_TaaOddRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
+		m_UpscaleRenderTarget.AddColorTexture(FloatingPoint16).CreateFramebuffer();
 
 		// SSAO Hemisphere Sample Generation (tangent space)
 		std::uniform_real_distribution<float> randomFloats(0.0f, 1.0f);
@@ -62,9 +61,13 @@ namespace Arcane
 			scale = Lerp(0.1f, 1.0f, scale * scale);
 			hemisphereSample *= scale;
 
-			m_SsaoKernel[i] = hemisphereSample;
+			m_SsaoKernel[i] = glm::vec4(hemisphereSample, 0.0f);
 		}
 
+		// The kernel never changes so it is only uploaded once
+		m_SsaoKernelBuffer.Allocate(sizeof(m_SsaoKernel), GL_STATIC_DRAW);
+		m_SsaoKernelBuffer.Upload(&m_SsaoKernel[0], sizeof(m_SsaoKernel));
+
 		// SSAO Random Rotation Texture (used to apply a random rotation when constructing the change of basis matrix)
 		// Random vectors should be in tangent space
 		std::array<glm::vec3, 16> noiseSSAO;
@@ -82,24 +85,41 @@ namespace Arcane
 		ssaoNoiseTextureSettings.HasMips = false;
 		m_SsaoNoiseTexture.SetTextureSettings(ssaoNoiseTextureSettings);
 		m_SsaoNoiseTexture.Generate2DTexture(4, 4, GL_RGB, GL_FLOAT, &noiseSSAO[0]);
+
+		// Auto exposure buffers, the histogram starts cleared and is cleared again by the GPU every time it is averaged
+		std::array<unsigned int, LuminanceHistogramBinCount> emptyHistogram = {};
+		m_LuminanceHistogramBuffer.Allocate(sizeof(emptyHistogram), GL_DYNAMIC_COPY);
+		m_LuminanceHistogramBuffer.Upload(&emptyHistogram[0], sizeof(emptyHistogram));
+		glm::vec2 initialExposure(1.0f, m_Exposure);
+		m_ExposureBuffer.Allocate(sizeof(initialExposure), GL_DYNAMIC_COPY);
+		m_ExposureBuffer.Upload(&initialExposure, sizeof(initialExposure));
 	}
 
 	PostProcessPass::~PostProcessPass() {}
 
-	// Generates the AO of the scene using SSAO and stores it in a single channel texture
-	PreLightingPassOutput PostProcessPass::ExecutePreLightingPass(GBuffer *inputGbuffer, ICamera *camera)
+	// Generates the AO of the scene using SSAO at half resolution, accumulates it over multiple frames then upsamples it into a full resolution single channel texture
+	PreLightingPassOutput PostProcessPass::ExecutePreLightingPass(GBuffer *inputGbuffer, ICamera *camera, Framebuffer *ssaoTarget)
 	{
 		PreLightingPassOutput passOutput;
 		if (!m_SsaoEnabled)
 		{
+			m_SsaoHistoryValid = false;
 			passOutput.ssaoTexture = AssetManager::GetInstance().GetWhiteTexture();
 			return passOutput;
 		}
 
-		// Generate the AO factors for the scene
-		glViewport(0, 0, m_SsaoRenderTarget.GetWidth(), m_SsaoRenderTarget.GetHeight());
-		m_SsaoRenderTarget.Bind();
+		glm::mat4 viewInverse = glm::inverse(camera->GetViewMatrix());
+		glm::mat4 projectionInverse = glm::inverse(camera->GetProjectionMatrix());
+
+		// With dynamic resolution only part of the GBuffer was rendered to, so only the matching part of every target is used
+		float renderScale = Window::GetRenderScale();
+		glm::ivec2 ssaoSize(Window::GetScaledDimension(ssaoTarget->GetWidth()), Window::GetScaledDimension(ssaoTarget->GetHeight()));
+
+		// Generate the AO factors for the scene (AO and view space depth)
+		glViewport(0, 0, ssaoSize.x, ssaoSize.y);
+		ssaoTarget->Bind();
 		m_GLCache->SetDepthTest(false);
+		m_GLCache->SetBlend(false);
 		m_GLCache->SetFaceCull(true);
 		m_GLCache->SetCullFace(GL_BACK);
 
@@ -107,18 +127,35 @@ namespace Arcane
 		m_GLCache->SetShader(m_SsaoShader);
 
 		// Used to tile the noise texture across the screen every 4 texels (because our noise texture is 4x4)
-		m_SsaoShader->SetUniform("noiseScale", glm::vec2(m_SsaoRenderTarget.GetWidth() * 0.25f, m_SsaoRenderTarget.GetHeight() * 0.25f));
+		m_SsaoShader->SetUniform("noiseScale", glm::vec2(ssaoSize) * 0.25f);
+		m_SsaoShader->SetUniform("renderScale", renderScale);
 
-		m_SsaoShader->SetUniform("ssaoStrength", m_SsaoStrength);
+		// With temporal accumulation each frame takes an interleaved slice of the kernel (so every slice has near and far samples) and the noise is rotated by the golden angle,
+		// this way the accumulated AO ends up using every sample of the kernel in lots of different orientations
+		if (m_SsaoTemporalEnabled)
+		{
+			const unsigned int sliceCount = SSAO_KERNEL_SIZE / SSAO_SAMPLES_PER_FRAME;
+			const float noiseAngle = 2.39996323f * (float)m_SsaoFrameIndex;
+			m_SsaoShader->SetUniform("numKernelSamples", SSAO_SAMPLES_PER_FRAME);
+			m_SsaoShader->SetUniform("sampleOffset", (int)(m_SsaoFrameIndex % sliceCount));
+			m_SsaoShader->SetUniform("sampleStride", (int)sliceCount);
+			m_SsaoShader->SetUniform("noiseRotation", glm::vec2(std::cos(noiseAngle), std::sin(noiseAngle)));
+		}
+		else
+		{
+			m_SsaoShader->SetUniform("numKernelSamples", SSAO_KERNEL_SIZE);
+			m_SsaoShader->SetUniform("sampleOffset", 0);
+			m_SsaoShader->SetUniform("sampleStride", 1);
+			m_SsaoShader->SetUniform("noiseRotation", glm::vec2(1.0f, 0.0f));
+		}
 		m_SsaoShader->SetUniform("sampleRadius", m_SsaoSampleRadius);
 		m_SsaoShader->SetUniform("sampleRadius2", m_SsaoSampleRadius * m_SsaoSampleRadius);
-		m_SsaoShader->SetUniform("numKernelSamples", (int)m_SsaoKernel.size());
-		m_SsaoShader->SetUniformArray("samples", static_cast<int>(m_SsaoKernel.size()), &m_SsaoKernel[0]);
+		m_SsaoKernelBuffer.BindBase(SsaoKernelBufferBinding);
 
 		m_SsaoShader->SetUniform("view", camera->GetViewMatrix());
 		m_SsaoShader->SetUniform("projection", camera->GetProjectionMatrix());
-		m_SsaoShader->SetUniform("viewInverse", glm::inverse(camera->GetViewMatrix()));
-		m_SsaoShader->SetUniform("projectionInverse", glm::inverse(camera->GetProjectionMatrix()));
+		m_SsaoShader->SetUniform("viewInverse", viewInverse);
+		m_SsaoShader->SetUniform("projectionInverse", projectionInverse);
 
 		inputGbuffer->GetNormal()->Bind(0);
 		m_SsaoShader->SetUniform("normalTexture", 0);
@@ -130,31 +167,70 @@ namespace Arcane
 		// Render our NDC quad to perform SSAO
 		Renderer::DrawNdcPlane();
 
-		// Blur the result
-		m_SsaoBlurRenderTarget.Bind();
-		m_SsaoBlurShader->Enable();
-
-		m_SsaoBlurShader->SetUniform("numSamplesAroundTexel", 2); // 5x5 kernel blur
-		m_SsaoBlurShader->SetUniform("ssaoInput", 0); // Texture unit
-		m_SsaoRenderTarget.GetColourTexture()->Bind(0);
+		// Blend the AO with the AO accumulated over the previous frames
+		Framebuffer *upsampleInput = ssaoTarget;
+		if (m_SsaoTemporalEnabled)
+		{
+			Framebuffer *accumulationTarget = (m_SsaoFrameIndex & 1) ? &m_SsaoTemporalOddRenderTarget : &m_SsaoTemporalEvenRenderTarget;
+			Framebuffer *historyTarget = (m_SsaoFrameIndex & 1) ? &m_SsaoTemporalEvenRenderTarget : &m_SsaoTemporalOddRenderTarget;
+
+			accumulationTarget->Bind();
+			m_GLCache->SetShader(m_SsaoTemporalShader);
+			m_SsaoTemporalShader->SetUniform("historyValid", m_SsaoHistoryValid);
+			m_SsaoTemporalShader->SetUniform("historyWeight", m_SsaoHistoryWeight);
+			m_SsaoTemporalShader->SetUniform("historyDepthTolerance", SSAO_HISTORY_DEPTH_TOLERANCE);
+			m_SsaoTemporalShader->SetUniform("viewInverse", viewInverse);
+			m_SsaoTemporalShader->SetUniform("projectionInverse", projectionInverse);
+			m_SsaoTemporalShader->SetUniform("previousViewProjection", m_SsaoPreviousViewProjection);
+			m_SsaoTemporalShader->SetUniform("renderScale", renderScale);
+			m_SsaoTemporalShader->SetUniform("previousRenderScale", m_SsaoPreviousRenderScale);
+
+			ssaoTarget->GetColourTexture()->Bind(0);
+			m_SsaoTemporalShader->SetUniform("ssaoInput", 0);
+			historyTarget->GetColourTexture()->Bind(1);
+			m_SsaoTemporalShader->SetUniform("ssaoHistory", 1);
+			inputGbuffer->GetDepthStencilTexture()->Bind(2);
+			m_SsaoTemporalShader->SetUniform("depthTexture", 2);
+
+			Renderer::DrawNdcPlane();
+
+			upsampleInput = accumulationTarget;
+			m_SsaoHistoryValid = true;
+		}
+		else
+		{
+			m_SsaoHistoryValid = false;
+		}
+		m_SsaoPreviousViewProjection = camera->GetProjectionMatrix() * camera->GetViewMatrix();
+		m_SsaoPreviousRenderScale = renderScale;
+		m_SsaoFrameIndex++;
+
+		// Upsample to full resolution without blurring the AO across depth discontinuities
+		glViewport(0, 0, Window::GetScaledDimension(m_SsaoUpsampleRenderTarget.GetWidth()), Window::GetScaledDimension(m_SsaoUpsampleRenderTarget.GetHeight()));
+		m_SsaoUpsampleRenderTarget.Bind();
+		m_GLCache->SetShader(m_SsaoUpsampleShader);
+		m_SsaoUpsampleShader->SetUniform("ssaoInputSize", ssaoSize);
+		m_SsaoUpsampleShader->SetUniform("renderScale", renderScale);
+		m_SsaoUpsampleShader->SetUniform("ssaoStrength", m_SsaoStrength);
+		m_SsaoUpsampleShader->SetUniform("projectionInverse", projectionInverse);
+
+		upsampleInput->GetColourTexture()->Bind(0);
+		m_SsaoUpsampleShader->SetUniform("ssaoInput", 0);
+		inputGbuffer->GetDepthStencilTexture()->Bind(1);
+		m_SsaoUpsampleShader->SetUniform("depthTexture", 1);
 
-		// Render our NDC quad to blur our SSAO texture
 		Renderer::DrawNdcPlane();
-		
+
 		// Reset unusual state
 		m_GLCache->SetDepthTest(true);
 
 		// Render pass output
-		passOutput.ssaoTexture = m_SsaoBlurRenderTarget.GetColourTexture();
+		passOutput.ssaoTexture = m_SsaoUpsampleRenderTarget.GetColourTexture();
 		return passOutput;
 	}
 
-	PostProcessPassOutput PostProcessPass::ExecutePostProcessPass(Framebuffer *framebufferToProcess)
+	Texture* PostProcessPass::ExecuteResolvePass(Framebuffer *framebufferToProcess, GBuffer *inputGbuffer, ICamera *camera)
 	{
-		PostProcessPassOutput output;
-
-		GLCache *glCache = GLCache::GetInstance();
-
 		// If the framebuffer is multi-sampled, resolve it
 		Framebuffer *inputFramebuffer = framebufferToProcess;
 		if (framebufferToProcess->IsMultisampled())
@@ -169,59 +245,36 @@ namespace Arcane
 		if (Application::GetInstance().GetWireframe())
 			glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
-		//Texture *sceneWithBloom = Bloom(target->getColourTexture());
-		//TonemapGammaCorrect(&m_TonemappedNonLinearTarget, sceneWithBloom);
-
-		// Convert our scene from HDR (linear) -> SDR (sRGB)
-		TonemapGammaCorrect(&m_TonemappedNonLinearTarget, inputFramebuffer->GetColourTexture());
-		inputFramebuffer = &m_TonemappedNonLinearTarget;
-
-		Framebuffer *framebufferToRenderTo = nullptr;
-		if (m_ChromaticAberrationEnabled)
+		// Anti-alias before anything else so the exposure, bloom and tonemap all see the stable image. TAA also upscales a dynamic resolution frame, otherwise it gets it's own upscale
+		Texture *hdrSceneTexture = inputFramebuffer->GetColourTexture();
+		if (m_TaaEnabled && inputGbuffer && camera)
 		{
-			if (framebufferToRenderTo == &m_FullRenderTarget) framebufferToRenderTo = &m_TonemappedNonLinearTarget;
-			else framebufferToRenderTo = &m_FullRenderTarget;
-
-			ChromaticAberration(framebufferToRenderTo, inputFramebuffer->GetColourTexture());
-			inputFramebuffer = framebufferToRenderTo;
+			hdrSceneTexture = TemporalAA(hdrSceneTexture, inputGbuffer, camera);
 		}
-
-		if (m_FilmGrainEnabled)
+		else
 		{
-			if (framebufferToRenderTo == &m_FullRenderTarget) framebufferToRenderTo = &m_TonemappedNonLinearTarget;
-			else framebufferToRenderTo = &m_FullRenderTarget;
-
-			FilmGrain(framebufferToRenderTo, inputFramebuffer->GetColourTexture());
-			inputFramebuffer = framebufferToRenderTo;
-		}
-
-		if (m_VignetteEnabled)
-		{
-			if (framebufferToRenderTo == &m_FullRenderTarget) framebufferToRenderTo = &m_TonemappedNonLinearTarget;
-			else framebufferToRenderTo = &m_FullRenderTarget;
-
-			Vignette(framebufferToRenderTo, inputFramebuffer->GetColourTexture());
-			inputFramebuffer = framebufferToRenderTo;
+			m_TaaHistoryValid = false;
+			if (Window::GetRenderScale() < 1.0f)
+				hdrSceneTexture = Upscale(hdrSceneTexture);
 		}
 
-		if (m_FxaaEnabled)
-		{
-			if (framebufferToRenderTo == &m_FullRenderTarget) framebufferToRenderTo = &m_TonemappedNonLinearTarget;
-			else framebufferToRenderTo = &m_FullRenderTarget;
-
-			Fxaa(framebufferToRenderTo, inputFramebuffer->GetColourTexture());
-			inputFramebuffer = framebufferToRenderTo;
-		}
+		AutoExposure(hdrSceneTexture);
 
-		// Finally return the output frame after being post processed
-		output.outFramebuffer = inputFramebuffer;
-		return output;
+		return hdrSceneTexture;
 	}
 
-	void PostProcessPass::TonemapGammaCorrect(Framebuffer *target, Texture *hdrTexture)
+	void PostProcessPass::UberPostProcess(Framebuffer *target, Texture *hdrTexture, Texture *bloomTexture)
 	{
+		unsigned int effects = 0;
+		if (bloomTexture != nullptr) effects |= UberEffect_Bloom;
+		if (m_ChromaticAberrationEnabled) effects |= UberEffect_ChromaticAberration;
+		if (m_FilmGrainEnabled) effects |= UberEffect_FilmGrain;
+		if (m_VignetteEnabled) effects |= UberEffect_Vignette;
+		if (m_VignetteEnabled && m_VignetteTexture != nullptr) effects |= UberEffect_VignetteMask;
+		Shader *uberShader = GetUberShader(effects);
+
 		glViewport(0, 0, target->GetWidth(), target->GetHeight());
-		m_GLCache->SetShader(m_TonemapGammaCorrectShader);
+		m_GLCache->SetShader(uberShader);
 		m_GLCache->SetDepthTest(false);
 		m_GLCache->SetBlend(false);
 		m_GLCache->SetFaceCull(true);
@@ -229,61 +282,187 @@ namespace Arcane
 		m_GLCache->SetStencilTest(false);
 		target->Bind();
 
-		m_TonemapGammaCorrectShader->SetUniform("gamma_inverse", 1.0f / m_GammaCorrection); 
-		m_TonemapGammaCorrectShader->SetUniform("exposure", m_Exposure);
-		m_TonemapGammaCorrectShader->SetUniform("input_texture", 0);
+		uberShader->SetUniform("gamma_inverse", 1.0f / m_GammaCorrection);
+		uberShader->SetUniform("input_texture", 0);
+		m_ExposureBuffer.BindBase(ExposureBufferBinding);
 		hdrTexture->Bind(0);
 
+		if (effects & UberEffect_Bloom)
+		{
+			uberShader->SetUniform("bloom_strength", m_BloomStrength);
+			uberShader->SetUniform("bloom_texture", 1);
+			bloomTexture->Bind(1);
+		}
+		if (effects & UberEffect_ChromaticAberration)
+		{
+			uberShader->SetUniform("chromatic_aberration_intensity", m_ChromaticAberrationIntensity * 100);
+			uberShader->SetUniform("texel_size", glm::vec2(1.0f / (float)target->GetWidth(), 1.0f / (float)target->GetHeight()));
+		}
+		if (effects & UberEffect_FilmGrain)
+		{
+			uberShader->SetUniform("film_grain_intensity", m_FilmGrainIntensity * 100.0f);
+			uberShader->SetUniform("time", (float)(std::fmod(m_EffectsTimer.Elapsed(), 100.0)));
+		}
+		if (effects & UberEffect_Vignette)
+		{
+			uberShader->SetUniform("vignette_colour", m_VignetteColour);
+			uberShader->SetUniform("vignette_intensity", m_VignetteIntensity);
+		}
+		if (effects & UberEffect_VignetteMask)
+		{
+			uberShader->SetUniform("vignette_mask", 2);
+			m_VignetteTexture->Bind(2);
+		}
+
 		Renderer::DrawNdcPlane();
 	}
 
-	void PostProcessPass::Fxaa(Framebuffer *target, Texture *texture)
+	Texture* PostProcessPass::TemporalAA(Texture *hdrSceneTexture, GBuffer *inputGbuffer, ICamera *camera)
 	{
-		glViewport(0, 0, target->GetWidth(), target->GetHeight());
-		m_GLCache->SetShader(m_FxaaShader);
+		Framebuffer *resolveTarget = (m_TaaFrameIndex & 1) ? &m_TaaOddRenderTarget : &m_TaaEvenRenderTarget;
+		Framebuffer *historyTarget = (m_TaaFrameIndex & 1) ? &m_TaaEvenRenderTarget : &m_TaaOddRenderTarget;
+		glm::mat4 viewProjection = camera->GetUnjitteredProjectionMatrix() * camera->GetViewMatrix();
+
+		glViewport(0, 0, resolveTarget->GetWidth(), resolveTarget->GetHeight());
+		m_GLCache->SetShader(m_TaaShader);
 		m_GLCache->SetDepthTest(false);
 		m_GLCache->SetBlend(false);
 		m_GLCache->SetFaceCull(true);
 		m_GLCache->SetCullFace(GL_BACK);
 		m_GLCache->SetStencilTest(false);
-		target->Bind();
+		resolveTarget->Bind();
 
-		m_FxaaShader->SetUniform("texel_size", glm::vec2(1.0f / (float)texture->GetWidth(), 1.0f / (float)texture->GetHeight()));
-		m_FxaaShader->SetUniform("input_texture", 0);
-		texture->Bind(0);
+		m_TaaShader->SetUniform("historyValid", m_TaaHistoryValid);
+		m_TaaShader->SetUniform("historyWeight", m_TaaHistoryWeight);
+		m_TaaShader->SetUniform("texelSize", glm::vec2(1.0f / (float)hdrSceneTexture->GetWidth(), 1.0f / (float)hdrSceneTexture->GetHeight()));
+		m_TaaShader->SetUniform("renderScale", Window::GetRenderScale());
+		m_TaaShader->SetUniform("viewProjectionInverse", glm::inverse(viewProjection));
+		m_TaaShader->SetUniform("previousViewProjection", m_TaaPreviousViewProjection);
+
+		hdrSceneTexture->Bind(0);
+		m_TaaShader->SetUniform("sceneTexture", 0);
+		historyTarget->GetColourTexture()->Bind(1);
+		m_TaaShader->SetUniform("historyTexture", 1);
+		inputGbuffer->GetMotionVectors()->Bind(2);
+		m_TaaShader->SetUniform("motionTexture", 2);
+		inputGbuffer->GetDepthStencilTexture()->Bind(3);
+		m_TaaShader->SetUniform("depthTexture", 3);
 
 		Renderer::DrawNdcPlane();
+
+		m_TaaPreviousViewProjection = viewProjection;
+		m_TaaHistoryValid = true;
+		m_TaaFrameIndex++;
+
+		return resolveTarget->GetColourTexture();
 	}
 
-	void PostProcessPass::Vignette(Framebuffer *target, Texture *texture, Texture *optionalVignetteMask)
+	Texture* PostProcessPass::Upscale(Texture *hdrSceneTexture)
 	{
-		glViewport(0, 0, target->GetWidth(), target->GetHeight());
-		m_GLCache->SetShader(m_VignetteShader);
+		glViewport(0, 0, m_UpscaleRenderTarget.GetWidth(), m_UpscaleRenderTarget.GetHeight());
+		m_GLCache->SetShader(m_UpscaleShader);
 		m_GLCache->SetDepthTest(false);
 		m_GLCache->SetBlend(false);
 		m_GLCache->SetFaceCull(true);
 		m_GLCache->SetCullFace(GL_BACK);
 		m_GLCache->SetStencilTest(false);
-		target->Bind();
+		m_UpscaleRenderTarget.Bind();
 
-		m_VignetteShader->SetUniform("colour", m_VignetteColour);
-		m_VignetteShader->SetUniform("intensity", m_VignetteIntensity);
-		m_VignetteShader->SetUniform("input_texture", 0);
-		texture->Bind(0);
-		if (optionalVignetteMask != nullptr)
+		m_UpscaleShader->SetUniform("renderScale", Window::GetRenderScale());
+		hdrSceneTexture->Bind(0);
+		m_UpscaleShader->SetUniform("sceneTexture", 0);
+
+		Renderer::DrawNdcPlane();
+
+		return m_UpscaleRenderTarget.GetColourTexture();
+	}
+
+	glm::vec2 PostProcessPass::GetTemporalAAJitter() const
+	{
+		if (!m_TaaEnabled)
+			return glm::vec2(0.0f, 0.0f);
+
+		// Halton(2, 3) covers the pixel evenly with only a handful of samples, centred on the pixel and converted to NDC (a pixel is 2 / resolution wide).
+		// Pixels are the ones actually rendered, so with dynamic resolution they are larger
+		unsigned int sampleIndex = (m_TaaFrameIndex % TAA_JITTER_SAMPLE_COUNT) + 1;
+		glm::vec2 jitter(Halton(sampleIndex, 2) - 0.5f, Halton(sampleIndex, 3) - 0.5f);
+		return jitter * glm::vec2(2.0f / (float)Window::GetScaledRenderResolutionWidth(), 2.0f / (float)Window::GetScaledRenderResolutionHeight());
+	}
+
+	float PostProcessPass::Halton(unsigned int index, unsigned int base) const
+	{
+		float result = 0.0f;
+		float fraction = 1.0f / (float)base;
+		while (index > 0)
 		{
-			m_VignetteShader->SetUniform("usesMask", 1);
-			m_VignetteShader->SetUniform("vignette_mask", 1);
-			optionalVignetteMask->Bind(1);
+			result += (float)(index % base) * fraction;
+			index /= base;
+			fraction /= (float)base;
 		}
+		return result;
+	}
 
-		Renderer::DrawNdcPlane();
+	void PostProcessPass::AutoExposure(Texture *hdrSceneTexture)
+	{
+		double currentTime = m_EffectsTimer.Elapsed();
+		float deltaTime = static_cast<float>(currentTime - m_LastExposureUpdateTime);
+		m_LastExposureUpdateTime = currentTime;
+
+		// A manual exposure is just written straight into the buffer the tonemap reads
+		if (!m_AutoExposureEnabled)
+		{
+			m_ExposureBuffer.Upload(&m_Exposure, sizeof(float), sizeof(float));
+			m_ExposureHistoryValid = false;
+			return;
+		}
+
+		const float logLuminanceRange = AUTO_EXPOSURE_MAX_LOG_LUMINANCE - AUTO_EXPOSURE_MIN_LOG_LUMINANCE;
+		m_LuminanceHistogramBuffer.BindBase(LuminanceHistogramBufferBinding);
+		m_ExposureBuffer.BindBase(ExposureBufferBinding);
+
+		// Bin every pixel of the scene by it's log luminance
+		m_GLCache->SetShader(m_SceneLuminanceShader);
+		m_SceneLuminanceShader->SetUniform("minLogLuminance", AUTO_EXPOSURE_MIN_LOG_LUMINANCE);
+		m_SceneLuminanceShader->SetUniform("inverseLogLuminanceRange", 1.0f / logLuminanceRange);
+		m_SceneLuminanceShader->SetUniform("scene_texture", 0);
+		hdrSceneTexture->Bind(0);
+		glDispatchCompute((hdrSceneTexture->GetWidth() + SceneLuminanceGroupSize - 1) / SceneLuminanceGroupSize, (hdrSceneTexture->GetHeight() + SceneLuminanceGroupSize - 1) / SceneLuminanceGroupSize, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+		// Average the histogram and adapt towards it, when there is no history (first frame or auto exposure was just enabled) it snaps straight to the average
+		float adaptationRate = m_ExposureHistoryValid ? 1.0f - std::exp(-deltaTime * m_AutoExposureAdaptationSpeed) : 1.0f;
+		m_GLCache->SetShader(m_ExposureAdaptationShader);
+		m_ExposureAdaptationShader->SetUniform("pixelCount", static_cast<int>(hdrSceneTexture->GetWidth() * hdrSceneTexture->GetHeight()));
+		m_ExposureAdaptationShader->SetUniform("minLogLuminance", AUTO_EXPOSURE_MIN_LOG_LUMINANCE);
+		m_ExposureAdaptationShader->SetUniform("logLuminanceRange", logLuminanceRange);
+		m_ExposureAdaptationShader->SetUniform("adaptationRate", adaptationRate);
+		m_ExposureAdaptationShader->SetUniform("keyValue", AUTO_EXPOSURE_KEY_VALUE);
+		m_ExposureAdaptationShader->SetUniform("exposureCompensation", m_Exposure);
+		glDispatchCompute(1, 1, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+		m_ExposureHistoryValid = true;
+	}
+
+	Shader* PostProcessPass::GetUberShader(unsigned int effects)
+	{
+		if (m_UberShaders[effects] == nullptr)
+		{
+			std::vector<std::string> defines;
+			if (effects & UberEffect_Bloom) defines.push_back("BLOOM");
+			if (effects & UberEffect_ChromaticAberration) defines.push_back("CHROMATIC_ABERRATION");
+			if (effects & UberEffect_FilmGrain) defines.push_back("FILM_GRAIN");
+			if (effects & UberEffect_Vignette) defines.push_back("VIGNETTE");
+			if (effects & UberEffect_VignetteMask) defines.push_back("VIGNETTE_MASK");
+			m_UberShaders[effects] = ShaderLoader::LoadShader("post_process/uber/PostProcessUber.glsl", defines);
+		}
+		return m_UberShaders[effects];
 	}
 
-	void PostProcessPass::ChromaticAberration(Framebuffer *target, Texture *texture)
+	void PostProcessPass::Fxaa(Framebuffer *target, Texture *texture)
 	{
 		glViewport(0, 0, target->GetWidth(), target->GetHeight());
-		m_GLCache->SetShader(m_ChromaticAberrationShader);
+		m_GLCache->SetShader(m_FxaaShader);
 		m_GLCache->SetDepthTest(false);
 		m_GLCache->SetBlend(false);
 		m_GLCache->SetFaceCull(true);
@@ -291,82 +470,99 @@ namespace Arcane
 		m_GLCache->SetStencilTest(false);
 		target->Bind();
 
-		m_ChromaticAberrationShader->SetUniform("intensity", m_ChromaticAberrationIntensity * 100);
-		m_ChromaticAberrationShader->SetUniform("texel_size", glm::vec2(1.0f / (float)texture->GetWidth(), 1.0f / (float)texture->GetHeight()));
-		m_ChromaticAberrationShader->SetUniform("input_texture", 0);
+		m_FxaaShader->SetUniform("texel_size", glm::vec2(1.0f / (float)texture->GetWidth(), 1.0f / (float)texture->GetHeight()));
+		m_FxaaShader->SetUniform("input_texture", 0);
 		texture->Bind(0);
 
 		Renderer::DrawNdcPlane();
 	}
 
-	void PostProcessPass::FilmGrain(Framebuffer *target, Texture *texture)
+	Texture* PostProcessPass::Bloom(Texture *hdrSceneTexture, Framebuffer *const bloomChain[BloomChainLength])
 	{
-		glViewport(0, 0, target->GetWidth(), target->GetHeight());
-		m_GLCache->SetShader(m_FilmGrainShader);
 		m_GLCache->SetDepthTest(false);
 		m_GLCache->SetBlend(false);
 		m_GLCache->SetFaceCull(true);
 		m_GLCache->SetCullFace(GL_BACK);
 		m_GLCache->SetStencilTest(false);
-		target->Bind();
 
-		m_FilmGrainShader->SetUniform("intensity", m_FilmGrainIntensity * 100.0f);
-		m_FilmGrainShader->SetUniform("time", (float)(std::fmod(m_EffectsTimer.Elapsed(), 100.0)));
-		m_FilmGrainShader->SetUniform("input_texture", 0);
-		texture->Bind(0);
+		// Blur the bright parts of the scene by walking down the mip chain and back up again
+		if (m_BloomComputeEnabled)
+			BloomDownsampleUpsampleCompute(hdrSceneTexture, bloomChain);
+		else
+			BloomDownsampleUpsample(hdrSceneTexture, bloomChain);
 
-		Renderer::DrawNdcPlane();
+		return bloomChain[0]->GetColourTexture();
 	}
 
-	Texture* PostProcessPass::Bloom(Texture *hdrSceneTexture)
+	void PostProcessPass::BloomDownsampleUpsample(Texture *hdrSceneTexture, Framebuffer *const bloomChain[BloomChainLength])
 	{
-		m_GLCache->SetDepthTest(false);
-		m_GLCache->SetBlend(false);
-		m_GLCache->SetFaceCull(true);
-		m_GLCache->SetCullFace(GL_BACK);
-		m_GLCache->SetStencilTest(false);
 
-		// Bloom Bright Pass
-		glViewport(0, 0, m_BrightPassRenderTarget.GetWidth(), m_BrightPassRenderTarget.GetHeight());
-		m_BrightPassRenderTarget.Bind();
-		m_BrightPassRenderTarget.ClearAll();
-		m_GLCache->SetShader(m_BloomBrightPassShader);
-		m_BloomBrightPassShader->SetUniform("threshold", m_BloomThreshold);
-		m_BloomBrightPassShader->SetUniform("scene_capture", 0);
-		hdrSceneTexture->Bind(0);
-		Renderer::DrawNdcPlane();
+		// Downsample, the threshold is applied when leaving the full resolution scene
+		m_GLCache->SetShader(m_BloomDownsampleShader);
+		m_BloomDownsampleShader->SetUniform("threshold", m_BloomThreshold);
+		m_BloomDownsampleShader->SetUniform("soft_knee", m_BloomThreshold * BLOOM_SOFT_KNEE);
+		m_BloomDownsampleShader->SetUniform("source_texture", 0);
+		Texture *source = hdrSceneTexture;
+		for (int i = 0; i < BloomChainLength; i++)
+		{
+			glViewport(0, 0, bloomChain[i]->GetWidth(), bloomChain[i]->GetHeight());
+			bloomChain[i]->Bind();
+			m_BloomDownsampleShader->SetUniform("isFirstDownsample", i == 0);
+			source->Bind(0);
+			Renderer::DrawNdcPlane();
 
-		// Bloom Gaussian Blur Pass
-		// As the render target gets smaller, we can increase the separable (two-pass) Gaussian kernel size
-		m_GLCache->SetShader(m_BloomGaussianBlurShader);
-		glViewport(0, 0, m_FullRenderTarget.GetWidth(), m_FullRenderTarget.GetHeight());
-		m_FullRenderTarget.Bind();
-		m_FullRenderTarget.ClearAll();
-		m_BloomGaussianBlurShader->SetUniform("isVerticalBlur", true);
-		m_BloomGaussianBlurShader->SetUniform("read_offset", glm::vec2(1.0f / (float)m_FullRenderTarget.GetWidth(), 1.0f / (float)m_FullRenderTarget.GetHeight()));
-		m_BloomGaussianBlurShader->SetUniform("bloom_texture", 0);
-		m_BrightPassRenderTarget.GetColourTexture()->Bind(0);
-		Renderer::DrawNdcPlane();
+			source = bloomChain[i]->GetColourTexture();
+		}
 
-		m_BloomFullRenderTarget.Bind();
-		m_BloomFullRenderTarget.ClearAll();
-		m_BloomGaussianBlurShader->SetUniform("isVerticalBlur", false);
-		m_BloomGaussianBlurShader->SetUniform("read_offset", glm::vec2(1.0f / (float)m_BloomFullRenderTarget.GetWidth(), 1.0f / (float)m_BloomFullRenderTarget.GetHeight()));
-		m_BloomGaussianBlurShader->SetUniform("bloom_texture", 0);
-		m_FullRenderTarget.GetColourTexture()->Bind(0);
-		Renderer::DrawNdcPlane();
+		// Upsample, adding each blurred mip onto the downsample of the mip above it
+		m_GLCache->SetBlend(true);
+		m_GLCache->SetBlendFunc(GL_ONE, GL_ONE);
+		m_GLCache->SetShader(m_BloomUpsampleShader);
+		m_BloomUpsampleShader->SetUniform("source_texture", 0);
+		for (int i = BloomChainLength - 1; i > 0; i--)
+		{
+			glViewport(0, 0, bloomChain[i - 1]->GetWidth(), bloomChain[i - 1]->GetHeight());
+			bloomChain[i - 1]->Bind();
+			bloomChain[i]->GetColourTexture()->Bind(0);
+			Renderer::DrawNdcPlane();
+		}
 
-		// Combine our bloom texture with the scene
-		m_GLCache->SetShader(m_BloomComposite);
-		glViewport(0, 0, m_FullRenderTarget.GetWidth(), m_FullRenderTarget.GetHeight());
-		m_FullRenderTarget.Bind();
-		m_BloomComposite->SetUniform("strength", 1.0f);
-		m_BloomComposite->SetUniform("scene_texture", 0);
-		m_BloomComposite->SetUniform("bloom_texture", 1);
-		hdrSceneTexture->Bind(0);
-		m_BloomFullRenderTarget.GetColourTexture()->Bind(1);
-		Renderer::DrawNdcPlane();
+		// Reset unusual state
+		m_GLCache->SetBlend(false);
+		m_GLCache->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
 
-		return m_FullRenderTarget.GetColourTexture();
+	void PostProcessPass::BloomDownsampleUpsampleCompute(Texture *hdrSceneTexture, Framebuffer *const bloomChain[BloomChainLength])
+	{
+
+		// Same as the fragment version, except the upsample reads and writes the destination itself instead of blending
+		m_GLCache->SetShader(m_BloomDownsampleComputeShader);
+		m_BloomDownsampleComputeShader->SetUniform("threshold", m_BloomThreshold);
+		m_BloomDownsampleComputeShader->SetUniform("soft_knee", m_BloomThreshold * BLOOM_SOFT_KNEE);
+		m_BloomDownsampleComputeShader->SetUniform("source_texture", 0);
+		Texture *source = hdrSceneTexture;
+		for (int i = 0; i < BloomChainLength; i++)
+		{
+			Texture *destination = bloomChain[i]->GetColourTexture();
+			m_BloomDownsampleComputeShader->SetUniform("isFirstDownsample", i == 0);
+			source->Bind(0);
+			glBindImageTexture(0, destination->GetTextureId(), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+			glDispatchCompute((destination->GetWidth() + BloomComputeGroupSize - 1) / BloomComputeGroupSize, (destination->GetHeight() + BloomComputeGroupSize - 1) / BloomComputeGroupSize, 1);
+			glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+			source = destination;
+		}
+
+		m_GLCache->SetShader(m_BloomUpsampleComputeShader);
+		m_BloomUpsampleComputeShader->SetUniform("source_texture", 0);
+		for (int i = BloomChainLength - 1; i > 0; i--)
+		{
+			Texture *destination = bloomChain[i - 1]->GetColourTexture();
+			bloomChain[i]->GetColourTexture()->Bind(0);
+			glBindImageTexture(0, destination->GetTextureId(), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA16F);
+			glDispatchCompute((destination->GetWidth() + BloomComputeGroupSize - 1) / BloomComputeGroupSize, (destination->GetHeight() + BloomComputeGroupSize - 1) / BloomComputeGroupSize, 1);
+			glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+		}
+		glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA16F);
 	}
 }
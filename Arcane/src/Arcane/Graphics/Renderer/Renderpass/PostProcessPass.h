@@ -18,6 +18,14 @@
 #include <Arcane/Graphics/Renderer/Renderpass/RenderPassType.h>
 #endif
 
+#ifndef UNIFORMBUFFER_H
+#include <Arcane/Platform/OpenGL/UniformBuffer.h>
+#endif
+
+#ifndef SHADERSTORAGEBUFFER_H
+#include <Arcane/Platform/OpenGL/ShaderStorageBuffer.h>
+#endif
+
 namespace Arcane
 {
 	class Shader;
@@ -26,32 +34,53 @@ namespace Arcane
 
 	class PostProcessPass : public RenderPass {
 	public:
+		static const int BloomChainLength = 3; // Half, quarter and eighth resolution
+
 		PostProcessPass(Scene *scene);
 		virtual ~PostProcessPass() override;
 
-		PreLightingPassOutput ExecutePreLightingPass(GBuffer *inputGbuffer, ICamera *camera);
-		PostProcessPassOutput ExecutePostProcessPass(Framebuffer *framebufferToProcess);
+		PreLightingPassOutput ExecutePreLightingPass(GBuffer *inputGbuffer, ICamera *camera, Framebuffer *ssaoTarget); // ssaoTarget is a half resolution FloatingPoint16 transient of the render graph, only needed for this pass
+		// Resolves multi-sampling, anti-aliases (or upscales) and adapts the exposure. Returns the full resolution HDR scene the bloom and uber post process read,
+		// TAA needs the GBuffer's motion vectors and the camera
+		Texture* ExecuteResolvePass(Framebuffer *framebufferToProcess, GBuffer *inputGbuffer = nullptr, ICamera *camera = nullptr);
 
 		// Post Processing Effects
-		void TonemapGammaCorrect(Framebuffer *target, Texture *hdrTexture);
+		void UberPostProcess(Framebuffer *target, Texture *hdrTexture, Texture *bloomTexture = nullptr); // Tonemap, chromatic aberration, film grain and vignette in one pass
 		void Fxaa(Framebuffer *target, Texture *texture);
-		void Vignette(Framebuffer *target, Texture *texture, Texture *optionalVignetteMask = nullptr);
-		void ChromaticAberration(Framebuffer *target, Texture *texture);
-		void FilmGrain(Framebuffer *target, Texture *texture);
-		Texture* Bloom(Texture *hdrSceneTexture);
+		Texture* Bloom(Texture *hdrSceneTexture, Framebuffer *const bloomChain[BloomChainLength]); // The chain is FloatingPoint16 targets. Returns the bloom in the half resolution one, it is added to the scene when tonemapping
+		void AutoExposure(Texture *hdrSceneTexture); // Updates the exposure buffer the tonemap reads without any CPU readback
+		Texture* TemporalAA(Texture *hdrSceneTexture, GBuffer *inputGbuffer, ICamera *camera); // Returns the resolved scene, which is kept as the next frame's history
+		Texture* Upscale(Texture *hdrSceneTexture); // Brings a dynamic resolution frame up to the render resolution when TAA isn't doing it
+
+		// Sub-pixel projection offset (in NDC) the camera should render this frame with, zero when TAA is disabled. Should be called after the render scale is set
+		glm::vec2 GetTemporalAAJitter() const;
 
 		// Tonemap bindings
 		inline float& GetGammaCorrectionRef() { return m_GammaCorrection; }
-		inline float& GetExposureRef() { return m_Exposure; }
+		inline float& GetExposureRef() { return m_Exposure; } // Exposure compensation when auto exposure is enabled
+		inline bool& GetAutoExposureEnabledRef() { return m_AutoExposureEnabled; }
+		inline float& GetAutoExposureAdaptationSpeedRef() { return m_AutoExposureAdaptationSpeed; }
+
+		// Bloom bindings
+		inline bool& GetBloomEnabledRef() { return m_BloomEnabled; }
+		inline bool& GetBloomComputeEnabledRef() { return m_BloomComputeEnabled; }
+		inline float& GetBloomThresholdRef() { return m_BloomThreshold; }
+		inline float& GetBloomStrengthRef() { return m_BloomStrength; }
 
 		// SSAO bindings
 		inline bool& GetSsaoEnabledRef() { return m_SsaoEnabled; }
 		inline float& GetSsaoSampleRadiusRef() { return m_SsaoSampleRadius; }
 		inline float& GetSsaoStrengthRef() { return m_SsaoStrength; }
+		inline bool& GetSsaoTemporalEnabledRef() { return m_SsaoTemporalEnabled; }
+		inline float& GetSsaoHistoryWeightRef() { return m_SsaoHistoryWeight; }
 
 		// FXAA bindings
 		inline bool& GetFxaaEnabledRef() { return m_FxaaEnabled; }
 
+		// TAA bindings
+		inline bool& GetTaaEnabledRef() { return m_TaaEnabled; }
+		inline float& GetTaaHistoryWeightRef() { return m_TaaHistoryWeight; }
+
 		// Vignette bindings
 		inline bool& GetVignetteEnabledRef() { return m_VignetteEnabled; }
 		inline Texture* GetVignetteTexture() { return m_VignetteTexture; }
@@ -66,50 +95,58 @@ namespace Arcane
 		inline bool& GetFilmGrainEnabledRef() { return m_FilmGrainEnabled; }
 		inline float& GetFilmGrainIntensityRef() { return m_FilmGrainIntensity; }
 
-		// Render Target Access (TODO: Should use render target aliasing and have a system for sharing render targets for different render passes. But this will suffice for now)
-		// Silly to manage all of these like this
-		inline Framebuffer* GetFullRenderTarget() { return &m_FullRenderTarget; }
-		inline Framebuffer* GetHalfRenderTarget() { return &m_HalfRenderTarget; }
-		inline Framebuffer* GetQuarterRenderTarget() { return &m_QuarterRenderTarget; }
-		inline Framebuffer* GetEighthRenderTarget() { return &m_EighthRenderTarget; }
-		inline Framebuffer* GetResolveRenderTarget() { return &m_ResolveRenderTarget; }
-		inline Framebuffer* GetTonemappedNonLinearTarget() { return &m_TonemappedNonLinearTarget; }
 	private:
 		inline float Lerp(float a, float b, float amount) { return a + amount * (b - a); }
+		float Halton(unsigned int index, unsigned int base) const;
+
+		Shader* GetUberShader(unsigned int effects);
+
+		void BloomDownsampleUpsample(Texture *hdrSceneTexture, Framebuffer *const bloomChain[BloomChainLength]);
+		void BloomDownsampleUpsampleCompute(Texture *hdrSceneTexture, Framebuffer *const bloomChain[BloomChainLength]);
 	private:
-		Shader *m_TonemapGammaCorrectShader;
-		Shader *m_FxaaShader;
-		Shader *m_SsaoShader, *m_SsaoBlurShader;
-		Shader *m_BloomBrightPassShader, *m_BloomGaussianBlurShader, *m_BloomComposite;
-		Shader *m_VignetteShader;
-		Shader *m_ChromaticAberrationShader;
-		Shader *m_FilmGrainShader;
-
-		Framebuffer m_SsaoRenderTarget;
-		Framebuffer m_SsaoBlurRenderTarget;
-		Framebuffer m_TonemappedNonLinearTarget;
+		// Bits selecting the uber post process shader variant, every combination is compiled the first time it is used
+		enum UberEffect : unsigned int {
+			UberEffect_Bloom = 1 << 0,
+			UberEffect_ChromaticAberration = 1 << 1,
+			UberEffect_FilmGrain = 1 << 2,
+			UberEffect_Vignette = 1 << 3,
+			UberEffect_VignetteMask = 1 << 4,
+			UberVariantCount = 1 << 5
+		};
+		std::array<Shader*, UberVariantCount> m_UberShaders;
+
+		Shader *m_FxaaShader, *m_TaaShader, *m_UpscaleShader;
+		Shader *m_SsaoShader, *m_SsaoTemporalShader, *m_SsaoUpsampleShader;
+		Shader *m_BloomDownsampleShader, *m_BloomUpsampleShader;
+		Shader *m_BloomDownsampleComputeShader, *m_BloomUpsampleComputeShader;
+		Shader *m_SceneLuminanceShader, *m_ExposureAdaptationShader;
+
+		Framebuffer m_SsaoTemporalEvenRenderTarget, m_SsaoTemporalOddRenderTarget; // Accumulated AO is written to one on alternating frames, so the other holds the previous frame's
+		Framebuffer m_SsaoUpsampleRenderTarget;
 		Framebuffer m_ResolveRenderTarget; // Only used if multi-sampling is enabled so it can be resolved
+		Framebuffer m_TaaEvenRenderTarget, m_TaaOddRenderTarget; // Resolved on alternating frames, so the other holds the previous frame's
+		Framebuffer m_UpscaleRenderTarget;
 
-		Framebuffer m_BrightPassRenderTarget;
-		Framebuffer m_BloomFullRenderTarget;
-		Framebuffer m_BloomHalfRenderTarget;
-		Framebuffer m_BloomQuarterRenderTarget;
-		Framebuffer m_BloomEightRenderTarget;
-
-		// Utility Framebuffers
-		Framebuffer m_FullRenderTarget;
-		Framebuffer m_HalfRenderTarget;
-		Framebuffer m_QuarterRenderTarget;
-		Framebuffer m_EighthRenderTarget;
+		// The bloom mip chain and the tonemapped frame are render graph transients, see MasterRenderPass
+		static const unsigned int BloomComputeGroupSize = 8; // Has to match the local size of the bloom compute shaders
 
 		// Post Processing Tweaks
 		float m_GammaCorrection = 2.2f;
 		float m_Exposure = 1.0f;
+		bool m_AutoExposureEnabled = true;
+		float m_AutoExposureAdaptationSpeed = AUTO_EXPOSURE_ADAPTATION_SPEED_DEFAULT;
+		bool m_BloomEnabled = true;
+		bool m_BloomComputeEnabled = false;
 		float m_BloomThreshold = 1.0f;
-		bool m_FxaaEnabled = true;
+		float m_BloomStrength = 0.2f;
+		bool m_FxaaEnabled = false;
+		bool m_TaaEnabled = true;
+		float m_TaaHistoryWeight = TAA_HISTORY_WEIGHT_DEFAULT;
 		bool m_SsaoEnabled = true;
 		float m_SsaoSampleRadius = 2.0f;
 		float m_SsaoStrength = 3.0f;
+		bool m_SsaoTemporalEnabled = true;
+		float m_SsaoHistoryWeight = SSAO_HISTORY_WEIGHT_DEFAULT;
 		bool m_VignetteEnabled = false;
 		Texture *m_VignetteTexture;
 		glm::vec3 m_VignetteColour = glm::vec3(0.0f, 0.0f, 0.0f);
@@ -120,8 +157,31 @@ namespace Arcane
 		float m_FilmGrainIntensity = 0.25f;
 
 		// SSAO Tweaks
-		std::array<glm::vec3, SSAO_KERNEL_SIZE> m_SsaoKernel;
+		std::array<glm::vec4, SSAO_KERNEL_SIZE> m_SsaoKernel; // w is unused, it's only there to match the kernel's std140 layout
+		UniformBuffer m_SsaoKernelBuffer;
 		Texture m_SsaoNoiseTexture;
+		static const unsigned int SsaoKernelBufferBinding = 0;
+
+		// SSAO temporal accumulation
+		glm::mat4 m_SsaoPreviousViewProjection;
+		float m_SsaoPreviousRenderScale;
+		unsigned int m_SsaoFrameIndex;
+		bool m_SsaoHistoryValid;
+
+		// TAA
+		glm::mat4 m_TaaPreviousViewProjection; // Unjittered
+		unsigned int m_TaaFrameIndex;
+		bool m_TaaHistoryValid;
+
+		// Auto exposure
+		ShaderStorageBuffer m_LuminanceHistogramBuffer;
+		ShaderStorageBuffer m_ExposureBuffer; // Adapted luminance followed by the exposure
+		double m_LastExposureUpdateTime;
+		bool m_ExposureHistoryValid;
+		static const unsigned int ExposureBufferBinding = 6;
+		static const unsigned int LuminanceHistogramBufferBinding = 7;
+		static const unsigned int LuminanceHistogramBinCount = 256; // Has to match the auto exposure compute shaders
+		static const unsigned int SceneLuminanceGroupSize = 16;
 
 		Timer m_EffectsTimer;
 	};
@@ -12,33 +12,26 @@
 
 namespace Arcane
 {
-	class Cubemap;
+	class HiZBuffer;
 
 	enum RenderPassType
 	{
 		MaterialRequired,
+		MaterialBufferRequired, // The shader reads the material from the material buffer, only the material's index is set per mesh
 		NoMaterialRequired
 	};
 
-	struct PostProcessPassOutput
-	{
-		Framebuffer *outFramebuffer = nullptr;
-	};
-
 	struct ShadowmapPassOutput
 	{
-		glm::mat4 directionalLightViewProjMatrix;
+		// Directional light shadows are split into cascades, each cascade is a layer of the directional shadowmap
+		glm::mat4 directionalLightViewProjMatrices[SHADOW_CASCADE_COUNT];
+		glm::vec2 directionalLightCascadeOrigins[SHADOW_CASCADE_COUNT]; // Snapped center of each cascade in the light's rotated space, used to tell if a cascade actually moved
+		float directionalLightCascadeTexelSizes[SHADOW_CASCADE_COUNT];
+		glm::vec4 directionalShadowmapCascadeBiases; // Bias is scaled per cascade since each cascade covers a different area and depth range
+		int directionalShadowmapCascadeCount = 0;
 		Framebuffer *directionalShadowmapFramebuffer = nullptr;
-		float directionalShadowmapBias;
 
-		glm::mat4 spotLightViewProjMatrix;
-		Framebuffer *spotLightShadowmapFramebuffer = nullptr;
-		float spotLightShadowmapBias;
-
-		bool hasPointLightShadows; // Need to have this since the point light shadow cubemap always needs to be bound even if we never use it (thanks to the OpenGL Driver)
-		Cubemap* pointLightShadowCubemap = nullptr;
-		float pointLightShadowmapBias;
-		float pointLightFarPlane;
+		Framebuffer *shadowAtlasFramebuffer = nullptr; // Spot and point light shadows, the tile for each light is stored in the light manager's shadow atlas buffer
 	};
 
 	struct LightingPassOutput
@@ -61,6 +54,12 @@ namespace Arcane
 		Texture *ssaoTexture = nullptr;
 	};
 
+	struct ScreenSpaceReflectionPassOutput
+	{
+		Texture *reflectionTexture = nullptr; // rgb = reflected colour, a = confidence of the hit (probes fill in the rest). Null if screen space reflections are disabled
+		HiZBuffer *hiZBuffer = nullptr; // Depth pyramid of the GBuffer, built every frame even if screen space reflections are disabled
+	};
+
 	struct EditorPassOutput
 	{
 		Framebuffer *outFramebuffer = nullptr;
@@ -6,19 +6,18 @@
 #include <Arcane/Graphics/Renderer/GLCache.h>
 #include <Arcane/Graphics/Renderer/Renderer.h>
 #include <Arcane/Graphics/Shader.h>
-#include <Arcane/Graphics/Texture/Cubemap.h>
 #include <Arcane/Util/Loaders/ShaderLoader.h>
 
 namespace Arcane
 {
-	ShadowmapPass::ShadowmapPass(Scene *scene) : RenderPass(scene), m_EmptyFramebuffer(1, 1, false)
+	static_assert(SHADOW_CASCADE_COUNT >= 1 && SHADOW_CASCADE_COUNT <= 4, "The lighting shaders only support between 1 and 4 shadow cascades");
+
+	ShadowmapPass::ShadowmapPass(Scene *scene) : RenderPass(scene)
 	{
 		Init();
 	}
 
-	ShadowmapPass::ShadowmapPass(Scene *scene, Framebuffer *customDirectionalLightShadowFramebuffer, Framebuffer *customSpotLightShadowFramebuffer, Cubemap* customPointLightShadowCubemap)
-		: RenderPass(scene), m_EmptyFramebuffer(1, 1, false),
-		m_CustomDirectionalLightShadowFramebuffer(customDirectionalLightShadowFramebuffer), m_CustomSpotLightShadowFramebuffer(customSpotLightShadowFramebuffer), m_CustomPointLightShadowCubemap(customPointLightShadowCubemap)
+	ShadowmapPass::ShadowmapPass(Scene *scene, Framebuffer *customDirectionalLightShadowFramebuffer) : RenderPass(scene), m_CustomDirectionalLightShadowFramebuffer(customDirectionalLightShadowFramebuffer)
 	{
 		Init();
 	}
@@ -34,7 +33,8 @@ namespace Arcane
 		m_ShadowmapSkinnedShader = ShaderLoader::LoadShader("Shadowmap_Generation_Skinned.glsl");
 		m_ShadowmapLinearShader = ShaderLoader::LoadShader("Shadowmap_Generation_Linear.glsl");
 		m_ShadowmapLinearSkinnedShader = ShaderLoader::LoadShader("Shadowmap_Generation_Linear_Skinned.glsl");
-		m_EmptyFramebuffer.AddDepthStencilTexture(NormalizedDepthOnly, true).CreateFramebuffer();
+		m_ShadowmapCascadedShader = ShaderLoader::LoadShader("Shadowmap_Generation_Cascaded.glsl");
+		m_ShadowmapCascadedSkinnedShader = ShaderLoader::LoadShader("Shadowmap_Generation_Cascaded_Skinned.glsl");
 	}
 
 	ShadowmapPassOutput ShadowmapPass::GenerateShadowmaps(ICamera *camera, bool renderOnlyStatic)
@@ -43,6 +43,7 @@ namespace Arcane
 		ShadowmapPassOutput passOutput;
 
 		LightManager *lightManager = m_ActiveScene->GetLightManager();
+		std::size_t staticCasterHash = lightManager->GetStaticShadowCasterHash();
 		Framebuffer *shadowFramebuffer;
 
 		// Directional Light Shadow Setup
@@ -55,213 +56,337 @@ namespace Arcane
 			shadowFramebuffer = lightManager->GetDirectionalLightShadowCasterFramebuffer();
 		}
 		glViewport(0, 0, shadowFramebuffer->GetWidth(), shadowFramebuffer->GetHeight());
-		shadowFramebuffer->Bind();
-		shadowFramebuffer->ClearDepth();
 
-		// Directional Light Shadows
+		// Shadow casters only need their transform (and the layers they overlap), so every non-skinned opaque caster in the arena goes out in a few multi-draws
+		Renderer::BeginMultiDrawIndirect();
+
+		// Directional Light Shadows (every cascade is rendered into it's own layer of the shadowmap in a single pass)
 		if (lightManager->HasDirectionalLightShadowCaster())
 		{
 			// Setup
-			Terrain *terrain = m_ActiveScene->GetTerrain();
-			glm::vec2 nearFarPlane = lightManager->GetDirectionalLightShadowCasterNearFarPlane();
-
-			// View + Projection setup
-			glm::vec3 dirLightShadowmapLookAtPos = camera->GetPosition();
-			glm::vec3 dirLightShadowmapEyePos = dirLightShadowmapLookAtPos - (lightManager->GetDirectionalLightShadowCasterLightDir() * 50.0f);
-			glm::mat4 directionalLightProjection = glm::ortho(-40.0f, 40.0f, -40.0f, 40.0f, nearFarPlane.x, nearFarPlane.y);
-			glm::mat4 directionalLightView = glm::lookAt(dirLightShadowmapEyePos, dirLightShadowmapLookAtPos, glm::vec3(0.0f, 1.0f, 0.0f));
-			glm::mat4 directionalLightViewProjMatrix = directionalLightProjection * directionalLightView;
+			CalculateShadowCascades(camera, lightManager->GetDirectionalLightShadowCasterLightDir(), lightManager->GetDirectionalLightShadowCasterNearFarPlane(), lightManager->GetDirectionalLightShadowCasterBias(), shadowFramebuffer->GetWidth(), passOutput);
 
 			m_GLCache->SetDepthTest(true);
 			m_GLCache->SetBlend(false);
 			m_GLCache->SetFaceCull(false); // For one sided objects - TODO: This will get overwritten by the renderer anyways
+			glEnable(GL_DEPTH_CLAMP); // Casters in front of a cascade's near plane get flattened onto it instead of being clipped, so the cascades can stay tight
 
-			// Setup model renderer
-			if (renderOnlyStatic)
+			if (m_CustomDirectionalLightShadowFramebuffer)
 			{
-				m_ActiveScene->AddModelsToRenderer(ModelFilterType::StaticModels);
+				// Custom shadow targets aren't cached so every caster needs to be rendered
+				shadowFramebuffer->Bind();
+				shadowFramebuffer->ClearDepth();
+				RenderDirectionalShadowCasters(passOutput.directionalLightViewProjMatrices, SHADOW_CASCADE_COUNT, camera, renderOnlyStatic ? ModelFilterType::StaticModels : ModelFilterType::AllModels, true);
 			}
 			else
 			{
-				m_ActiveScene->AddModelsToRenderer(ModelFilterType::AllModels);
-			}
+				// Static casters are cached per cascade, so only the cascades that moved (or had their static casters change) need them re-rendered
+				Framebuffer *staticShadowFramebuffer = lightManager->GetDirectionalLightStaticShadowFramebuffer();
+				staticShadowFramebuffer->Bind();
+				for (int cascade = 0; cascade < SHADOW_CASCADE_COUNT; cascade++)
+				{
+					if (!lightManager->RequiresStaticCascadeRender(cascade, passOutput.directionalLightCascadeOrigins[cascade], passOutput.directionalLightCascadeTexelSizes[cascade], passOutput.directionalLightViewProjMatrices[cascade]))
+						continue;
 
-			// Render skinned models
-			{
-				m_GLCache->SetShader(m_ShadowmapSkinnedShader);
-				m_ShadowmapSkinnedShader->SetUniform("lightSpaceViewProjectionMatrix", directionalLightViewProjMatrix);
-				Renderer::FlushOpaqueSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapSkinnedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
-				Renderer::FlushTransparentSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapSkinnedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
-			}
+					staticShadowFramebuffer->SetDepthAttachmentLayer(NormalizedDepthOnly, staticShadowFramebuffer->GetDepthStencilTexture()->GetTextureId(), cascade);
+					staticShadowFramebuffer->ClearDepth();
+					RenderDirectionalShadowCasters(&passOutput.directionalLightViewProjMatrices[cascade], 1, camera, ModelFilterType::StaticNonAnimatedModels, true);
+				}
 
-			// Render non-skinned models
-			{
-				m_GLCache->SetShader(m_ShadowmapShader);
-				m_ShadowmapShader->SetUniform("lightSpaceViewProjectionMatrix", directionalLightViewProjMatrix);
-				Renderer::FlushOpaqueNonSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
-				Renderer::FlushTransparentNonSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
+				// Start every cascade from the cached static depth and only render the dynamic casters on top
+				glCopyImageSubData(staticShadowFramebuffer->GetDepthStencilTexture()->GetTextureId(), GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+								   shadowFramebuffer->GetDepthStencilTexture()->GetTextureId(), GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, shadowFramebuffer->GetWidth(), shadowFramebuffer->GetHeight(), SHADOW_CASCADE_COUNT);
+				shadowFramebuffer->Bind();
+				if (!renderOnlyStatic)
+				{
+					RenderDirectionalShadowCasters(passOutput.directionalLightViewProjMatrices, SHADOW_CASCADE_COUNT, camera, ModelFilterType::DynamicModels, false);
+				}
 			}
 
-			// Render terrain
-			terrain->Draw(m_ShadowmapShader, RenderPassType::NoMaterialRequired);
+			glDisable(GL_DEPTH_CLAMP);
 
 			// Update output
-			passOutput.directionalLightViewProjMatrix = directionalLightViewProjMatrix;
-			passOutput.directionalShadowmapBias = lightManager->GetDirectionalLightShadowCasterBias();
+			passOutput.directionalShadowmapCascadeCount = SHADOW_CASCADE_COUNT;
 			passOutput.directionalShadowmapFramebuffer = shadowFramebuffer;
 		}
 
-		// Spot Light Shadow Setup
-		if (m_CustomSpotLightShadowFramebuffer)
+		// Spot + Point Light Shadows (every caster renders into it's own tile of the shadow atlas, point lights have a tile for each cube face)
+		ShadowAtlas *shadowAtlas = lightManager->GetShadowAtlas();
+		const std::vector<ShadowAtlasCaster> &shadowAtlasCasters = lightManager->GetShadowAtlasCasters();
+		if (!shadowAtlasCasters.empty())
 		{
-			shadowFramebuffer = m_CustomSpotLightShadowFramebuffer;
+			m_GLCache->SetDepthTest(true);
+			m_GLCache->SetBlend(false);
+			m_GLCache->SetFaceCull(false); // For one sided objects - TODO: This will get overwritten by the renderer anyways
+
+			// Re-render the static casters of any tile whose light moved (or had it's static casters change) into the static atlas
+			Framebuffer *staticShadowFramebuffer = shadowAtlas->GetStaticFramebuffer();
+			staticShadowFramebuffer->Bind();
+			glEnable(GL_SCISSOR_TEST);
+			for (unsigned int i = 0; i < shadowAtlasCasters.size(); i += GetShadowAtlasCasterTileCount(shadowAtlasCasters[i]))
+			{
+				const ShadowAtlasCaster *casters = &shadowAtlasCasters[i];
+				unsigned int tileCount = GetShadowAtlasCasterTileCount(casters[0]);
+
+				// Only clear the tiles that are being re-rendered, point lights might only need some of their faces re-rendered
+				int tileMask = 0;
+				for (unsigned int tile = 0; tile < tileCount; tile++)
+				{
+					const ShadowAtlasCaster &caster = casters[tile];
+					if (!shadowAtlas->RequiresStaticTileRender(i + tile, caster.LightSpaceViewProjectionMatrix, caster.Viewport, staticCasterHash))
+						continue;
+
+					glScissor(caster.Viewport.x, caster.Viewport.y, caster.Viewport.z, caster.Viewport.w);
+					staticShadowFramebuffer->ClearDepth();
+					tileMask |= 1 << tile;
+				}
+
+				if (tileMask == 0)
+					continue;
+
+				if (casters[0].LinearDepth)
+				{
+					RenderPointShadowCaster(casters, tileMask, camera, ModelFilterType::StaticNonAnimatedModels, true);
+				}
+				else
+				{
+					glViewport(casters[0].Viewport.x, casters[0].Viewport.y, casters[0].Viewport.z, casters[0].Viewport.w);
+					glScissor(casters[0].Viewport.x, casters[0].Viewport.y, casters[0].Viewport.z, casters[0].Viewport.w);
+					RenderSpotShadowCaster(casters[0], camera, ModelFilterType::StaticNonAnimatedModels, true);
+				}
+			}
+			glDisable(GL_SCISSOR_TEST);
+
+			// Start every tile from the cached static depth and only render the dynamic casters on top
+			shadowFramebuffer = shadowAtlas->GetFramebuffer();
+			shadowFramebuffer->Bind();
+			for (const ShadowAtlasCaster &caster : shadowAtlasCasters)
+			{
+				shadowAtlas->CopyStaticTile(caster.Viewport);
+			}
+			if (!renderOnlyStatic)
+			{
+				for (unsigned int i = 0; i < shadowAtlasCasters.size(); i += GetShadowAtlasCasterTileCount(shadowAtlasCasters[i]))
+				{
+					const ShadowAtlasCaster &caster = shadowAtlasCasters[i];
+					if (caster.LinearDepth)
+					{
+						RenderPointShadowCaster(&caster, 0x3F, camera, ModelFilterType::DynamicModels, false);
+					}
+					else
+					{
+						glViewport(caster.Viewport.x, caster.Viewport.y, caster.Viewport.z, caster.Viewport.w);
+						RenderSpotShadowCaster(caster, camera, ModelFilterType::DynamicModels, false);
+					}
+				}
+			}
 		}
-		else
+		passOutput.shadowAtlasFramebuffer = shadowAtlas->GetFramebuffer();
+		Renderer::EndMultiDrawIndirect();
+
+		return passOutput;
+	}
+
+	// Each cascade is fit around a slice of the camera's frustum with a bounding sphere, so the cascade's size doesn't change as the camera rotates.
+	// The cascade is then snapped to the shadowmap's texel grid so moving the camera doesn't cause the shadow edges to shimmer
+	void ShadowmapPass::CalculateShadowCascades(ICamera *camera, const glm::vec3 &lightDir, const glm::vec2 &lightNearFarPlane, float shadowBias, unsigned int shadowmapResolution, ShadowmapPassOutput &passOutput)
+	{
+		float cameraNear = camera->GetNearPlane();
+		float cameraFar = camera->GetFarPlane();
+		float shadowDistance = glm::min(SHADOW_CASCADE_MAX_DISTANCE, cameraFar);
+
+		// Practical split scheme - Blend logarithmic splits (ideal resolution distribution) with uniform splits (avoids wasting resolution right in front of the camera)
+		float splits[SHADOW_CASCADE_COUNT + 1];
+		splits[0] = cameraNear;
+		for (int i = 1; i <= SHADOW_CASCADE_COUNT; i++)
 		{
-			shadowFramebuffer = lightManager->GetSpotLightShadowCasterFramebuffer();
+			float splitPercentage = static_cast<float>(i) / SHADOW_CASCADE_COUNT;
+			float logSplit = cameraNear * glm::pow(shadowDistance / cameraNear, splitPercentage);
+			float uniformSplit = cameraNear + (shadowDistance - cameraNear) * splitPercentage;
+			splits[i] = glm::mix(uniformSplit, logSplit, SHADOW_CASCADE_SPLIT_LAMBDA);
 		}
-		glViewport(0, 0, shadowFramebuffer->GetWidth(), shadowFramebuffer->GetHeight());
-		shadowFramebuffer->Bind();
-		shadowFramebuffer->ClearDepth();
 
-		// Spot Light Shadows
-		if (lightManager->HasSpotLightShadowCaster())
+		// Corners of the camera's frustum, the slice for each cascade is found by moving along the rays between the near and far corners
+		glm::mat4 inverseViewProjection = glm::inverse(camera->GetProjectionMatrix() * camera->GetViewMatrix());
+		glm::vec3 nearCorners[4], farCorners[4];
+		for (int i = 0; i < 4; i++)
 		{
-			// Setup
-			Terrain *terrain = m_ActiveScene->GetTerrain();
-			glm::vec2 nearFarPlane = lightManager->GetSpotLightShadowCasterNearFarPlane();
+			glm::vec2 ndcCorner((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f);
+			glm::vec4 nearCorner = inverseViewProjection * glm::vec4(ndcCorner, -1.0f, 1.0f);
+			glm::vec4 farCorner = inverseViewProjection * glm::vec4(ndcCorner, 1.0f, 1.0f);
+			nearCorners[i] = glm::vec3(nearCorner) / nearCorner.w;
+			farCorners[i] = glm::vec3(farCorner) / farCorner.w;
+		}
 
-			// View + Projection setup
-			float outerAngleRadians = lightManager->GetSpotLightShadowCasterOuterCutOffAngle();
-			float radius = lightManager->GetSpotLightShadowCasterAttenuationRange() * glm::tan(outerAngleRadians); // Need to get spotlight's radius given it's range and angle so we can use it for the projection bounds
-			glm::mat4 spotLightProjection = glm::ortho(-radius, radius, -radius, radius, nearFarPlane.x, nearFarPlane.y);
-			glm::vec3 spotLightPos = lightManager->GetSpotLightShadowCasterLightPosition();
-			glm::mat4 spotLightView = glm::lookAt(spotLightPos, spotLightPos + lightManager->GetSpotLightShadowCasterLightDir(), glm::vec3(0.0f, 1.0f, 0.0f));
-			glm::mat4 spotLightViewProjMatrix = spotLightProjection * spotLightView;
+		// Every cascade shares the light's rotation, so snapping in this space keeps the texels in the same world space positions
+		glm::vec3 up = glm::abs(lightDir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), lightDir, up);
+		glm::mat4 inverseLightRotation = glm::inverse(lightRotation);
 
-			m_GLCache->SetDepthTest(true);
-			m_GLCache->SetBlend(false);
-			m_GLCache->SetFaceCull(false); // For one sided objects - TODO: This will get overwritten by the renderer anyways
+		float firstCascadeTexelSize = 1.0f, firstCascadeDepthRange = 1.0f;
+		for (int cascade = 0; cascade < SHADOW_CASCADE_COUNT; cascade++)
+		{
+			float sliceNear = (splits[cascade] - cameraNear) / (cameraFar - cameraNear);
+			float sliceFar = (splits[cascade + 1] - cameraNear) / (cameraFar - cameraNear);
 
-			// Setup model renderer
-			if (renderOnlyStatic)
+			glm::vec3 sliceCorners[8];
+			glm::vec3 sliceCenter(0.0f);
+			for (int i = 0; i < 4; i++)
 			{
-				m_ActiveScene->AddModelsToRenderer(ModelFilterType::StaticModels);
-			}
-			else
-			{
-				m_ActiveScene->AddModelsToRenderer(ModelFilterType::AllModels);
+				sliceCorners[i] = glm::mix(nearCorners[i], farCorners[i], sliceNear);
+				sliceCorners[i + 4] = glm::mix(nearCorners[i], farCorners[i], sliceFar);
+				sliceCenter += sliceCorners[i] + sliceCorners[i + 4];
 			}
+			sliceCenter /= 8.0f;
 
-			// Render skinned models
+			// Round the radius so floating point error doesn't change the cascade's size every frame
+			float radius = 0.0f;
+			for (int i = 0; i < 8; i++)
 			{
-				m_GLCache->SetShader(m_ShadowmapSkinnedShader);
-				m_ShadowmapSkinnedShader->SetUniform("lightSpaceViewProjectionMatrix", spotLightViewProjMatrix);
-				Renderer::FlushOpaqueSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapSkinnedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
-				Renderer::FlushTransparentSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapSkinnedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
+				radius = glm::max(radius, glm::length(sliceCorners[i] - sliceCenter));
 			}
-
-			// Render non-skinned models
+			radius = glm::ceil(radius * 16.0f) / 16.0f;
+
+			float texelSize = (2.0f * radius) / shadowmapResolution;
+			glm::vec3 lightSpaceCenter = glm::vec3(lightRotation * glm::vec4(sliceCenter, 1.0f));
+			lightSpaceCenter.x = glm::floor(lightSpaceCenter.x / texelSize) * texelSize;
+			lightSpaceCenter.y = glm::floor(lightSpaceCenter.y / texelSize) * texelSize;
+			glm::vec3 snappedCenter = glm::vec3(inverseLightRotation * glm::vec4(lightSpaceCenter, 1.0f));
+
+			// Pull the light back so casters outside of the slice still cast into it, the light's far plane controls how far back casters are searched for
+			float lightDistance = glm::max(radius, lightNearFarPlane.y * 0.5f);
+			float depthRange = lightDistance + radius - lightNearFarPlane.x;
+			glm::mat4 cascadeProjection = glm::ortho(-radius, radius, -radius, radius, lightNearFarPlane.x, lightDistance + radius);
+			glm::mat4 cascadeView = glm::lookAt(snappedCenter - (lightDir * lightDistance), snappedCenter, up);
+			passOutput.directionalLightViewProjMatrices[cascade] = cascadeProjection * cascadeView;
+			passOutput.directionalLightCascadeOrigins[cascade] = glm::vec2(lightSpaceCenter);
+			passOutput.directionalLightCascadeTexelSizes[cascade] = texelSize;
+
+			// The light's bias is used by the first cascade, the rest keep the same bias in world units scaled by how much larger their texels are
+			if (cascade == 0)
 			{
-				m_GLCache->SetShader(m_ShadowmapShader);
-				m_ShadowmapShader->SetUniform("lightSpaceViewProjectionMatrix", spotLightViewProjMatrix);
-				Renderer::FlushOpaqueNonSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
-				Renderer::FlushTransparentNonSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
+				firstCascadeTexelSize = texelSize;
+				firstCascadeDepthRange = depthRange;
 			}
-
-			// Render terrain
-			terrain->Draw(m_ShadowmapShader, RenderPassType::NoMaterialRequired);
-
-			// Update output
-			passOutput.spotLightViewProjMatrix = spotLightViewProjMatrix;
-			passOutput.spotLightShadowmapBias = lightManager->GetSpotLightShadowCasterBias();
-			passOutput.spotLightShadowmapFramebuffer = shadowFramebuffer;
+			float worldSpaceBias = shadowBias * firstCascadeDepthRange * (texelSize / firstCascadeTexelSize);
+			passOutput.directionalShadowmapCascadeBiases[cascade] = worldSpaceBias / depthRange;
 		}
+	}
+
+	void ShadowmapPass::RenderDirectionalShadowCasters(const glm::mat4 *cascadeViewProjMatrices, int cascadeCount, ICamera *camera, ModelFilterType filter, bool renderTerrain)
+	{
+		// Meshes are culled against every cascade so they are only rendered into the cascades they overlap
+		Renderer::BeginLayerCulling(cascadeViewProjMatrices, cascadeCount, false);
+		m_ActiveScene->AddModelsToRenderer(filter);
 
-		// Point Light Shadow Setup
-		Cubemap *pointLightShadowCubemap = nullptr;
-		if (m_CustomPointLightShadowCubemap)
+		// Render skinned models
 		{
-			pointLightShadowCubemap = m_CustomPointLightShadowCubemap;
+			m_GLCache->SetShader(m_ShadowmapCascadedSkinnedShader);
+			m_ShadowmapCascadedSkinnedShader->SetUniformArray("lightSpaceViewProjectionMatrices", cascadeCount, cascadeViewProjMatrices);
+			m_ShadowmapCascadedSkinnedShader->SetUniform("cascadeCount", cascadeCount);
+			Renderer::FlushOpaqueSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapCascadedSkinnedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
+			Renderer::FlushTransparentSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapCascadedSkinnedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
 		}
-		else
+
+		// Render non-skinned models
 		{
-			pointLightShadowCubemap = lightManager->GetPointLightShadowCasterCubemap();
+			m_GLCache->SetShader(m_ShadowmapCascadedShader);
+			m_ShadowmapCascadedShader->SetUniformArray("lightSpaceViewProjectionMatrices", cascadeCount, cascadeViewProjMatrices);
+			m_ShadowmapCascadedShader->SetUniform("cascadeCount", cascadeCount);
+			Renderer::FlushOpaqueNonSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapCascadedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
+			Renderer::FlushTransparentNonSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapCascadedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
 		}
-		m_EmptyFramebuffer.Bind();
+		Renderer::EndLayerCulling();
 
-		// Point Light Shadows
-		passOutput.hasPointLightShadows = false;
-		if (lightManager->HasPointlightShadowCaster())
+		// Render terrain (covers every cascade)
+		if (renderTerrain)
 		{
-			// Setup
-			Terrain* terrain = m_ActiveScene->GetTerrain();
-			glm::vec2 nearFarPlane = lightManager->GetPointLightShadowCasterNearFarPlane();
+			m_GLCache->SetShader(m_ShadowmapCascadedShader);
+			m_ShadowmapCascadedShader->SetUniform("layerMask", -1);
+			m_ActiveScene->GetTerrain()->Draw(m_ShadowmapCascadedShader, RenderPassType::NoMaterialRequired);
+		}
+	}
 
-			// Camera Setup
-			m_CubemapCamera.SetPosition(lightManager->GetPointLightShadowCasterLightPosition());
-			m_CubemapCamera.SetNearFarPlane(nearFarPlane.x, nearFarPlane.y);
-			glm::mat4 pointLightProjection = m_CubemapCamera.GetProjectionMatrix();
+	void ShadowmapPass::RenderSpotShadowCaster(const ShadowAtlasCaster &caster, ICamera *camera, ModelFilterType filter, bool renderTerrain)
+	{
+		// Setup model renderer
+		m_ActiveScene->AddModelsToRenderer(filter);
 
-			m_GLCache->SetDepthTest(true);
-			m_GLCache->SetBlend(false);
-			m_GLCache->SetFaceCull(false); // For one sided objects - TODO: This will get overwritten by the renderer anyways
+		// Render skinned models
+		{
+			m_GLCache->SetShader(m_ShadowmapSkinnedShader);
+			m_ShadowmapSkinnedShader->SetUniform("lightSpaceViewProjectionMatrix", caster.LightSpaceViewProjectionMatrix);
+			Renderer::FlushOpaqueSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapSkinnedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
+			Renderer::FlushTransparentSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapSkinnedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
+		}
 
-			// Render the scene to the probe's cubemap
-			glViewport(0, 0, pointLightShadowCubemap->GetFaceWidth(), pointLightShadowCubemap->GetFaceHeight());
-			for (int i = 0; i < 6; i++)
-			{
-				// Setup the camera's view
-				m_CubemapCamera.SwitchCameraToFace(i);
-				glm::mat4 pointLightView = m_CubemapCamera.GetViewMatrix();
-				glm::mat4 pointLightViewProjMatrix = pointLightProjection * pointLightView;
+		// Render non-skinned models
+		{
+			m_GLCache->SetShader(m_ShadowmapShader);
+			m_ShadowmapShader->SetUniform("lightSpaceViewProjectionMatrix", caster.LightSpaceViewProjectionMatrix);
+			Renderer::FlushOpaqueNonSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
+			Renderer::FlushTransparentNonSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
+		}
 
-				m_EmptyFramebuffer.SetDepthAttachment(DepthStencilAttachmentFormat::NormalizedDepthOnly, pointLightShadowCubemap->GetCubemapID(), GL_TEXTURE_CUBE_MAP_POSITIVE_X + i);
-				m_EmptyFramebuffer.ClearDepth();
+		// Render terrain
+		if (renderTerrain)
+		{
+			m_ActiveScene->GetTerrain()->Draw(m_ShadowmapShader, RenderPassType::NoMaterialRequired);
+		}
+	}
 
-				// Setup model renderer
-				if (renderOnlyStatic)
-				{
-					m_ActiveScene->AddModelsToRenderer(ModelFilterType::StaticModels);
-				}
-				else
-				{
-					m_ActiveScene->AddModelsToRenderer(ModelFilterType::AllModels);
-				}
+	// All six faces are rendered in a single pass, the geometry shader routes each triangle to the viewports of the faces it overlaps.
+	// Meshes are also culled against every face on the CPU so the geometry shader can skip the faces a mesh can't touch
+	void ShadowmapPass::RenderPointShadowCaster(const ShadowAtlasCaster *faceCasters, int faceMask, ICamera *camera, ModelFilterType filter, bool renderTerrain)
+	{
+		glm::mat4 faceViewProjMatrices[6];
+		for (unsigned int face = 0; face < 6; face++)
+		{
+			const ShadowAtlasCaster &caster = faceCasters[face];
+			faceViewProjMatrices[face] = caster.LightSpaceViewProjectionMatrix;
+			glViewportIndexedf(face, static_cast<float>(caster.Viewport.x), static_cast<float>(caster.Viewport.y), static_cast<float>(caster.Viewport.z), static_cast<float>(caster.Viewport.w));
+			glScissorIndexed(face, caster.Viewport.x, caster.Viewport.y, caster.Viewport.z, caster.Viewport.w);
+		}
 
-				// Render skinned models
-				{
-					m_GLCache->SetShader(m_ShadowmapLinearSkinnedShader);
-					m_ShadowmapLinearSkinnedShader->SetUniform("lightPos", m_CubemapCamera.GetPosition());
-					m_ShadowmapLinearSkinnedShader->SetUniform("lightFarPlane", nearFarPlane.y);
-					m_ShadowmapLinearSkinnedShader->SetUniform("lightSpaceViewProjectionMatrix", pointLightViewProjMatrix);
-					Renderer::FlushOpaqueSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapLinearSkinnedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
-					Renderer::FlushTransparentSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapLinearSkinnedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
-				}
+		// Setup model renderer
+		Renderer::BeginLayerCulling(faceViewProjMatrices, 6);
+		m_ActiveScene->AddModelsToRenderer(filter);
 
-				// Render non-skinned models
-				{
-					m_GLCache->SetShader(m_ShadowmapLinearShader);
-					m_ShadowmapLinearShader->SetUniform("lightPos", m_CubemapCamera.GetPosition());
-					m_ShadowmapLinearShader->SetUniform("lightFarPlane", nearFarPlane.y);
-					m_ShadowmapLinearShader->SetUniform("lightSpaceViewProjectionMatrix", pointLightViewProjMatrix);
-					Renderer::FlushOpaqueNonSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapLinearShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
-					Renderer::FlushTransparentNonSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapLinearShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
-				}
+		// Render skinned models
+		{
+			m_GLCache->SetShader(m_ShadowmapLinearSkinnedShader);
+			m_ShadowmapLinearSkinnedShader->SetUniformArray("lightSpaceViewProjectionMatrices", 6, faceViewProjMatrices);
+			m_ShadowmapLinearSkinnedShader->SetUniform("faceMask", faceMask);
+			m_ShadowmapLinearSkinnedShader->SetUniform("lightPos", faceCasters[0].LightPosition);
+			m_ShadowmapLinearSkinnedShader->SetUniform("lightFarPlane", faceCasters[0].FarPlane);
+			Renderer::FlushOpaqueSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapLinearSkinnedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
+			Renderer::FlushTransparentSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapLinearSkinnedShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
+		}
 
-				// Render terrain
-				terrain->Draw(m_ShadowmapLinearShader, RenderPassType::NoMaterialRequired);
-			}
-			// Reset state
-			m_EmptyFramebuffer.SetDepthAttachment(DepthStencilAttachmentFormat::NormalizedDepthOnly, 0, GL_TEXTURE_CUBE_MAP_POSITIVE_X);
+		// Render non-skinned models
+		{
+			m_GLCache->SetShader(m_ShadowmapLinearShader);
+			m_ShadowmapLinearShader->SetUniformArray("lightSpaceViewProjectionMatrices", 6, faceViewProjMatrices);
+			m_ShadowmapLinearShader->SetUniform("faceMask", faceMask);
+			m_ShadowmapLinearShader->SetUniform("lightPos", faceCasters[0].LightPosition);
+			m_ShadowmapLinearShader->SetUniform("lightFarPlane", faceCasters[0].FarPlane);
+			Renderer::FlushOpaqueNonSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapLinearShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
+			Renderer::FlushTransparentNonSkinnedMeshes(camera, RenderPassType::NoMaterialRequired, m_ShadowmapLinearShader); // TODO: This should not use the camera's position for sorting we are rendering shadow maps for lights
+		}
+		Renderer::EndLayerCulling();
 
-			// Update output
-			passOutput.hasPointLightShadows = true;
-			passOutput.pointLightShadowmapBias = lightManager->GetPointLightShadowCasterBias();
-			passOutput.pointLightFarPlane = nearFarPlane.y;
+		// Render terrain (covers every face)
+		if (renderTerrain)
+		{
+			m_GLCache->SetShader(m_ShadowmapLinearShader);
+			m_ShadowmapLinearShader->SetUniform("layerMask", -1);
+			m_ActiveScene->GetTerrain()->Draw(m_ShadowmapLinearShader, RenderPassType::NoMaterialRequired);
 		}
-		passOutput.pointLightShadowCubemap = pointLightShadowCubemap; // Has to be bound even if it isn't used, thanks to OpenGL Driver
+	}
 
-		return passOutput;
+	unsigned int ShadowmapPass::GetShadowAtlasCasterTileCount(const ShadowAtlasCaster &caster)
+	{
+		// Point lights always have their six cube face tiles next to each other in the caster list
+		return caster.LinearDepth ? 6 : 1;
 	}
 }
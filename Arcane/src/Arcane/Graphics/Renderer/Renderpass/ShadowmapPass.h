@@ -2,10 +2,6 @@
 #ifndef SHADOWMAPPASS_H
 #define SHADOWMAPPASS_H
 
-#ifndef CUBEMAPCAMERA_H
-#include <Arcane/Graphics/Camera/CubemapCamera.h>
-#endif
-
 #ifndef RENDERPASS_H
 #include <Arcane/Graphics/Renderer/Renderpass/RenderPass.h>
 #endif
@@ -16,30 +12,38 @@
 
 namespace Arcane
 {
-	class Cubemap;
 	class ICamera;
 	class Scene;
 	class Shader;
 	class Framebuffer;
+	struct ShadowAtlasCaster;
+	enum class ModelFilterType;
 
 	class ShadowmapPass : public RenderPass {
 	public:
 		ShadowmapPass(Scene *scene);
-		ShadowmapPass(Scene *scene, Framebuffer *customDirectionalLightShadowFramebuffer, Framebuffer *customSpotLightShadowFramebuffer, Cubemap *customPointLightShadowCubemap);
+		ShadowmapPass(Scene *scene, Framebuffer *customDirectionalLightShadowFramebuffer);
 		virtual ~ShadowmapPass() override;
 
 		ShadowmapPassOutput GenerateShadowmaps(ICamera *camera, bool renderOnlyStatic);
+
+		// Allows the pass to be kept around while the custom target is leased from the render target pool only when it's needed
+		inline void SetCustomDirectionalLightShadowFramebuffer(Framebuffer *customFramebuffer) { m_CustomDirectionalLightShadowFramebuffer = customFramebuffer; }
 	private:
 		void Init();
+		void CalculateShadowCascades(ICamera *camera, const glm::vec3 &lightDir, const glm::vec2 &lightNearFarPlane, float shadowBias, unsigned int shadowmapResolution, ShadowmapPassOutput &passOutput);
+		void RenderDirectionalShadowCasters(const glm::mat4 *cascadeViewProjMatrices, int cascadeCount, ICamera *camera, ModelFilterType filter, bool renderTerrain);
+		void RenderSpotShadowCaster(const ShadowAtlasCaster &caster, ICamera *camera, ModelFilterType filter, bool renderTerrain);
+		void RenderPointShadowCaster(const ShadowAtlasCaster *faceCasters, int faceMask, ICamera *camera, ModelFilterType filter, bool renderTerrain);
+
+		static unsigned int GetShadowAtlasCasterTileCount(const ShadowAtlasCaster &caster);
 	private:
 		Shader *m_ShadowmapShader, *m_ShadowmapSkinnedShader, *m_ShadowmapLinearShader, *m_ShadowmapLinearSkinnedShader;
-		CubemapCamera m_CubemapCamera;
-		Framebuffer m_EmptyFramebuffer; // Used for attaching to when rendering (like cubemap faces)
+		Shader *m_ShadowmapCascadedShader, *m_ShadowmapCascadedSkinnedShader;
 
-		// Option to use custom shadow framebuffers/cubemaps. Most will go through the light manager and request the specified resolutions for normal rendering
+		// Option to use a custom directional shadow framebuffer (needs a depth texture array with a layer per cascade). Most will go through the light manager and request the specified resolutions for normal rendering
+		// Spot and point light shadows always go through the light manager's shadow atlas
 		Framebuffer *m_CustomDirectionalLightShadowFramebuffer = nullptr;
-		Framebuffer *m_CustomSpotLightShadowFramebuffer = nullptr;
-		Cubemap *m_CustomPointLightShadowCubemap = nullptr;
 	};
 }
 #endif
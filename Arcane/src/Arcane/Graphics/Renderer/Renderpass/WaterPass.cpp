@@ -7,6 +7,9 @@
 #include <Arcane/Graphics/Camera/ICamera.h>
 #include <Arcane/Graphics/Renderer/GLCache.h>
 #include <Arcane/Graphics/Renderer/Renderer.h>
+#include <Arcane/Graphics/Renderer/HiZBuffer.h>
+#include <Arcane/Graphics/Renderer/RenderTargetPool.h>
+#include <Arcane/Graphics/Window.h>
 #include <Arcane/Util/Loaders/AssetManager.h>
 #include <Arcane/Util/Loaders/ShaderLoader.h>
 #include <Arcane/Graphics/Renderer/Renderpass/Forward/ForwardLightingPass.h>
@@ -15,9 +18,11 @@
 
 namespace Arcane
 {
-	WaterPass::WaterPass(Scene * scene) : RenderPass(scene), m_WaterEnabled(true)
+	WaterPass::WaterPass(Scene * scene) : RenderPass(scene), m_WaterEnabled(true), m_ReflectionLightingPass(scene, nullptr), m_RefractionLightingPass(scene, nullptr)
 	{
 		m_WaterShader = ShaderLoader::LoadShader("Water.glsl");
+		m_ReflectionLightingPass.SetReducedQuality(true, WATER_CAPTURE_TEXTURE_LOD_BIAS);
+		m_RefractionLightingPass.SetReducedQuality(true, WATER_CAPTURE_TEXTURE_LOD_BIAS);
 
 		AssetManager &assetManager = AssetManager::GetInstance();
 
@@ -29,7 +34,12 @@ namespace Arcane
 
 	}
 
-	WaterPassOutput WaterPass::ExecuteWaterPass(ShadowmapPassOutput &inputShadowmapData, Framebuffer *inputFramebuffer, ICamera *camera)
+	bool WaterPass::HasVisibleWater()
+	{
+		return m_WaterEnabled && m_ActiveScene->GetWaterManager()->HasVisibleWater();
+	}
+
+	WaterPassOutput WaterPass::ExecuteWaterPass(ShadowmapPassOutput &inputShadowmapData, Framebuffer *inputFramebuffer, ICamera *camera, HiZBuffer *hiZBuffer)
 	{
 		WaterPassOutput passOutput;
 		if (!m_WaterEnabled)
@@ -40,97 +50,55 @@ namespace Arcane
 
 		LightManager *lightManager = m_ActiveScene->GetLightManager();
 		WaterManager *waterManager = m_ActiveScene->GetWaterManager();
-		const WaterComponent *closestWaterWithReflectionRefraction = waterManager->GetClosestWaterComponent();
+		std::vector<WaterCapture> &captures = waterManager->GetCaptures();
 
-		auto group = m_ActiveScene->m_Registry.view<TransformComponent, WaterComponent>();
-		for (auto entity : group)
+		// Render every capture into it's atlas tiles first, water planes at the same height share a capture
+		m_GLCache->SetUsesClipPlane(true);
+		for (WaterCapture &capture : captures)
 		{
-			auto&[transformComponent, waterComponent] = group.get<TransformComponent, WaterComponent>(entity);
-
-			// Setup state
-			m_GLCache->SetUsesClipPlane(true);
-
-			// Only the closest water can receive reflection and refraction from the environment with planar reflections/refractions
-			bool canReflectRefract = false;
-			Framebuffer *reflectionFramebuffer = nullptr;
-			Framebuffer *refractionFramebuffer = nullptr;
-			if (closestWaterWithReflectionRefraction == &waterComponent)
-			{
-				canReflectRefract = true;
-			}
+			if (capture.ReflectionEnabled)
+				RenderReflectionCapture(capture, inputShadowmapData, camera);
+			if (capture.RefractionEnabled)
+				RenderRefractionCapture(capture, inputShadowmapData, camera);
+		}
+		m_GLCache->SetUsesClipPlane(false);
 
-			if (canReflectRefract)
+		// Copy the scene (without any water) once for all of the screen space reflections, into a target leased for the frame. A multisampled scene is resolved by the copy
+		auto group = m_ActiveScene->m_Registry.view<TransformComponent, WaterComponent>();
+		Framebuffer *sceneColourCopy = nullptr;
+		if (hiZBuffer)
+		{
+			for (auto entity : group)
 			{
-				reflectionFramebuffer = waterManager->GetWaterReflectionFramebuffer();
-				refractionFramebuffer = waterManager->GetWaterRefractionFramebuffer();
-
-				// Generate Reflection framebuffer and render to it
-				if (closestWaterWithReflectionRefraction->ReflectionEnabled)
+				WaterComponent &waterComponent = group.get<WaterComponent>(entity);
+				if (waterComponent.ReflectionEnabled && waterComponent.ReflectionMode == WaterReflectionMode::WaterReflectionMode_ScreenSpace)
 				{
-					glm::vec2 reflectionNearFarPlane = waterManager->GetClosestWaterReflectionNearFarPlane();
-					float prevNearPlane = camera->GetNearPlane();
-					float prevFarPlane = camera->GetFarPlane();
-
-					m_GLCache->SetClipPlane(glm::vec4(0.0f, 1.0f, 0.0f, -transformComponent.Translation.y + waterComponent.ReflectionPlaneBias));
-					float distance = 2 * (camera->GetPosition().y - transformComponent.Translation.y);
-					camera->SetPosition(camera->GetPosition() - glm::vec3(0.0f, distance, 0.0f));
-					camera->SetNearFarPlane(reflectionNearFarPlane.x, reflectionNearFarPlane.y);
-					camera->InvertPitch();
-
-					ForwardLightingPass lightingPass(m_ActiveScene, reflectionFramebuffer);
-					LightingPassOutput output = lightingPass.ExecuteOpaqueLightingPass(inputShadowmapData, camera, false, false);
-					lightingPass.ExecuteTransparentLightingPass(inputShadowmapData, output.outputFramebuffer, camera, false, false);
-
-					// Check if reflection uses MSAA and resolve it if so
-					if (closestWaterWithReflectionRefraction->ReflectionMSAA)
-					{
-						Framebuffer *reflectionResolveFramebuffer = waterManager->GetWaterReflectionResolveFramebuffer();
-						glBindFramebuffer(GL_READ_FRAMEBUFFER, reflectionFramebuffer->GetFramebuffer());
-						glBindFramebuffer(GL_DRAW_FRAMEBUFFER, reflectionResolveFramebuffer->GetFramebuffer());
-						glBlitFramebuffer(0, 0, reflectionFramebuffer->GetWidth(), reflectionFramebuffer->GetHeight(), 0, 0, reflectionResolveFramebuffer->GetWidth(), reflectionResolveFramebuffer->GetHeight(), GL_COLOR_BUFFER_BIT, GL_NEAREST);
-						reflectionFramebuffer = reflectionResolveFramebuffer; // Update reflection framebuffer to the resolved with no MSAA
-					}
-
-					camera->SetPosition(camera->GetPosition() + glm::vec3(0.0f, distance, 0.0f));
-					camera->SetNearFarPlane(prevNearPlane, prevFarPlane);
-					camera->InvertPitch();
-				}
+					RenderTargetDesc copyDesc;
+					copyDesc.Width = Window::GetRenderResolutionWidth();
+					copyDesc.Height = Window::GetRenderResolutionHeight();
+					copyDesc.HasColour = true;
+					copyDesc.ColourFormat = FloatingPoint16;
+					sceneColourCopy = RenderTargetPool::AcquireForFrame(copyDesc);
 
-				// Generate Refraction framebuffer and render to it
-				if (closestWaterWithReflectionRefraction->RefractionEnabled)
-				{
-					glm::vec2 refractionNearFarPlane = waterManager->GetClosestWaterRefractionNearFarPlane();
-					float prevNearPlane = camera->GetNearPlane();
-					float prevFarPlane = camera->GetFarPlane();
-
-					m_GLCache->SetClipPlane(glm::vec4(0.0f, -1.0f, 0.0f, transformComponent.Translation.y + waterComponent.RefractionPlaneBias));
-					camera->SetNearFarPlane(refractionNearFarPlane.x, refractionNearFarPlane.y);
-
-					ForwardLightingPass lightingPass(m_ActiveScene, refractionFramebuffer);
-					LightingPassOutput output = lightingPass.ExecuteOpaqueLightingPass(inputShadowmapData, camera, false, false);
-					lightingPass.ExecuteTransparentLightingPass(inputShadowmapData, output.outputFramebuffer, camera, false, false);
-
-					// Check if refraction uses MSAA and resolve it if so
-					if (closestWaterWithReflectionRefraction->RefractionMSAA)
-					{
-						Framebuffer *refractionResolveFramebuffer = waterManager->GetWaterRefractionResolveFramebuffer();
-						glBindFramebuffer(GL_READ_FRAMEBUFFER, refractionFramebuffer->GetFramebuffer());
-						glBindFramebuffer(GL_DRAW_FRAMEBUFFER, refractionResolveFramebuffer->GetFramebuffer());
-						glBlitFramebuffer(0, 0, refractionFramebuffer->GetWidth(), refractionFramebuffer->GetHeight(), 0, 0, refractionResolveFramebuffer->GetWidth(), refractionResolveFramebuffer->GetHeight(), GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, GL_NEAREST);
-						refractionFramebuffer = refractionResolveFramebuffer; // Update refraction framebuffer to the resolved with no MSAA
-					}
-
-					camera->SetNearFarPlane(prevNearPlane, prevFarPlane);
+					glBindFramebuffer(GL_READ_FRAMEBUFFER, inputFramebuffer->GetFramebuffer());
+					glBindFramebuffer(GL_DRAW_FRAMEBUFFER, sceneColourCopy->GetFramebuffer());
+					glBlitFramebuffer(0, 0, inputFramebuffer->GetWidth(), inputFramebuffer->GetHeight(), 0, 0, sceneColourCopy->GetWidth(), sceneColourCopy->GetHeight(), GL_COLOR_BUFFER_BIT, GL_NEAREST);
+					break;
 				}
 			}
+		}
 
-			// Reset State
-			m_GLCache->SetUsesClipPlane(false);
+		for (auto entity : group)
+		{
+			auto&[transformComponent, waterComponent] = group.get<TransformComponent, WaterComponent>(entity);
+
+			int captureIndex = waterManager->GetCaptureIndex(&waterComponent);
+			const WaterCapture *capture = captureIndex >= 0 ? &captures[captureIndex] : nullptr;
 
 			// Finally render the water geometry and shade it
 			m_GLCache->SetShader(m_WaterShader);
 			inputFramebuffer->Bind();
-			glViewport(0, 0, inputFramebuffer->GetWidth(), inputFramebuffer->GetHeight());
+			glViewport(0, 0, Window::GetScaledDimension(inputFramebuffer->GetWidth()), Window::GetScaledDimension(inputFramebuffer->GetHeight()));
 			if (inputFramebuffer->IsMultisampled())
 			{
 				m_GLCache->SetMultisample(true);
@@ -152,7 +120,7 @@ namespace Arcane
 			waterComponent.MoveTimer = static_cast<float>(m_EffectsTimer.Elapsed() * waterComponent.WaveSpeed);
 			waterComponent.MoveTimer = static_cast<float>(std::fmod((double)waterComponent.MoveTimer, 1.0));
 
-			lightManager->BindLightingUniforms(m_WaterShader);
+			lightManager->BindLightingUniforms(m_WaterShader, camera);
 			m_WaterShader->SetUniform("view", camera->GetViewMatrix());
 			m_WaterShader->SetUniform("projection", camera->GetProjectionMatrix());
 			m_WaterShader->SetUniform("viewInverse", glm::inverse(camera->GetViewMatrix()));
@@ -170,22 +138,44 @@ namespace Arcane
 			m_WaterShader->SetUniform("waterNormalSmoothing", waterComponent.NormalSmoothing);
 			m_WaterShader->SetUniform("depthDampeningEffect", waterComponent.DepthDampening);
 
-			// Only setup reflections/refractions if it is the closest water component received by the WaterManager, and it has those options enabled
-			bool reflection = canReflectRefract && waterComponent.ReflectionEnabled;
-			bool refraction = canReflectRefract && waterComponent.RefractionEnabled;
+			// Only setup planar reflections/refractions if the water's capture got a tile in the atlas this frame, and it has those options enabled
+			bool screenSpaceReflection = waterComponent.ReflectionEnabled && waterComponent.ReflectionMode == WaterReflectionMode::WaterReflectionMode_ScreenSpace;
+			bool reflection = screenSpaceReflection || (capture && capture->ReflectionEnabled && waterComponent.ReflectionEnabled);
+			bool refraction = capture && capture->RefractionEnabled && waterComponent.RefractionEnabled;
 			m_WaterShader->SetUniform("reflectionEnabled", reflection);
-			if (reflection)
+			m_WaterShader->SetUniform("screenSpaceReflection", screenSpaceReflection);
+			if (screenSpaceReflection)
+			{
+				// Misses (or no depth pyramid at all) fall back to the reflection probe closest to the water
+				m_ActiveScene->GetProbeManager()->BindProbes(transformComponent.Translation, m_WaterShader);
+				m_WaterShader->SetUniform("ssrMaxIterations", sceneColourCopy ? SSR_MAX_ITERATIONS_DEFAULT : 0);
+				if (sceneColourCopy)
+				{
+					m_WaterShader->SetUniform("hiZMaxLevel", static_cast<int>(hiZBuffer->GetMipCount() - 1));
+					m_WaterShader->SetUniform("hiZBaseSize", hiZBuffer->GetBaseSize());
+					m_WaterShader->SetUniform("renderScale", Window::GetRenderScale());
+					m_WaterShader->SetUniform("ssrThickness", SSR_THICKNESS_DEFAULT);
+					hiZBuffer->GetTexture()->Bind(7);
+					m_WaterShader->SetUniform("hiZBuffer", 7);
+					sceneColourCopy->GetColourTexture()->Bind(8);
+					m_WaterShader->SetUniform("sceneColourTexture", 8);
+				}
+			}
+			else if (reflection)
 			{
 				m_WaterShader->SetUniform("reflectionTexture", 0);
-				reflectionFramebuffer->GetColourTexture()->Bind(0);
+				waterManager->GetReflectionAtlas()->GetColourTexture()->Bind(0);
+				m_WaterShader->SetUniform("reflectionViewProjection", capture->ReflectionViewProjection);
+				m_WaterShader->SetUniform("reflectionAtlasScaleBias", capture->ReflectionAtlasScaleBias);
 			}
 			m_WaterShader->SetUniform("refractionEnabled", refraction);
 			if (refraction)
 			{
 				m_WaterShader->SetUniform("refractionTexture", 1);
-				refractionFramebuffer->GetColourTexture()->Bind(1);
-				m_WaterShader->SetUniform("refractionDepthTexture", 4);
-				refractionFramebuffer->GetDepthStencilTexture()->Bind(4);
+				waterManager->GetRefractionAtlas()->GetColourTexture()->Bind(1);
+				m_WaterShader->SetUniform("refractionDepthTexture", 6);
+				waterManager->GetRefractionAtlas()->GetDepthStencilTexture()->Bind(6);
+				m_WaterShader->SetUniform("refractionAtlasScaleBias", capture->RefractionAtlasScaleBias);
 			}
 
 			m_WaterShader->SetUniform("dudvWaveTexture", 2);
@@ -206,4 +196,90 @@ namespace Arcane
 		passOutput.outputFramebuffer = inputFramebuffer;
 		return passOutput;
 	}
+
+	void WaterPass::RenderReflectionCapture(WaterCapture &capture, ShadowmapPassOutput &shadowmapData, ICamera *camera)
+	{
+		const WaterComponent &settings = *capture.SettingsWater;
+
+		// At half rate every other frame reuses the previous reflection, the water manager only keeps the history while the capture stays in the same tile
+		bool reuseReflection = settings.ReflectionHalfRate && capture.ReflectionHistoryValid && !capture.ReflectionReusedLastFrame;
+		capture.ReflectionReusedLastFrame = reuseReflection;
+		if (reuseReflection)
+			return;
+
+		float prevNearPlane = camera->GetNearPlane();
+		float prevFarPlane = camera->GetFarPlane();
+
+		glm::vec4 reflectionClipPlane(0.0f, 1.0f, 0.0f, -capture.PlaneHeight + settings.ReflectionPlaneBias);
+		m_GLCache->SetClipPlane(reflectionClipPlane);
+		float distance = 2 * (camera->GetPosition().y - capture.PlaneHeight);
+		camera->SetPosition(camera->GetPosition() - glm::vec3(0.0f, distance, 0.0f));
+		camera->SetNearFarPlane(settings.ReflectionNearPlane, settings.ReflectionFarPlane);
+		camera->InvertPitch();
+		capture.ReflectionViewProjection = camera->GetProjectionMatrix() * camera->GetViewMatrix();
+
+		Renderer::BeginCaptureCulling(camera, reflectionClipPlane, settings.CaptureMinScreenSize);
+		RenderCapture(m_ReflectionLightingPass, m_ActiveScene->GetWaterManager()->GetReflectionAtlas(), capture.ReflectionViewport, capture.ReflectionMSAA, GL_COLOR_BUFFER_BIT, shadowmapData, camera);
+		Renderer::EndCaptureCulling();
+
+		camera->SetPosition(camera->GetPosition() + glm::vec3(0.0f, distance, 0.0f));
+		camera->SetNearFarPlane(prevNearPlane, prevFarPlane);
+		camera->InvertPitch();
+
+		capture.ReflectionHistoryValid = true;
+	}
+
+	void WaterPass::RenderRefractionCapture(WaterCapture &capture, ShadowmapPassOutput &shadowmapData, ICamera *camera)
+	{
+		const WaterComponent &settings = *capture.SettingsWater;
+
+		float prevNearPlane = camera->GetNearPlane();
+		float prevFarPlane = camera->GetFarPlane();
+
+		glm::vec4 refractionClipPlane(0.0f, -1.0f, 0.0f, capture.PlaneHeight + settings.RefractionPlaneBias);
+		m_GLCache->SetClipPlane(refractionClipPlane);
+		camera->SetNearFarPlane(settings.RefractionNearPlane, settings.RefractionFarPlane);
+
+		// Depth is resolved as well since the water samples it for depth dampening
+		Renderer::BeginCaptureCulling(camera, refractionClipPlane, settings.CaptureMinScreenSize);
+		RenderCapture(m_RefractionLightingPass, m_ActiveScene->GetWaterManager()->GetRefractionAtlas(), capture.RefractionViewport, capture.RefractionMSAA, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, shadowmapData, camera);
+		Renderer::EndCaptureCulling();
+
+		camera->SetNearFarPlane(prevNearPlane, prevFarPlane);
+	}
+
+	void WaterPass::RenderCapture(ForwardLightingPass &lightingPass, Framebuffer *atlas, const glm::uvec4 &viewport, bool multisampled, GLbitfield resolveMask, ShadowmapPassOutput &shadowmapData, ICamera *camera)
+	{
+		// Non-MSAA captures render straight into their atlas tile, MSAA captures render into the corner of a pooled scratch target and are resolved into their tile.
+		// Without any MSAA water the scratch target isn't needed at all, so it eventually gets trimmed from the pool
+		Framebuffer *target = atlas;
+		glm::uvec4 targetViewport = viewport;
+		if (multisampled)
+		{
+			RenderTargetDesc scratchDesc;
+			scratchDesc.Width = WATER_MSAA_CAPTURE_RESOLUTION;
+			scratchDesc.Height = WATER_MSAA_CAPTURE_RESOLUTION;
+			scratchDesc.Multisampled = true;
+			scratchDesc.HasColour = true;
+			scratchDesc.ColourFormat = FloatingPoint16;
+			scratchDesc.DepthType = RenderTargetDepthType::RenderTargetDepthType_RBO;
+			scratchDesc.DepthFormat = NormalizedDepthOnly;
+			target = RenderTargetPool::Acquire(scratchDesc);
+			targetViewport = glm::uvec4(0, 0, viewport.z, viewport.w);
+		}
+
+		lightingPass.SetCustomFramebuffer(target);
+		lightingPass.SetViewport(targetViewport);
+		LightingPassOutput output = lightingPass.ExecuteOpaqueLightingPass(shadowmapData, camera, false, false);
+		lightingPass.ExecuteTransparentLightingPass(shadowmapData, output.outputFramebuffer, camera, false, false);
+
+		if (multisampled)
+		{
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, target->GetFramebuffer());
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, atlas->GetFramebuffer());
+			glBlitFramebuffer(0, 0, viewport.z, viewport.w, viewport.x, viewport.y, viewport.x + viewport.z, viewport.y + viewport.w, resolveMask, GL_NEAREST);
+
+			RenderTargetPool::Release(target);
+		}
+	}
 }
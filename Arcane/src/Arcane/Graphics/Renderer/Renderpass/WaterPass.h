@@ -18,11 +18,18 @@
 #include <Arcane/Util/Timer.h>
 #endif
 
+#ifndef FORWARDLIGHTINGPASS_H
+#include <Arcane/Graphics/Renderer/Renderpass/Forward/ForwardLightingPass.h>
+#endif
+
 namespace Arcane
 {
 	class Shader;
 	class Scene;
 	class ICamera;
+	class Framebuffer;
+	class HiZBuffer;
+	struct WaterCapture;
 
 	class WaterPass : public RenderPass
 	{
@@ -30,13 +37,23 @@ namespace Arcane
 		WaterPass(Scene *scene);
 		virtual ~WaterPass() override;
 
-		WaterPassOutput ExecuteWaterPass(ShadowmapPassOutput &inputShadowmapData, Framebuffer *inputFramebuffer, ICamera *camera);
+		// Screen space reflections need the depth pyramid of the opaque scene, without it (ie forward rendering) they only show the reflection probe
+		WaterPassOutput ExecuteWaterPass(ShadowmapPassOutput &inputShadowmapData, Framebuffer *inputFramebuffer, ICamera *camera, HiZBuffer *hiZBuffer = nullptr);
+
+		bool HasVisibleWater(); // If not the pass would do nothing, so it can be culled
+	private:
+		void RenderReflectionCapture(WaterCapture &capture, ShadowmapPassOutput &shadowmapData, ICamera *camera);
+		void RenderRefractionCapture(WaterCapture &capture, ShadowmapPassOutput &shadowmapData, ICamera *camera);
+		void RenderCapture(ForwardLightingPass &lightingPass, Framebuffer *atlas, const glm::uvec4 &viewport, bool multisampled, GLbitfield resolveMask, ShadowmapPassOutput &shadowmapData, ICamera *camera);
 	private:
 		bool m_WaterEnabled;
 
 		Shader *m_WaterShader;
 		Quad m_WaterPlane;
 		Timer m_EffectsTimer;
+
+		// Reflections and refractions are captured with the reduced quality lighting shaders
+		ForwardLightingPass m_ReflectionLightingPass, m_RefractionLightingPass;
 	};
 }
 #endif
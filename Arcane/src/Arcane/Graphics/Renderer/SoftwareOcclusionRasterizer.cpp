@@ -0,0 +1,262 @@
+#include "arcpch.h"
+#include "SoftwareOcclusionRasterizer.h"
+
+#include <Arcane/Core/Threads/ParallelFor.h>
+
+#include <xmmintrin.h>
+
+namespace Arcane
+{
+	SoftwareOcclusionRasterizer::SoftwareOcclusionRasterizer(int width, int height) : m_Width(width), m_Height(height), m_ViewProjection(1.0f)
+	{
+		ARC_ASSERT(width > 0 && (width % 4) == 0, "Occlusion rasterizer width must be a multiple of four");
+
+		m_BandCount = (m_Height + OCCLUSION_RASTERIZER_BAND_HEIGHT - 1) / OCCLUSION_RASTERIZER_BAND_HEIGHT;
+		m_DepthBuffer.resize(m_Width * m_Height, 1.0f);
+	}
+
+	SoftwareOcclusionRasterizer::~SoftwareOcclusionRasterizer() {}
+
+	void SoftwareOcclusionRasterizer::BeginFrame(const glm::mat4 &viewProjection)
+	{
+		m_ViewProjection = viewProjection;
+		m_Triangles.clear();
+		std::fill(m_DepthBuffer.begin(), m_DepthBuffer.end(), 1.0f);
+	}
+
+	void SoftwareOcclusionRasterizer::AddOccluderMesh(const std::vector<glm::vec3> &positions, const std::vector<unsigned int> &indices, const glm::mat4 &transform, bool cullBackface)
+	{
+		glm::mat4 modelViewProjection = m_ViewProjection * transform;
+
+		std::vector<glm::vec4> clipPositions(positions.size());
+		for (size_t i = 0; i < positions.size(); i++)
+		{
+			clipPositions[i] = modelViewProjection * glm::vec4(positions[i], 1.0f);
+		}
+
+		if (indices.empty())
+		{
+			for (size_t i = 0; i + 2 < clipPositions.size(); i += 3)
+			{
+				AddClipSpaceTriangle(clipPositions[i], clipPositions[i + 1], clipPositions[i + 2], cullBackface);
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				AddClipSpaceTriangle(clipPositions[indices[i]], clipPositions[indices[i + 1]], clipPositions[indices[i + 2]], cullBackface);
+			}
+		}
+	}
+
+	void SoftwareOcclusionRasterizer::AddOccluderBox(const glm::vec3 &boundsMin, const glm::vec3 &boundsMax)
+	{
+		glm::vec4 clipCorners[8];
+		for (int corner = 0; corner < 8; corner++)
+		{
+			clipCorners[corner] = m_ViewProjection * glm::vec4((corner & 1) ? boundsMax.x : boundsMin.x, (corner & 2) ? boundsMax.y : boundsMin.y, (corner & 4) ? boundsMax.z : boundsMin.z, 1.0f);
+		}
+
+		// Every face is the four corners sharing a bit, walked around the other two axes. Faces on the max side of an axis need the opposite winding to face outwards
+		for (int axis = 0; axis < 3; axis++)
+		{
+			int uBit = 1 << ((axis + 1) % 3), vBit = 1 << ((axis + 2) % 3);
+			for (int side = 0; side < 2; side++)
+			{
+				int base = side ? (1 << axis) : 0;
+				int c0 = base, c1 = base | uBit, c2 = base | uBit | vBit, c3 = base | vBit;
+				if (side == 0)
+					std::swap(c1, c3);
+
+				AddClipSpaceTriangle(clipCorners[c0], clipCorners[c1], clipCorners[c2], true);
+				AddClipSpaceTriangle(clipCorners[c0], clipCorners[c2], clipCorners[c3], true);
+			}
+		}
+	}
+
+	void SoftwareOcclusionRasterizer::Rasterize()
+	{
+		if (m_Triangles.empty())
+			return;
+
+		ParallelFor(static_cast<unsigned int>(m_BandCount), [this](unsigned int band)
+		{
+			RasterizeBand(static_cast<int>(band));
+		}, 2);
+	}
+
+	bool SoftwareOcclusionRasterizer::IsOccluded(const glm::mat4 &transform, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax) const
+	{
+		if (m_Triangles.empty())
+			return false;
+
+		glm::mat4 modelViewProjection = m_ViewProjection * transform;
+		glm::vec2 screenMin(std::numeric_limits<float>::max()), screenMax(std::numeric_limits<float>::lowest());
+		float closestDepth = 1.0f;
+		for (int corner = 0; corner < 8; corner++)
+		{
+			glm::vec4 clipCorner = modelViewProjection * glm::vec4((corner & 1) ? boundsMax.x : boundsMin.x, (corner & 2) ? boundsMax.y : boundsMin.y, (corner & 4) ? boundsMax.z : boundsMin.z, 1.0f);
+			if (clipCorner.w <= 0.0f || clipCorner.z < -clipCorner.w)
+				return false;
+
+			glm::vec3 screenCorner = ClipToScreen(clipCorner);
+			screenMin = glm::min(screenMin, glm::vec2(screenCorner));
+			screenMax = glm::max(screenMax, glm::vec2(screenCorner));
+			closestDepth = glm::min(closestDepth, screenCorner.z);
+		}
+
+		// Off screen boxes are left to frustum culling
+		if (screenMax.x < 0.0f || screenMax.y < 0.0f || screenMin.x >= m_Width || screenMin.y >= m_Height)
+			return false;
+
+		// Every pixel the box touches is tested, the first column is rounded down to a multiple of four so whole groups can be compared (extra pixels only make the test stricter)
+		int minX = glm::clamp(static_cast<int>(screenMin.x), 0, m_Width - 1) & ~3;
+		int maxX = glm::clamp(static_cast<int>(screenMax.x), 0, m_Width - 1);
+		int minY = glm::clamp(static_cast<int>(screenMin.y), 0, m_Height - 1);
+		int maxY = glm::clamp(static_cast<int>(screenMax.y), 0, m_Height - 1);
+
+		const __m128 boxDepth = _mm_set1_ps(closestDepth);
+		for (int y = minY; y <= maxY; y++)
+		{
+			const float *row = &m_DepthBuffer[y * m_Width];
+			for (int x = minX; x <= maxX; x += 4)
+			{
+				if (_mm_movemask_ps(_mm_cmple_ps(boxDepth, _mm_loadu_ps(row + x))) != 0)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	void SoftwareOcclusionRasterizer::AddClipSpaceTriangle(const glm::vec4 &v0, const glm::vec4 &v1, const glm::vec4 &v2, bool cullBackface)
+	{
+		// Only the near plane needs clipping (vertices behind it can't be projected), everything else is handled by clamping the triangle's bounds to the screen
+		const glm::vec4 *input[3] = { &v0, &v1, &v2 };
+		float nearDistance[3] = { v0.z + v0.w, v1.z + v1.w, v2.z + v2.w };
+		if (nearDistance[0] >= 0.0f && nearDistance[1] >= 0.0f && nearDistance[2] >= 0.0f)
+		{
+			AddScreenTriangle(ClipToScreen(v0), ClipToScreen(v1), ClipToScreen(v2), cullBackface);
+			return;
+		}
+
+		glm::vec4 clipped[4];
+		int clippedCount = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			int next = (i + 1) % 3;
+			if (nearDistance[i] >= 0.0f)
+				clipped[clippedCount++] = *input[i];
+			if ((nearDistance[i] >= 0.0f) != (nearDistance[next] >= 0.0f))
+			{
+				float t = nearDistance[i] / (nearDistance[i] - nearDistance[next]);
+				clipped[clippedCount++] = glm::mix(*input[i], *input[next], t);
+			}
+		}
+
+		for (int i = 1; i + 1 < clippedCount; i++)
+		{
+			AddScreenTriangle(ClipToScreen(clipped[0]), ClipToScreen(clipped[i]), ClipToScreen(clipped[i + 1]), cullBackface);
+		}
+	}
+
+	void SoftwareOcclusionRasterizer::AddScreenTriangle(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2, bool cullBackface)
+	{
+		float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+		if (area == 0.0f || (area < 0.0f && cullBackface))
+			return;
+
+		float minX = glm::min(v0.x, glm::min(v1.x, v2.x)), maxX = glm::max(v0.x, glm::max(v1.x, v2.x));
+		float minY = glm::min(v0.y, glm::min(v1.y, v2.y)), maxY = glm::max(v0.y, glm::max(v1.y, v2.y));
+		if (maxX < 0.0f || maxY < 0.0f || minX >= m_Width || minY >= m_Height)
+			return;
+
+		ScreenTriangle triangle;
+		triangle.Vertices[0] = v0;
+		triangle.Vertices[1] = area > 0.0f ? v1 : v2;
+		triangle.Vertices[2] = area > 0.0f ? v2 : v1;
+		triangle.MinY = glm::max(static_cast<int>(minY), 0);
+		triangle.MaxY = glm::min(static_cast<int>(maxY), m_Height - 1);
+		m_Triangles.push_back(triangle);
+	}
+
+	glm::vec3 SoftwareOcclusionRasterizer::ClipToScreen(const glm::vec4 &clipPosition) const
+	{
+		glm::vec3 ndcPosition = glm::vec3(clipPosition) / clipPosition.w;
+		return glm::vec3((ndcPosition.x * 0.5f + 0.5f) * m_Width, (ndcPosition.y * 0.5f + 0.5f) * m_Height, ndcPosition.z * 0.5f + 0.5f);
+	}
+
+	void SoftwareOcclusionRasterizer::RasterizeBand(int band)
+	{
+		int bandMinY = band * OCCLUSION_RASTERIZER_BAND_HEIGHT;
+		int bandMaxY = glm::min(bandMinY + OCCLUSION_RASTERIZER_BAND_HEIGHT, m_Height) - 1;
+
+		for (const ScreenTriangle &triangle : m_Triangles)
+		{
+			if (triangle.MaxY < bandMinY || triangle.MinY > bandMaxY)
+				continue;
+
+			RasterizeTriangle(triangle, bandMinY, bandMaxY);
+		}
+	}
+
+	void SoftwareOcclusionRasterizer::RasterizeTriangle(const ScreenTriangle &triangle, int bandMinY, int bandMaxY)
+	{
+		const glm::vec3 &v0 = triangle.Vertices[0], &v1 = triangle.Vertices[1], &v2 = triangle.Vertices[2];
+
+		int minX = glm::clamp(static_cast<int>(glm::min(v0.x, glm::min(v1.x, v2.x))), 0, m_Width - 1) & ~3;
+		int maxX = glm::clamp(static_cast<int>(glm::max(v0.x, glm::max(v1.x, v2.x))), 0, m_Width - 1);
+		int minY = glm::max(triangle.MinY, bandMinY);
+		int maxY = glm::min(triangle.MaxY, bandMaxY);
+
+		// Edge functions (positive inside since the triangle is counter clockwise) and the depth plane, all in the form a * x + b * y + c
+		const glm::vec3 *edgeStart[3] = { &v0, &v1, &v2 };
+		const glm::vec3 *edgeEnd[3] = { &v1, &v2, &v0 };
+		__m128 edgeA[3];
+		float edgeB[3], edgeC[3];
+		for (int edge = 0; edge < 3; edge++)
+		{
+			float a = edgeStart[edge]->y - edgeEnd[edge]->y;
+			float b = edgeEnd[edge]->x - edgeStart[edge]->x;
+			edgeA[edge] = _mm_set1_ps(a);
+			edgeB[edge] = b;
+			edgeC[edge] = -(a * edgeStart[edge]->x + b * edgeStart[edge]->y);
+		}
+
+		float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+		float depthA = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+		float depthB = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) / area;
+		float depthC = v0.z - depthA * v0.x - depthB * v0.y;
+		const __m128 depthAVector = _mm_set1_ps(depthA);
+
+		// Pixels are sampled at their centre
+		const __m128 pixelOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		const __m128 zero = _mm_setzero_ps();
+		for (int y = minY; y <= maxY; y++)
+		{
+			float pixelY = y + 0.5f;
+			__m128 edgeRow[3];
+			for (int edge = 0; edge < 3; edge++)
+			{
+				edgeRow[edge] = _mm_set1_ps(edgeB[edge] * pixelY + edgeC[edge]);
+			}
+			__m128 depthRow = _mm_set1_ps(depthB * pixelY + depthC);
+
+			float *row = &m_DepthBuffer[y * m_Width];
+			for (int x = minX; x <= maxX; x += 4)
+			{
+				__m128 pixelX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), pixelOffsets);
+				__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[0], pixelX), edgeRow[0]), zero);
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[1], pixelX), edgeRow[1]), zero));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[2], pixelX), edgeRow[2]), zero));
+				if (_mm_movemask_ps(inside) == 0)
+					continue;
+
+				__m128 depth = _mm_add_ps(_mm_mul_ps(depthAVector, pixelX), depthRow);
+				__m128 current = _mm_loadu_ps(row + x);
+				__m128 closest = _mm_min_ps(current, depth);
+				_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closest), _mm_andnot_ps(inside, current)));
+			}
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef SOFTWAREOCCLUSIONRASTERIZER_H
+#define SOFTWAREOCCLUSIONRASTERIZER_H
+
+#ifndef IOCCLUSIONCULLER_H
+#include <Arcane/Graphics/Renderer/IOcclusionCuller.h>
+#endif
+
+namespace Arcane
+{
+	// Rasterizes low poly occluders into a small depth buffer on the CPU so meshes can be culled the same frame without reading anything back from the GPU.
+	// Rows of the buffer are split into bands that are rasterized in parallel, four pixels at a time. Every band is only ever written by one thread and triangles are
+	// always processed in the order they were added, so the result doesn't depend on how the bands were scheduled. Nothing here touches OpenGL
+	class SoftwareOcclusionRasterizer : public IOcclusionCuller
+	{
+	public:
+		// Width must be a multiple of four
+		SoftwareOcclusionRasterizer(int width = OCCLUSION_RASTERIZER_WIDTH, int height = OCCLUSION_RASTERIZER_HEIGHT);
+		virtual ~SoftwareOcclusionRasterizer() override;
+
+		// Clears the depth buffer and the occluders from the previous frame
+		void BeginFrame(const glm::mat4 &viewProjection);
+
+		// Model space triangles placed in the world by transform, if there are no indices every three positions are a triangle
+		void AddOccluderMesh(const std::vector<glm::vec3> &positions, const std::vector<unsigned int> &indices, const glm::mat4 &transform, bool cullBackface);
+
+		// World space box, only the faces pointing towards the camera are rasterized
+		void AddOccluderBox(const glm::vec3 &boundsMin, const glm::vec3 &boundsMax);
+
+		void Rasterize();
+
+		virtual bool IsOccluded(const glm::mat4 &transform, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax) const override;
+
+		inline int GetWidth() const { return m_Width; }
+		inline int GetHeight() const { return m_Height; }
+		inline const std::vector<float>& GetDepthBuffer() const { return m_DepthBuffer; } // Bottom row first, depth is in the same [0, 1] range as the depth buffer
+		inline unsigned int GetTriangleCount() const { return static_cast<unsigned int>(m_Triangles.size()); }
+	private:
+		// Triangle after the perspective divide, xy is in pixels and z is depth. Always counter clockwise
+		struct ScreenTriangle
+		{
+			glm::vec3 Vertices[3];
+			int MinY, MaxY;
+		};
+
+		void AddClipSpaceTriangle(const glm::vec4 &v0, const glm::vec4 &v1, const glm::vec4 &v2, bool cullBackface);
+		void AddScreenTriangle(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2, bool cullBackface);
+		glm::vec3 ClipToScreen(const glm::vec4 &clipPosition) const;
+
+		void RasterizeBand(int band);
+		void RasterizeTriangle(const ScreenTriangle &triangle, int bandMinY, int bandMaxY);
+	private:
+		int m_Width, m_Height;
+		int m_BandCount;
+
+		glm::mat4 m_ViewProjection;
+		std::vector<float> m_DepthBuffer;
+		std::vector<ScreenTriangle> m_Triangles;
+	};
+}
+#endif
@@ -6,9 +6,10 @@
 
 namespace Arcane
 {
-	Shader::Shader(const std::string &path) : m_ShaderFilePath(path) {
+	Shader::Shader(const std::string &path, const std::vector<std::string> &defines) : m_ShaderFilePath(path) {
 		std::string shaderBinary = FileUtils::ReadFile(m_ShaderFilePath);
 		auto shaderSources = PreProcessShaderBinary(shaderBinary);
+		InjectDefines(shaderSources, defines);
 		Compile(shaderSources);
 	}
 
@@ -153,6 +154,28 @@ namespace Arcane
 		return shaderSources;
 	}
 
+	// Defines have to come after the #version directive, so they are added on the line following it in every stage
+	void Shader::InjectDefines(std::unordered_map<GLenum, std::string> &shaderSources, const std::vector<std::string> &defines) {
+		if (defines.empty())
+			return;
+
+		std::string defineBlock;
+		for (const std::string &define : defines) {
+			defineBlock += "#define " + define + "\n";
+		}
+
+		for (auto &item : shaderSources) {
+			std::string &source = item.second;
+			size_t versionPos = source.find("#version");
+			size_t insertPos = 0;
+			if (versionPos != std::string::npos) {
+				size_t eol = source.find('\n', versionPos);
+				insertPos = (eol == std::string::npos) ? source.size() : eol + 1;
+			}
+			source.insert(insertPos, defineBlock);
+		}
+	}
+
 	void Shader::Compile(const std::unordered_map<GLenum, std::string> &shaderSources) {
 		m_ShaderID = glCreateProgram();
 
@@ -8,7 +8,7 @@ namespace Arcane
 	{
 		friend class ShaderLoader;
 	private:
-		Shader(const std::string &path);
+		Shader(const std::string &path, const std::vector<std::string> &defines);
 	public:
 		~Shader();
 
@@ -43,6 +43,7 @@ namespace Arcane
 
 		static GLenum ShaderTypeFromString(const std::string &type);
 		std::unordered_map<GLenum, std::string> PreProcessShaderBinary(std::string &source);
+		void InjectDefines(std::unordered_map<GLenum, std::string> &shaderSources, const std::vector<std::string> &defines);
 		void Compile(const std::unordered_map<GLenum, std::string> &shaderSources);
 	private:
 		unsigned int m_ShaderID;
@@ -68,6 +68,22 @@ namespace Arcane
 		Unbind();
 	}
 
+	void Cubemap::SetFaceData(GLenum face, int mip, GLenum dataFormat, GLenum pixelDataType, const void *data)
+	{
+		ARC_ASSERT(m_FacesGenerated >= 6, "Cubemap needs all of it's faces generated before the face data can be set");
+
+		Bind();
+		glTexSubImage2D(face, mip, 0, 0, glm::max(m_FaceWidth >> mip, 1u), glm::max(m_FaceHeight >> mip, 1u), dataFormat, pixelDataType, data);
+		Unbind();
+	}
+
+	void Cubemap::GetFaceData(GLenum face, int mip, GLenum dataFormat, GLenum pixelDataType, void *outData)
+	{
+		Bind();
+		glGetTexImage(face, mip, dataFormat, pixelDataType, outData);
+		Unbind();
+	}
+
 	void Cubemap::Bind(int unit) {
 		glActiveTexture(GL_TEXTURE0 + unit);
 		glBindTexture(GL_TEXTURE_CUBE_MAP, m_CubemapID);
@@ -38,6 +38,10 @@ namespace Arcane
 
 		void GenerateCubemapFace(GLenum face, unsigned int faceWidth, unsigned int faceHeight, GLenum dataFormat, const unsigned char *data);
 
+		// Reads/writes a mip of a face that has already been generated (used for baking generated cubemaps to disk)
+		void SetFaceData(GLenum face, int mip, GLenum dataFormat, GLenum pixelDataType, const void *data);
+		void GetFaceData(GLenum face, int mip, GLenum dataFormat, GLenum pixelDataType, void *outData);
+
 		void Bind(int unit = 0);
 		void Unbind();
 
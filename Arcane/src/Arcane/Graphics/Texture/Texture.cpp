@@ -2,17 +2,18 @@
 #include "Texture.h"
 
 #include <Arcane/Graphics/Renderer/Renderer.h>
+#include <Arcane/Graphics/Mesh/MaterialBuffer.h>
 
 namespace Arcane
 {
-	Texture::Texture() : m_TextureId(0), m_TextureTarget(0), m_Width(0), m_Height(0), m_TextureSettings() {}
+	Texture::Texture() : m_TextureId(0), m_TextureTarget(0), m_Width(0), m_Height(0), m_LayerCount(1), m_TextureSettings() {}
 
-	Texture::Texture(TextureSettings &settings) : m_TextureId(0), m_TextureTarget(0), m_Width(0), m_Height(0), m_TextureSettings(settings) {}
+	Texture::Texture(TextureSettings &settings) : m_TextureId(0), m_TextureTarget(0), m_Width(0), m_Height(0), m_LayerCount(1), m_TextureSettings(settings) {}
 
 	// TODO: Current Texture Copy implementation only copies the highest resolution mip (level 0)
 	// This implementation is fine when the hardware generates the mips because our newly created texture will do the same
 	// This only fails if the mip levels contain custom data that was generated by the hardware via glGenerateMipmap(...)
-	Texture::Texture(const Texture &texture) : m_TextureId(0), m_TextureTarget(texture.GetTextureTarget()), m_Width(texture.GetWidth()), m_Height(texture.GetHeight()), m_TextureSettings(texture.GetTextureSettings())
+	Texture::Texture(const Texture &texture) : m_TextureId(0), m_TextureTarget(texture.GetTextureTarget()), m_Width(texture.GetWidth()), m_Height(texture.GetHeight()), m_LayerCount(1), m_TextureSettings(texture.GetTextureSettings())
 	{
 		glGenTextures(1, &m_TextureId);
 		Bind();
@@ -25,30 +26,33 @@ namespace Arcane
 	}
 
 	Texture::~Texture() {
+		if (IsGenerated()) {
+			MaterialBuffer::OnTextureDeleted(m_TextureId);
+		}
 		glDeleteTextures(1, &m_TextureId);
 	}
 
 	void Texture::ApplyTextureSettings() {
 		// Texture wrapping
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_TextureSettings.TextureWrapSMode);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_TextureSettings.TextureWrapTMode);
+		glTexParameteri(m_TextureTarget, GL_TEXTURE_WRAP_S, m_TextureSettings.TextureWrapSMode);
+		glTexParameteri(m_TextureTarget, GL_TEXTURE_WRAP_T, m_TextureSettings.TextureWrapTMode);
 		if (m_TextureSettings.HasBorder) {
-			glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, glm::value_ptr(m_TextureSettings.BorderColour));
+			glTexParameterfv(m_TextureTarget, GL_TEXTURE_BORDER_COLOR, glm::value_ptr(m_TextureSettings.BorderColour));
 		}
 
 		// Texture filtering
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_TextureSettings.TextureMinificationFilterMode);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_TextureSettings.TextureMagnificationFilterMode);
+		glTexParameteri(m_TextureTarget, GL_TEXTURE_MIN_FILTER, m_TextureSettings.TextureMinificationFilterMode);
+		glTexParameteri(m_TextureTarget, GL_TEXTURE_MAG_FILTER, m_TextureSettings.TextureMagnificationFilterMode);
 
 		// Mipmapping
 		if (m_TextureSettings.HasMips) {
-			glGenerateMipmap(GL_TEXTURE_2D);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, m_TextureSettings.MipBias);
+			glGenerateMipmap(m_TextureTarget);
+			glTexParameteri(m_TextureTarget, GL_TEXTURE_LOD_BIAS, m_TextureSettings.MipBias);
 		}
 
 		// Anisotropic filtering (Check with renderer to see the max amount allowed
 		float anistropyAmount = glm::min<float>(m_TextureSettings.TextureAnisotropyLevel, Renderer::GetRendererData().MaxAnisotropy);
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, anistropyAmount);
+		glTexParameterf(m_TextureTarget, GL_TEXTURE_MAX_ANISOTROPY_EXT, anistropyAmount);
 	}
 
 	void Texture::Generate2DTexture(unsigned int width, unsigned int height, GLenum dataFormat, GLenum pixelDataType, const void *data) {
@@ -89,6 +93,26 @@ namespace Arcane
 		Unbind();
 	}
 
+	void Texture::Generate2DArrayTexture(unsigned int width, unsigned int height, unsigned int layerCount, GLenum dataFormat, GLenum pixelDataType) {
+		m_TextureTarget = GL_TEXTURE_2D_ARRAY;
+		m_Width = width;
+		m_Height = height;
+		m_LayerCount = layerCount;
+
+		// If GL_NONE is specified, set the texture format to the data format
+		if (m_TextureSettings.TextureFormat == GL_NONE) {
+			m_TextureSettings.TextureFormat = dataFormat;
+		}
+
+		glGenTextures(1, &m_TextureId);
+		Bind();
+
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, m_TextureSettings.TextureFormat, width, height, layerCount, 0, dataFormat, pixelDataType, nullptr);
+		ApplyTextureSettings();
+
+		Unbind();
+	}
+
 	void Texture::GenerateMips() {
 		m_TextureSettings.HasMips = true;
 		if (IsGenerated()) {
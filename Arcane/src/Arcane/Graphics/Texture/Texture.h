@@ -39,6 +39,7 @@ namespace Arcane
 		// Generation functions
 		void Generate2DTexture(unsigned int width, unsigned int height, GLenum dataFormat, GLenum pixelDataType = GL_UNSIGNED_BYTE, const void *data = nullptr);
 		void Generate2DMultisampleTexture(unsigned int width, unsigned int height);
+		void Generate2DArrayTexture(unsigned int width, unsigned int height, unsigned int layerCount, GLenum dataFormat, GLenum pixelDataType = GL_UNSIGNED_BYTE);
 		void GenerateMips(); // Will attempt to generate mipmaps, only works if the texture has already been generated
 
 		void Bind(int unit = 0) const;
@@ -65,6 +66,7 @@ namespace Arcane
 		inline bool IsGenerated() const { return m_TextureId != 0; }
 		inline unsigned int GetWidth() const { return m_Width; }
 		inline unsigned int GetHeight() const { return m_Height; }
+		inline unsigned int GetLayerCount() const { return m_LayerCount; }
 		inline const TextureSettings& GetTextureSettings() const { return m_TextureSettings; }
 	private:
 		void ApplyTextureSettings();
@@ -73,6 +75,7 @@ namespace Arcane
 		GLenum m_TextureTarget;
 
 		unsigned int m_Width, m_Height;
+		unsigned int m_LayerCount; // Only greater than one for array textures
 
 		TextureSettings m_TextureSettings;
 	};
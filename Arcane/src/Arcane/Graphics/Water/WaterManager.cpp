@@ -3,98 +3,215 @@
 
 #include <Arcane/Scene/Scene.h>
 #include <Arcane/Scene/Components.h>
-#include <Arcane/Platform/OpenGL/Framebuffer/Framebuffer.h>
+#include <Arcane/Graphics/Camera/ICamera.h>
 
 namespace Arcane
 {
-	WaterManager::WaterManager(Scene *scene) : m_Scene(scene), m_ReflectionFramebuffer(nullptr), m_RefractionFramebuffer(nullptr), m_ClosestWaterComponent(nullptr), m_ResolveReflectionFramebuffer(nullptr), m_ResolveRefractionFramebuffer(nullptr)
+	WaterManager::WaterManager(Scene *scene) : m_Scene(scene), m_HasVisibleWater(false), m_ReflectionAllocator(WATER_ATLAS_RESOLUTION, WATER_ATLAS_MIN_TILE_RESOLUTION), m_RefractionAllocator(WATER_ATLAS_RESOLUTION, WATER_ATLAS_MIN_TILE_RESOLUTION),
+		m_ReflectionAtlas(WATER_ATLAS_RESOLUTION, WATER_ATLAS_RESOLUTION, false), m_RefractionAtlas(WATER_ATLAS_RESOLUTION, WATER_ATLAS_RESOLUTION, false)
 	{
-
+		// Refraction needs depth that can be sampled so the water can dampen it's distortion in shallow areas
+		m_ReflectionAtlas.AddColorTexture(FloatingPoint16).AddDepthStencilRBO(NormalizedDepthOnly).CreateFramebuffer();
+		m_RefractionAtlas.AddColorTexture(FloatingPoint16).AddDepthStencilTexture(NormalizedDepthOnly).CreateFramebuffer();
 	}
 
-	WaterManager::~WaterManager()
-	{
-		delete m_ReflectionFramebuffer;
-		delete m_RefractionFramebuffer;
-		delete m_ResolveReflectionFramebuffer;
-		delete m_ResolveRefractionFramebuffer;
-	}
+	WaterManager::~WaterManager() {}
 
 	void WaterManager::Init()
 	{
-		FindClosestWater();
+		GatherCaptures();
+		AllocateCaptureTiles();
 	}
 
 	void WaterManager::Update()
 	{
-		FindClosestWater();
+		GatherCaptures();
+		AllocateCaptureTiles();
+	}
+
+	int WaterManager::GetCaptureIndex(const WaterComponent *water) const
+	{
+		auto iter = m_WaterCaptureIndices.find(water);
+		if (iter == m_WaterCaptureIndices.end())
+			return -1;
+		return iter->second;
 	}
 
 	// TODO: Should use camera component's position
-	void WaterManager::FindClosestWater()
+	void WaterManager::GatherCaptures()
 	{
-		// Reset our pointers since it is possible no water exists anymore
-		m_ClosestWaterComponent = nullptr;
-		float closestDistance2 = std::numeric_limits<float>::max();
+		std::swap(m_Captures, m_PreviousCaptures);
+		m_Captures.clear();
+		m_WaterCaptureIndices.clear();
+		m_HasVisibleWater = false;
+
+		ICamera *camera = m_Scene->GetCamera();
+		glm::vec3 cameraPosition = camera->GetPosition();
+		glm::mat4 viewProjection = camera->GetProjectionMatrix() * camera->GetViewMatrix();
+
+		struct VisibleWater
+		{
+			WaterComponent *Water;
+			TransformComponent *Transform;
+			float DistanceToCamera2;
+		};
+		std::vector<VisibleWater> visibleWater;
 
 		auto group = m_Scene->m_Registry.view<TransformComponent, WaterComponent>();
 		for (auto entity : group)
 		{
-			// Water must have a mesh, otherwise nothing to render water on
 			auto&[transformComponent, waterComponent] = group.get<TransformComponent, WaterComponent>(entity);
+			if (!IsWaterVisible(transformComponent, viewProjection))
+				continue;
+			m_HasVisibleWater = true;
 
-			float currentDistance2 = glm::distance2(m_Scene->GetCamera()->GetPosition(), transformComponent.Translation);
-			if (currentDistance2 < closestDistance2)
-			{
-				closestDistance2 = currentDistance2;
-				m_ClosestWaterComponent = &waterComponent;
-				m_ClosestWaterTransform = &transformComponent;
-			}
+			// Screen space reflections don't need a capture, so the water only needs one for a planar reflection or refraction
+			if (!UsesPlanarReflection(waterComponent) && !waterComponent.RefractionEnabled)
+				continue;
+
+			visibleWater.push_back({ &waterComponent, &transformComponent, glm::distance2(cameraPosition, transformComponent.Translation) });
 		}
 
-		if (m_ClosestWaterComponent)
+		// Closest water first, so the closest water of every group provides the capture's settings and the furthest groups are the ones left out past the limit
+		std::sort(visibleWater.begin(), visibleWater.end(), [](const VisibleWater &a, const VisibleWater &b)
+		{
+			return a.DistanceToCamera2 < b.DistanceToCamera2;
+		});
+
+		for (const VisibleWater &water : visibleWater)
 		{
-			// TODO:
-			// Ideally we won't be re-allocating everytime we encounter a different sized reflection/refraction buffer. This NEEDS to be solved if we ever allow multiple water surfaces reflecting and refracting in a single scene
-			// Just allocate the biggest and only render to a portion with glViewPort, and make sure when we sample we account for the smaller size as well
-			glm::uvec2 requiredReflectionResolution = GetWaterReflectionRefractionQualityResolution(m_ClosestWaterComponent->WaterReflectionResolution);
-			if (m_ClosestWaterComponent->ReflectionEnabled && (!m_ReflectionFramebuffer || m_ReflectionFramebuffer->GetWidth() != requiredReflectionResolution.x || m_ReflectionFramebuffer->GetHeight() != requiredReflectionResolution.y || (m_ReflectionFramebuffer->IsMultisampled() != m_ClosestWaterComponent->ReflectionMSAA)))
+			float planeHeight = water.Transform->Translation.y;
+
+			int captureIndex = -1;
+			for (int i = 0; i < static_cast<int>(m_Captures.size()); i++)
 			{
-				if (m_ClosestWaterComponent->ReflectionMSAA)
-				{
-					ReallocateReflectionTarget(&m_ReflectionFramebuffer, requiredReflectionResolution, true);
-				}
-				else
+				if (glm::abs(m_Captures[i].PlaneHeight - planeHeight) <= WATER_CAPTURE_HEIGHT_TOLERANCE)
 				{
-					ReallocateReflectionTarget(&m_ReflectionFramebuffer, requiredReflectionResolution, false);
+					captureIndex = i;
+					break;
 				}
 			}
 
-			glm::uvec2 requiredRefractionResolution = GetWaterReflectionRefractionQualityResolution(m_ClosestWaterComponent->WaterRefractionResolution);
-			if (m_ClosestWaterComponent->ReflectionEnabled && (!m_RefractionFramebuffer || m_RefractionFramebuffer->GetWidth() != requiredRefractionResolution.x || m_RefractionFramebuffer->GetHeight() != requiredRefractionResolution.y || (m_RefractionFramebuffer->IsMultisampled() != m_ClosestWaterComponent->RefractionMSAA)))
+			if (captureIndex == -1)
 			{
-				if (m_ClosestWaterComponent->RefractionMSAA)
-				{
-					ReallocateRefractionTarget(&m_RefractionFramebuffer, requiredRefractionResolution, true);
-				}
-				else
-				{
-					ReallocateRefractionTarget(&m_RefractionFramebuffer, requiredRefractionResolution, false);
-				}
+				if (m_Captures.size() >= WATER_MAX_CAPTURES)
+					continue;
+
+				WaterCapture capture = {};
+				capture.PlaneHeight = planeHeight;
+				capture.SettingsWater = water.Water;
+				capture.DistanceToCamera2 = water.DistanceToCamera2;
+				capture.ReflectionViewProjection = glm::mat4(1.0f);
+				m_Captures.push_back(capture);
+				captureIndex = static_cast<int>(m_Captures.size() - 1);
 			}
 
-			// If we are using reflection MSAA maybe re-allocate that target if it is required
-			if (m_ClosestWaterComponent->ReflectionEnabled && m_ClosestWaterComponent->ReflectionMSAA && (!m_ResolveReflectionFramebuffer || m_ResolveReflectionFramebuffer->GetWidth() != requiredReflectionResolution.x || m_ResolveReflectionFramebuffer->GetHeight() != requiredReflectionResolution.y))
+			// The group uses the highest quality any of it's water asks for
+			WaterCapture &capture = m_Captures[captureIndex];
+			if (UsesPlanarReflection(*water.Water))
 			{
-				ReallocateReflectionTarget(&m_ResolveReflectionFramebuffer, requiredReflectionResolution, false);
+				capture.ReflectionEnabled = true;
+				capture.ReflectionMSAA |= water.Water->ReflectionMSAA;
+				capture.ReflectionResolution = glm::max(capture.ReflectionResolution, GetWaterReflectionRefractionQualityResolution(water.Water->WaterReflectionResolution).x);
 			}
-			if (m_ClosestWaterComponent->RefractionEnabled && m_ClosestWaterComponent->RefractionMSAA && (!m_ResolveRefractionFramebuffer || m_ResolveRefractionFramebuffer->GetWidth() != requiredRefractionResolution.x || m_ResolveRefractionFramebuffer->GetHeight() != requiredRefractionResolution.y))
+			if (water.Water->RefractionEnabled)
 			{
-				ReallocateRefractionTarget(&m_ResolveRefractionFramebuffer, requiredRefractionResolution, false);
+				capture.RefractionEnabled = true;
+				capture.RefractionMSAA |= water.Water->RefractionMSAA;
+				capture.RefractionResolution = glm::max(capture.RefractionResolution, GetWaterReflectionRefractionQualityResolution(water.Water->WaterRefractionResolution).x);
 			}
+
+			m_WaterCaptureIndices[water.Water] = captureIndex;
 		}
 	}
 
+	void WaterManager::AllocateCaptureTiles()
+	{
+		m_ReflectionAllocator.ClearRequests();
+		m_RefractionAllocator.ClearRequests();
+
+		// MSAA captures are resolved from the scratch target, so their tiles can't be larger than it
+		std::vector<glm::uvec2> requestHandles(m_Captures.size());
+		for (unsigned int i = 0; i < m_Captures.size(); i++)
+		{
+			WaterCapture &capture = m_Captures[i];
+			float importance = 1.0f / (1.0f + glm::sqrt(capture.DistanceToCamera2));
+
+			if (capture.ReflectionEnabled)
+			{
+				unsigned int resolution = capture.ReflectionMSAA ? glm::min(capture.ReflectionResolution, static_cast<unsigned int>(WATER_MSAA_CAPTURE_RESOLUTION)) : capture.ReflectionResolution;
+				requestHandles[i].x = m_ReflectionAllocator.AddRequest(importance, resolution, 1);
+			}
+			if (capture.RefractionEnabled)
+			{
+				unsigned int resolution = capture.RefractionMSAA ? glm::min(capture.RefractionResolution, static_cast<unsigned int>(WATER_MSAA_CAPTURE_RESOLUTION)) : capture.RefractionResolution;
+				requestHandles[i].y = m_RefractionAllocator.AddRequest(importance, resolution, 1);
+			}
+		}
+
+		m_ReflectionAllocator.Allocate();
+		m_RefractionAllocator.Allocate();
+
+		for (unsigned int i = 0; i < m_Captures.size(); i++)
+		{
+			WaterCapture &capture = m_Captures[i];
+			if (capture.ReflectionEnabled)
+			{
+				capture.ReflectionEnabled = m_ReflectionAllocator.GetAllocation(requestHandles[i].x, 0, capture.ReflectionViewport);
+				capture.ReflectionAtlasScaleBias = m_ReflectionAllocator.GetAtlasScaleBias(capture.ReflectionViewport);
+			}
+			if (capture.RefractionEnabled)
+			{
+				capture.RefractionEnabled = m_RefractionAllocator.GetAllocation(requestHandles[i].y, 0, capture.RefractionViewport);
+				capture.RefractionAtlasScaleBias = m_RefractionAllocator.GetAtlasScaleBias(capture.RefractionViewport);
+			}
+
+			// The previous reflection can only be reprojected if it is still in the same tile
+			for (const WaterCapture &previousCapture : m_PreviousCaptures)
+			{
+				if (glm::abs(previousCapture.PlaneHeight - capture.PlaneHeight) <= WATER_CAPTURE_HEIGHT_TOLERANCE && previousCapture.ReflectionEnabled && capture.ReflectionEnabled && previousCapture.ReflectionViewport == capture.ReflectionViewport)
+				{
+					capture.ReflectionViewProjection = previousCapture.ReflectionViewProjection;
+					capture.ReflectionHistoryValid = previousCapture.ReflectionHistoryValid;
+					capture.ReflectionReusedLastFrame = previousCapture.ReflectionReusedLastFrame;
+					break;
+				}
+			}
+		}
+	}
+
+	bool WaterManager::UsesPlanarReflection(const WaterComponent &water)
+	{
+		return water.ReflectionEnabled && water.ReflectionMode == WaterReflectionMode::WaterReflectionMode_Planar;
+	}
+
+	bool WaterManager::IsWaterVisible(const TransformComponent &transform, const glm::mat4 &viewProjection)
+	{
+		// Same transform the water pass renders the plane with, the plane is only hidden if all four corners are outside the same clip plane
+		glm::mat4 translate = glm::translate(glm::mat4(1.0f), transform.Translation);
+		glm::mat4 rotate = glm::rotate(glm::mat4(1.0f), glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+		glm::mat4 scale = glm::scale(glm::mat4(1.0f), transform.Scale);
+		glm::mat4 modelViewProjection = viewProjection * translate * rotate * scale;
+
+		int cornersOutsidePlane[6] = { 0, 0, 0, 0, 0, 0 };
+		for (int corner = 0; corner < 4; corner++)
+		{
+			glm::vec4 clipCorner = modelViewProjection * glm::vec4((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, 0.0f, 1.0f);
+			for (int axis = 0; axis < 3; axis++)
+			{
+				cornersOutsidePlane[axis * 2] += clipCorner[axis] < -clipCorner.w ? 1 : 0;
+				cornersOutsidePlane[axis * 2 + 1] += clipCorner[axis] > clipCorner.w ? 1 : 0;
+			}
+		}
+
+		for (int plane = 0; plane < 6; plane++)
+		{
+			if (cornersOutsidePlane[plane] == 4)
+				return false;
+		}
+		return true;
+	}
+
 	glm::uvec2 WaterManager::GetWaterReflectionRefractionQualityResolution(WaterReflectionRefractionQuality quality)
 	{
 		switch (quality)
@@ -119,48 +236,4 @@ namespace Arcane
 			return glm::uvec2(0, 0);
 		}
 	}
-
-	void WaterManager::ReallocateReflectionTarget(Framebuffer **framebuffer, glm::uvec2 newResolution, bool multisampled)
-	{
-		if (*framebuffer) // TODO: Can this ever be garbage data or nullptr? If it is just a nullptr this isn't needed. Ehh this function is temporary until this is improved anyways
-		{
-			delete *framebuffer;
-		}
-
-		*framebuffer = new Framebuffer(newResolution.x, newResolution.y, multisampled);
-		(*framebuffer)->AddColorTexture(FloatingPoint16).AddDepthStencilRBO(NormalizedDepthOnly).CreateFramebuffer();
-	}
-
-	void WaterManager::ReallocateRefractionTarget(Framebuffer **framebuffer, glm::uvec2 newResolution, bool multisampled)
-	{
-		if (*framebuffer) // TODO: Can this ever be garbage data or nullptr? If it is just a nullptr this isn't needed. Ehh this function is temporary until this is improved anyways
-		{
-			delete *framebuffer;
-		}
-
-		*framebuffer = new Framebuffer(newResolution.x, newResolution.y, multisampled);
-		(*framebuffer)->AddColorTexture(FloatingPoint16).AddDepthStencilTexture(NormalizedDepthOnly).CreateFramebuffer();
-	}
-
-	glm::vec2 WaterManager::GetClosestWaterReflectionNearFarPlane()
-	{
-		if (!m_ClosestWaterComponent)
-		{
-			ARC_ASSERT(false, "Water with Reflection does not exist in current scene - could not get near/far plane");
-			return glm::vec2(WATER_REFLECTION_NEAR_PLANE_DEFAULT, WATER_REFLECTION_FAR_PLANE_DEFAULT);
-		}
-
-		return glm::vec2(m_ClosestWaterComponent->ReflectionNearPlane, m_ClosestWaterComponent->ReflectionFarPlane);
-	}
-
-	glm::vec2 WaterManager::GetClosestWaterRefractionNearFarPlane()
-	{
-		if (!m_ClosestWaterComponent)
-		{
-			ARC_ASSERT(false, "Water with Refraction does not exist in current scene - could not get near/far plane");
-			return glm::vec2(WATER_REFRACTION_NEAR_PLANE_DEFAULT, WATER_REFRACTION_FAR_PLANE_DEFAULT);
-		}
-
-		return glm::vec2(m_ClosestWaterComponent->RefractionNearPlane, m_ClosestWaterComponent->RefractionFarPlane);
-	}
 }
@@ -2,12 +2,19 @@
 #ifndef WATERMANAGER_H
 #define WATERMANAGER_H
 
+#ifndef FRAMEBUFFER_H
+#include <Arcane/Platform/OpenGL/Framebuffer/Framebuffer.h>
+#endif
+
+#ifndef ATLASALLOCATOR_H
+#include <Arcane/Graphics/Renderer/AtlasAllocator.h>
+#endif
+
 namespace Arcane
 {
 	class Scene;
 	struct WaterComponent;
 	struct TransformComponent;
-	class Framebuffer;
 
 	enum class WaterReflectionRefractionQuality : int
 	{
@@ -19,6 +26,34 @@ namespace Arcane
 		WaterReflectionRefractionQualitySize
 	};
 
+	enum class WaterReflectionMode : int
+	{
+		WaterReflectionMode_Planar,			// Scene is re-rendered from the mirrored camera into the reflection atlas
+		WaterReflectionMode_ScreenSpace,	// Traced against the already rendered scene, falls back to the reflection probe (needs the deferred renderer's depth pyramid)
+		WaterReflectionModeSize
+	};
+
+	// A planar reflection and/or refraction, shared by every visible water plane at the same height since they would all capture the same image
+	struct WaterCapture
+	{
+		float PlaneHeight;
+		const WaterComponent *SettingsWater; // Closest water of the group, it's plane biases, near/far planes and culling settings are used for the capture
+		float DistanceToCamera2;
+
+		bool ReflectionEnabled, RefractionEnabled; // Only true if the capture has a tile in the atlas this frame
+		bool ReflectionMSAA, RefractionMSAA;
+		unsigned int ReflectionResolution, RefractionResolution;
+		glm::uvec4 ReflectionViewport, RefractionViewport; // (x, y, width, height) of the tile in the atlas
+		glm::vec4 ReflectionAtlasScaleBias, RefractionAtlasScaleBias;
+
+		// Reflection history for half rate reflections, only carried over to the next frame if the capture keeps the same tile
+		glm::mat4 ReflectionViewProjection;
+		bool ReflectionHistoryValid;
+		bool ReflectionReusedLastFrame;
+	};
+
+	// Every visible water plane is grouped into a capture by height, each capture then gets a tile in the reflection and refraction atlases.
+	// The atlases are allocated once, so any amount of lakes, rivers and pools can coexist without reallocating render targets
 	class WaterManager
 	{
 	public:
@@ -29,29 +64,28 @@ namespace Arcane
 		void Update();
 
 		static glm::uvec2 GetWaterReflectionRefractionQualityResolution(WaterReflectionRefractionQuality quality);
+		static bool UsesPlanarReflection(const WaterComponent &water);
+
+		inline std::vector<WaterCapture>& GetCaptures() { return m_Captures; }
+		int GetCaptureIndex(const WaterComponent *water) const; // Returns -1 if the water doesn't receive reflection/refraction this frame
+		inline bool HasVisibleWater() const { return m_HasVisibleWater; } // Includes water without a capture, the renderer skips the water pass entirely without any
 
-		// Getters for water using reflection/refraction (right now the closest water instance is the one that gets reflection/refraction)
-		inline bool HasWaterWithRefractionReflection() const { return m_ReflectionFramebuffer != nullptr && m_RefractionFramebuffer != nullptr; }
-		Framebuffer* GetWaterRefractionFramebuffer() { return m_RefractionFramebuffer; }
-		Framebuffer* GetWaterReflectionFramebuffer() { return m_ReflectionFramebuffer; }
-		Framebuffer* GetWaterRefractionResolveFramebuffer() { return m_ResolveRefractionFramebuffer; } // MSAA resolve framebuffer for refraction
-		Framebuffer* GetWaterReflectionResolveFramebuffer() { return m_ResolveReflectionFramebuffer; } // MSAA resolve framebuffer for reflection
-		inline const WaterComponent* GetClosestWaterComponent() { return m_ClosestWaterComponent; }
-		glm::vec2 GetClosestWaterReflectionNearFarPlane();
-		glm::vec2 GetClosestWaterRefractionNearFarPlane();
+		inline Framebuffer* GetReflectionAtlas() { return &m_ReflectionAtlas; }
+		inline Framebuffer* GetRefractionAtlas() { return &m_RefractionAtlas; }
 	private:
-		void FindClosestWater();
+		void GatherCaptures();
+		void AllocateCaptureTiles();
 
-		void ReallocateReflectionTarget(Framebuffer **framebuffer, glm::uvec2 newResolution, bool multisampled);
-		void ReallocateRefractionTarget(Framebuffer **framebuffer, glm::uvec2 newResolution, bool multisampled);
+		static bool IsWaterVisible(const TransformComponent &transform, const glm::mat4 &viewProjection);
 	private:
 		Scene *m_Scene;
 
-		// Currently only supports one reflection/refraction water surface at a time, so keep track of the closest so it can reflect and refract it so the water pass can then use these at rendering time
-		WaterComponent *m_ClosestWaterComponent;
-		TransformComponent *m_ClosestWaterTransform;
-		Framebuffer *m_ReflectionFramebuffer, *m_RefractionFramebuffer;
-		Framebuffer *m_ResolveReflectionFramebuffer, *m_ResolveRefractionFramebuffer; // Only used for MSAA
+		std::vector<WaterCapture> m_Captures, m_PreviousCaptures;
+		std::unordered_map<const WaterComponent*, int> m_WaterCaptureIndices;
+		bool m_HasVisibleWater;
+
+		AtlasAllocator m_ReflectionAllocator, m_RefractionAllocator;
+		Framebuffer m_ReflectionAtlas, m_RefractionAtlas;
 	};
 }
 
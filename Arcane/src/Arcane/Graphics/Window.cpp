@@ -11,6 +11,7 @@ namespace Arcane
 	bool Window::s_HideUI;
 	int Window::s_Width; int Window::s_Height;
 	int Window::s_RenderResolutionWidth; int Window::s_RenderResolutionHeight;
+	float Window::s_RenderScale = 1.0f;
 	bool Window::s_VSync;
 	bool Window::s_EnableImGui;
 
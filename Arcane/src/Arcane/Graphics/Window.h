@@ -34,6 +34,13 @@ namespace Arcane
 		static inline int GetHeight() { return s_Height; }
 		static inline int GetRenderResolutionWidth() { return s_RenderResolutionWidth; }
 		static inline int GetRenderResolutionHeight() { return s_RenderResolutionHeight; }
+
+		// Fraction of the render resolution the main view is currently drawn at (dynamic resolution). Targets stay allocated at the render resolution and only their bottom left corner is drawn to
+		static inline float GetRenderScale() { return s_RenderScale; }
+		static inline void SetRenderScale(float scale) { s_RenderScale = scale; }
+		static inline int GetScaledDimension(int dimension) { return glm::max(1, static_cast<int>(std::ceil(dimension * s_RenderScale))); }
+		static inline int GetScaledRenderResolutionWidth() { return GetScaledDimension(s_RenderResolutionWidth); }
+		static inline int GetScaledRenderResolutionHeight() { return GetScaledDimension(s_RenderResolutionHeight); }
 	private:
 		bool InitInternal();
 		void SetFullscreenResolution();
@@ -66,6 +73,7 @@ namespace Arcane
 		static bool s_HideUI;
 		static int s_Width, s_Height;
 		static int s_RenderResolutionWidth, s_RenderResolutionHeight;
+		static float s_RenderScale;
 		static bool s_VSync;
 
 		static bool s_EnableImGui;
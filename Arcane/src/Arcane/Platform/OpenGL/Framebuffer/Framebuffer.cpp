@@ -82,25 +82,7 @@ namespace Arcane
 
 		Bind();
 
-		TextureSettings depthStencilSettings;
-		depthStencilSettings.TextureFormat = textureFormat;
-		depthStencilSettings.TextureWrapSMode = GL_CLAMP_TO_BORDER;
-		depthStencilSettings.TextureWrapTMode = GL_CLAMP_TO_BORDER;
-		if (bilinearFiltering)
-		{
-			depthStencilSettings.TextureMinificationFilterMode = GL_LINEAR;
-			depthStencilSettings.TextureMagnificationFilterMode = GL_LINEAR;
-		}
-		else
-		{
-			depthStencilSettings.TextureMinificationFilterMode = GL_NEAREST;
-			depthStencilSettings.TextureMagnificationFilterMode = GL_NEAREST;
-		}
-		depthStencilSettings.TextureAnisotropyLevel = 1.0f;
-		depthStencilSettings.HasBorder = true;
-		depthStencilSettings.BorderColour = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
-		depthStencilSettings.HasMips = false;
-		m_DepthStencilTexture.SetTextureSettings(depthStencilSettings);
+		m_DepthStencilTexture.SetTextureSettings(GetDepthStencilTextureSettings(textureFormat, bilinearFiltering));
 
 		// Generate depth attachment
 		if (m_IsMultisampled) {
@@ -116,6 +98,33 @@ namespace Arcane
 		return *this;
 	}
 
+	Framebuffer& Framebuffer::AddDepthStencilTextureArray(DepthStencilAttachmentFormat textureFormat, unsigned int layerCount, bool bilinearFiltering/* = false*/) {
+#ifdef ARC_DEV_BUILD
+		if (m_DepthStencilTexture.IsGenerated()) {
+			ARC_LOG_ERROR("Framebuffer already has a depth attachment");
+			return *this;
+		}
+#endif // ARC_DEV_BUILD
+		ARC_ASSERT(m_Width > 0 && m_Height > 0 && layerCount > 0, "Framebuffer width, height, and layer count need to be > 0 to generate depth/stencil texture array");
+		ARC_ASSERT(!m_IsMultisampled, "Multisampled depth/stencil texture arrays are not supported");
+
+		GLenum attachmentType = GL_DEPTH_STENCIL_ATTACHMENT;
+		if (textureFormat == NormalizedDepthOnly) {
+			attachmentType = GL_DEPTH_ATTACHMENT;
+		}
+
+		Bind();
+
+		m_DepthStencilTexture.SetTextureSettings(GetDepthStencilTextureSettings(textureFormat, bilinearFiltering));
+
+		// Generate layered depth attachment, every layer gets cleared and can be rendered to in a single pass
+		m_DepthStencilTexture.Generate2DArrayTexture(m_Width, m_Height, layerCount, GL_DEPTH_COMPONENT, GL_FLOAT);
+		glFramebufferTexture(GL_FRAMEBUFFER, attachmentType, m_DepthStencilTexture.GetTextureId(), 0);
+
+		Unbind();
+		return *this;
+	}
+
 	Framebuffer& Framebuffer::AddDepthStencilRBO(DepthStencilAttachmentFormat textureFormat) {
 #ifdef ARC_DEV_BUILD
 		if (m_DepthStencilRBO != 0) {
@@ -164,6 +173,38 @@ namespace Arcane
 		glFramebufferTexture2D(GL_FRAMEBUFFER, attachmentType, targetType, target, 0);
 	}
 
+	void Framebuffer::SetDepthAttachmentLayer(DepthStencilAttachmentFormat textureFormat, unsigned int target, int layer) {
+		GLenum attachmentType = GL_DEPTH_STENCIL_ATTACHMENT;
+		if (textureFormat == NormalizedDepthOnly)
+		{
+			attachmentType = GL_DEPTH_ATTACHMENT;
+		}
+
+		glFramebufferTextureLayer(GL_FRAMEBUFFER, attachmentType, target, 0, layer);
+	}
+
+	TextureSettings Framebuffer::GetDepthStencilTextureSettings(DepthStencilAttachmentFormat textureFormat, bool bilinearFiltering) {
+		TextureSettings depthStencilSettings;
+		depthStencilSettings.TextureFormat = textureFormat;
+		depthStencilSettings.TextureWrapSMode = GL_CLAMP_TO_BORDER;
+		depthStencilSettings.TextureWrapTMode = GL_CLAMP_TO_BORDER;
+		if (bilinearFiltering)
+		{
+			depthStencilSettings.TextureMinificationFilterMode = GL_LINEAR;
+			depthStencilSettings.TextureMagnificationFilterMode = GL_LINEAR;
+		}
+		else
+		{
+			depthStencilSettings.TextureMinificationFilterMode = GL_NEAREST;
+			depthStencilSettings.TextureMagnificationFilterMode = GL_NEAREST;
+		}
+		depthStencilSettings.TextureAnisotropyLevel = 1.0f;
+		depthStencilSettings.HasBorder = true;
+		depthStencilSettings.BorderColour = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+		depthStencilSettings.HasMips = false;
+		return depthStencilSettings;
+	}
+
 	void Framebuffer::Bind() {
 		glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
 	}
@@ -38,6 +38,7 @@ namespace Arcane
 		void CreateFramebuffer();
 		Framebuffer& AddColorTexture(ColorAttachmentFormat textureFormat);
 		Framebuffer& AddDepthStencilTexture(DepthStencilAttachmentFormat textureFormat, bool bilinearFiltering = false); // bilinearFiltering should be false for GBuffer but shadowmaps can set this to true to get some free bilinear sampling
+		Framebuffer& AddDepthStencilTextureArray(DepthStencilAttachmentFormat textureFormat, unsigned int layerCount, bool bilinearFiltering = false); // Attached as a layered target so geometry shaders can pick the layer with gl_Layer
 		Framebuffer& AddDepthStencilRBO(DepthStencilAttachmentFormat rboFormat);
 
 		void Bind();
@@ -46,6 +47,7 @@ namespace Arcane
 		// Assumes framebuffer is bound
 		void SetColorAttachment(unsigned int target, unsigned int targetType, int mipToWriteTo = 0);
 		void SetDepthAttachment(DepthStencilAttachmentFormat textureFormat, unsigned int target, unsigned int targetType);
+		void SetDepthAttachmentLayer(DepthStencilAttachmentFormat textureFormat, unsigned int target, int layer); // Attaches a single layer of an array texture, so only that layer is rendered to and cleared
 		void ClearAll();
 		void ClearColour();
 		void ClearDepth();
@@ -63,6 +65,8 @@ namespace Arcane
 
 		inline Texture* GetDepthStencilTexture() { return &m_DepthStencilTexture; }
 		inline unsigned int GetDepthStencilRBO() { return m_DepthStencilRBO; }
+	protected:
+		static TextureSettings GetDepthStencilTextureSettings(DepthStencilAttachmentFormat textureFormat, bool bilinearFiltering);
 	protected:
 		unsigned int m_FBO;
 
@@ -34,7 +34,7 @@ namespace Arcane
 		// Render Target 2
 		{
 			TextureSettings renderTarget2;
-			renderTarget2.TextureFormat = GL_RGB32F;
+			renderTarget2.TextureFormat = GL_RG16;
 			renderTarget2.TextureWrapSMode = GL_CLAMP_TO_EDGE;
 			renderTarget2.TextureWrapTMode = GL_CLAMP_TO_EDGE;
 			renderTarget2.TextureMinificationFilterMode = GL_NEAREST;
@@ -42,7 +42,7 @@ namespace Arcane
 			renderTarget2.TextureAnisotropyLevel = 1.0f;
 			renderTarget2.HasMips = false;
 			m_GBufferRenderTargets[1].SetTextureSettings(renderTarget2);
-			m_GBufferRenderTargets[1].Generate2DTexture(m_Width, m_Height, GL_RGB);
+			m_GBufferRenderTargets[1].Generate2DTexture(m_Width, m_Height, GL_RG, GL_UNSIGNED_SHORT);
 			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, m_GBufferRenderTargets[1].GetTextureId(), 0);
 		}
 
@@ -61,9 +61,24 @@ namespace Arcane
 			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, m_GBufferRenderTargets[2].GetTextureId(), 0);
 		}
 
+		// Render Target 4
+		{
+			TextureSettings renderTarget4;
+			renderTarget4.TextureFormat = GL_RG16F;
+			renderTarget4.TextureWrapSMode = GL_CLAMP_TO_EDGE;
+			renderTarget4.TextureWrapTMode = GL_CLAMP_TO_EDGE;
+			renderTarget4.TextureMinificationFilterMode = GL_NEAREST;
+			renderTarget4.TextureMagnificationFilterMode = GL_NEAREST;
+			renderTarget4.TextureAnisotropyLevel = 1.0f;
+			renderTarget4.HasMips = false;
+			m_GBufferRenderTargets[3].SetTextureSettings(renderTarget4);
+			m_GBufferRenderTargets[3].Generate2DTexture(m_Width, m_Height, GL_RG, GL_FLOAT);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT3, GL_TEXTURE_2D, m_GBufferRenderTargets[3].GetTextureId(), 0);
+		}
+
 		// Finally tell OpenGL that we will be rendering to all of the attachments
-		unsigned int attachments[3] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
-		glDrawBuffers(3, attachments);
+		unsigned int attachments[4] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
+		glDrawBuffers(4, attachments);
 
 		// Check if the creation failed
 		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
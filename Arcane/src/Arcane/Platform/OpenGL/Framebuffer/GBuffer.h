@@ -17,13 +17,17 @@ namespace Arcane
 		inline Texture* GetAlbedo() { return &m_GBufferRenderTargets[0]; }
 		inline Texture* GetNormal() { return &m_GBufferRenderTargets[1]; }
 		inline Texture* GetMaterialInfo() { return &m_GBufferRenderTargets[2]; }
+		inline Texture* GetMotionVectors() { return &m_GBufferRenderTargets[3]; }
 	private:
 		void Init();
 	private:
 		// 0 RGBA8  ->       albedo.r     albedo.g        albedo.b     albedo's alpha
-		// 1 RGB32F ->       normal.x     normal.y        normal.z
+		// 1 RG16   ->       normal.u     normal.v                                          (octahedral encoded world space normal)
 		// 2 RGBA8  ->       metallic     roughness       ambientOcclusion
-		std::array<Texture, 3> m_GBufferRenderTargets;
+		// 3 RG16F  ->       motion.x     motion.y                                          (screen UV movement since the previous frame)
+		// Position is never stored, it is reconstructed from the depth buffer with the inverse projection
+		// 16 bytes of colour and 4 of depth-stencil (D24S8) per pixel, so about 70 MB at 2560x1440
+		std::array<Texture, 4> m_GBufferRenderTargets;
 	};
 }
 #endif
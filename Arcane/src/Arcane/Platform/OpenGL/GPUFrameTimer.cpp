@@ -0,0 +1,60 @@
+#include "arcpch.h"
+#include "GPUFrameTimer.h"
+
+namespace Arcane
+{
+	GPUFrameTimer::GPUFrameTimer() : m_FrameIndex(0), m_LatestFrameTimeMS(-1.0), m_LatestWorkCount(0), m_NewResult(false)
+	{
+		for (int i = 0; i < FramesInFlight; i++)
+		{
+			glGenQueries(2, m_Queries[i]);
+			m_Pending[i] = false;
+			m_WorkCounts[i] = 0;
+		}
+	}
+
+	GPUFrameTimer::~GPUFrameTimer()
+	{
+		for (int i = 0; i < FramesInFlight; i++)
+		{
+			glDeleteQueries(2, m_Queries[i]);
+		}
+	}
+
+	void GPUFrameTimer::BeginFrame()
+	{
+		m_NewResult = false;
+
+		// Oldest first, so the latest time ends up being the newest frame that has finished
+		for (int i = 0; i < FramesInFlight; i++)
+		{
+			int frame = (m_FrameIndex + i) % FramesInFlight;
+			if (!m_Pending[frame])
+				continue;
+
+			GLint available = 0;
+			glGetQueryObjectiv(m_Queries[frame][1], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+				break; // Later frames can't have finished either
+
+			GLuint64 beginTime, endTime;
+			glGetQueryObjectui64v(m_Queries[frame][0], GL_QUERY_RESULT, &beginTime);
+			glGetQueryObjectui64v(m_Queries[frame][1], GL_QUERY_RESULT, &endTime);
+			m_LatestFrameTimeMS = double(endTime - beginTime) / 1000000.0;
+			m_LatestWorkCount = m_WorkCounts[frame];
+			m_NewResult = true;
+			m_Pending[frame] = false;
+		}
+
+		// If the GPU is more than FramesInFlight behind the oldest result is dropped, re-issuing the query is cheaper than waiting for it
+		glQueryCounter(m_Queries[m_FrameIndex][0], GL_TIMESTAMP);
+	}
+
+	void GPUFrameTimer::EndFrame(unsigned int workCount)
+	{
+		glQueryCounter(m_Queries[m_FrameIndex][1], GL_TIMESTAMP);
+		m_WorkCounts[m_FrameIndex] = workCount;
+		m_Pending[m_FrameIndex] = true;
+		m_FrameIndex = (m_FrameIndex + 1) % FramesInFlight;
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+#ifndef GPUFRAMETIMER_H
+#define GPUFRAMETIMER_H
+
+namespace Arcane
+{
+	// GPU time of a whole frame that is measured in every build, unlike the GPUTimerManager's timers which only exist in dev builds. A pair of timestamps is used instead of
+	// GL_TIME_ELAPSED so it can wrap the dev build's timers (elapsed time queries can't be nested). Each frame's result is only read once it's available, usually a frame
+	// or two later, so reading it never stalls waiting on the GPU
+	class GPUFrameTimer
+	{
+	public:
+		GPUFrameTimer();
+		~GPUFrameTimer();
+
+		void BeginFrame(); // Also picks up any results that have become available
+		void EndFrame(unsigned int workCount = 0); // The work count is handed back with the frame's time, so the cost of a unit of work can be worked out (ie probe update steps)
+
+		// Most recent complete frame's time, negative until the first one has been read back
+		inline double GetLatestFrameTimeMS() const { return m_LatestFrameTimeMS; }
+		inline unsigned int GetLatestFrameWorkCount() const { return m_LatestWorkCount; }
+		inline bool HasNewResult() const { return m_NewResult; } // True if the last BeginFrame picked up a frame that hadn't been read yet
+	private:
+		static const int FramesInFlight = 3;
+
+		GLuint m_Queries[FramesInFlight][2]; // Begin and end timestamps
+		bool m_Pending[FramesInFlight];
+		unsigned int m_WorkCounts[FramesInFlight];
+		int m_FrameIndex;
+		double m_LatestFrameTimeMS;
+		unsigned int m_LatestWorkCount;
+		bool m_NewResult;
+	};
+}
+#endif
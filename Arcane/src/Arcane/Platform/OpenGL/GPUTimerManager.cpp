@@ -7,10 +7,12 @@ namespace Arcane
 {
 #ifdef ARC_DEV_BUILD
 	/*								GPU Timer								*/
-	GPUTimer::GPUTimer(const std::string &timerName) : m_TimerName(timerName), m_IsUsed(false)
+	GPUTimer::GPUTimer(const std::string &timerName) : m_TimerName(timerName)
 	{
 		m_ElapsedTimeNanoseconds[0] = 0;
 		m_ElapsedTimeNanoseconds[1] = 0;
+		m_IsUsed[0] = false;
+		m_IsUsed[1] = false;
 
 		glGenQueries(2, m_Query);
 	}
@@ -22,7 +24,7 @@ namespace Arcane
 
 	void GPUTimer::BeginQuery(bool oddFrame)
 	{
-		m_IsUsed = true;
+		m_IsUsed[oddFrame] = true;
 		glBeginQuery(GL_TIME_ELAPSED, m_Query[oddFrame]);
 	}
 
@@ -34,8 +36,11 @@ namespace Arcane
 	void GPUTimer::CalculateTime(bool oddFrame)
 	{
 		// Note: This function will block and wait until the work is done, that is why this gets called for the opposite frame, so we are getting the previous frames timing and not stalling. This is all handled by the GPUTimerManager
-		if (!m_IsUsed)
+		if (!m_IsUsed[!oddFrame])
+		{
+			m_ElapsedTimeNanoseconds[!oddFrame] = 0;
 			return;
+		}
 
 		glGetQueryObjectui64v(m_Query[!oddFrame], GL_QUERY_RESULT, &m_ElapsedTimeNanoseconds[!oddFrame]);
 	}
@@ -61,6 +66,12 @@ namespace Arcane
 	{
 		s_OddFrame = !s_OddFrame;
 		s_FirstFrame = false;
+
+		// The queries of this parity are from two frames ago, so they only count once they are started again
+		for (auto& element : s_Timers)
+		{
+			element->m_IsUsed[s_OddFrame] = false;
+		}
 	}
 
 	GPUTimer* GPUTimerManager::CreateGPUTimer(const std::string &timerName)
@@ -24,7 +24,7 @@ namespace Arcane
 		const std::string m_TimerName;
 		GLuint m_Query[2];
 		GLuint64 m_ElapsedTimeNanoseconds[2];
-		bool m_IsUsed;
+		bool m_IsUsed[2]; // If the query was started in the even/odd frame, timers can be skipped (ie their render graph node was culled) so this is cleared every other frame
 	};
 
 	class GPUTimerManager
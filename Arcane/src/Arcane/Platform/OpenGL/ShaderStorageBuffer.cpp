@@ -0,0 +1,59 @@
+#include "arcpch.h"
+#include "ShaderStorageBuffer.h"
+
+namespace Arcane
+{
+	ShaderStorageBuffer::ShaderStorageBuffer() : m_Size(0), m_Usage(GL_DYNAMIC_DRAW)
+	{
+		glGenBuffers(1, &m_BufferID);
+	}
+
+	ShaderStorageBuffer::ShaderStorageBuffer(size_t sizeInBytes, GLenum usage) : m_Size(0), m_Usage(usage)
+	{
+		glGenBuffers(1, &m_BufferID);
+		Allocate(sizeInBytes, usage);
+	}
+
+	ShaderStorageBuffer::~ShaderStorageBuffer()
+	{
+		glDeleteBuffers(1, &m_BufferID);
+	}
+
+	void ShaderStorageBuffer::Allocate(size_t sizeInBytes, GLenum usage)
+	{
+		m_Size = sizeInBytes;
+		m_Usage = usage;
+
+		Bind();
+		glBufferData(GL_SHADER_STORAGE_BUFFER, m_Size, nullptr, m_Usage);
+	}
+
+	void ShaderStorageBuffer::Upload(const void *data, size_t sizeInBytes, size_t offset)
+	{
+		if (sizeInBytes == 0)
+			return;
+
+		if (offset + sizeInBytes > m_Size)
+		{
+			Allocate(offset + sizeInBytes, m_Usage);
+		}
+
+		Bind();
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, sizeInBytes, data);
+	}
+
+	void ShaderStorageBuffer::Bind() const
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_BufferID);
+	}
+
+	void ShaderStorageBuffer::BindBase(unsigned int bindingPoint) const
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingPoint, m_BufferID);
+	}
+
+	void ShaderStorageBuffer::Unbind() const
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+}
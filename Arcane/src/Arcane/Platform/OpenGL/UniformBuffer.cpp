@@ -0,0 +1,59 @@
+#include "arcpch.h"
+#include "UniformBuffer.h"
+
+namespace Arcane
+{
+	UniformBuffer::UniformBuffer() : m_Size(0), m_Usage(GL_DYNAMIC_DRAW)
+	{
+		glGenBuffers(1, &m_BufferID);
+	}
+
+	UniformBuffer::UniformBuffer(size_t sizeInBytes, GLenum usage) : m_Size(0), m_Usage(usage)
+	{
+		glGenBuffers(1, &m_BufferID);
+		Allocate(sizeInBytes, usage);
+	}
+
+	UniformBuffer::~UniformBuffer()
+	{
+		glDeleteBuffers(1, &m_BufferID);
+	}
+
+	void UniformBuffer::Allocate(size_t sizeInBytes, GLenum usage)
+	{
+		m_Size = sizeInBytes;
+		m_Usage = usage;
+
+		Bind();
+		glBufferData(GL_UNIFORM_BUFFER, m_Size, nullptr, m_Usage);
+	}
+
+	void UniformBuffer::Upload(const void *data, size_t sizeInBytes, size_t offset)
+	{
+		if (sizeInBytes == 0)
+			return;
+
+		if (offset + sizeInBytes > m_Size)
+		{
+			Allocate(offset + sizeInBytes, m_Usage);
+		}
+
+		Bind();
+		glBufferSubData(GL_UNIFORM_BUFFER, offset, sizeInBytes, data);
+	}
+
+	void UniformBuffer::Bind() const
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, m_BufferID);
+	}
+
+	void UniformBuffer::BindBase(unsigned int bindingPoint) const
+	{
+		glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, m_BufferID);
+	}
+
+	void UniformBuffer::Unbind() const
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+}
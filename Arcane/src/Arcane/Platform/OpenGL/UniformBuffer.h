@@ -0,0 +1,33 @@
+#pragma once
+#ifndef UNIFORMBUFFER_H
+#define UNIFORMBUFFER_H
+
+namespace Arcane
+{
+	// Data uploaded to a uniform buffer has to match the std140 layout of the block it is read through (a vec3 or array element takes up as much as a vec4)
+	class UniformBuffer
+	{
+	public:
+		UniformBuffer();
+		UniformBuffer(size_t sizeInBytes, GLenum usage = GL_DYNAMIC_DRAW);
+		~UniformBuffer();
+
+		// Reallocates the buffer's storage, any previous contents are discarded
+		void Allocate(size_t sizeInBytes, GLenum usage = GL_DYNAMIC_DRAW);
+
+		// Uploads data into the buffer, will grow the buffer if the data doesn't fit (contents outside of the upload are discarded if a grow happens)
+		void Upload(const void *data, size_t sizeInBytes, size_t offset = 0);
+
+		void Bind() const;
+		void BindBase(unsigned int bindingPoint) const;
+		void Unbind() const;
+
+		inline unsigned int GetBufferID() const { return m_BufferID; }
+		inline size_t GetSize() const { return m_Size; }
+	private:
+		unsigned int m_BufferID;
+		size_t m_Size;
+		GLenum m_Usage;
+	};
+}
+#endif
@@ -91,6 +91,11 @@ namespace Arcane
 		bool IsTransparent = false; // Should be true if the model contains any translucent material
 		bool IsStatic = false;		// Should be true if the model will never have its transform modified
 		bool ShouldBackfaceCull = true; // Should be true for majority of models, unless a model isn't double sided
+		bool IsOccluder = false;	// Should be true for large models that hide a lot of the scene (ie buildings), they are drawn in the depth pre-pass. Only used by static opaque models
+
+		// Transform the model was rendered with last frame (see Scene::StorePreviousTransforms), used for motion vectors
+		glm::mat4 PreviousTransform = glm::mat4(1.0f);
+		bool HasPreviousTransform = false;
 	};
 
 	struct LightComponent
@@ -111,6 +116,7 @@ namespace Arcane
 		float ShadowBias = SHADOWMAP_BIAS_DEFAULT;
 		ShadowQuality ShadowResolution = ShadowQuality::ShadowQuality_Medium;
 		float ShadowNearPlane = SHADOWMAP_NEAR_PLANE_DEFAULT, ShadowFarPlane = SHADOWMAP_FAR_PLANE_DEFAULT;
+		int ShadowAtlasTileIndex = -1; // Should not be set or used by the user. Assigned every frame by the light manager for spot and point lights that got space in the shadow atlas
 	};
 
 	struct PoseAnimatorComponent
@@ -124,6 +130,7 @@ namespace Arcane
 		float AlbedoPower = 0.05f;
 
 		bool ReflectionEnabled = true;
+		WaterReflectionMode ReflectionMode = WaterReflectionMode::WaterReflectionMode_Planar;
 		WaterReflectionRefractionQuality WaterRefractionResolution = WaterReflectionRefractionQuality::WaterReflectionRefractionQuality_High;
 		bool RefractionEnabled = true;
 		WaterReflectionRefractionQuality WaterReflectionResolution = WaterReflectionRefractionQuality::WaterReflectionRefractionQuality_High;
@@ -146,6 +153,8 @@ namespace Arcane
 		
 		float ReflectionNearPlane = WATER_REFLECTION_NEAR_PLANE_DEFAULT, ReflectionFarPlane = WATER_REFLECTION_FAR_PLANE_DEFAULT;
 		float RefractionNearPlane = WATER_REFRACTION_NEAR_PLANE_DEFAULT, RefractionFarPlane = WATER_REFRACTION_FAR_PLANE_DEFAULT;
+		float CaptureMinScreenSize = WATER_CAPTURE_MIN_SCREEN_SIZE_DEFAULT;
+		bool ReflectionHalfRate = false; // Reflection is only re-rendered every other frame, the frames in between reproject the previous reflection
 
 		float MoveTimer = 0.0f; // Should not be set or used by the user. Just used for water rendering, that is why this isn't viewable/modifiable in the inspector panel
 
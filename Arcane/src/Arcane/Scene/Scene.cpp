@@ -4,10 +4,13 @@
 #include <Arcane/Graphics/Window.h>
 #include <Arcane/Graphics/Skybox.h>
 #include <Arcane/Graphics/Mesh/Mesh.h>
+#include <Arcane/Graphics/Mesh/Model.h>
 #include <Arcane/Graphics/Renderer/GLCache.h>
 #include <Arcane/Graphics/Renderer/Renderer.h>
+#include <Arcane/Graphics/Renderer/SoftwareOcclusionRasterizer.h>
 #include <Arcane/Scene/Entity.h>
 #include <Arcane/Scene/Components.h>
+#include <Arcane/Util/Loaders/AssetManager.h>
 
 namespace Arcane
 {
@@ -91,43 +94,157 @@ namespace Arcane
 			{
 				poseAnimator = &currentEntity.GetComponent<PoseAnimatorComponent>().PoseAnimator;
 			}
+			const glm::mat4 *previousTransform = model.HasPreviousTransform ? &model.PreviousTransform : nullptr;
 
 			switch (filter)
 			{
 			case ModelFilterType::AllModels:
-				Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull);
+				Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull, previousTransform);
 				break;
 			case ModelFilterType::StaticModels:
 				if (model.IsStatic)
 				{
-					Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull);
+					Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull, previousTransform);
 				}
 				break;
 			case ModelFilterType::OpaqueModels:
 				if (model.IsTransparent == false)
 				{
-					Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull);
+					Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull, previousTransform);
 				}
 				break;
 			case ModelFilterType::OpaqueStaticModels:
 				if (model.IsTransparent == false && model.IsStatic)
 				{
-					Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull);
+					Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull, previousTransform);
 				}
 				break;
 			case ModelFilterType::TransparentModels:
 				if (model.IsTransparent)
 				{
-					Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull);
+					Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull, previousTransform);
 				}
 				break;
 			case ModelFilterType::TransparentStaticModels:
 				if (model.IsTransparent && model.IsStatic)
 				{
-					Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull);
+					Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull, previousTransform);
+				}
+				break;
+			case ModelFilterType::StaticNonAnimatedModels:
+				if (model.IsStatic && !poseAnimator)
+				{
+					Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull, previousTransform);
+				}
+				break;
+			case ModelFilterType::DynamicModels:
+				if (!model.IsStatic || poseAnimator)
+				{
+					Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull, previousTransform);
+				}
+				break;
+			case ModelFilterType::StaticOccluderModels:
+				if (model.IsOccluder && model.IsStatic && !model.IsTransparent && !poseAnimator)
+				{
+					Renderer::QueueMesh(model.AssetModel, transform.GetTransform(), poseAnimator, model.IsTransparent, model.ShouldBackfaceCull, previousTransform);
 				}
 				break;
 			}
 		}
 	}
+
+	void Scene::StorePreviousTransforms()
+	{
+		auto group = m_Registry.group<TransformComponent, MeshComponent>();
+		for (auto entity : group)
+		{
+			auto&[transform, model] = group.get<TransformComponent, MeshComponent>(entity);
+
+			model.PreviousTransform = transform.GetTransform();
+			model.HasPreviousTransform = true;
+		}
+	}
+
+	void Scene::AddOccludersToRasterizer(SoftwareOcclusionRasterizer *rasterizer, const glm::vec3 &cameraPosition)
+	{
+		auto group = m_Registry.group<TransformComponent, MeshComponent>();
+		for (auto entity : group)
+		{
+			auto&[transform, model] = group.get<TransformComponent, MeshComponent>(entity);
+			if (!model.IsOccluder || !model.IsStatic || model.IsTransparent || !model.AssetModel || m_Registry.any_of<PoseAnimatorComponent>(entity))
+				continue;
+
+			std::vector<Mesh> &meshes = model.AssetModel->GetMeshes();
+			size_t triangleCount = 0;
+			for (const Mesh &mesh : meshes)
+			{
+				triangleCount += (mesh.GetIndices().empty() ? mesh.GetPositions().size() : mesh.GetIndices().size()) / 3;
+			}
+			if (triangleCount > OCCLUSION_RASTERIZER_MAX_OCCLUDER_TRIANGLES)
+				continue;
+
+			glm::mat4 transformMatrix = transform.GetTransform();
+			for (const Mesh &mesh : meshes)
+			{
+				rasterizer->AddOccluderMesh(mesh.GetPositions(), mesh.GetIndices(), transformMatrix, model.ShouldBackfaceCull);
+			}
+		}
+
+		// The terrain has no underside so its boxes would hide things they shouldn't when viewed from below
+		if (cameraPosition.y > m_Terrain.GetMinHeight())
+		{
+			for (const TerrainOccluderBox &box : m_Terrain.GetOccluderBoxes())
+			{
+				rasterizer->AddOccluderBox(box.BoundsMin, box.BoundsMax);
+			}
+		}
+	}
+
+	std::size_t Scene::CalculateStaticContentHash()
+	{
+		std::size_t hash = 0;
+		auto hashCombine = [&hash](std::size_t value)
+		{
+			hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		};
+		auto hashFloats = [&hashCombine](const float *values, int count)
+		{
+			for (int i = 0; i < count; i++)
+			{
+				hashCombine(std::hash<float>()(values[i]));
+			}
+		};
+
+		// Models are hashed by their path instead of pointer so the hash is the same between launches (the path is known before the model finishes loading)
+		AssetManager &assetManager = AssetManager::GetInstance();
+		auto meshGroup = m_Registry.group<TransformComponent, MeshComponent>();
+		for (auto entity : meshGroup)
+		{
+			auto&[transformComponent, meshComponent] = meshGroup.get<TransformComponent, MeshComponent>(entity);
+			if (!meshComponent.IsStatic || !meshComponent.AssetModel)
+				continue;
+
+			hashCombine(std::hash<std::string>()(assetManager.GetModelPath(meshComponent.AssetModel)));
+			hashCombine(std::hash<bool>()(meshComponent.IsTransparent));
+			glm::mat4 transform = transformComponent.GetTransform();
+			hashFloats(glm::value_ptr(transform), 16);
+		}
+
+		// Probe captures are lit by every light in the scene
+		auto lightView = m_Registry.view<TransformComponent, LightComponent>();
+		for (auto entity : lightView)
+		{
+			auto&[transformComponent, lightComponent] = lightView.get<TransformComponent, LightComponent>(entity);
+
+			hashCombine(std::hash<int>()(static_cast<int>(lightComponent.Type)));
+			hashFloats(&transformComponent.Translation.x, 3);
+			hashFloats(&transformComponent.Rotation.x, 3);
+			hashFloats(&lightComponent.LightColour.x, 3);
+			float lightProperties[] = { lightComponent.Intensity, lightComponent.AttenuationRange, lightComponent.InnerCutOff, lightComponent.OuterCutOff };
+			hashFloats(lightProperties, 4);
+			hashCombine(std::hash<bool>()(lightComponent.CastShadows));
+		}
+
+		return hash;
+	}
 }
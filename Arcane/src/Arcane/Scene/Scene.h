@@ -36,6 +36,7 @@ namespace Arcane
 	class Window;
 	class Skybox;
 	class GLCache;
+	class SoftwareOcclusionRasterizer;
 
 	enum class ModelFilterType
 	{
@@ -44,7 +45,10 @@ namespace Arcane
 		OpaqueModels,
 		OpaqueStaticModels,
 		TransparentModels,
-		TransparentStaticModels
+		TransparentStaticModels,
+		StaticNonAnimatedModels,	// Static models that never change, animated models are excluded since their pose changes every frame
+		DynamicModels,				// Everything StaticNonAnimatedModels excludes
+		StaticOccluderModels		// Static opaque non-animated models flagged as occluders
 	};
 
 	class Scene
@@ -67,6 +71,15 @@ namespace Arcane
 		void AddModelsToRenderer(ModelFilterType filter);
 		void AddSkinnedModelsToRenderer(ModelFilterType filter);
 
+		// Should be called once the frame has been rendered, the transforms are what the next frame's motion vectors are measured from
+		void StorePreviousTransforms();
+
+		// Flagged static occluder models and the terrain's chunk boxes. Models with more triangles than OCCLUSION_RASTERIZER_MAX_OCCLUDER_TRIANGLES are skipped
+		void AddOccludersToRasterizer(SoftwareOcclusionRasterizer *rasterizer, const glm::vec3 &cameraPosition);
+
+		// Hash of everything that is baked into the scene's probes (static models and lights), it is stable between launches so it can be used to key baked data on disk
+		std::size_t CalculateStaticContentHash();
+
 		inline Terrain* GetTerrain() { return &m_Terrain; }
 		inline LightManager* GetLightManager() { return &m_LightManager; }
 		inline WaterManager* GetWaterManager() { return &m_WaterManager; }
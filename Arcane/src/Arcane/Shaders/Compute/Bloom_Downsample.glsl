@@ -0,0 +1,90 @@
+/*
+	Compute version of the bloom downsample (see Post_Process/Bloom/BloomDownsample.glsl), with the same taps and weights.
+	Each group loads the source texels its 8x8 output texels cover into shared memory once, instead of every thread fetching its 13 overlapping bilinear taps from the texture
+*/
+
+#shader-type compute
+#version 430 core
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout (rgba16f, binding = 0) writeonly uniform image2D destination;
+
+uniform sampler2D source_texture;
+
+uniform bool isFirstDownsample;
+uniform float threshold;
+uniform float soft_knee;
+
+// 8x8 output texels cover 16x16 source texels, plus the two texel border the outer taps reach into
+shared vec3 sourceTexels[20][20];
+
+// Other function prototypes
+vec3 Tap(ivec2 tileTexel);
+vec3 BoxWeighted(vec3 a, vec3 b, vec3 c, vec3 d, inout float totalWeight, float boxWeight);
+vec3 Threshold(vec3 colour);
+
+void main() {
+	ivec2 sourceSize = textureSize(source_texture, 0);
+	ivec2 tileOrigin = ivec2(gl_WorkGroupID.xy) * 16 - 2;
+	for (uint index = gl_LocalInvocationIndex; index < 20 * 20; index += 8 * 8) {
+		ivec2 tileTexel = ivec2(index % 20, index / 20);
+		sourceTexels[tileTexel.y][tileTexel.x] = texelFetch(source_texture, clamp(tileOrigin + tileTexel, ivec2(0), sourceSize - 1), 0).rgb;
+	}
+	barrier();
+
+	ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+	if (any(greaterThanEqual(texel, imageSize(destination)))) {
+		return;
+	}
+
+	// The output texel covers source texels 2 * texel and 2 * texel + 1, a tap at an offset of n is the bilinear sample between the texels n away from that
+	ivec2 base = ivec2(gl_LocalInvocationID.xy) * 2 + 2;
+	vec3 a = Tap(base + ivec2(-2, -2));
+	vec3 b = Tap(base + ivec2( 0, -2));
+	vec3 c = Tap(base + ivec2( 2, -2));
+	vec3 d = Tap(base + ivec2(-1, -1));
+	vec3 e = Tap(base + ivec2( 1, -1));
+	vec3 f = Tap(base + ivec2(-2,  0));
+	vec3 g = Tap(base);
+	vec3 h = Tap(base + ivec2( 2,  0));
+	vec3 i = Tap(base + ivec2(-1,  1));
+	vec3 j = Tap(base + ivec2( 1,  1));
+	vec3 k = Tap(base + ivec2(-2,  2));
+	vec3 l = Tap(base + ivec2( 0,  2));
+	vec3 m = Tap(base + ivec2( 2,  2));
+
+	float totalWeight = 0.0;
+	vec3 result = BoxWeighted(d, e, i, j, totalWeight, 0.5);
+	result += BoxWeighted(a, b, f, g, totalWeight, 0.125);
+	result += BoxWeighted(b, c, g, h, totalWeight, 0.125);
+	result += BoxWeighted(f, g, k, l, totalWeight, 0.125);
+	result += BoxWeighted(g, h, l, m, totalWeight, 0.125);
+	result /= totalWeight;
+
+	if (isFirstDownsample) {
+		result = Threshold(result);
+	}
+	imageStore(destination, texel, vec4(result, 1.0));
+}
+
+// Bilinear sample exactly between four texels of the tile
+vec3 Tap(ivec2 tileTexel) {
+	return (sourceTexels[tileTexel.y][tileTexel.x] + sourceTexels[tileTexel.y][tileTexel.x + 1] + sourceTexels[tileTexel.y + 1][tileTexel.x] + sourceTexels[tileTexel.y + 1][tileTexel.x + 1]) * 0.25;
+}
+
+vec3 BoxWeighted(vec3 a, vec3 b, vec3 c, vec3 d, inout float totalWeight, float boxWeight) {
+	vec3 box = (a + b + c + d) * 0.25;
+	if (isFirstDownsample) {
+		boxWeight /= 1.0 + dot(box, vec3(0.2126, 0.7152, 0.0722));
+	}
+	totalWeight += boxWeight;
+	return box * boxWeight;
+}
+
+vec3 Threshold(vec3 colour) {
+	float brightness = max(colour.r, max(colour.g, colour.b));
+	float soft = clamp(brightness - threshold + soft_knee, 0.0, 2.0 * soft_knee);
+	soft = (soft * soft) / (4.0 * soft_knee + 0.00001);
+	float contribution = max(soft, brightness - threshold) / max(brightness, 0.00001);
+	return colour * contribution;
+}
@@ -0,0 +1,60 @@
+/*
+	Compute version of the bloom upsample (see Post_Process/Bloom/BloomUpsample.glsl). The lower mip is at most half the size of the destination,
+	so the 3x3 tent taps of a group's 8x8 output texels all land within an 8x8 block of source texels which is loaded into shared memory once
+*/
+
+#shader-type compute
+#version 430 core
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout (rgba16f, binding = 0) uniform image2D destination; // Still holds the destination mip's downsample, the upsample is added on top of it
+
+uniform sampler2D source_texture;
+
+shared vec3 sourceTexels[8][8];
+
+// Other function prototypes
+vec3 Bilinear(vec2 tilePosition);
+
+void main() {
+	ivec2 sourceSize = textureSize(source_texture, 0);
+	ivec2 destinationSize = imageSize(destination);
+	vec2 scale = vec2(sourceSize) / vec2(destinationSize);
+
+	// Start a texel before the group's first sample position, since the tent reaches one texel out
+	ivec2 groupOrigin = ivec2(gl_WorkGroupID.xy) * 8;
+	ivec2 tileOrigin = ivec2(floor((vec2(groupOrigin) + 0.5) * scale - 0.5)) - 1;
+	ivec2 tileTexel = ivec2(gl_LocalInvocationID.xy);
+	sourceTexels[tileTexel.y][tileTexel.x] = texelFetch(source_texture, clamp(tileOrigin + tileTexel, ivec2(0), sourceSize - 1), 0).rgb;
+	barrier();
+
+	ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+	if (any(greaterThanEqual(texel, destinationSize))) {
+		return;
+	}
+
+	vec2 tilePosition = (vec2(texel) + 0.5) * scale - 0.5 - vec2(tileOrigin);
+	vec3 result = Bilinear(tilePosition) * 4.0;
+	result += Bilinear(tilePosition + vec2(-1.0,  0.0)) * 2.0;
+	result += Bilinear(tilePosition + vec2( 1.0,  0.0)) * 2.0;
+	result += Bilinear(tilePosition + vec2( 0.0, -1.0)) * 2.0;
+	result += Bilinear(tilePosition + vec2( 0.0,  1.0)) * 2.0;
+	result += Bilinear(tilePosition + vec2(-1.0, -1.0));
+	result += Bilinear(tilePosition + vec2( 1.0, -1.0));
+	result += Bilinear(tilePosition + vec2(-1.0,  1.0));
+	result += Bilinear(tilePosition + vec2( 1.0,  1.0));
+
+	vec3 downsample = imageLoad(destination, texel).rgb;
+	imageStore(destination, texel, vec4(downsample + result * (1.0 / 16.0), 1.0));
+}
+
+// tilePosition is in texels relative to the centre of the tile's first texel
+vec3 Bilinear(vec2 tilePosition) {
+	ivec2 texel0 = clamp(ivec2(floor(tilePosition)), ivec2(0), ivec2(7));
+	ivec2 texel1 = clamp(texel0 + 1, ivec2(0), ivec2(7));
+	vec2 weight = tilePosition - floor(tilePosition);
+
+	vec3 bottom = mix(sourceTexels[texel0.y][texel0.x], sourceTexels[texel0.y][texel1.x], weight.x);
+	vec3 top = mix(sourceTexels[texel1.y][texel0.x], sourceTexels[texel1.y][texel1.x], weight.x);
+	return mix(bottom, top, weight.y);
+}
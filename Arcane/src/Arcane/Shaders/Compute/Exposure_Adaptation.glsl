@@ -0,0 +1,46 @@
+/*
+	Averages the luminance histogram built by Scene_Luminance.glsl and moves the adapted luminance towards it, the way an eye slowly adjusts to a change in brightness.
+	The exposure the tonemapper reads is then derived from the adapted luminance. The histogram is cleared for the next frame, so nothing has to be read back or reset on the CPU
+*/
+
+#shader-type compute
+#version 430 core
+layout (local_size_x = 256, local_size_y = 1, local_size_z = 1) in;
+
+layout (std430, binding = 7) buffer LuminanceHistogramBuffer { uint luminanceHistogram[256]; };
+layout (std430, binding = 6) buffer ExposureBuffer { float adaptedLuminance; float exposure; };
+
+uniform int pixelCount;
+uniform float minLogLuminance;
+uniform float logLuminanceRange;
+uniform float adaptationRate; // Fraction of the way to move towards this frame's luminance, 1 snaps straight to it
+uniform float keyValue;
+uniform float exposureCompensation;
+
+shared float weightedBinCounts[256];
+
+void main() {
+	uint bin = gl_LocalInvocationIndex;
+	uint binCount = luminanceHistogram[bin];
+	weightedBinCounts[bin] = float(binCount) * float(bin);
+	luminanceHistogram[bin] = 0;
+	barrier();
+
+	for (uint stride = 128; stride > 0; stride >>= 1) {
+		if (bin < stride) {
+			weightedBinCounts[bin] += weightedBinCounts[bin + stride];
+		}
+		barrier();
+	}
+
+	// Only the first thread writes the result, its bin count is the amount of black pixels which aren't part of the average
+	if (bin == 0) {
+		int litPixelCount = pixelCount - int(binCount);
+		if (litPixelCount > 0) {
+			float averageBin = weightedBinCounts[0] / float(litPixelCount);
+			float averageLogLuminance = ((averageBin - 1.0) / 254.0) * logLuminanceRange + minLogLuminance;
+			adaptedLuminance = mix(adaptedLuminance, exp2(averageLogLuminance), adaptationRate);
+		}
+		exposure = exposureCompensation * keyValue / max(adaptedLuminance, 0.0001);
+	}
+}
@@ -1,5 +1,44 @@
+/*
+	Builds a histogram of the HDR scene's log2 luminance for auto exposure. Each group bins its pixels in shared memory first,
+	so the global histogram only takes one atomic add per bin per group. Bin 0 is reserved for (near) black pixels so they can be left out of the average
+*/
+
 #shader-type compute
 #version 430 core
 layout (local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
 
+layout (std430, binding = 7) buffer LuminanceHistogramBuffer { uint luminanceHistogram[256]; };
+
+uniform sampler2D scene_texture;
+
+uniform float minLogLuminance;
+uniform float inverseLogLuminanceRange;
+
+shared uint groupHistogram[256];
+
+// Other function prototypes
+uint LuminanceToBin(vec3 hdrColour);
+
+void main() {
+	groupHistogram[gl_LocalInvocationIndex] = 0;
+	barrier();
+
+	ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+	if (all(lessThan(texel, textureSize(scene_texture, 0)))) {
+		atomicAdd(groupHistogram[LuminanceToBin(texelFetch(scene_texture, texel, 0).rgb)], 1);
+	}
+	barrier();
+
+	atomicAdd(luminanceHistogram[gl_LocalInvocationIndex], groupHistogram[gl_LocalInvocationIndex]);
+}
+
+uint LuminanceToBin(vec3 hdrColour) {
+	float luminance = dot(hdrColour, vec3(0.2126, 0.7152, 0.0722));
+	if (luminance < 0.0001) {
+		return 0;
+	}
 
+	// Bins 1 to 255 cover the log luminance range, anything outside of it goes into the first or last bin
+	float logLuminance = clamp((log2(luminance) - minLogLuminance) * inverseLogLuminanceRange, 0.0, 1.0);
+	return uint(logLuminance * 254.0 + 1.0);
+}
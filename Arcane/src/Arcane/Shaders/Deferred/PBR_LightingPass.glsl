@@ -24,41 +24,58 @@ struct DirLight {
 	vec3 lightColour;
 };
 
+// Point and spot lights are stored in SSBOs (std430) and must match GPUPointLight and GPUSpotLight
 struct PointLight {
 	vec3 position;
+	float attenuationRadius;
 
-	float intensity;
 	vec3 lightColour;
-	float attenuationRadius;
+	float intensity;
+
+	int shadowAtlasTileIndex; // First of the six cube face tiles, -1 if the light has no shadows
 };
 
 struct SpotLight {
 	vec3 position;
-	vec3 direction;
+	float attenuationRadius;
 
+	vec3 direction;
 	float intensity;
-	vec3 lightColour;
-	float attenuationRadius;
 
+	vec3 lightColour;
 	float cutOff;
+
 	float outerCutOff;
+	int shadowAtlasTileIndex; // -1 if the light has no shadows
 };
 
+#define MAX_SHADOW_CASCADES 4
+
+// Directional light shadows, every cascade is a layer of the shadowmap
 struct ShadowData {
-	mat4 lightSpaceViewProjectionMatrix;
-	float shadowBias;
+	mat4 lightSpaceViewProjectionMatrices[MAX_SHADOW_CASCADES];
+	vec4 cascadeShadowBiases;
+	int cascadeCount;
 	int lightShadowIndex;
 };
 
-struct ShadowDataPointLight {
-	float farPlane;
+// Light probe irradiance stored as L2 spherical harmonics (already convolved with a cosine lobe), must match GPULightProbe
+struct LightProbe {
+	vec4 shCoefficients[9];
+	vec4 positionRadius; // xyz = position, w = influence radius (0 for the fallback)
+};
+
+// Spot and point light shadows are tiles in the shadow atlas, must match GPUShadowAtlasTile
+struct ShadowAtlasTile {
+	mat4 lightSpaceViewProjectionMatrix;
+	vec4 atlasScaleBias; // xy = scale, zw = offset of the tile in the atlas
 	float shadowBias;
-	int lightShadowIndex;
+	float farPlane; // Only used by point lights since they store linear depth
 };
 
 #define MAX_DIR_LIGHTS 3
-#define MAX_POINT_LIGHTS 6
-#define MAX_SPOT_LIGHTS 6
+#define MAX_PROBE_BLEND_COUNT 4
+#define MAX_REFLECTION_PROBES 4
 const float PI = 3.14159265359;
 
 in vec2 TexCoords;
@@ -67,35 +84,54 @@ out vec4 color;
 
 // GBuffer
 uniform sampler2D albedoTexture;
-uniform sampler2D normalTexture;
+uniform sampler2D normalTexture; // Octahedral encoded
 uniform sampler2D materialInfoTexture;
 uniform sampler2D ssaoTexture;
 uniform sampler2D depthTexture;
+uniform float renderScale; // Fraction of the GBuffer (and the SSAO/SSR) rendered to this frame (dynamic resolution)
 
 // IBL
 uniform int reflectionProbeMipCount;
 uniform bool computeIBL;
-uniform samplerCube irradianceMap;
-uniform samplerCube prefilterMap;
+layout (std430, binding = 5) readonly buffer LightProbeBuffer { LightProbe lightProbes[]; }; // The fallback is at index 0
+uniform samplerCube prefilterMap; // Fallback reflection probe
 uniform sampler2D brdfLUT;
+uniform bool ssrEnabled;
+uniform sampler2D ssrTexture; // rgb = reflected colour, a = confidence of the screen space hit
+
+// Probe selection (per pixel). The light probe grid is the CPU's probe spatial index, each cell is (offset, count) into the probe indices stored after the cells
+layout (std430, binding = 10) readonly buffer LightProbeGridBuffer { uint lightProbeGrid[]; };
+uniform vec3 lightProbeGridMin;
+uniform float lightProbeGridCellSize;
+uniform ivec3 lightProbeGridSize;
+uniform int lightProbeBlendCount; // 0 only uses the fallback, 1 uses the highest weighted probe, otherwise up to 3 probes are blended with the fallback
+uniform samplerCube reflectionProbeMaps[MAX_REFLECTION_PROBES];
+uniform vec4 reflectionProbePositionRadii[MAX_REFLECTION_PROBES];
+uniform int reflectionProbeCount;
 
 // Lighting
 uniform ivec4 numDirPointSpotLights;
 uniform DirLight dirLights[MAX_DIR_LIGHTS];
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
-uniform SpotLight spotLights[MAX_SPOT_LIGHTS];
+layout (std430, binding = 0) readonly buffer PointLightBuffer { PointLight pointLights[]; };
+layout (std430, binding = 1) readonly buffer SpotLightBuffer { SpotLight spotLights[]; };
+
+// Light Clusters (each cluster is an offset into lightIndices followed by its point light count and spot light count packed as (point | spot << 16))
+layout (std430, binding = 2) readonly buffer LightClusterBuffer { uvec2 lightClusters[]; };
+layout (std430, binding = 3) readonly buffer LightIndexBuffer { uint lightIndices[]; };
+uniform ivec3 clusterGridSize;
+uniform vec2 clusterZParams;
+uniform mat4 clusterView;
+uniform mat4 clusterProjection;
 
 uniform vec3 viewPos;
 uniform mat4 viewInverse;
 uniform mat4 projectionInverse;
 
 // Shadow Data
-uniform sampler2D dirLightShadowmap;
+uniform sampler2DArray dirLightShadowmap;
 uniform ShadowData dirLightShadowData;
-uniform sampler2D spotLightShadowmap;
-uniform ShadowData spotLightShadowData;
-uniform samplerCube pointLightShadowCubemap;
-uniform ShadowDataPointLight pointLightShadowData;
+uniform sampler2D shadowAtlas;
+layout (std430, binding = 4) readonly buffer ShadowAtlasBuffer { ShadowAtlasTile shadowAtlasTiles[]; };
 
 // Light radiance calculations
 vec3 CalculateDirectionalLightRadiance(vec3 albedo, vec3 normal, float metallic, float roughness, vec3 fragPos, vec3 fragToViewNorm, vec3 baseReflectivity);
@@ -110,21 +146,27 @@ vec3 FresnelSchlick(float cosTheta, vec3 baseReflectivity);
 
 // Other function prototypes
 float CalculateDirLightShadow(vec3 fragPos);
-float CalculateSpotLightShadow(vec3 fragPos);
-float CalculatePointLightShadow(vec3 lightToFrag);
+float CalculateSpotLightShadow(vec3 fragPos, int tileIndex);
+float CalculatePointLightShadow(vec3 fragPos, vec3 lightToFrag, int firstTileIndex);
+float SampleShadowAtlas(ShadowAtlasTile tile, vec2 tileCoords, float compareDepth);
+vec3 EvaluateLightProbeIrradiance(int probeIndex, vec3 normal);
+vec3 BlendLightProbeIrradiance(vec3 fragPos, vec3 normal);
+vec3 SampleReflectionProbe(vec3 fragPos, vec3 reflectionVec, float lod);
 vec3 WorldPosFromDepth();
+vec3 DecodeNormal(vec2 encoded);
 
 void main() {
 	// Sample textures
-	vec4 sampledAlbedo = texture(albedoTexture, TexCoords).rgba;
+	vec2 gbufferCoords = TexCoords * renderScale;
+	vec4 sampledAlbedo = texture(albedoTexture, gbufferCoords).rgba;
 	vec3 albedo = sampledAlbedo.rgb;
 	float albedoAlpha = sampledAlbedo.w;
-	vec3 normal = texture(normalTexture, TexCoords).rgb;
-	float metallic = texture(materialInfoTexture, TexCoords).r;
-	float unclampedRoughness = texture(materialInfoTexture, TexCoords).g; // Used for indirect specular (reflections)
+	vec3 normal = DecodeNormal(texture(normalTexture, gbufferCoords).rg);
+	float metallic = texture(materialInfoTexture, gbufferCoords).r;
+	float unclampedRoughness = texture(materialInfoTexture, gbufferCoords).g; // Used for indirect specular (reflections)
 	float roughness = max(unclampedRoughness, 0.04); // Used for calculations since specular highlights will be too fine, and will cause flicker
-	float materialAO = texture(materialInfoTexture, TexCoords).b;
-	float sceneAO = texture(ssaoTexture, TexCoords).r;
+	float materialAO = texture(materialInfoTexture, gbufferCoords).b;
+	float sceneAO = texture(ssaoTexture, gbufferCoords).r;
 	float ao = min(materialAO, sceneAO);
 
 	// Reconstruct fragPos
@@ -150,9 +192,13 @@ void main() {
 		vec3 diffuseRatio = vec3(1.0) - specularRatio;
 		diffuseRatio *= 1.0 - metallic;
 
-		vec3 indirectDiffuse = texture(irradianceMap, normal).rgb * albedo * diffuseRatio;
+		vec3 indirectDiffuse = BlendLightProbeIrradiance(fragPos, normal) * albedo * diffuseRatio;
 
-		vec3 prefilterColour = textureLod(prefilterMap, reflectionVec, unclampedRoughness * (reflectionProbeMipCount - 1)).rgb;
+		vec3 prefilterColour = SampleReflectionProbe(fragPos, reflectionVec, unclampedRoughness * (reflectionProbeMipCount - 1));
+		if (ssrEnabled) {
+			vec4 screenSpaceReflection = texture(ssrTexture, gbufferCoords);
+			prefilterColour = mix(prefilterColour, screenSpaceReflection.rgb, screenSpaceReflection.a);
+		}
 		vec2 brdfIntegration = texture(brdfLUT, vec2(max(dot(normal, fragToViewNorm), 0.0), roughness)).rg;
 		vec3 indirectSpecular = prefilterColour * (specularRatio * brdfIntegration.x + brdfIntegration.y);
 
@@ -188,7 +234,7 @@ vec3 CalculateDirectionalLightRadiance(vec3 albedo, vec3 normal, float metallic,
 		// Also calculate the diffuse, a lambertian calculation will be added onto the final radiance calculation
 		vec3 diffuse = diffuseRatio * albedo / PI;
 
-		// Calculate shadows, but first check to make sure the current light index is the shadow caster
+		// Calculate shadows, lights without a tile in the shadow atlas return no shadow
 		float shadowAmount = 0.0f;
 		if (i == dirLightShadowData.lightShadowIndex)
 			shadowAmount = CalculateDirLightShadow(fragPos);
@@ -201,10 +247,25 @@ vec3 CalculateDirectionalLightRadiance(vec3 albedo, vec3 normal, float metallic,
 }
 
 
+// Finds the cluster a world space position falls in, so only the lights overlapping that cluster need to be iterated
+uint GetLightClusterIndex(vec3 worldPos) {
+	vec4 viewSpacePos = clusterView * vec4(worldPos, 1.0);
+	vec4 clipSpacePos = clusterProjection * viewSpacePos;
+	vec2 screenUV = clamp((clipSpacePos.xy / clipSpacePos.w) * 0.5 + 0.5, 0.0, 0.9999);
+
+	int slice = clamp(int(log(max(-viewSpacePos.z, 0.0001)) * clusterZParams.x - clusterZParams.y), 0, clusterGridSize.z - 1);
+	ivec2 tile = ivec2(screenUV * vec2(clusterGridSize.xy));
+	return uint(tile.x + tile.y * clusterGridSize.x + slice * clusterGridSize.x * clusterGridSize.y);
+}
+
+
 vec3 CalculatePointLightRadiance(vec3 albedo, vec3 normal, float metallic, float roughness, vec3 fragPos, vec3 fragToViewNorm, vec3 baseReflectivity) {
 	vec3 pointLightIrradiance = vec3(0.0);
 
-	for (int i = 0; i < numDirPointSpotLights.y; ++i) {
+	uvec2 lightCluster = lightClusters[GetLightClusterIndex(fragPos)];
+	uint clusterPointLightCount = lightCluster.y & 0xFFFFu;
+	for (uint clusterLight = 0; clusterLight < clusterPointLightCount; ++clusterLight) {
+		int i = int(lightIndices[lightCluster.x + clusterLight]);
 		vec3 fragToLightNorm = normalize(pointLights[i].position - fragPos);
 		vec3 halfwayNorm = normalize(fragToViewNorm + fragToLightNorm);
 		vec3 lightToFrag = fragPos - pointLights[i].position;
@@ -236,10 +297,8 @@ vec3 CalculatePointLightRadiance(vec3 albedo, vec3 normal, float metallic, float
 		// Also calculate the diffuse, a lambertian calculation will be added onto the final radiance calculation
 		vec3 diffuse = diffuseRatio * albedo / PI;
 
-		// Calculate shadows, but first check to make sure the current light index is the shadow caster
-		float shadowAmount = 0.0;
-		if (i == pointLightShadowData.lightShadowIndex)
-			shadowAmount = CalculatePointLightShadow(lightToFrag);
+		// Calculate shadows, lights without a tile in the shadow atlas return no shadow
+		float shadowAmount = CalculatePointLightShadow(fragPos, lightToFrag, pointLights[i].shadowAtlasTileIndex);
 
 		// Add the light's radiance to the irradiance sum
 		pointLightIrradiance += (diffuse + specular) * radiance * max(dot(normal, fragToLightNorm), 0.0) * (1.0 - shadowAmount);
@@ -252,7 +311,11 @@ vec3 CalculatePointLightRadiance(vec3 albedo, vec3 normal, float metallic, float
 vec3 CalculateSpotLightRadiance(vec3 albedo, vec3 normal, float metallic, float roughness,  vec3 fragPos, vec3 fragToViewNorm, vec3 baseReflectivity) {
 	vec3 spotLightIrradiance = vec3(0.0);
 
-	for (int i = 0; i < numDirPointSpotLights.z; ++i) {
+	uvec2 lightCluster = lightClusters[GetLightClusterIndex(fragPos)];
+	uint clusterPointLightCount = lightCluster.y & 0xFFFFu;
+	uint clusterSpotLightCount = lightCluster.y >> 16;
+	for (uint clusterLight = 0; clusterLight < clusterSpotLightCount; ++clusterLight) {
+		int i = int(lightIndices[lightCluster.x + clusterPointLightCount + clusterLight]);
 		vec3 fragToLightNorm = normalize(spotLights[i].position - fragPos);
 		vec3 halfwayNorm = normalize(fragToViewNorm + fragToLightNorm);
 		float fragToLightDistance = length(spotLights[i].position - fragPos);
@@ -288,10 +351,8 @@ vec3 CalculateSpotLightRadiance(vec3 albedo, vec3 normal, float metallic, float
 		// Also calculate the diffuse, a lambertian calculation will be added onto the final radiance calculation
 		vec3 diffuse = diffuseRatio * albedo / PI;
 
-		// Calculate shadows, but first check to make sure the current light index is the shadow caster
-		float shadowAmount = 0.0f;
-		if (i == spotLightShadowData.lightShadowIndex)
-			shadowAmount = CalculateSpotLightShadow(fragPos);
+		// Calculate shadows, lights without a tile in the shadow atlas return no shadow
+		float shadowAmount = CalculateSpotLightShadow(fragPos, spotLights[i].shadowAtlasTileIndex);
 
 		// Add the light's radiance to the irradiance sum
 		spotLightIrradiance += (diffuse + specular) * radiance * max(dot(normal, fragToLightNorm), 0.0) * (1.0 - shadowAmount);
@@ -343,33 +404,42 @@ float CalculateDirLightShadow(vec3 fragPos) {
 	if (dirLightShadowData.lightShadowIndex == -1)
 		return 0.0;
 
-	vec4 fragPosLightClipSpace = dirLightShadowData.lightSpaceViewProjectionMatrix * vec4(fragPos, 1.0);
-	vec3 ndcCoords = fragPosLightClipSpace.xyz / fragPosLightClipSpace.w;
-	vec3 depthmapCoords = ndcCoords * 0.5 + 0.5;
-
-	float currentDepth = depthmapCoords.z;
-	if (currentDepth > 1.0)
-		return 0.0;
-
-	// Perform Percentage Closer Filtering (PCF) in order to produce soft shadows - Use bilinear filtering to get some free samples (4 bilinear samples, 4 samples -> 16 values actually processed)
-	float shadow = 0.0;
-	vec2 texelSize = 1.0 / textureSize(dirLightShadowmap, 0);
-	for (float y = -1.5; y < 1.0; y += 2.0) {
-		for (float x = -1.5; x < 1.0; x += 2.0) {
-			float sampledDepthPCF = texture(dirLightShadowmap, depthmapCoords.xy + (texelSize * vec2(x, y))).r;
-			shadow += currentDepth > sampledDepthPCF + dirLightShadowData.shadowBias ? 1.0 : 0.0; // Add shadow bias to avoid shadow acne. However too much bias can cause peter panning
+	// Cascades are ordered from closest to furthest, so use the first cascade that contains the fragment (leaving room on the edges for the PCF samples)
+	vec2 texelSize = 1.0 / textureSize(dirLightShadowmap, 0).xy;
+	for (int cascade = 0; cascade < dirLightShadowData.cascadeCount; cascade++) {
+		vec4 fragPosLightClipSpace = dirLightShadowData.lightSpaceViewProjectionMatrices[cascade] * vec4(fragPos, 1.0);
+		vec3 ndcCoords = fragPosLightClipSpace.xyz / fragPosLightClipSpace.w;
+		vec3 depthmapCoords = ndcCoords * 0.5 + 0.5;
+		if (any(lessThan(depthmapCoords.xy, texelSize * 2.0)) || any(greaterThan(depthmapCoords.xy, 1.0 - (texelSize * 2.0))))
+			continue;
+
+		float currentDepth = depthmapCoords.z;
+		if (currentDepth > 1.0)
+			return 0.0;
+
+		// Perform Percentage Closer Filtering (PCF) in order to produce soft shadows - Use bilinear filtering to get some free samples (4 bilinear samples, 4 samples -> 16 values actually processed)
+		float shadow = 0.0;
+		for (float y = -1.5; y < 1.0; y += 2.0) {
+			for (float x = -1.5; x < 1.0; x += 2.0) {
+				float sampledDepthPCF = texture(dirLightShadowmap, vec3(depthmapCoords.xy + (texelSize * vec2(x, y)), cascade)).r;
+				shadow += currentDepth > sampledDepthPCF + dirLightShadowData.cascadeShadowBiases[cascade] ? 1.0 : 0.0; // Add shadow bias to avoid shadow acne. However too much bias can cause peter panning
+			}
 		}
+		shadow *= 0.25;
+
+		return shadow;
 	}
-	shadow *= 0.25;
 
-	return shadow;
+	// Past the furthest cascade
+	return 0.0;
 }
 
-float CalculateSpotLightShadow(vec3 fragPos) {
-	if (spotLightShadowData.lightShadowIndex == -1)
+float CalculateSpotLightShadow(vec3 fragPos, int tileIndex) {
+	if (tileIndex == -1)
 		return 0.0;
 
-	vec4 fragPosLightClipSpace = spotLightShadowData.lightSpaceViewProjectionMatrix * vec4(fragPos, 1.0);
+	ShadowAtlasTile tile = shadowAtlasTiles[tileIndex];
+	vec4 fragPosLightClipSpace = tile.lightSpaceViewProjectionMatrix * vec4(fragPos, 1.0);
 	vec3 ndcCoords = fragPosLightClipSpace.xyz / fragPosLightClipSpace.w;
 	vec3 depthmapCoords = ndcCoords * 0.5 + 0.5;
 
@@ -377,54 +447,56 @@ float CalculateSpotLightShadow(vec3 fragPos) {
 	if (currentDepth > 1.0)
 		return 0.0;
 
-	// Perform Percentage Closer Filtering (PCF) in order to produce soft shadows - Use bilinear filtering to get some free samples (4 bilinear samples, 4 samples -> 16 values actually processed)
-	float shadow = 0.0;
-	vec2 texelSize = 1.0 / textureSize(spotLightShadowmap, 0);
-	for (float y = -1.5; y < 1.0; y += 2.0) {
-		for (float x = -1.5; x < 1.0; x += 2.0) {
-			float sampledDepthPCF = texture(spotLightShadowmap, depthmapCoords.xy + (texelSize * vec2(x, y))).r;
-			shadow += currentDepth > sampledDepthPCF + spotLightShadowData.shadowBias ? 1.0 : 0.0; // Add shadow bias to avoid shadow acne. However too much bias can cause peter panning
-		}
-	}
-	shadow *= 0.25;
-
-	return shadow;
+	return SampleShadowAtlas(tile, depthmapCoords.xy, currentDepth - tile.shadowBias); // Add shadow bias to avoid shadow acne. However too much bias can cause peter panning
 }
 
-vec3 sampleOffsetDirections[20] = vec3[]
-(
-	vec3( 1,  1,  1), vec3( 1, -1,  1), vec3(-1, -1,  1), vec3(-1,  1,  1), 
-	vec3( 1,  1, -1), vec3( 1, -1, -1), vec3(-1, -1, -1), vec3(-1,  1, -1),
-	vec3( 1,  1,  0), vec3( 1, -1,  0), vec3(-1, -1,  0), vec3(-1,  1,  0),
-	vec3( 1,  0,  1), vec3(-1,  0,  1), vec3( 1,  0, -1), vec3(-1,  0, -1),
-	vec3( 0,  1,  1), vec3( 0, -1,  1), vec3( 0, -1, -1), vec3( 0,  1, -1)
-);
-
-float CalculatePointLightShadow(vec3 lightToFrag) {
-	if (pointLightShadowData.lightShadowIndex == -1)
+float CalculatePointLightShadow(vec3 fragPos, vec3 lightToFrag, int firstTileIndex) {
+	if (firstTileIndex == -1)
 		return 0.0;
 
+	// Find the cube face the fragment lies in (same face order as a cubemap), each face has it's own tile in the atlas
+	vec3 absLightToFrag = abs(lightToFrag);
+	int faceIndex;
+	if (absLightToFrag.x >= absLightToFrag.y && absLightToFrag.x >= absLightToFrag.z)
+		faceIndex = lightToFrag.x > 0.0 ? 0 : 1;
+	else if (absLightToFrag.y >= absLightToFrag.z)
+		faceIndex = lightToFrag.y > 0.0 ? 2 : 3;
+	else
+		faceIndex = lightToFrag.z > 0.0 ? 4 : 5;
+	ShadowAtlasTile tile = shadowAtlasTiles[firstTileIndex + faceIndex];
+
 	float currentDepth = length(lightToFrag);
-	if (currentDepth > pointLightShadowData.farPlane)
+	if (currentDepth > tile.farPlane)
 		return 0.0;
 
+	vec4 fragPosLightClipSpace = tile.lightSpaceViewProjectionMatrix * vec4(fragPos, 1.0);
+	vec2 tileCoords = (fragPosLightClipSpace.xy / fragPosLightClipSpace.w) * 0.5 + 0.5;
+
+	return SampleShadowAtlas(tile, tileCoords, (currentDepth - tile.shadowBias) / tile.farPlane); // Point lights store linear depth in the [0, 1] range
+}
+
+// Perform Percentage Closer Filtering (PCF) in order to produce soft shadows - Use bilinear filtering to get some free samples (4 bilinear samples, 4 samples -> 16 values actually processed)
+// Samples are clamped to the tile so neighbouring tiles in the atlas never bleed in
+float SampleShadowAtlas(ShadowAtlasTile tile, vec2 tileCoords, float compareDepth) {
+	vec2 texelSize = 1.0 / textureSize(shadowAtlas, 0);
+	vec2 atlasCoords = tileCoords * tile.atlasScaleBias.xy + tile.atlasScaleBias.zw;
+	vec2 tileMin = tile.atlasScaleBias.zw + texelSize;
+	vec2 tileMax = tile.atlasScaleBias.zw + tile.atlasScaleBias.xy - texelSize;
+
 	float shadow = 0.0;
-	float samples = 20;
-	float diskRadius = 0.05;
-	for (int i = 0; i < samples; i++)
-	{
-		float closestDepth = texture(pointLightShadowCubemap, lightToFrag + sampleOffsetDirections[i] * diskRadius).r;
-		closestDepth *= pointLightShadowData.farPlane; // undo the [0,1] mapping
-		if (currentDepth - pointLightShadowData.shadowBias > closestDepth)
-			shadow += 1.0;
+	for (float y = -1.5; y < 1.0; y += 2.0) {
+		for (float x = -1.5; x < 1.0; x += 2.0) {
+			float sampledDepthPCF = texture(shadowAtlas, clamp(atlasCoords + (texelSize * vec2(x, y)), tileMin, tileMax)).r;
+			shadow += compareDepth > sampledDepthPCF ? 1.0 : 0.0;
+		}
 	}
-	shadow /= float(samples);
+	shadow *= 0.25;
 
 	return shadow;
 }
 
 vec3 WorldPosFromDepth() {
-	float z = 2.0 * texture(depthTexture, TexCoords).r - 1.0; // [-1, 1]
+	float z = 2.0 * texture(depthTexture, TexCoords * renderScale).r - 1.0; // [-1, 1]
 	vec4 clipSpacePos = vec4(TexCoords * 2.0 - 1.0 , z, 1.0);
 	vec4 viewSpacePos = projectionInverse * clipSpacePos;
 	viewSpacePos /= viewSpacePos.w; // Perspective division
@@ -433,3 +505,104 @@ vec3 WorldPosFromDepth() {
 
 	return worldSpacePos.xyz;
 }
+
+// Evaluates the probe's spherical harmonics in the direction of the normal, the L2 basis constants must match the CPU projection
+vec3 EvaluateLightProbeIrradiance(int probeIndex, vec3 normal) {
+	LightProbe probe = lightProbes[probeIndex];
+	vec3 irradiance = probe.shCoefficients[0].rgb * 0.282095;
+	irradiance += probe.shCoefficients[1].rgb * 0.488603 * normal.y;
+	irradiance += probe.shCoefficients[2].rgb * 0.488603 * normal.z;
+	irradiance += probe.shCoefficients[3].rgb * 0.488603 * normal.x;
+	irradiance += probe.shCoefficients[4].rgb * 1.092548 * normal.x * normal.y;
+	irradiance += probe.shCoefficients[5].rgb * 1.092548 * normal.y * normal.z;
+	irradiance += probe.shCoefficients[6].rgb * 0.315392 * (3.0 * normal.z * normal.z - 1.0);
+	irradiance += probe.shCoefficients[7].rgb * 1.092548 * normal.x * normal.z;
+	irradiance += probe.shCoefficients[8].rgb * 0.546274 * (normal.x * normal.x - normal.y * normal.y);
+	return max(irradiance, vec3(0.0)); // Ringing can push the reconstruction slightly negative
+}
+
+// Same selection as ProbeManager::SelectProbes, just for the pixel's position instead of an object's
+vec3 BlendLightProbeIrradiance(vec3 fragPos, vec3 normal) {
+	ivec4 probeIndices = ivec4(0);
+	vec4 probeWeights = vec4(0.0);
+
+	ivec3 cell = ivec3(floor((fragPos - lightProbeGridMin) / lightProbeGridCellSize));
+	if (lightProbeBlendCount > 0 && all(greaterThanEqual(cell, ivec3(0))) && all(lessThan(cell, lightProbeGridSize))) {
+		int cellIndex = cell.x + cell.y * lightProbeGridSize.x + cell.z * lightProbeGridSize.x * lightProbeGridSize.y;
+		uint probeOffset = lightProbeGrid[cellIndex * 2];
+		uint probeCount = lightProbeGrid[cellIndex * 2 + 1];
+		for (uint i = 0; i < probeCount; i++) {
+			int probeIndex = int(lightProbeGrid[probeOffset + i]) + 1; // Scene probes follow the fallback in the probe buffer
+			vec4 positionRadius = lightProbes[probeIndex].positionRadius;
+			float distance = length(positionRadius.xyz - fragPos);
+			if (distance >= positionRadius.w)
+				continue;
+
+			float falloff = 1.0 - (distance / positionRadius.w);
+			float weight = falloff * falloff;
+
+			// Keep the highest weighted probes sorted, a displaced probe moves down a slot
+			for (int slot = 0; slot < lightProbeBlendCount; slot++) {
+				if (weight > probeWeights[slot]) {
+					float displacedWeight = probeWeights[slot];
+					int displacedIndex = probeIndices[slot];
+					probeWeights[slot] = weight;
+					probeIndices[slot] = probeIndex;
+					weight = displacedWeight;
+					probeIndex = displacedIndex;
+				}
+			}
+		}
+	}
+
+	float totalWeight = dot(probeWeights, vec4(1.0));
+	if (totalWeight <= 0.0)
+		return EvaluateLightProbeIrradiance(0, normal);
+	if (lightProbeBlendCount == 1)
+		return EvaluateLightProbeIrradiance(probeIndices[0], normal);
+
+	// Normalize if the probes fully cover the pixel, otherwise the fallback fills in the rest so there is no seam at the edge of the probes' influence
+	bool normalizeWeights = totalWeight > 1.0;
+	float normalization = normalizeWeights ? 1.0 / totalWeight : 1.0;
+	vec3 irradiance = vec3(0.0);
+	for (int i = 0; i < MAX_PROBE_BLEND_COUNT; i++) {
+		if (probeWeights[i] > 0.0) {
+			irradiance += EvaluateLightProbeIrradiance(probeIndices[i], normal) * probeWeights[i] * normalization;
+		}
+	}
+	if (!normalizeWeights) {
+		irradiance += EvaluateLightProbeIrradiance(0, normal) * (1.0 - totalWeight);
+	}
+	return irradiance;
+}
+
+// Uses the highest weighted of the bound reflection probes, falling back to the skybox's probe outside of all of them
+vec3 SampleReflectionProbe(vec3 fragPos, vec3 reflectionVec, float lod) {
+	int selectedProbe = -1;
+	float highestWeight = 0.0;
+	for (int i = 0; i < reflectionProbeCount; i++) {
+		float distance = length(reflectionProbePositionRadii[i].xyz - fragPos);
+		float weight = 1.0 - (distance / reflectionProbePositionRadii[i].w);
+		if (weight > highestWeight) {
+			highestWeight = weight;
+			selectedProbe = i;
+		}
+	}
+
+	// The probe differs per pixel, so each map is sampled behind a loop index (which is uniform) instead of indexing the sampler array with selectedProbe
+	for (int i = 0; i < MAX_REFLECTION_PROBES; i++) {
+		if (i == selectedProbe) {
+			return textureLod(reflectionProbeMaps[i], reflectionVec, lod).rgb;
+		}
+	}
+	return textureLod(prefilterMap, reflectionVec, lod).rgb;
+}
+
+// Inverse of the geometry pass' octahedral encoding
+vec3 DecodeNormal(vec2 encoded) {
+	encoded = encoded * 2.0 - 1.0;
+	vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float fold = clamp(-normal.z, 0.0, 1.0);
+	normal.xy += vec2(normal.x >= 0.0 ? -fold : fold, normal.y >= 0.0 ? -fold : fold);
+	return normalize(normal);
+}
@@ -6,13 +6,47 @@ layout (location = 1) in vec3 normal;
 layout (location = 2) in vec2 texCoords;
 layout (location = 3) in vec3 tangent;
 layout (location = 4) in vec3 bitangent;
+layout (location = 7) in uint drawIndex; // Only meaningful for indirect draws, where it's the draw's index into the draw data
 
 out mat3 TBN;
 out vec2 TexCoords;
 out vec3 FragPosTangentSpace;
 out vec3 ViewPosTangentSpace;
+out vec4 CurrentClipPos;
+out vec4 PreviousClipPos;
+flat out int MaterialIndex;
+
+#define MATERIAL_HAS_ALBEDO_TEXTURE 1
+#define MATERIAL_HAS_METALLIC_TEXTURE 2
+#define MATERIAL_HAS_ROUGHNESS_TEXTURE 4
+#define MATERIAL_HAS_DISPLACEMENT 8
+
+struct MaterialData {
+	vec4 albedoColour;
+	float metallicValue, roughnessValue, parallaxStrength;
+	int flags;
+	vec2 minMaxDisplacementSteps;
+	vec2 padding;
+	uvec2 textures[6]; // Bindless handle, or the texture array bucket and layer
+};
+layout (std430, binding = 9) readonly buffer MaterialBuffer {
+	MaterialData materials[];
+};
+
+struct DrawData {
+	mat4 model;
+	mat4 previousModel;
+	mat3 normalMatrix;
+	int layerMask;
+	int materialIndex;
+};
+layout (std430, binding = 8) readonly buffer DrawDataBuffer {
+	DrawData drawData[];
+};
+
+uniform bool drawIndirect;
+uniform int materialIndex;
 
-uniform bool hasDisplacement;
 uniform vec3 viewPos;
 
 uniform mat3 normalMatrix;
@@ -20,21 +54,36 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+// Used for motion vectors, the view projections are unjittered so the motion only comes from the camera and the mesh moving
+uniform mat4 previousModel;
+uniform mat4 currentViewProjection;
+uniform mat4 previousViewProjection;
+
 void main() {
+	// Indirect draws read everything that would otherwise be a per mesh uniform from their draw data
+	mat4 modelMatrix = drawIndirect ? drawData[drawIndex].model : model;
+	mat4 previousModelMatrix = drawIndirect ? drawData[drawIndex].previousModel : previousModel;
+	mat3 modelNormalMatrix = drawIndirect ? drawData[drawIndex].normalMatrix : normalMatrix;
+	MaterialIndex = drawIndirect ? drawData[drawIndex].materialIndex : materialIndex;
+
 	// Use the normal matrix to maintain the orthogonal property of a vector when it is scaled non-uniformly
-	vec3 T = normalize(normalMatrix * tangent);
-	vec3 B = normalize(normalMatrix * bitangent);
-	vec3 N = normalize(normalMatrix * normal);
+	vec3 T = normalize(modelNormalMatrix * tangent);
+	vec3 B = normalize(modelNormalMatrix * bitangent);
+	vec3 N = normalize(modelNormalMatrix * normal);
 	TBN = mat3(T, B, N);
 
 	TexCoords = texCoords;
-	vec3 fragPos = vec3(model * vec4(position, 1.0f));
+	bool hasDisplacement = (materials[MaterialIndex].flags & MATERIAL_HAS_DISPLACEMENT) != 0;
+	vec3 fragPos = vec3(modelMatrix * vec4(position, 1.0f));
 	if (hasDisplacement) {
 		mat3 inverseTBN = transpose(TBN); // Calculate matrix to go from world -> tangent (orthogonal matrix's transpose = inverse)
 		FragPosTangentSpace = inverseTBN * fragPos;
 		ViewPosTangentSpace = inverseTBN * viewPos;
 	}
 
+	CurrentClipPos = currentViewProjection * vec4(fragPos, 1.0);
+	PreviousClipPos = previousViewProjection * previousModelMatrix * vec4(position, 1.0);
+
 	gl_Position = projection * view * vec4(fragPos, 1.0);
 }
 
@@ -44,60 +93,84 @@ void main() {
 #shader-type fragment
 #version 430 core
 
+#ifdef MATERIAL_BINDLESS
+#extension GL_ARB_bindless_texture : require
+#endif
+
 layout (location = 0) out vec4 gb_Albedo;
-layout (location = 1) out vec3 gb_Normal;
+layout (location = 1) out vec2 gb_Normal; // Octahedral encoded world space normal
 layout (location = 2) out vec4 gb_MaterialInfo;
+layout (location = 3) out vec2 gb_MotionVector;
 
-struct Material {
-	sampler2D texture_albedo;
-	sampler2D texture_normal;
-	sampler2D texture_metallic;
-	sampler2D texture_roughness;
-	sampler2D texture_ao;
-	sampler2D texture_displacement;
+#define MATERIAL_TEXTURE_ARRAY_MAX_BUCKETS 10
 
-	// Used if textures aren't provided
-	vec4 albedoColour;
-	float metallicValue, roughnessValue;
+#define MATERIAL_TEXTURE_ALBEDO 0
+#define MATERIAL_TEXTURE_NORMAL 1
+#define MATERIAL_TEXTURE_METALLIC 2
+#define MATERIAL_TEXTURE_ROUGHNESS 3
+#define MATERIAL_TEXTURE_AO 4
+#define MATERIAL_TEXTURE_DISPLACEMENT 5
 
-	bool hasAlbedoTexture, hasMetallicTexture, hasRoughnessTexture;
+#define MATERIAL_HAS_ALBEDO_TEXTURE 1
+#define MATERIAL_HAS_METALLIC_TEXTURE 2
+#define MATERIAL_HAS_ROUGHNESS_TEXTURE 4
+#define MATERIAL_HAS_DISPLACEMENT 8
+
+struct MaterialData {
+	vec4 albedoColour;
+	float metallicValue, roughnessValue, parallaxStrength;
+	int flags;
+	vec2 minMaxDisplacementSteps;
+	vec2 padding;
+	uvec2 textures[6]; // Bindless handle, or the texture array bucket and layer
 };
+layout (std430, binding = 9) readonly buffer MaterialBuffer {
+	MaterialData materials[];
+};
+
+#ifndef MATERIAL_BINDLESS
+uniform sampler2DArray materialTextureArrays[MATERIAL_TEXTURE_ARRAY_MAX_BUCKETS];
+#endif
 
 in mat3 TBN;
 in vec2 TexCoords;
 in vec3 FragPosTangentSpace;
 in vec3 ViewPosTangentSpace;
-
-uniform bool hasDisplacement;
-uniform vec2 minMaxDisplacementSteps;
-uniform float parallaxStrength;
-uniform Material material;
+in vec4 CurrentClipPos;
+in vec4 PreviousClipPos;
+flat in int MaterialIndex; // Constant across a draw, so indexing the texture arrays with it stays dynamically uniform
 
 // Functions
+vec4 SampleMaterialTexture(int textureSlot, vec2 texCoords);
+vec4 SampleMaterialTextureLod(int textureSlot, vec2 texCoords, float lod);
+vec2 QueryMaterialTextureLod(int textureSlot, vec2 texCoords);
 vec3 UnpackNormal(vec3 textureNormal);
+vec2 EncodeNormal(vec3 normal);
 vec2 ParallaxMapping(vec2 texCoords, vec3 viewDirTangentSpace);
 
 void main() {
 	// Parallax mapping
+	MaterialData material = materials[MaterialIndex];
 	vec2 textureCoordinates = TexCoords;
-	if (hasDisplacement) {
+	if ((material.flags & MATERIAL_HAS_DISPLACEMENT) != 0) {
 		vec3 viewDirTangentSpace = normalize(ViewPosTangentSpace - FragPosTangentSpace);
 		textureCoordinates = ParallaxMapping(TexCoords, viewDirTangentSpace);
 	}
 
 	// Sample textures
-	vec4 albedo = material.hasAlbedoTexture ? texture(material.texture_albedo, textureCoordinates).rgba * material.albedoColour : material.albedoColour;
-	vec3 normal = texture(material.texture_normal, textureCoordinates).rgb;
-	float metallic = material.hasMetallicTexture ? texture(material.texture_metallic, textureCoordinates).r : material.metallicValue;
-	float roughness = material.hasRoughnessTexture ? texture(material.texture_roughness, textureCoordinates).r : material.roughnessValue;
-	float ao = texture(material.texture_ao, textureCoordinates).r;
+	vec4 albedo = (material.flags & MATERIAL_HAS_ALBEDO_TEXTURE) != 0 ? SampleMaterialTexture(MATERIAL_TEXTURE_ALBEDO, textureCoordinates).rgba * material.albedoColour : material.albedoColour;
+	vec3 normal = SampleMaterialTexture(MATERIAL_TEXTURE_NORMAL, textureCoordinates).rgb;
+	float metallic = (material.flags & MATERIAL_HAS_METALLIC_TEXTURE) != 0 ? SampleMaterialTexture(MATERIAL_TEXTURE_METALLIC, textureCoordinates).r : material.metallicValue;
+	float roughness = (material.flags & MATERIAL_HAS_ROUGHNESS_TEXTURE) != 0 ? SampleMaterialTexture(MATERIAL_TEXTURE_ROUGHNESS, textureCoordinates).r : material.roughnessValue;
+	float ao = SampleMaterialTexture(MATERIAL_TEXTURE_AO, textureCoordinates).r;
 
 	// Normal mapping code. Opted out of tangent space normal mapping since I would have to convert all of my lights to tangent space
 	normal = normalize(TBN * UnpackNormal(normal));
 
 	gb_Albedo = albedo;
-	gb_Normal = normal;
+	gb_Normal = EncodeNormal(normal);
 	gb_MaterialInfo = vec4(metallic, roughness, ao, 1.0);
+	gb_MotionVector = (CurrentClipPos.xy / CurrentClipPos.w - PreviousClipPos.xy / PreviousClipPos.w) * 0.5; // NDC -> UV movement since the previous frame
 }
 
 // Unpacks the normal from the texture and returns the normal in tangent space
@@ -107,38 +180,74 @@ vec3 UnpackNormal(vec3 textureNormal) {
 
 vec2 ParallaxMapping(vec2 texCoords, vec3 viewDirTangentSpace) {
 	// Figure out the LoD we should sample from while raymarching the heightfield in tangent space. Required to fix an artifacting issue
-	vec2 lodInfo = textureQueryLod(material.texture_displacement, texCoords);
+	vec2 lodInfo = QueryMaterialTextureLod(MATERIAL_TEXTURE_DISPLACEMENT, texCoords);
 	float lodToSample = lodInfo.x;
 	float expectedLod = lodInfo.y; // Even if mip mapping isn't enabled this will still give us a mip level
 
-	const float minSteps = minMaxDisplacementSteps.x;
-	const float maxSteps = minMaxDisplacementSteps.y;
+	const float minSteps = materials[MaterialIndex].minMaxDisplacementSteps.x;
+	const float maxSteps = materials[MaterialIndex].minMaxDisplacementSteps.y;
 	float numSteps = mix(maxSteps, minSteps, clamp(expectedLod * 0.4, 0, 1)); // More steps are required at lower mip levels since the camera is closer to the surface
 
 	float layerDepth = 1.0 / numSteps;
 	float currentLayerDepth = 0.0;
 
 	// Calculate the direction and the amount we should raymarch each iteration
-	vec2 p = viewDirTangentSpace.xy * parallaxStrength;
+	vec2 p = viewDirTangentSpace.xy * materials[MaterialIndex].parallaxStrength;
 	vec2 deltaTexCoords = p / numSteps;
 
 	// Get the initial values
 	vec2 currentTexCoords = texCoords;
-	float currentSampledDepth = textureLod(material.texture_displacement, currentTexCoords, lodToSample).r;
+	float currentSampledDepth = SampleMaterialTextureLod(MATERIAL_TEXTURE_DISPLACEMENT, currentTexCoords, lodToSample).r;
 
 	// Keep ray marching along vector p by the texture coordinate delta, until the raymarching depth catches up to the sampled depth (ie the -view vector intersects the surface)
 	while (currentLayerDepth < currentSampledDepth) {
 		currentTexCoords -= deltaTexCoords;
-		currentSampledDepth = textureLod(material.texture_displacement, currentTexCoords, lodToSample).r;
+		currentSampledDepth = SampleMaterialTextureLod(MATERIAL_TEXTURE_DISPLACEMENT, currentTexCoords, lodToSample).r;
 		currentLayerDepth += layerDepth;
 	}
 
 	// Now we need to get the previous step and the current step, and interpolate between the two texture coordinates
 	vec2 prevTexCoords = currentTexCoords + deltaTexCoords;
 	float afterDepth = currentSampledDepth - currentLayerDepth;
-	float beforeDepth = textureLod(material.texture_displacement, prevTexCoords, lodToSample).r - currentLayerDepth + layerDepth;
+	float beforeDepth = SampleMaterialTextureLod(MATERIAL_TEXTURE_DISPLACEMENT, prevTexCoords, lodToSample).r - currentLayerDepth + layerDepth;
 	float weight = afterDepth / (afterDepth - beforeDepth);
 	vec2 finalTexCoords = mix(currentTexCoords, prevTexCoords, weight);
 
 	return finalTexCoords;
 }
+
+// Octahedral encoding, the normal is projected onto an octahedron which is unfolded into a square so two 16 bit channels hold it with very little error
+vec2 EncodeNormal(vec3 normal) {
+	normal /= abs(normal.x) + abs(normal.y) + abs(normal.z);
+	vec2 signNotZero = vec2(normal.x >= 0.0 ? 1.0 : -1.0, normal.y >= 0.0 ? 1.0 : -1.0);
+	vec2 encoded = (normal.z >= 0.0) ? normal.xy : (1.0 - abs(normal.yx)) * signNotZero;
+	return encoded * 0.5 + 0.5;
+}
+
+// A material texture is either a bindless handle or a layer of one of the texture arrays, the array index comes from the material so it's the same across the draw
+vec4 SampleMaterialTexture(int textureSlot, vec2 texCoords) {
+	uvec2 textureReference = materials[MaterialIndex].textures[textureSlot];
+#ifdef MATERIAL_BINDLESS
+	return texture(sampler2D(textureReference), texCoords);
+#else
+	return texture(materialTextureArrays[textureReference.x], vec3(texCoords, float(textureReference.y)));
+#endif
+}
+
+vec4 SampleMaterialTextureLod(int textureSlot, vec2 texCoords, float lod) {
+	uvec2 textureReference = materials[MaterialIndex].textures[textureSlot];
+#ifdef MATERIAL_BINDLESS
+	return textureLod(sampler2D(textureReference), texCoords, lod);
+#else
+	return textureLod(materialTextureArrays[textureReference.x], vec3(texCoords, float(textureReference.y)), lod);
+#endif
+}
+
+vec2 QueryMaterialTextureLod(int textureSlot, vec2 texCoords) {
+	uvec2 textureReference = materials[MaterialIndex].textures[textureSlot];
+#ifdef MATERIAL_BINDLESS
+	return textureQueryLod(sampler2D(textureReference), texCoords);
+#else
+	return textureQueryLod(materialTextureArrays[textureReference.x], texCoords);
+#endif
+}
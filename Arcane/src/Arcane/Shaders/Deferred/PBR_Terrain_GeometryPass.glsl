@@ -9,12 +9,18 @@ layout (location = 4) in vec3 bitangent;
 
 out mat3 TBN;
 out vec2 TexCoords;
+out vec4 CurrentClipPos;
+out vec4 PreviousClipPos;
 
 uniform mat3 normalMatrix;
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+// The terrain never moves so only the camera's movement is needed for it's motion vectors (both are unjittered)
+uniform mat4 currentViewProjection;
+uniform mat4 previousViewProjection;
+
 void main() {
 	// Use the normal matrix to maintain the orthogonal property of a vector when it is scaled non-uniformly
 	vec3 T = normalize(normalMatrix * tangent);
@@ -24,7 +30,11 @@ void main() {
 
 	TexCoords = texCoords;
 
-	gl_Position = projection * view * model * vec4(position, 1.0);
+	vec4 worldPos = model * vec4(position, 1.0);
+	CurrentClipPos = currentViewProjection * worldPos;
+	PreviousClipPos = previousViewProjection * worldPos;
+
+	gl_Position = projection * view * worldPos;
 }
 
 
@@ -34,8 +44,9 @@ void main() {
 #version 430 core
 
 layout (location = 0) out vec4 gb_Albedo;
-layout (location = 1) out vec3 gb_Normal;
+layout (location = 1) out vec2 gb_Normal; // Octahedral encoded world space normal
 layout (location = 2) out vec4 gb_MaterialInfo;
+layout (location = 3) out vec2 gb_MotionVector;
 
 struct Material {
 	sampler2D texture_albedo1; // background texture
@@ -69,11 +80,14 @@ struct Material {
 
 in mat3 TBN;
 in vec2 TexCoords;
+in vec4 CurrentClipPos;
+in vec4 PreviousClipPos;
 
 uniform Material material;
 
 // Functions
 vec3 UnpackNormal(vec3 textureNormal);
+vec2 EncodeNormal(vec3 normal);
 
 void main() {
 	vec4 blendMapColour = texture(material.blendmap, TexCoords);
@@ -115,11 +129,20 @@ void main() {
 	normal = normalize(TBN * UnpackNormal(normal));
 
 	gb_Albedo = vec4(albedo, 1.0);
-	gb_Normal = normal;
+	gb_Normal = EncodeNormal(normal);
 	gb_MaterialInfo = vec4(metallic, roughness, ao, 1.0);
+	gb_MotionVector = (CurrentClipPos.xy / CurrentClipPos.w - PreviousClipPos.xy / PreviousClipPos.w) * 0.5; // NDC -> UV movement since the previous frame
 }
 
 // Unpacks the normal from the texture and returns the normal in tangent space
 vec3 UnpackNormal(vec3 textureNormal) {
 	return normalize(textureNormal * 2.0 - 1.0);
 }
+
+// Octahedral encoding, the normal is projected onto an octahedron which is unfolded into a square so two 16 bit channels hold it with very little error
+vec2 EncodeNormal(vec3 normal) {
+	normal /= abs(normal.x) + abs(normal.y) + abs(normal.z);
+	vec2 signNotZero = vec2(normal.x >= 0.0 ? 1.0 : -1.0, normal.y >= 0.0 ? 1.0 : -1.0);
+	vec2 encoded = (normal.z >= 0.0) ? normal.xy : (1.0 - abs(normal.yx)) * signNotZero;
+	return encoded * 0.5 + 0.5;
+}
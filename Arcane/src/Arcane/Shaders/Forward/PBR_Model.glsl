@@ -72,41 +72,56 @@ struct DirLight {
 	vec3 lightColour;
 };
 
+// Point and spot lights are stored in SSBOs (std430) and must match GPUPointLight and GPUSpotLight
 struct PointLight {
 	vec3 position;
+	float attenuationRadius;
 
-	float intensity;
 	vec3 lightColour;
-	float attenuationRadius;
+	float intensity;
+
+	int shadowAtlasTileIndex; // First of the six cube face tiles, -1 if the light has no shadows
 };
 
 struct SpotLight {
 	vec3 position;
-	vec3 direction;
+	float attenuationRadius;
 
+	vec3 direction;
 	float intensity;
-	vec3 lightColour;
-	float attenuationRadius;
 
+	vec3 lightColour;
 	float cutOff;
+
 	float outerCutOff;
+	int shadowAtlasTileIndex; // -1 if the light has no shadows
 };
 
+#define MAX_SHADOW_CASCADES 4
+
+// Directional light shadows, every cascade is a layer of the shadowmap
 struct ShadowData {
-	mat4 lightSpaceViewProjectionMatrix;
-	float shadowBias;
+	mat4 lightSpaceViewProjectionMatrices[MAX_SHADOW_CASCADES];
+	vec4 cascadeShadowBiases;
+	int cascadeCount;
 	int lightShadowIndex;
 };
 
-struct ShadowDataPointLight {
-	float farPlane;
+// Light probe irradiance stored as L2 spherical harmonics (already convolved with a cosine lobe), must match GPULightProbe
+struct LightProbe {
+	vec4 shCoefficients[9];
+	vec4 positionRadius; // xyz = position, w = influence radius (0 for the fallback)
+};
+
+// Spot and point light shadows are tiles in the shadow atlas, must match GPUShadowAtlasTile
+struct ShadowAtlasTile {
+	mat4 lightSpaceViewProjectionMatrix;
+	vec4 atlasScaleBias; // xy = scale, zw = offset of the tile in the atlas
 	float shadowBias;
-	int lightShadowIndex;
+	float farPlane; // Only used by point lights since they store linear depth
 };
 
 #define MAX_DIR_LIGHTS 3
-#define MAX_POINT_LIGHTS 6
-#define MAX_SPOT_LIGHTS 6
 const float PI = 3.14159265359;
 
 in mat3 TBN;
@@ -120,23 +135,31 @@ out vec4 color;
 // IBL
 uniform int reflectionProbeMipCount;
 uniform bool computeIBL;
-uniform samplerCube irradianceMap;
+uniform ivec4 lightProbeIndices; // Up to four probes blended by lightProbeWeights (weights sum to one)
+uniform vec4 lightProbeWeights;
+layout (std430, binding = 5) readonly buffer LightProbeBuffer { LightProbe lightProbes[]; };
 uniform samplerCube prefilterMap;
 uniform sampler2D brdfLUT;
 
 // Lighting
 uniform ivec4 numDirPointSpotLights;
 uniform DirLight dirLights[MAX_DIR_LIGHTS];
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
-uniform SpotLight spotLights[MAX_SPOT_LIGHTS];
+layout (std430, binding = 0) readonly buffer PointLightBuffer { PointLight pointLights[]; };
+layout (std430, binding = 1) readonly buffer SpotLightBuffer { SpotLight spotLights[]; };
+
+// Light Clusters (each cluster is an offset into lightIndices followed by its point light count and spot light count packed as (point | spot << 16))
+layout (std430, binding = 2) readonly buffer LightClusterBuffer { uvec2 lightClusters[]; };
+layout (std430, binding = 3) readonly buffer LightIndexBuffer { uint lightIndices[]; };
+uniform ivec3 clusterGridSize;
+uniform vec2 clusterZParams;
+uniform mat4 clusterView;
+uniform mat4 clusterProjection;
 
 // Shadow Data
-uniform sampler2D dirLightShadowmap;
+uniform sampler2DArray dirLightShadowmap;
 uniform ShadowData dirLightShadowData;
-uniform sampler2D spotLightShadowmap;
-uniform ShadowData spotLightShadowData;
-uniform samplerCube pointLightShadowCubemap;
-uniform ShadowDataPointLight pointLightShadowData;
+uniform sampler2D shadowAtlas;
+layout (std430, binding = 4) readonly buffer ShadowAtlasBuffer { ShadowAtlasTile shadowAtlasTiles[]; };
 
 uniform bool hasDisplacement;
 uniform vec2 minMaxDisplacementSteps;
@@ -144,6 +167,15 @@ uniform float parallaxStrength;
 uniform Material material;
 uniform vec3 viewPos;
 
+// The reduced quality variant (REDUCED_QUALITY defined when the shader is loaded) is used for secondary views like planar water reflections.
+// It skips parallax and normal mapping, biases material sampling towards smaller mips, and only takes a single shadow tap
+#ifdef REDUCED_QUALITY
+uniform float textureLodBias;
+#define SAMPLE_MATERIAL(materialTexture, coords) texture(materialTexture, coords, textureLodBias)
+#else
+#define SAMPLE_MATERIAL(materialTexture, coords) texture(materialTexture, coords)
+#endif
+
 // Light radiance calculations
 vec3 CalculateDirectionalLightRadiance(vec3 albedo, vec3 normal, float metallic, float roughness, vec3 fragToViewNorm, vec3 baseReflectivity);
 vec3 CalculatePointLightRadiance(vec3 albedo, vec3 normal, float metallic, float roughness, vec3 fragToViewNorm, vec3 baseReflectivity);
@@ -158,30 +190,39 @@ vec3 FresnelSchlick(float cosTheta, vec3 baseReflectivity);
 // Other function prototypes
 vec3 UnpackNormal(vec3 textureNormal);
 float CalculateDirLightShadow();
-float CalculateSpotLightShadow();
-float CalculatePointLightShadow(vec3 lightToFrag);
+float CalculateSpotLightShadow(int tileIndex);
+float CalculatePointLightShadow(vec3 lightToFrag, int firstTileIndex);
+float SampleShadowAtlas(ShadowAtlasTile tile, vec2 tileCoords, float compareDepth);
+vec3 EvaluateLightProbeIrradiance(int probeIndex, vec3 normal);
+vec3 BlendLightProbeIrradiance(vec3 normal);
 vec2 ParallaxMapping(vec2 texCoords, vec3 viewDirTangentSpace);
 
 void main() {
 	// Parallax mapping
 	vec2 textureCoordinates = TexCoords;
+#ifndef REDUCED_QUALITY
 	if (hasDisplacement) {
 		vec3 viewDirTangentSpace = normalize(ViewPosTangentSpace - FragPosTangentSpace);
 		textureCoordinates = ParallaxMapping(TexCoords, viewDirTangentSpace);
 	}
+#endif
 
 	// Sample textures
-	vec4 sampledAlbedo = material.hasAlbedoTexture ? texture(material.texture_albedo, textureCoordinates).rgba * material.albedoColour : material.albedoColour;
+	vec4 sampledAlbedo = material.hasAlbedoTexture ? SAMPLE_MATERIAL(material.texture_albedo, textureCoordinates).rgba * material.albedoColour : material.albedoColour;
 	vec3 albedo = sampledAlbedo.rgb;
 	float albedoAlpha = sampledAlbedo.w;
-	vec3 normal = texture(material.texture_normal, textureCoordinates).rgb;
-	float metallic = material.hasMetallicTexture ? texture(material.texture_metallic, textureCoordinates).r : material.metallicValue;
-	float unclampedRoughness = material.hasRoughnessTexture ? texture(material.texture_roughness, textureCoordinates).r : material.roughnessValue; // Used for indirect specular (reflections)
+	vec3 normal = SAMPLE_MATERIAL(material.texture_normal, textureCoordinates).rgb;
+	float metallic = material.hasMetallicTexture ? SAMPLE_MATERIAL(material.texture_metallic, textureCoordinates).r : material.metallicValue;
+	float unclampedRoughness = material.hasRoughnessTexture ? SAMPLE_MATERIAL(material.texture_roughness, textureCoordinates).r : material.roughnessValue; // Used for indirect specular (reflections)
 	float roughness = max(unclampedRoughness, 0.04); // Used for calculations since specular highlights will be too fine, and will cause flicker
-	float ao = texture(material.texture_ao, textureCoordinates).r;
+	float ao = SAMPLE_MATERIAL(material.texture_ao, textureCoordinates).r;
 
 	// Normal mapping code. Opted out of tangent space normal mapping since I would have to convert all of my lights to tangent space
+#ifdef REDUCED_QUALITY
+	normal = normalize(TBN[2]);
+#else
 	normal = normalize(TBN * UnpackNormal(normal));
+#endif
 	
 	vec3 fragToViewNorm = normalize(viewPos - FragPos);
 	vec3 reflectionVec = reflect(-fragToViewNorm, normal);
@@ -203,7 +244,7 @@ void main() {
 		vec3 diffuseRatio = vec3(1.0) - specularRatio;
 		diffuseRatio *= 1.0 - metallic;
 
-		vec3 indirectDiffuse = texture(irradianceMap, normal).rgb * albedo * diffuseRatio;
+		vec3 indirectDiffuse = BlendLightProbeIrradiance(normal) * albedo * diffuseRatio;
 
 		vec3 prefilterColour = textureLod(prefilterMap, reflectionVec, unclampedRoughness * (reflectionProbeMipCount - 1)).rgb;
 		vec2 brdfIntegration = texture(brdfLUT, vec2(max(dot(normal, fragToViewNorm), 0.0), roughness)).rg;
@@ -241,7 +282,7 @@ vec3 CalculateDirectionalLightRadiance(vec3 albedo, vec3 normal, float metallic,
 		// Also calculate the diffuse, a lambertian calculation will be added onto the final radiance calculation
 		vec3 diffuse = diffuseRatio * albedo / PI;
 
-		// Calculate shadows, but first check to make sure the current light index is the shadow caster
+		// Calculate shadows, lights without a tile in the shadow atlas return no shadow
 		float shadowAmount = 0.0f;
 		if (i == dirLightShadowData.lightShadowIndex)
 			shadowAmount = CalculateDirLightShadow();
@@ -254,10 +295,25 @@ vec3 CalculateDirectionalLightRadiance(vec3 albedo, vec3 normal, float metallic,
 }
 
 
+// Finds the cluster a world space position falls in, so only the lights overlapping that cluster need to be iterated
+uint GetLightClusterIndex(vec3 worldPos) {
+	vec4 viewSpacePos = clusterView * vec4(worldPos, 1.0);
+	vec4 clipSpacePos = clusterProjection * viewSpacePos;
+	vec2 screenUV = clamp((clipSpacePos.xy / clipSpacePos.w) * 0.5 + 0.5, 0.0, 0.9999);
+
+	int slice = clamp(int(log(max(-viewSpacePos.z, 0.0001)) * clusterZParams.x - clusterZParams.y), 0, clusterGridSize.z - 1);
+	ivec2 tile = ivec2(screenUV * vec2(clusterGridSize.xy));
+	return uint(tile.x + tile.y * clusterGridSize.x + slice * clusterGridSize.x * clusterGridSize.y);
+}
+
+
 vec3 CalculatePointLightRadiance(vec3 albedo, vec3 normal, float metallic, float roughness, vec3 fragToViewNorm, vec3 baseReflectivity) {
 	vec3 pointLightIrradiance = vec3(0.0);
 
-	for (int i = 0; i < numDirPointSpotLights.y; ++i) {
+	uvec2 lightCluster = lightClusters[GetLightClusterIndex(FragPos)];
+	uint clusterPointLightCount = lightCluster.y & 0xFFFFu;
+	for (uint clusterLight = 0; clusterLight < clusterPointLightCount; ++clusterLight) {
+		int i = int(lightIndices[lightCluster.x + clusterLight]);
 		vec3 fragToLightNorm = normalize(pointLights[i].position - FragPos);
 		vec3 halfwayNorm = normalize(fragToViewNorm + fragToLightNorm);
 		vec3 lightToFrag = FragPos - pointLights[i].position;
@@ -289,10 +345,8 @@ vec3 CalculatePointLightRadiance(vec3 albedo, vec3 normal, float metallic, float
 		// Also calculate the diffuse, a lambertian calculation will be added onto the final radiance calculation
 		vec3 diffuse = diffuseRatio * albedo / PI;
 
-		// Calculate shadows, but first check to make sure the current light index is the shadow caster
-		float shadowAmount = 0.0f;
-		if (i == pointLightShadowData.lightShadowIndex)
-			shadowAmount = CalculatePointLightShadow(lightToFrag);
+		// Calculate shadows, lights without a tile in the shadow atlas return no shadow
+		float shadowAmount = CalculatePointLightShadow(lightToFrag, pointLights[i].shadowAtlasTileIndex);
 
 		// Add the light's radiance to the irradiance sum
 		pointLightIrradiance += (diffuse + specular) * radiance * max(dot(normal, fragToLightNorm), 0.0) * (1.0 - shadowAmount);
@@ -305,7 +359,11 @@ vec3 CalculatePointLightRadiance(vec3 albedo, vec3 normal, float metallic, float
 vec3 CalculateSpotLightRadiance(vec3 albedo, vec3 normal, float metallic, float roughness, vec3 fragToViewNorm, vec3 baseReflectivity) {
 	vec3 spotLightIrradiance = vec3(0.0);
 
-	for (int i = 0; i < numDirPointSpotLights.z; ++i) {
+	uvec2 lightCluster = lightClusters[GetLightClusterIndex(FragPos)];
+	uint clusterPointLightCount = lightCluster.y & 0xFFFFu;
+	uint clusterSpotLightCount = lightCluster.y >> 16;
+	for (uint clusterLight = 0; clusterLight < clusterSpotLightCount; ++clusterLight) {
+		int i = int(lightIndices[lightCluster.x + clusterPointLightCount + clusterLight]);
 		vec3 fragToLightNorm = normalize(spotLights[i].position - FragPos);
 		vec3 halfwayNorm = normalize(fragToViewNorm + fragToLightNorm);
 		float fragToLightDistance = length(spotLights[i].position - FragPos);
@@ -341,10 +399,8 @@ vec3 CalculateSpotLightRadiance(vec3 albedo, vec3 normal, float metallic, float
 		// Also calculate the diffuse, a lambertian calculation will be added onto the final radiance calculation
 		vec3 diffuse = diffuseRatio * albedo / PI;
 
-		// Calculate shadows, but first check to make sure the current light index is the shadow caster
-		float shadowAmount = 0.0f;
-		if (i == spotLightShadowData.lightShadowIndex)
-			shadowAmount = CalculateSpotLightShadow();
+		// Calculate shadows, lights without a tile in the shadow atlas return no shadow
+		float shadowAmount = CalculateSpotLightShadow(spotLights[i].shadowAtlasTileIndex);
 
 		// Add the light's radiance to the irradiance sum
 		spotLightIrradiance += (diffuse + specular) * radiance * max(dot(normal, fragToLightNorm), 0.0) * (1.0 - shadowAmount);
@@ -402,33 +458,46 @@ float CalculateDirLightShadow() {
 	if (dirLightShadowData.lightShadowIndex == -1)
 		return 0.0;
 
-	vec4 fragPosLightClipSpace = dirLightShadowData.lightSpaceViewProjectionMatrix * vec4(FragPos, 1.0);
-	vec3 ndcCoords = fragPosLightClipSpace.xyz / fragPosLightClipSpace.w;
-	vec3 depthmapCoords = ndcCoords * 0.5 + 0.5;
-
-	float currentDepth = depthmapCoords.z;
-	if (currentDepth > 1.0)
-		return 0.0;
-
-	// Perform Percentage Closer Filtering (PCF) in order to produce soft shadows - Use bilinear filtering to get some free samples (4 bilinear samples, 4 samples -> 16 values actually processed)
-	float shadow = 0.0;
-	vec2 texelSize = 1.0 / textureSize(dirLightShadowmap, 0);
-	for (float y = -1.5; y < 1.0; y += 2.0) {
-		for (float x = -1.5; x < 1.0; x += 2.0) {
-			float sampledDepthPCF = texture(dirLightShadowmap, depthmapCoords.xy + (texelSize * vec2(x, y))).r;
-			shadow += currentDepth > sampledDepthPCF + dirLightShadowData.shadowBias ? 1.0 : 0.0; // Add shadow bias to avoid shadow acne. However too much bias can cause peter panning
+	// Cascades are ordered from closest to furthest, so use the first cascade that contains the fragment (leaving room on the edges for the PCF samples)
+	vec2 texelSize = 1.0 / textureSize(dirLightShadowmap, 0).xy;
+	for (int cascade = 0; cascade < dirLightShadowData.cascadeCount; cascade++) {
+		vec4 fragPosLightClipSpace = dirLightShadowData.lightSpaceViewProjectionMatrices[cascade] * vec4(FragPos, 1.0);
+		vec3 ndcCoords = fragPosLightClipSpace.xyz / fragPosLightClipSpace.w;
+		vec3 depthmapCoords = ndcCoords * 0.5 + 0.5;
+		if (any(lessThan(depthmapCoords.xy, texelSize * 2.0)) || any(greaterThan(depthmapCoords.xy, 1.0 - (texelSize * 2.0))))
+			continue;
+
+		float currentDepth = depthmapCoords.z;
+		if (currentDepth > 1.0)
+			return 0.0;
+
+#ifdef REDUCED_QUALITY
+		return currentDepth > texture(dirLightShadowmap, vec3(depthmapCoords.xy, cascade)).r + dirLightShadowData.cascadeShadowBiases[cascade] ? 1.0 : 0.0;
+#else
+		// Perform Percentage Closer Filtering (PCF) in order to produce soft shadows - Use bilinear filtering to get some free samples (4 bilinear samples, 4 samples -> 16 values actually processed)
+		float shadow = 0.0;
+		for (float y = -1.5; y < 1.0; y += 2.0) {
+			for (float x = -1.5; x < 1.0; x += 2.0) {
+				float sampledDepthPCF = texture(dirLightShadowmap, vec3(depthmapCoords.xy + (texelSize * vec2(x, y)), cascade)).r;
+				shadow += currentDepth > sampledDepthPCF + dirLightShadowData.cascadeShadowBiases[cascade] ? 1.0 : 0.0; // Add shadow bias to avoid shadow acne. However too much bias can cause peter panning
+			}
 		}
+		shadow *= 0.25;
+
+		return shadow;
+#endif
 	}
-	shadow *= 0.25;
 
-	return shadow;
+	// Past the furthest cascade
+	return 0.0;
 }
 
-float CalculateSpotLightShadow() {
-	if (spotLightShadowData.lightShadowIndex == -1)
+float CalculateSpotLightShadow(int tileIndex) {
+	if (tileIndex == -1)
 		return 0.0;
 
-	vec4 fragPosLightClipSpace = spotLightShadowData.lightSpaceViewProjectionMatrix * vec4(FragPos, 1.0);
+	ShadowAtlasTile tile = shadowAtlasTiles[tileIndex];
+	vec4 fragPosLightClipSpace = tile.lightSpaceViewProjectionMatrix * vec4(FragPos, 1.0);
 	vec3 ndcCoords = fragPosLightClipSpace.xyz / fragPosLightClipSpace.w;
 	vec3 depthmapCoords = ndcCoords * 0.5 + 0.5;
 
@@ -436,50 +505,56 @@ float CalculateSpotLightShadow() {
 	if (currentDepth > 1.0)
 		return 0.0;
 
-	// Perform Percentage Closer Filtering (PCF) in order to produce soft shadows - Use bilinear filtering to get some free samples (4 bilinear samples, 4 samples -> 16 values actually processed)
-	float shadow = 0.0;
-	vec2 texelSize = 1.0 / textureSize(spotLightShadowmap, 0);
-	for (float y = -1.5; y < 1.0; y += 2.0) {
-		for (float x = -1.5; x < 1.0; x += 2.0) {
-			float sampledDepthPCF = texture(spotLightShadowmap, depthmapCoords.xy + (texelSize * vec2(x, y))).r;
-			shadow += currentDepth > sampledDepthPCF + spotLightShadowData.shadowBias ? 1.0 : 0.0; // Add shadow bias to avoid shadow acne. However too much bias can cause peter panning
-		}
-	}
-	shadow *= 0.25;
-
-	return shadow;
+	return SampleShadowAtlas(tile, depthmapCoords.xy, currentDepth - tile.shadowBias); // Add shadow bias to avoid shadow acne. However too much bias can cause peter panning
 }
 
-vec3 sampleOffsetDirections[20] = vec3[]
-(
-	vec3( 1,  1,  1), vec3( 1, -1,  1), vec3(-1, -1,  1), vec3(-1,  1,  1), 
-	vec3( 1,  1, -1), vec3( 1, -1, -1), vec3(-1, -1, -1), vec3(-1,  1, -1),
-	vec3( 1,  1,  0), vec3( 1, -1,  0), vec3(-1, -1,  0), vec3(-1,  1,  0),
-	vec3( 1,  0,  1), vec3(-1,  0,  1), vec3( 1,  0, -1), vec3(-1,  0, -1),
-	vec3( 0,  1,  1), vec3( 0, -1,  1), vec3( 0, -1, -1), vec3( 0,  1, -1)
-);
-
-float CalculatePointLightShadow(vec3 lightToFrag) {
-	if (pointLightShadowData.lightShadowIndex == -1)
+float CalculatePointLightShadow(vec3 lightToFrag, int firstTileIndex) {
+	if (firstTileIndex == -1)
 		return 0.0;
 
+	// Find the cube face the fragment lies in (same face order as a cubemap), each face has it's own tile in the atlas
+	vec3 absLightToFrag = abs(lightToFrag);
+	int faceIndex;
+	if (absLightToFrag.x >= absLightToFrag.y && absLightToFrag.x >= absLightToFrag.z)
+		faceIndex = lightToFrag.x > 0.0 ? 0 : 1;
+	else if (absLightToFrag.y >= absLightToFrag.z)
+		faceIndex = lightToFrag.y > 0.0 ? 2 : 3;
+	else
+		faceIndex = lightToFrag.z > 0.0 ? 4 : 5;
+	ShadowAtlasTile tile = shadowAtlasTiles[firstTileIndex + faceIndex];
+
 	float currentDepth = length(lightToFrag);
-	if (currentDepth > pointLightShadowData.farPlane)
+	if (currentDepth > tile.farPlane)
 		return 0.0;
 
+	vec4 fragPosLightClipSpace = tile.lightSpaceViewProjectionMatrix * vec4(FragPos, 1.0);
+	vec2 tileCoords = (fragPosLightClipSpace.xy / fragPosLightClipSpace.w) * 0.5 + 0.5;
+
+	return SampleShadowAtlas(tile, tileCoords, (currentDepth - tile.shadowBias) / tile.farPlane); // Point lights store linear depth in the [0, 1] range
+}
+
+// Perform Percentage Closer Filtering (PCF) in order to produce soft shadows - Use bilinear filtering to get some free samples (4 bilinear samples, 4 samples -> 16 values actually processed)
+// Samples are clamped to the tile so neighbouring tiles in the atlas never bleed in
+float SampleShadowAtlas(ShadowAtlasTile tile, vec2 tileCoords, float compareDepth) {
+	vec2 texelSize = 1.0 / textureSize(shadowAtlas, 0);
+	vec2 atlasCoords = tileCoords * tile.atlasScaleBias.xy + tile.atlasScaleBias.zw;
+	vec2 tileMin = tile.atlasScaleBias.zw + texelSize;
+	vec2 tileMax = tile.atlasScaleBias.zw + tile.atlasScaleBias.xy - texelSize;
+
+#ifdef REDUCED_QUALITY
+	return compareDepth > texture(shadowAtlas, clamp(atlasCoords, tileMin, tileMax)).r ? 1.0 : 0.0;
+#else
 	float shadow = 0.0;
-	float samples = 20;
-	float diskRadius = 0.05;
-	for (int i = 0; i < samples; i++)
-	{
-		float closestDepth = texture(pointLightShadowCubemap, lightToFrag + sampleOffsetDirections[i] * diskRadius).r;
-		closestDepth *= pointLightShadowData.farPlane; // undo the [0,1] mapping
-		if (currentDepth - pointLightShadowData.shadowBias > closestDepth)
-			shadow += 1.0;
+	for (float y = -1.5; y < 1.0; y += 2.0) {
+		for (float x = -1.5; x < 1.0; x += 2.0) {
+			float sampledDepthPCF = texture(shadowAtlas, clamp(atlasCoords + (texelSize * vec2(x, y)), tileMin, tileMax)).r;
+			shadow += compareDepth > sampledDepthPCF ? 1.0 : 0.0;
+		}
 	}
-	shadow /= float(samples);
+	shadow *= 0.25;
 
 	return shadow;
+#endif
 }
 
 vec2 ParallaxMapping(vec2 texCoords, vec3 viewDirTangentSpace) {
@@ -519,3 +594,28 @@ vec2 ParallaxMapping(vec2 texCoords, vec3 viewDirTangentSpace) {
 
 	return finalTexCoords;
 }
+
+// Evaluates the probe's spherical harmonics in the direction of the normal, the L2 basis constants must match the CPU projection
+vec3 EvaluateLightProbeIrradiance(int probeIndex, vec3 normal) {
+	LightProbe probe = lightProbes[probeIndex];
+	vec3 irradiance = probe.shCoefficients[0].rgb * 0.282095;
+	irradiance += probe.shCoefficients[1].rgb * 0.488603 * normal.y;
+	irradiance += probe.shCoefficients[2].rgb * 0.488603 * normal.z;
+	irradiance += probe.shCoefficients[3].rgb * 0.488603 * normal.x;
+	irradiance += probe.shCoefficients[4].rgb * 1.092548 * normal.x * normal.y;
+	irradiance += probe.shCoefficients[5].rgb * 1.092548 * normal.y * normal.z;
+	irradiance += probe.shCoefficients[6].rgb * 0.315392 * (3.0 * normal.z * normal.z - 1.0);
+	irradiance += probe.shCoefficients[7].rgb * 1.092548 * normal.x * normal.z;
+	irradiance += probe.shCoefficients[8].rgb * 0.546274 * (normal.x * normal.x - normal.y * normal.y);
+	return max(irradiance, vec3(0.0)); // Ringing can push the reconstruction slightly negative
+}
+
+vec3 BlendLightProbeIrradiance(vec3 normal) {
+	vec3 irradiance = vec3(0.0);
+	for (int i = 0; i < 4; i++) {
+		if (lightProbeWeights[i] > 0.0) {
+			irradiance += EvaluateLightProbeIrradiance(lightProbeIndices[i], normal) * lightProbeWeights[i];
+		}
+	}
+	return irradiance;
+}
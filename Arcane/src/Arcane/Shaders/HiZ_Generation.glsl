@@ -0,0 +1,49 @@
+/*
+	Builds one mip of the hierarchical depth pyramid. Every texel stores the closest (r) and furthest (g) depth of the texels it covers in the mip above it
+*/
+
+#shader-type vertex
+#version 430 core
+
+layout (location = 0) in vec3 position;
+
+void main() {
+	gl_Position = vec4(position, 1.0);
+}
+
+
+
+
+#shader-type fragment
+#version 430 core
+
+out vec2 FragColour;
+
+uniform sampler2D sourceTexture; // Depth buffer for the base mip, otherwise the pyramid with only the previous mip visible
+uniform bool sourceIsDepth;
+uniform ivec2 sourceSize; // Part of the previous mip that was built, smaller than the mip when rendering below the render resolution
+
+void main() {
+	ivec2 texel = ivec2(gl_FragCoord.xy);
+	if (sourceIsDepth) {
+		float depth = texelFetch(sourceTexture, texel, 0).r;
+		FragColour = vec2(depth, depth);
+		return;
+	}
+
+	// If the previous mip has an odd size the last row/column of this mip also has to cover the extra texel, otherwise it would be missed by every texel
+	ivec2 sourceTexel = texel * 2;
+	ivec2 footprint = ivec2(2, 2);
+	if ((sourceSize.x & 1) != 0 && sourceTexel.x + 3 == sourceSize.x) footprint.x = 3;
+	if ((sourceSize.y & 1) != 0 && sourceTexel.y + 3 == sourceSize.y) footprint.y = 3;
+
+	vec2 minMaxDepth = vec2(1.0, 0.0);
+	for (int y = 0; y < footprint.y; y++) {
+		for (int x = 0; x < footprint.x; x++) {
+			vec2 sampledDepth = texelFetch(sourceTexture, min(sourceTexel + ivec2(x, y), sourceSize - 1), 0).rg;
+			minMaxDepth.x = min(minMaxDepth.x, sampledDepth.x);
+			minMaxDepth.y = max(minMaxDepth.y, sampledDepth.y);
+		}
+	}
+	FragColour = minMaxDepth;
+}
@@ -0,0 +1,87 @@
+/*
+	Dual filter bloom downsample. Each texel is a 13 tap filter of the mip above it (five overlapping 2x2 boxes using bilinear taps), which avoids the flickering a plain box downsample has.
+	The first downsample from the scene also applies the threshold and weights the boxes by their brightness (Karis average) so single very bright pixels don't create fireflies
+*/
+
+#shader-type vertex
+#version 430 core
+
+layout (location = 0) in vec3 position;
+layout (location = 2) in vec2 texCoord;
+
+out vec2 TexCoords;
+
+void main() {
+	gl_Position = vec4(position, 1.0);
+	TexCoords = texCoord;
+}
+
+
+
+
+#shader-type fragment
+#version 430 core
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D source_texture;
+
+uniform bool isFirstDownsample;
+uniform float threshold;
+uniform float soft_knee;
+
+// Other function prototypes
+vec3 BoxWeighted(vec3 a, vec3 b, vec3 c, vec3 d, inout float totalWeight, float boxWeight);
+vec3 Threshold(vec3 colour);
+
+void main() {
+	vec2 texelSize = 1.0 / vec2(textureSize(source_texture, 0));
+
+	vec3 a = texture(source_texture, TexCoords + texelSize * vec2(-2.0, -2.0)).rgb;
+	vec3 b = texture(source_texture, TexCoords + texelSize * vec2( 0.0, -2.0)).rgb;
+	vec3 c = texture(source_texture, TexCoords + texelSize * vec2( 2.0, -2.0)).rgb;
+	vec3 d = texture(source_texture, TexCoords + texelSize * vec2(-1.0, -1.0)).rgb;
+	vec3 e = texture(source_texture, TexCoords + texelSize * vec2( 1.0, -1.0)).rgb;
+	vec3 f = texture(source_texture, TexCoords + texelSize * vec2(-2.0,  0.0)).rgb;
+	vec3 g = texture(source_texture, TexCoords).rgb;
+	vec3 h = texture(source_texture, TexCoords + texelSize * vec2( 2.0,  0.0)).rgb;
+	vec3 i = texture(source_texture, TexCoords + texelSize * vec2(-1.0,  1.0)).rgb;
+	vec3 j = texture(source_texture, TexCoords + texelSize * vec2( 1.0,  1.0)).rgb;
+	vec3 k = texture(source_texture, TexCoords + texelSize * vec2(-2.0,  2.0)).rgb;
+	vec3 l = texture(source_texture, TexCoords + texelSize * vec2( 0.0,  2.0)).rgb;
+	vec3 m = texture(source_texture, TexCoords + texelSize * vec2( 2.0,  2.0)).rgb;
+
+	// The centre box covers the texel's own footprint so it gets half of the weight, the four corner boxes share the rest
+	float totalWeight = 0.0;
+	vec3 result = BoxWeighted(d, e, i, j, totalWeight, 0.5);
+	result += BoxWeighted(a, b, f, g, totalWeight, 0.125);
+	result += BoxWeighted(b, c, g, h, totalWeight, 0.125);
+	result += BoxWeighted(f, g, k, l, totalWeight, 0.125);
+	result += BoxWeighted(g, h, l, m, totalWeight, 0.125);
+	result /= totalWeight;
+
+	if (isFirstDownsample) {
+		result = Threshold(result);
+	}
+	FragColour = vec4(result, 1.0);
+}
+
+vec3 BoxWeighted(vec3 a, vec3 b, vec3 c, vec3 d, inout float totalWeight, float boxWeight) {
+	vec3 box = (a + b + c + d) * 0.25;
+	if (isFirstDownsample) {
+		boxWeight /= 1.0 + dot(box, vec3(0.2126, 0.7152, 0.0722));
+	}
+	totalWeight += boxWeight;
+	return box * boxWeight;
+}
+
+// Quadratic curve around the threshold so bloom fades in instead of popping
+vec3 Threshold(vec3 colour) {
+	float brightness = max(colour.r, max(colour.g, colour.b));
+	float soft = clamp(brightness - threshold + soft_knee, 0.0, 2.0 * soft_knee);
+	soft = (soft * soft) / (4.0 * soft_knee + 0.00001);
+	float contribution = max(soft, brightness - threshold) / max(brightness, 0.00001);
+	return colour * contribution;
+}
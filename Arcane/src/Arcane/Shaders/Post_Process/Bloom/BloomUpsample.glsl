@@ -0,0 +1,45 @@
+/*
+	Dual filter bloom upsample. A 3x3 tent filter of the lower mip is additively blended over the mip it is upsampled into (which still holds that mip's downsample),
+	so every mip's blur is accumulated on the way back up the chain
+*/
+
+#shader-type vertex
+#version 430 core
+
+layout (location = 0) in vec3 position;
+layout (location = 2) in vec2 texCoord;
+
+out vec2 TexCoords;
+
+void main() {
+	gl_Position = vec4(position, 1.0);
+	TexCoords = texCoord;
+}
+
+
+
+
+#shader-type fragment
+#version 430 core
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D source_texture;
+
+void main() {
+	vec2 texelSize = 1.0 / vec2(textureSize(source_texture, 0));
+
+	vec3 result = texture(source_texture, TexCoords).rgb * 4.0;
+	result += texture(source_texture, TexCoords + texelSize * vec2(-1.0,  0.0)).rgb * 2.0;
+	result += texture(source_texture, TexCoords + texelSize * vec2( 1.0,  0.0)).rgb * 2.0;
+	result += texture(source_texture, TexCoords + texelSize * vec2( 0.0, -1.0)).rgb * 2.0;
+	result += texture(source_texture, TexCoords + texelSize * vec2( 0.0,  1.0)).rgb * 2.0;
+	result += texture(source_texture, TexCoords + texelSize * vec2(-1.0, -1.0)).rgb;
+	result += texture(source_texture, TexCoords + texelSize * vec2( 1.0, -1.0)).rgb;
+	result += texture(source_texture, TexCoords + texelSize * vec2(-1.0,  1.0)).rgb;
+	result += texture(source_texture, TexCoords + texelSize * vec2( 1.0,  1.0)).rgb;
+
+	FragColour = vec4(result * (1.0 / 16.0), 1.0);
+}
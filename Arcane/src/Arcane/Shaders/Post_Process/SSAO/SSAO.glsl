@@ -1,5 +1,7 @@
 /*
 	Deferred SSAO Generation. It tiles a 4x4 texture accross the screen, in order to elimate banding but then it will introduce high frequency noise that can be blurred
+	With temporal accumulation only every sampleStride'th sample of the kernel is taken (starting at sampleOffset) and the noise is rotated every frame, so the accumulated result covers the whole kernel
+	Outputs the unstrengthened AO in r and the view space depth in g, so the accumulation and upsample can tell surfaces apart
 */
 
 #shader-type vertex
@@ -24,20 +26,29 @@ void main()
 
 in vec2 TexCoords;
 
-out float FragColour;
+out vec4 FragColour;
 
-uniform sampler2D normalTexture;
+uniform sampler2D normalTexture; // Octahedral encoded
 uniform sampler2D depthTexture;
 uniform sampler2D texNoise;
 
 // tile noise texture over screen based on screen dimensions divided by noise size
 uniform vec2 noiseScale;
 
-uniform float ssaoStrength;
+uniform vec2 noiseRotation; // cos and sin of the angle the noise is rotated by this frame
+
+uniform float renderScale; // Fraction of the GBuffer rendered to this frame (dynamic resolution)
+
 uniform float sampleRadius;
 uniform float sampleRadius2;
 uniform int numKernelSamples;
-uniform vec3 samples[64];
+uniform int sampleOffset;
+uniform int sampleStride;
+
+// Generated once, only xyz is used (std140 pads every array element to a vec4)
+layout (std140, binding = 0) uniform SsaoKernel {
+	vec4 samples[64];
+};
 
 uniform mat4 view;
 uniform mat4 projection;
@@ -46,17 +57,19 @@ uniform mat4 projectionInverse;
 
 // Other function prototypes
 vec3 WorldPosFromDepth(vec2 textureCoordinates);
+vec3 DecodeNormal(vec2 encoded);
 
 void main() {
-	// Early out if there is no data in the GBuffer at this particular sample
-	vec3 normal = texture(normalTexture, TexCoords).xyz;
-	if (normal == vec3(0.0, 0.0, 0.0)) {
-		FragColour = 1.0;
+	// Early out if there is no data in the GBuffer at this particular sample (the encoded normal can't be empty, so the depth is used)
+	if (texture(depthTexture, TexCoords * renderScale).r >= 1.0) {
+		FragColour = vec4(1.0, 0.0, 0.0, 0.0);
 		return;
 	}
+	vec3 normal = DecodeNormal(texture(normalTexture, TexCoords * renderScale).rg);
 
 	vec3 fragPos = WorldPosFromDepth(TexCoords);
 	vec3 randomVec = texture(texNoise, TexCoords * noiseScale).xyz;
+	randomVec.xy = vec2(randomVec.x * noiseRotation.x - randomVec.y * noiseRotation.y, randomVec.x * noiseRotation.y + randomVec.y * noiseRotation.x);
 
 	// Make a TBN matrix to go from tangent -> world space (so we can put our hemipshere tangent sample points into world space)
 	// Since our normal is already in world space, this TBN matrix will take our tangent space vector and put it into world space
@@ -67,7 +80,7 @@ void main() {
 	// Calculate the total amount of occlusion for this fragment
 	float occlusion = 0.0f;
 	for (int i = 0; i < numKernelSamples; ++i) {
-		vec3 sampleWorld = (TBN * samples[i]) * sampleRadius;
+		vec3 sampleWorld = (TBN * samples[sampleOffset + i * sampleStride].xyz) * sampleRadius;
 		sampleWorld = fragPos + sampleWorld;
 
 		// Take our sample position in world space and convert it to screen coordinates
@@ -77,7 +90,7 @@ void main() {
 		sampleScreenSpace.xyz = (sampleScreenSpace.xyz * 0.5) + 0.5; // [-1, 1] -> [0, 1]
 
 		// Check if our current samples depth is behind the screen space geometry's depth, if so then we know it is occluded in screenspace
-		float sceneDepth = texture(depthTexture, sampleScreenSpace.xy).r;
+		float sceneDepth = texture(depthTexture, clamp(sampleScreenSpace.xy, 0.0, 1.0) * renderScale).r;
 
 		// Peform a range check on the current fragment we are calculating the occlusion factor for, and the occlusion position
 		vec3 occlusionPos = WorldPosFromDepth(sampleScreenSpace.xy);
@@ -89,11 +102,12 @@ void main() {
 	// Finally we need to normalize our occlusion factor
 	occlusion = 1.0 - (occlusion / numKernelSamples);
 
-	FragColour = pow(occlusion, ssaoStrength);
+	float viewDepth = -(view * vec4(fragPos, 1.0)).z;
+	FragColour = vec4(occlusion, viewDepth, 0.0, 0.0);
 }
 
 vec3 WorldPosFromDepth(vec2 textureCoordinates) {
-	float z = 2.0 * texture(depthTexture, textureCoordinates).r - 1.0; // [-1, 1]
+	float z = 2.0 * texture(depthTexture, clamp(textureCoordinates, 0.0, 1.0) * renderScale).r - 1.0; // [-1, 1]
 	vec4 clipSpacePos = vec4(textureCoordinates * 2.0 - 1.0 , z, 1.0);
 	vec4 viewSpacePos = projectionInverse * clipSpacePos;
 
@@ -103,3 +117,12 @@ vec3 WorldPosFromDepth(vec2 textureCoordinates) {
 
 	return worldSpacePos.xyz;
 }
+
+// Inverse of the geometry pass' octahedral encoding
+vec3 DecodeNormal(vec2 encoded) {
+	encoded = encoded * 2.0 - 1.0;
+	vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float fold = clamp(-normal.z, 0.0, 1.0);
+	normal.xy += vec2(normal.x >= 0.0 ? -fold : fold, normal.y >= 0.0 ? -fold : fold);
+	return normalize(normal);
+}
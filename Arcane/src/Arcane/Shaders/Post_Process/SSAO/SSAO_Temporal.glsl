@@ -0,0 +1,84 @@
+/*
+	Accumulates the AO over multiple frames. The accumulated AO is reprojected with the previous frame's view projection and thrown away if the depth it was accumulated at
+	doesn't match where the surface was last frame, so disoccluded pixels start again from this frame's AO instead of smearing
+*/
+
+#shader-type vertex
+#version 430 core
+
+layout (location = 0) in vec3 position;
+layout (location = 2) in vec2 texCoords;
+
+out vec2 TexCoords;
+
+void main()
+{
+	TexCoords = texCoords;
+	gl_Position = vec4(position, 1.0);
+}
+
+
+
+
+#shader-type fragment
+#version 430 core
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D ssaoInput; // r = AO, g = view space depth (0 if there was nothing in the GBuffer)
+uniform sampler2D ssaoHistory;
+uniform sampler2D depthTexture;
+
+uniform bool historyValid;
+uniform float historyWeight;
+uniform float historyDepthTolerance;
+
+// Fraction of every screen sized texture rendered to this frame and the previous frame (dynamic resolution)
+uniform float renderScale;
+uniform float previousRenderScale;
+
+uniform mat4 viewInverse;
+uniform mat4 projectionInverse;
+uniform mat4 previousViewProjection;
+
+// Other function prototypes
+vec3 WorldPosFromDepth(vec2 textureCoordinates);
+
+void main() {
+	vec2 current = texture(ssaoInput, TexCoords * renderScale).rg;
+	if (current.g == 0.0 || !historyValid) {
+		FragColour = vec4(current, 0.0, 0.0);
+		return;
+	}
+
+	// Find where this surface was on the screen last frame
+	vec4 previousClip = previousViewProjection * vec4(WorldPosFromDepth(TexCoords), 1.0);
+	vec2 previousCoords = (previousClip.xy / previousClip.w) * 0.5 + 0.5;
+	if (previousCoords.x < 0.0 || previousCoords.x > 1.0 || previousCoords.y < 0.0 || previousCoords.y > 1.0) {
+		FragColour = vec4(current, 0.0, 0.0);
+		return;
+	}
+
+	// previousClip.w is the surface's view space depth last frame, if the history was accumulated at a different depth it belongs to another surface
+	vec2 history = texture(ssaoHistory, previousCoords * previousRenderScale).rg;
+	if (abs(history.g - previousClip.w) > previousClip.w * historyDepthTolerance) {
+		FragColour = vec4(current, 0.0, 0.0);
+		return;
+	}
+
+	FragColour = vec4(mix(current.r, history.r, historyWeight), current.g, 0.0, 0.0);
+}
+
+vec3 WorldPosFromDepth(vec2 textureCoordinates) {
+	float z = 2.0 * texture(depthTexture, textureCoordinates * renderScale).r - 1.0; // [-1, 1]
+	vec4 clipSpacePos = vec4(textureCoordinates * 2.0 - 1.0 , z, 1.0);
+	vec4 viewSpacePos = projectionInverse * clipSpacePos;
+
+	viewSpacePos /= viewSpacePos.w; // Perspective division
+
+	vec4 worldSpacePos = viewInverse * viewSpacePos;
+
+	return worldSpacePos.xyz;
+}
@@ -0,0 +1,79 @@
+/*
+	Bilateral upsample of the half resolution AO to full resolution. Each pixel takes a 4x4 neighbourhood of half resolution texels (enough to cover the 4x4 noise tile),
+	weighted by distance and by how close the texel's depth is to the pixel's, so the AO doesn't bleed across depth edges. The strength is applied here
+*/
+
+#shader-type vertex
+#version 430 core
+
+layout (location = 0) in vec3 position;
+layout (location = 2) in vec2 texCoords;
+
+out vec2 TexCoords;
+
+void main()
+{
+	TexCoords = texCoords;
+	gl_Position = vec4(position, 1.0);
+}
+
+
+
+
+#shader-type fragment
+#version 430 core
+
+in vec2 TexCoords;
+
+out float FragColour;
+
+uniform sampler2D ssaoInput; // r = AO, g = view space depth (0 if there was nothing in the GBuffer)
+uniform sampler2D depthTexture;
+
+uniform ivec2 ssaoInputSize; // Part of the half resolution AO that was rendered to this frame
+uniform float renderScale; // Fraction of the GBuffer rendered to this frame (dynamic resolution)
+
+uniform float ssaoStrength;
+uniform mat4 projectionInverse;
+
+void main() {
+	float depth = texture(depthTexture, TexCoords * renderScale).r;
+	if (depth == 1.0) {
+		FragColour = 1.0;
+		return;
+	}
+
+	// Full resolution view space depth
+	vec4 viewSpacePos = projectionInverse * vec4(TexCoords * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+	float viewDepth = -viewSpacePos.z / viewSpacePos.w;
+
+	vec2 inputTexel = TexCoords * vec2(ssaoInputSize) - 0.5;
+	ivec2 baseTexel = ivec2(floor(inputTexel)) - ivec2(1);
+
+	float totalOcclusion = 0.0;
+	float totalWeight = 0.0;
+	float closestDepthDifference = 1e30;
+	float closestOcclusion = 1.0;
+	for (int y = 0; y < 4; ++y) {
+		for (int x = 0; x < 4; ++x) {
+			ivec2 texel = clamp(baseTexel + ivec2(x, y), ivec2(0), ssaoInputSize - 1);
+			vec2 ssao = texelFetch(ssaoInput, texel, 0).rg;
+
+			vec2 offset = vec2(texel) - inputTexel;
+			float depthDifference = abs(ssao.g - viewDepth);
+			float weight = exp(-0.5 * dot(offset, offset)) * exp(-depthDifference / (viewDepth * 0.02));
+
+			totalOcclusion += ssao.r * weight;
+			totalWeight += weight;
+
+			if (depthDifference < closestDepthDifference) {
+				closestDepthDifference = depthDifference;
+				closestOcclusion = ssao.r;
+			}
+		}
+	}
+
+	// If no texel is on the same surface (thin geometry) just use the closest one in depth
+	float occlusion = (totalWeight > 0.0001) ? totalOcclusion / totalWeight : closestOcclusion;
+	FragColour = pow(occlusion, ssaoStrength);
+}
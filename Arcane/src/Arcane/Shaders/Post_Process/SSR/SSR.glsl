@@ -0,0 +1,183 @@
+/*
+	Deferred Screen Space Reflections. The reflected ray is traced against the min/max depth pyramid so it can skip over large empty areas of the screen,
+	the hit is then reprojected into the previous frame's lit scene (this runs before the current frame is lit). Alpha is the confidence of the hit so misses fall back to the reflection probe
+*/
+
+#shader-type vertex
+#version 430 core
+
+layout (location = 0) in vec3 position;
+layout (location = 2) in vec2 texCoords;
+
+out vec2 TexCoords;
+
+void main()
+{
+	TexCoords = texCoords;
+	gl_Position = vec4(position, 1.0);
+}
+
+
+
+
+#shader-type fragment
+#version 430 core
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D normalTexture; // Octahedral encoded
+uniform sampler2D materialInfoTexture;
+uniform sampler2D depthTexture;
+uniform sampler2D hiZBuffer; // r = closest depth, g = furthest depth
+uniform sampler2D previousSceneColour;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform mat4 viewInverse;
+uniform mat4 projectionInverse;
+uniform mat4 previousViewProjection;
+uniform float nearPlane;
+
+uniform int hiZMaxLevel;
+uniform ivec2 hiZBaseSize; // Part of the pyramid's base mip that was built this frame
+
+// Fraction of every screen sized texture that was rendered to this frame and the previous frame (dynamic resolution), screen coordinates are scaled by it before sampling
+uniform float renderScale;
+uniform float previousRenderScale;
+uniform int maxIterations;
+uniform float thickness;
+uniform float maxRoughness;
+
+// Function prototypes
+vec3 ViewPosFromDepth(vec2 textureCoordinates, float depth);
+vec3 ProjectToScreen(vec3 viewPos);
+float LinearizeDepth(float depth);
+bool TraceHiZ(vec3 rayStart, vec3 rayDir, out vec3 hitPoint);
+vec3 IntersectCellBoundary(vec3 rayOrigin, vec3 rayDir, vec2 cell, vec2 cellCount, vec2 crossStep, vec2 crossOffset);
+float ScreenEdgeFade(vec2 screenCoords);
+vec3 DecodeNormal(vec2 encoded);
+
+void main() {
+	FragColour = vec4(0.0, 0.0, 0.0, 0.0);
+
+	// Early out if there is no data in the GBuffer at this particular sample or the surface is too rough for a sharp reflection
+	vec2 gbufferCoords = TexCoords * renderScale;
+	float roughness = texture(materialInfoTexture, gbufferCoords).g;
+	float depth = texture(depthTexture, gbufferCoords).r;
+	if (depth >= 1.0 || roughness >= maxRoughness) {
+		return;
+	}
+	vec3 normal = DecodeNormal(texture(normalTexture, gbufferCoords).rg);
+
+	vec3 viewPos = ViewPosFromDepth(TexCoords, depth);
+	vec3 viewNormal = normalize(mat3(view) * normal);
+	vec3 reflectDir = normalize(reflect(normalize(viewPos), viewNormal));
+
+	// Rays heading towards the camera are shortened so the end point can't be behind the near plane (it couldn't be projected)
+	float rayLength = 1.0;
+	if (viewPos.z + reflectDir.z > -nearPlane) {
+		rayLength = (-nearPlane - viewPos.z) / reflectDir.z * 0.99;
+	}
+	vec3 screenStart = ProjectToScreen(viewPos);
+	vec3 screenEnd = ProjectToScreen(viewPos + reflectDir * rayLength);
+
+	vec3 hitPoint;
+	if (!TraceHiZ(screenStart, screenEnd - screenStart, hitPoint)) {
+		return;
+	}
+
+	// Reproject the hit into the previous frame since that is the last lit version of the scene
+	vec4 hitWorldPos = viewInverse * vec4(ViewPosFromDepth(hitPoint.xy, hitPoint.z), 1.0);
+	vec4 previousClipPos = previousViewProjection * hitWorldPos;
+	vec2 previousCoords = (previousClipPos.xy / previousClipPos.w) * 0.5 + 0.5;
+
+	// Fade out hits near the edge of the screen (the ray would have left the screen soon after) and rays pointing back at the camera (would hit back faces that weren't rendered)
+	float confidence = ScreenEdgeFade(hitPoint.xy) * ScreenEdgeFade(previousCoords);
+	confidence *= 1.0 - clamp(reflectDir.z * 2.0, 0.0, 1.0);
+	confidence *= 1.0 - smoothstep(maxRoughness * 0.5, maxRoughness, roughness);
+
+	FragColour = vec4(texture(previousSceneColour, previousCoords * previousRenderScale).rgb, confidence);
+}
+
+vec3 ViewPosFromDepth(vec2 textureCoordinates, float depth) {
+	vec4 clipSpacePos = vec4(textureCoordinates * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+	vec4 viewSpacePos = projectionInverse * clipSpacePos;
+	return viewSpacePos.xyz / viewSpacePos.w; // Perspective division
+}
+
+// Returns (texture coordinates, depth), depth after the perspective divide is linear in screen space so the ray can be stepped linearly
+vec3 ProjectToScreen(vec3 viewPos) {
+	vec4 clipSpacePos = projection * vec4(viewPos, 1.0);
+	return (clipSpacePos.xyz / clipSpacePos.w) * 0.5 + 0.5;
+}
+
+float LinearizeDepth(float depth) {
+	return projection[3][2] / ((depth * 2.0 - 1.0) + projection[2][2]);
+}
+
+// Walks the ray through the depth pyramid. Cells the ray passes entirely in front of (or too far behind) are stepped over and the trace moves up a mip,
+// otherwise the trace moves down a mip. A hit is found once the trace moves below the base mip
+bool TraceHiZ(vec3 rayStart, vec3 rayDir, out vec3 hitPoint) {
+	if (abs(rayDir.x) < 0.00001) rayDir.x = 0.00001;
+	if (abs(rayDir.y) < 0.00001) rayDir.y = 0.00001;
+	vec2 crossStep = vec2(rayDir.x >= 0.0 ? 1.0 : 0.0, rayDir.y >= 0.0 ? 1.0 : 0.0);
+	vec2 crossOffset = (crossStep * 2.0 - 1.0) * 0.00001; // Nudges the ray over the boundary so it lands in the next cell
+
+	// Step out of the starting texel so the surface doesn't reflect itself
+	vec2 baseCellCount = vec2(hiZBaseSize);
+	vec3 ray = IntersectCellBoundary(rayStart, rayDir, floor(rayStart.xy * baseCellCount), baseCellCount, crossStep, crossOffset);
+
+	int level = 0;
+	int iterations = 0;
+	while (level >= 0 && iterations < maxIterations) {
+		if (any(lessThan(ray.xy, vec2(0.0))) || any(greaterThanEqual(ray.xy, vec2(1.0))) || ray.z <= 0.0 || ray.z >= 1.0) {
+			return false;
+		}
+
+		vec2 cellCount = vec2(max(hiZBaseSize >> level, ivec2(1)));
+		vec2 cell = floor(ray.xy * cellCount);
+		vec2 minMaxDepth = texelFetch(hiZBuffer, ivec2(cell), level).rg;
+
+		// Rays moving away from the camera can jump straight to the closest depth in the cell
+		vec3 tmpRay = ray;
+		if (rayDir.z > 0.0 && ray.z < minMaxDepth.x) {
+			tmpRay = ray + rayDir * ((minMaxDepth.x - ray.z) / rayDir.z);
+		}
+
+		bool inFrontOfCell = tmpRay.z < minMaxDepth.x;
+		bool behindCell = LinearizeDepth(tmpRay.z) > LinearizeDepth(minMaxDepth.y) + thickness;
+		if (floor(tmpRay.xy * cellCount) != cell || inFrontOfCell || behindCell) {
+			tmpRay = IntersectCellBoundary(ray, rayDir, cell, cellCount, crossStep, crossOffset);
+			level = min(hiZMaxLevel, level + 2);
+		}
+
+		ray = tmpRay;
+		level--;
+		iterations++;
+	}
+
+	hitPoint = ray;
+	return level < 0;
+}
+
+vec3 IntersectCellBoundary(vec3 rayOrigin, vec3 rayDir, vec2 cell, vec2 cellCount, vec2 crossStep, vec2 crossOffset) {
+	vec2 boundary = (cell + crossStep) / cellCount + crossOffset;
+	vec2 t = (boundary - rayOrigin.xy) / rayDir.xy;
+	return rayOrigin + rayDir * min(t.x, t.y);
+}
+
+float ScreenEdgeFade(vec2 screenCoords) {
+	vec2 fade = smoothstep(vec2(0.0), vec2(0.1), screenCoords) * (1.0 - smoothstep(vec2(0.9), vec2(1.0), screenCoords));
+	return fade.x * fade.y;
+}
+
+// Inverse of the geometry pass' octahedral encoding
+vec3 DecodeNormal(vec2 encoded) {
+	encoded = encoded * 2.0 - 1.0;
+	vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float fold = clamp(-normal.z, 0.0, 1.0);
+	normal.xy += vec2(normal.x >= 0.0 ? -fold : fold, normal.y >= 0.0 ? -fold : fold);
+	return normalize(normal);
+}
@@ -0,0 +1,123 @@
+/*
+	Temporal anti-aliasing resolve. The history is reprojected with the GBuffer's motion vectors, taken from the closest surface in the 3x3 neighbourhood so the edges of
+	moving objects follow the object instead of the background. The history is then clamped to the colour range of the current neighbourhood so anything that no longer
+	matches the scene (disocclusion, lighting changes) can't ghost. Blending happens on tonemapped colours so a few very bright pixels don't flicker.
+	With dynamic resolution the scene, motion and depth only cover part of their textures while the history is always at the render resolution, so this also upscales
+*/
+
+#shader-type vertex
+#version 430 core
+
+layout (location = 0) in vec3 position;
+layout (location = 2) in vec2 texCoords;
+
+out vec2 TexCoords;
+
+void main()
+{
+	TexCoords = texCoords;
+	gl_Position = vec4(position, 1.0);
+}
+
+
+
+
+#shader-type fragment
+#version 430 core
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D sceneTexture;
+uniform sampler2D historyTexture;
+uniform sampler2D motionTexture; // UV movement since the previous frame
+uniform sampler2D depthTexture;
+
+uniform bool historyValid;
+uniform float historyWeight;
+uniform vec2 texelSize; // Of the scene texture
+uniform float renderScale; // Fraction of the scene, motion and depth textures rendered to this frame
+
+// Both unjittered, only used to reproject pixels that have no geometry and therefore no motion vector
+uniform mat4 viewProjectionInverse;
+uniform mat4 previousViewProjection;
+
+// Other function prototypes
+vec3 Tonemap(vec3 colour);
+vec3 InverseTonemap(vec3 colour);
+vec3 RGBToYCoCg(vec3 colour);
+vec3 YCoCgToRGB(vec3 colour);
+
+void main() {
+	vec2 sceneCoords = TexCoords * renderScale;
+	vec3 current = texture(sceneTexture, sceneCoords).rgb;
+	if (!historyValid) {
+		FragColour = vec4(current, 1.0);
+		return;
+	}
+
+	// Colour bounds of the neighbourhood and the closest surface in it
+	vec3 neighbourhoodMin = vec3(1e30);
+	vec3 neighbourhoodMax = vec3(-1e30);
+	float closestDepth = 1.0;
+	vec2 closestCoords = sceneCoords;
+	for (int y = -1; y <= 1; ++y) {
+		for (int x = -1; x <= 1; ++x) {
+			vec2 sampleCoords = sceneCoords + vec2(x, y) * texelSize;
+			vec3 neighbour = RGBToYCoCg(Tonemap(texture(sceneTexture, sampleCoords).rgb));
+			neighbourhoodMin = min(neighbourhoodMin, neighbour);
+			neighbourhoodMax = max(neighbourhoodMax, neighbour);
+
+			float depth = texture(depthTexture, sampleCoords).r;
+			if (depth < closestDepth) {
+				closestDepth = depth;
+				closestCoords = sampleCoords;
+			}
+		}
+	}
+
+	// Nothing was rendered here (skybox) so only the camera has moved, reproject the point on the far plane
+	vec2 motion;
+	if (closestDepth == 1.0) {
+		vec4 farPlanePos = viewProjectionInverse * vec4(TexCoords * 2.0 - 1.0, 1.0, 1.0);
+		vec4 previousClip = previousViewProjection * vec4(farPlanePos.xyz / farPlanePos.w, 1.0);
+		motion = TexCoords - ((previousClip.xy / previousClip.w) * 0.5 + 0.5);
+	}
+	else {
+		motion = texture(motionTexture, closestCoords).rg;
+	}
+
+	vec2 previousCoords = TexCoords - motion;
+	if (previousCoords.x < 0.0 || previousCoords.x > 1.0 || previousCoords.y < 0.0 || previousCoords.y > 1.0) {
+		FragColour = vec4(current, 1.0);
+		return;
+	}
+
+	vec3 history = RGBToYCoCg(Tonemap(texture(historyTexture, previousCoords).rgb));
+	history = clamp(history, neighbourhoodMin, neighbourhoodMax);
+
+	vec3 resolved = mix(RGBToYCoCg(Tonemap(current)), history, historyWeight);
+	FragColour = vec4(InverseTonemap(YCoCgToRGB(resolved)), 1.0);
+}
+
+// Reversible tonemap, squashes the HDR range without changing the hue
+vec3 Tonemap(vec3 colour) {
+	return colour / (1.0 + max(colour.r, max(colour.g, colour.b)));
+}
+
+vec3 InverseTonemap(vec3 colour) {
+	return colour / max(1.0 - max(colour.r, max(colour.g, colour.b)), 0.0001);
+}
+
+vec3 RGBToYCoCg(vec3 colour) {
+	return vec3(0.25 * colour.r + 0.5 * colour.g + 0.25 * colour.b,
+				0.5 * colour.r - 0.5 * colour.b,
+				-0.25 * colour.r + 0.5 * colour.g - 0.25 * colour.b);
+}
+
+vec3 YCoCgToRGB(vec3 colour) {
+	return vec3(colour.x + colour.y - colour.z,
+				colour.x + colour.z,
+				colour.x - colour.y - colour.z);
+}
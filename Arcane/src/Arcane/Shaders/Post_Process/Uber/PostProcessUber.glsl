@@ -0,0 +1,126 @@
+/*
+	Every post process effect that only needs the pixel it is writing (plus fixed offsets into the scene) done in a single pass, so the frame is only read and written once.
+	Each combination of effects is compiled as a separate variant (BLOOM, CHROMATIC_ABERRATION, FILM_GRAIN, VIGNETTE, VIGNETTE_MASK), disabled effects cost nothing.
+	Effects are applied in the same order they used to be as separate passes: bloom, chromatic aberration, tonemap + gamma correction, film grain then vignette
+*/
+
+#shader-type vertex
+#version 430 core
+
+layout (location = 0) in vec3 position;
+layout (location = 2) in vec2 texCoord;
+
+out vec2 TexCoords;
+
+void main() {
+	gl_Position = vec4(position, 1.0);
+	TexCoords = texCoord;
+}
+
+
+
+
+#shader-type fragment
+#version 430 core
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D input_texture;
+
+uniform float gamma_inverse;
+
+// Written by the auto exposure on the GPU, or uploaded from the CPU when the exposure is set manually
+layout (std430, binding = 6) readonly buffer ExposureBuffer { float adaptedLuminance; float exposure; };
+
+#ifdef BLOOM
+uniform sampler2D bloom_texture; // Top of the bloom chain (half resolution), tent filtered the same way as the rest of the upsamples
+uniform float bloom_strength;
+#endif
+
+#ifdef CHROMATIC_ABERRATION
+uniform float chromatic_aberration_intensity;
+uniform vec2 texel_size;
+#endif
+
+#ifdef FILM_GRAIN
+uniform float film_grain_intensity;
+uniform float time;
+#endif
+
+#ifdef VIGNETTE
+uniform vec3 vignette_colour;
+uniform float vignette_intensity;
+#ifdef VIGNETTE_MASK
+uniform sampler2D vignette_mask;
+#endif
+#endif
+
+// Other function prototypes
+#ifdef BLOOM
+vec3 SampleBloom(vec2 textureCoordinates);
+#endif
+
+void main() {
+	// Sample our HDR scene
+#ifdef CHROMATIC_ABERRATION
+	// Emulated how Unity handles their "fast" implementation
+	vec2 diffFromCenter = TexCoords - vec2(0.5, 0.5);
+	vec2 offset = diffFromCenter * texel_size * chromatic_aberration_intensity;
+	vec3 hdrColour;
+	hdrColour.r = texture(input_texture, TexCoords - (1 * offset)).r;
+	hdrColour.g = texture(input_texture, TexCoords - (2 * offset)).g;
+	hdrColour.b = texture(input_texture, TexCoords - (3 * offset)).b;
+#else
+	vec3 hdrColour = texture(input_texture, TexCoords).rgb;
+#endif
+
+	// Bloom is blurry enough that splitting it's channels wouldn't be noticeable, so it is only sampled once
+#ifdef BLOOM
+	hdrColour += SampleBloom(TexCoords) * bloom_strength;
+#endif
+
+	// Apply a simple exposure tonemap (HDR -> SDR) (dark scenes should have higher exposures, while bright scenes should have lower exposures)
+	vec3 tonemappedColour = vec3(1.0) - exp(exposure * -hdrColour);
+
+	// Apply gamma correction (Linear -> Non-linear(sRGB))
+	vec3 colour = pow(tonemappedColour, vec3(gamma_inverse));
+
+#ifdef FILM_GRAIN
+	float x = (TexCoords.x + 4) * (TexCoords.y + 4) * ((time + 1) * 10.0);
+	vec4 grain = vec4(mod((mod(x, 13.0) + 1.0) * (mod(x, 123.0) + 1.0), 0.01) - 0.005) * film_grain_intensity;
+	colour += grain.xyz;
+#endif
+
+#ifdef VIGNETTE
+#ifdef VIGNETTE_MASK
+	float vignetteOpacity = (1.0 - texture(vignette_mask, TexCoords).r) * vignette_intensity;
+	colour = mix(colour, vignette_colour, vignetteOpacity);
+#else
+	vec2 uv = TexCoords;
+	uv *= 1.0 - TexCoords.xy;
+	float vig = uv.x * uv.y * 15.0;
+	vig = pow(vig, vignette_intensity * 5.0);
+	colour = mix(vignette_colour, colour, vig);
+#endif
+#endif
+
+	FragColour = vec4(colour, 1.0);
+}
+
+#ifdef BLOOM
+vec3 SampleBloom(vec2 textureCoordinates) {
+	vec2 texelSize = 1.0 / vec2(textureSize(bloom_texture, 0));
+	vec3 bloom = texture(bloom_texture, textureCoordinates).rgb * 4.0;
+	bloom += texture(bloom_texture, textureCoordinates + texelSize * vec2(-1.0,  0.0)).rgb * 2.0;
+	bloom += texture(bloom_texture, textureCoordinates + texelSize * vec2( 1.0,  0.0)).rgb * 2.0;
+	bloom += texture(bloom_texture, textureCoordinates + texelSize * vec2( 0.0, -1.0)).rgb * 2.0;
+	bloom += texture(bloom_texture, textureCoordinates + texelSize * vec2( 0.0,  1.0)).rgb * 2.0;
+	bloom += texture(bloom_texture, textureCoordinates + texelSize * vec2(-1.0, -1.0)).rgb;
+	bloom += texture(bloom_texture, textureCoordinates + texelSize * vec2( 1.0, -1.0)).rgb;
+	bloom += texture(bloom_texture, textureCoordinates + texelSize * vec2(-1.0,  1.0)).rgb;
+	bloom += texture(bloom_texture, textureCoordinates + texelSize * vec2( 1.0,  1.0)).rgb;
+	return bloom * (1.0 / 16.0);
+}
+#endif
@@ -0,0 +1,69 @@
+/*
+	Upscales a frame rendered below the render resolution (dynamic resolution) when TAA isn't there to do it. Catmull-Rom is sharper than bilinear,
+	it's 16 taps are folded into 9 bilinear fetches by merging the middle two weights of each axis. Taps are clamped to the part of the texture that was rendered to
+*/
+
+#shader-type vertex
+#version 430 core
+
+layout (location = 0) in vec3 position;
+layout (location = 2) in vec2 texCoords;
+
+out vec2 TexCoords;
+
+void main()
+{
+	TexCoords = texCoords;
+	gl_Position = vec4(position, 1.0);
+}
+
+
+
+
+#shader-type fragment
+#version 430 core
+
+in vec2 TexCoords;
+
+out vec4 FragColour;
+
+uniform sampler2D sceneTexture;
+uniform float renderScale; // Fraction of the scene texture that was rendered to
+
+void main() {
+	vec2 sourceSize = vec2(textureSize(sceneTexture, 0));
+	vec2 texelSize = 1.0 / sourceSize;
+	vec2 minCoords = 0.5 * texelSize;
+	vec2 maxCoords = renderScale - 0.5 * texelSize;
+
+	// Catmull-Rom weights of the 4x4 texels around the sample position
+	vec2 samplePos = TexCoords * renderScale * sourceSize;
+	vec2 texPos1 = floor(samplePos - 0.5) + 0.5;
+	vec2 f = samplePos - texPos1;
+	vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+	vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+	vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+	vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+	// The middle two texels are fetched together, the bilinear filter weights them by how far between them the fetch is
+	vec2 w12 = w1 + w2;
+	vec2 texPos0 = clamp((texPos1 - 1.0) * texelSize, minCoords, maxCoords);
+	vec2 texPos12 = clamp((texPos1 + w2 / w12) * texelSize, minCoords, maxCoords);
+	vec2 texPos3 = clamp((texPos1 + 2.0) * texelSize, minCoords, maxCoords);
+
+	vec3 result = vec3(0.0);
+	result += texture(sceneTexture, vec2(texPos0.x, texPos0.y)).rgb * w0.x * w0.y;
+	result += texture(sceneTexture, vec2(texPos12.x, texPos0.y)).rgb * w12.x * w0.y;
+	result += texture(sceneTexture, vec2(texPos3.x, texPos0.y)).rgb * w3.x * w0.y;
+
+	result += texture(sceneTexture, vec2(texPos0.x, texPos12.y)).rgb * w0.x * w12.y;
+	result += texture(sceneTexture, vec2(texPos12.x, texPos12.y)).rgb * w12.x * w12.y;
+	result += texture(sceneTexture, vec2(texPos3.x, texPos12.y)).rgb * w3.x * w12.y;
+
+	result += texture(sceneTexture, vec2(texPos0.x, texPos3.y)).rgb * w0.x * w3.y;
+	result += texture(sceneTexture, vec2(texPos12.x, texPos3.y)).rgb * w12.x * w3.y;
+	result += texture(sceneTexture, vec2(texPos3.x, texPos3.y)).rgb * w3.x * w3.y;
+
+	// The negative lobes can overshoot below zero next to very bright pixels
+	FragColour = vec4(max(result, vec3(0.0)), 1.0);
+}
@@ -2,12 +2,26 @@
 #version 430 core
 
 layout (location = 0) in vec3 position;
-
+layout (location = 7) in uint drawIndex; // Only meaningful for indirect draws, where it's the draw's index into the draw data
+
+struct DrawData {
+	mat4 model;
+	mat4 previousModel;
+	mat3 normalMatrix;
+	int layerMask;
+	int materialIndex;
+};
+layout (std430, binding = 8) readonly buffer DrawDataBuffer {
+	DrawData drawData[];
+};
+
+uniform bool drawIndirect;
 uniform mat4 lightSpaceViewProjectionMatrix;
 uniform mat4 model;
 
 void main() {
-	gl_Position = lightSpaceViewProjectionMatrix * model * vec4(position, 1.0f);
+	mat4 modelMatrix = drawIndirect ? drawData[drawIndex].model : model;
+	gl_Position = lightSpaceViewProjectionMatrix * modelMatrix * vec4(position, 1.0f);
 }
 
 
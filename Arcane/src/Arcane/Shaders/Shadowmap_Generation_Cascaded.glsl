@@ -0,0 +1,78 @@
+#shader-type vertex
+#version 430 core
+
+layout (location = 0) in vec3 position;
+layout (location = 7) in uint drawIndex; // Only meaningful for indirect draws, where it's the draw's index into the draw data
+
+struct DrawData {
+	mat4 model;
+	mat4 previousModel;
+	mat3 normalMatrix;
+	int layerMask;
+	int materialIndex;
+};
+layout (std430, binding = 8) readonly buffer DrawDataBuffer {
+	DrawData drawData[];
+};
+
+uniform bool drawIndirect;
+uniform mat4 model;
+uniform int layerMask; // Cascades the mesh overlaps, meshes are culled against every cascade on the CPU
+
+flat out int vertexLayerMask;
+
+void main() {
+	mat4 modelMatrix = drawIndirect ? drawData[drawIndex].model : model;
+	vertexLayerMask = drawIndirect ? drawData[drawIndex].layerMask : layerMask;
+
+	// Every cascade has it's own projection so only transform to world space, the geometry shader projects into each cascade
+	gl_Position = modelMatrix * vec4(position, 1.0f);
+}
+
+
+
+
+#shader-type geometry
+#version 430 core
+
+#define MAX_SHADOW_CASCADES 4
+
+// One invocation per cascade so every cascade is rendered in a single pass
+layout (triangles, invocations = MAX_SHADOW_CASCADES) in;
+layout (triangle_strip, max_vertices = 3) out;
+
+uniform mat4 lightSpaceViewProjectionMatrices[MAX_SHADOW_CASCADES];
+uniform int cascadeCount;
+flat in int vertexLayerMask[];
+
+void main() {
+	if (gl_InvocationID >= cascadeCount || (vertexLayerMask[0] & (1 << gl_InvocationID)) == 0)
+		return;
+
+	vec4 clipPositions[3];
+	for (int i = 0; i < 3; i++)
+		clipPositions[i] = lightSpaceViewProjectionMatrices[gl_InvocationID] * gl_in[i].gl_Position;
+
+	// Cull triangles that are outside of the cascade's bounds (orthographic projection so w is always 1). Near plane isn't tested since casters in front of it get pancaked by depth clamping
+	vec2 clipMin = min(min(clipPositions[0].xy, clipPositions[1].xy), clipPositions[2].xy);
+	vec2 clipMax = max(max(clipPositions[0].xy, clipPositions[1].xy), clipPositions[2].xy);
+	if (any(greaterThan(clipMin, vec2(1.0))) || any(lessThan(clipMax, vec2(-1.0))))
+		return;
+
+	for (int i = 0; i < 3; i++) {
+		gl_Layer = gl_InvocationID;
+		gl_Position = clipPositions[i];
+		EmitVertex();
+	}
+	EndPrimitive();
+}
+
+
+
+
+#shader-type fragment
+#version 430 core
+
+void main() {
+	// Nothing needs to be done, we just need to write to the depth buffer
+}
@@ -0,0 +1,70 @@
+#shader-type vertex
+#version 430 core
+
+layout (location = 0) in vec3 position;
+layout (location = 5) in ivec4 boneIds;
+layout (location = 6) in vec4 weights;
+
+uniform mat4 model;
+
+const int MAX_BONES = 100;
+const int MAX_BONES_PER_VERTEX = 4;
+uniform mat4 bonesMatrices[MAX_BONES];
+
+void main() {
+	mat4 boneTransform = bonesMatrices[boneIds[0]] * weights[0] +
+						 bonesMatrices[boneIds[1]] * weights[1] +
+						 bonesMatrices[boneIds[2]] * weights[2] +
+						 bonesMatrices[boneIds[3]] * weights[3];
+
+	// Every cascade has it's own projection so only transform to world space, the geometry shader projects into each cascade
+	gl_Position = model * boneTransform * vec4(position, 1.0f);
+}
+
+
+
+
+#shader-type geometry
+#version 430 core
+
+#define MAX_SHADOW_CASCADES 4
+
+// One invocation per cascade so every cascade is rendered in a single pass
+layout (triangles, invocations = MAX_SHADOW_CASCADES) in;
+layout (triangle_strip, max_vertices = 3) out;
+
+uniform mat4 lightSpaceViewProjectionMatrices[MAX_SHADOW_CASCADES];
+uniform int cascadeCount;
+uniform int layerMask; // Cascades the mesh overlaps, meshes are culled against every cascade on the CPU
+
+void main() {
+	if (gl_InvocationID >= cascadeCount || (layerMask & (1 << gl_InvocationID)) == 0)
+		return;
+
+	vec4 clipPositions[3];
+	for (int i = 0; i < 3; i++)
+		clipPositions[i] = lightSpaceViewProjectionMatrices[gl_InvocationID] * gl_in[i].gl_Position;
+
+	// Cull triangles that are outside of the cascade's bounds (orthographic projection so w is always 1). Near plane isn't tested since casters in front of it get pancaked by depth clamping
+	vec2 clipMin = min(min(clipPositions[0].xy, clipPositions[1].xy), clipPositions[2].xy);
+	vec2 clipMax = max(max(clipPositions[0].xy, clipPositions[1].xy), clipPositions[2].xy);
+	if (any(greaterThan(clipMin, vec2(1.0))) || any(lessThan(clipMax, vec2(-1.0))))
+		return;
+
+	for (int i = 0; i < 3; i++) {
+		gl_Layer = gl_InvocationID;
+		gl_Position = clipPositions[i];
+		EmitVertex();
+	}
+	EndPrimitive();
+}
+
+
+
+
+#shader-type fragment
+#version 430 core
+
+void main() {
+	// Nothing needs to be done, we just need to write to the depth buffer
+}
@@ -2,15 +2,72 @@
 #version 430 core
 
 layout (location = 0) in vec3 position;
+layout (location = 7) in uint drawIndex; // Only meaningful for indirect draws, where it's the draw's index into the draw data
 
-out vec4 worldFragPos;
+struct DrawData {
+	mat4 model;
+	mat4 previousModel;
+	mat3 normalMatrix;
+	int layerMask;
+	int materialIndex;
+};
+layout (std430, binding = 8) readonly buffer DrawDataBuffer {
+	DrawData drawData[];
+};
 
-uniform mat4 lightSpaceViewProjectionMatrix;
+uniform bool drawIndirect;
 uniform mat4 model;
+uniform int layerMask; // Faces the mesh overlaps, meshes are culled against every face on the CPU
+
+flat out int vertexLayerMask;
+
+void main() {
+	mat4 modelMatrix = drawIndirect ? drawData[drawIndex].model : model;
+	vertexLayerMask = drawIndirect ? drawData[drawIndex].layerMask : layerMask;
+
+	// Every cube face has it's own projection so only transform to world space, the geometry shader projects into each face
+	gl_Position = modelMatrix * vec4(position, 1.0f);
+}
+
+
+
+
+#shader-type geometry
+#version 430 core
+
+// One invocation per cube face so every face of the point light is rendered in a single pass, each face has it's own viewport in the shadow atlas
+layout (triangles, invocations = 6) in;
+layout (triangle_strip, max_vertices = 3) out;
+
+out vec4 worldFragPos;
+
+uniform mat4 lightSpaceViewProjectionMatrices[6];
+uniform int faceMask; // Faces that are being rendered this pass
+flat in int vertexLayerMask[];
 
 void main() {
-	worldFragPos = model * vec4(position, 1.0f);
-	gl_Position = lightSpaceViewProjectionMatrix * worldFragPos;
+	if ((faceMask & vertexLayerMask[0] & (1 << gl_InvocationID)) == 0)
+		return;
+
+	vec4 clipPositions[3];
+	for (int i = 0; i < 3; i++)
+		clipPositions[i] = lightSpaceViewProjectionMatrices[gl_InvocationID] * gl_in[i].gl_Position;
+
+	// Cull triangles that are entirely outside of one of the face's frustum planes, so a triangle usually only ends up being rasterized by one or two faces
+	for (int axis = 0; axis < 3; axis++) {
+		if (clipPositions[0][axis] > clipPositions[0].w && clipPositions[1][axis] > clipPositions[1].w && clipPositions[2][axis] > clipPositions[2].w)
+			return;
+		if (clipPositions[0][axis] < -clipPositions[0].w && clipPositions[1][axis] < -clipPositions[1].w && clipPositions[2][axis] < -clipPositions[2].w)
+			return;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		gl_ViewportIndex = gl_InvocationID;
+		worldFragPos = gl_in[i].gl_Position;
+		gl_Position = clipPositions[i];
+		EmitVertex();
+	}
+	EndPrimitive();
 }
 
 
@@ -5,9 +5,6 @@ layout (location = 0) in vec3 position;
 layout (location = 5) in ivec4 boneIds;
 layout (location = 6) in vec4 weights;
 
-out vec4 worldFragPos;
-
-uniform mat4 lightSpaceViewProjectionMatrix;
 uniform mat4 model;
 
 const int MAX_BONES = 100;
@@ -20,8 +17,49 @@ void main() {
 						 bonesMatrices[boneIds[2]] * weights[2] +
 						 bonesMatrices[boneIds[3]] * weights[3];
 
-	worldFragPos = model * boneTransform * vec4(position, 1.0f);
-	gl_Position = lightSpaceViewProjectionMatrix * worldFragPos;
+	// Every cube face has it's own projection so only transform to world space, the geometry shader projects into each face
+	gl_Position = model * boneTransform * vec4(position, 1.0f);
+}
+
+
+
+
+#shader-type geometry
+#version 430 core
+
+// One invocation per cube face so every face of the point light is rendered in a single pass, each face has it's own viewport in the shadow atlas
+layout (triangles, invocations = 6) in;
+layout (triangle_strip, max_vertices = 3) out;
+
+out vec4 worldFragPos;
+
+uniform mat4 lightSpaceViewProjectionMatrices[6];
+uniform int faceMask; // Faces that are being rendered this pass
+uniform int layerMask; // Faces the mesh overlaps, meshes are culled against every face on the CPU
+
+void main() {
+	if ((faceMask & layerMask & (1 << gl_InvocationID)) == 0)
+		return;
+
+	vec4 clipPositions[3];
+	for (int i = 0; i < 3; i++)
+		clipPositions[i] = lightSpaceViewProjectionMatrices[gl_InvocationID] * gl_in[i].gl_Position;
+
+	// Cull triangles that are entirely outside of one of the face's frustum planes, so a triangle usually only ends up being rasterized by one or two faces
+	for (int axis = 0; axis < 3; axis++) {
+		if (clipPositions[0][axis] > clipPositions[0].w && clipPositions[1][axis] > clipPositions[1].w && clipPositions[2][axis] > clipPositions[2].w)
+			return;
+		if (clipPositions[0][axis] < -clipPositions[0].w && clipPositions[1][axis] < -clipPositions[1].w && clipPositions[2][axis] < -clipPositions[2].w)
+			return;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		gl_ViewportIndex = gl_InvocationID;
+		worldFragPos = gl_in[i].gl_Position;
+		gl_Position = clipPositions[i];
+		EmitVertex();
+	}
+	EndPrimitive();
 }
 
 
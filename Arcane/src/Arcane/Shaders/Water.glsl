@@ -31,8 +31,6 @@ void main() {
 #version 430 core
 
 #define MAX_DIR_LIGHTS 3
-#define MAX_POINT_LIGHTS 6
-#define MAX_SPOT_LIGHTS 6
 
 struct DirLight {
 	vec3 direction;
@@ -41,23 +39,25 @@ struct DirLight {
 	vec3 lightColour;
 };
 
+// Point and spot lights are stored in SSBOs (std430) and must match GPUPointLight and GPUSpotLight
 struct PointLight {
 	vec3 position;
+	float attenuationRadius;
 
-	float intensity;
 	vec3 lightColour;
-	float attenuationRadius;
+	float intensity;
 };
 
 struct SpotLight {
 	vec3 position;
-	vec3 direction;
+	float attenuationRadius;
 
+	vec3 direction;
 	float intensity;
-	vec3 lightColour;
-	float attenuationRadius;
 
+	vec3 lightColour;
 	float cutOff;
+
 	float outerCutOff;
 };
 
@@ -75,14 +75,38 @@ uniform sampler2D dudvWaveTexture;
 uniform sampler2D normalMap;
 uniform sampler2D refractionDepthTexture;
 
+// Screen space reflections (reflection probe is the fallback for misses)
+uniform bool screenSpaceReflection;
+uniform sampler2D hiZBuffer; // r = closest depth, g = furthest depth of the opaque scene
+uniform sampler2D sceneColourTexture;
+uniform int hiZMaxLevel;
+uniform ivec2 hiZBaseSize; // Part of the pyramid's base mip that was built this frame
+uniform float renderScale; // Fraction of the scene colour that was rendered to this frame (dynamic resolution)
+uniform int ssrMaxIterations;
+uniform float ssrThickness;
+uniform samplerCube prefilterMap;
+
 // Lighting
 uniform ivec4 numDirPointSpotLights;
 uniform DirLight dirLights[MAX_DIR_LIGHTS];
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
-uniform SpotLight spotLights[MAX_SPOT_LIGHTS];
+layout (std430, binding = 0) readonly buffer PointLightBuffer { PointLight pointLights[]; };
+layout (std430, binding = 1) readonly buffer SpotLightBuffer { SpotLight spotLights[]; };
 
+// Light Clusters (each cluster is an offset into lightIndices followed by its point light count and spot light count packed as (point | spot << 16))
+layout (std430, binding = 2) readonly buffer LightClusterBuffer { uvec2 lightClusters[]; };
+layout (std430, binding = 3) readonly buffer LightIndexBuffer { uint lightIndices[]; };
+uniform ivec3 clusterGridSize;
+uniform vec2 clusterZParams;
+uniform mat4 clusterView;
+uniform mat4 clusterProjection;
+
+uniform mat4 view;
+uniform mat4 projection;
 uniform mat4 viewInverse;
 uniform mat4 projectionInverse;
+uniform mat4 reflectionViewProjection; // Mirrored camera the reflection texture was rendered with
+uniform vec4 reflectionAtlasScaleBias; // Tile of the reflection/refraction atlas this water's capture was rendered to (xy = scale, zw = offset)
+uniform vec4 refractionAtlasScaleBias;
 
 uniform bool reflectionEnabled;
 uniform bool refractionEnabled;
@@ -98,12 +122,21 @@ uniform float depthDampeningEffect;
 
 // Function Declarations
 vec3 WorldPosFromDepth(vec2 texCoords);
+vec2 TileToAtlasCoords(vec2 tileCoords, vec4 atlasScaleBias, vec2 atlasSize);
+vec3 ScreenSpaceReflection(vec3 normal, vec3 viewVec);
+vec3 ProjectToScreen(vec3 viewPos);
+float LinearizeDepth(float depth);
+bool TraceHiZ(vec3 rayStart, vec3 rayDir, out vec3 hitPoint);
+vec3 IntersectCellBoundary(vec3 rayOrigin, vec3 rayDir, vec2 cell, vec2 cellCount, vec2 crossStep, vec2 crossOffset);
+uint GetLightClusterIndex(vec3 worldPos);
 
 void main() {
 	vec2 ndc = clipSpace.xy / clipSpace.w;
 	vec2 textureCoords = ndc * 0.5 + 0.5;
 
-	vec2 reflectCoords = vec2(textureCoords.x, 1.0 - textureCoords.y);
+	// The surface is projected with the mirrored camera the reflection was rendered with, this also reprojects reflections that weren't re-rendered this frame
+	vec4 reflectionClipSpace = reflectionViewProjection * vec4(worldFragPos, 1.0);
+	vec2 reflectCoords = (reflectionClipSpace.xy / reflectionClipSpace.w) * 0.5 + 0.5;
 	vec2 refractCoords = vec2(textureCoords.x, textureCoords.y);
 
 	// Apply offset to the sampled coords for the refracted & reflected texture
@@ -129,15 +162,15 @@ void main() {
 
 	vec4 reflectedColour = vec4(1.0, 1.0, 1.0, 1.0);
 	vec4 refractedColour = vec4(1.0, 1.0, 1.0, 1.0);
-	if (reflectionEnabled) {
+	if (reflectionEnabled && !screenSpaceReflection) {
 		reflectCoords += totalDistortion;
 		reflectCoords = clamp(reflectCoords, 0.0001, 0.9999);
-		reflectedColour = texture(reflectionTexture, reflectCoords);
+		reflectedColour = texture(reflectionTexture, TileToAtlasCoords(reflectCoords, reflectionAtlasScaleBias, textureSize(reflectionTexture, 0)));
 	}
 	if (refractionEnabled) {
 		refractCoords += totalDistortion;
 		refractCoords = clamp(refractCoords, 0.0001, 0.9999);
-		refractedColour = texture(refractionTexture, refractCoords);
+		refractedColour = texture(refractionTexture, TileToAtlasCoords(refractCoords, refractionAtlasScaleBias, textureSize(refractionTexture, 0)));
 	}
 
 	// Calculate other light properties
@@ -152,6 +185,11 @@ void main() {
 	
 	vec3 viewVec = normalize(fragToView);
 
+	// Screen space reflections are traced with the wave normal instead of being distorted afterwards
+	if (reflectionEnabled && screenSpaceReflection) {
+		reflectedColour = vec4(ScreenSpaceReflection(normal, viewVec), 1.0);
+	}
+
 	// Specular (reflection) light highlights
 	vec3 specHighlight = vec3(0.0, 0.0, 0.0);
 	if (shouldShine) {
@@ -162,8 +200,12 @@ void main() {
 			specHighlight += dirLights[i].intensity * dirLights[i].lightColour * specular * dampeningEffect2;
 		}
 
-		// Point light specular contribution
-		for (int i = 0; i < numDirPointSpotLights.y; i++) {
+		// Point light specular contribution (only the lights in this fragment's cluster)
+		uvec2 lightCluster = lightClusters[GetLightClusterIndex(worldFragPos)];
+		uint clusterPointLightCount = lightCluster.y & 0xFFFFu;
+		uint clusterSpotLightCount = lightCluster.y >> 16;
+		for (uint clusterLight = 0; clusterLight < clusterPointLightCount; clusterLight++) {
+			int i = int(lightIndices[lightCluster.x + clusterLight]);
 			vec3 lightToFrag = worldFragPos - pointLights[i].position;
 			vec3 reflectedVec = reflect(normalize(lightToFrag), normal);
 			float specular = pow(max(dot(reflectedVec, viewVec), 0.0), shineDamper);
@@ -180,7 +222,8 @@ void main() {
 		}
 
 		// Spot light specular contribution
-		for (int i = 0; i < numDirPointSpotLights.z; i++) {
+		for (uint clusterLight = 0; clusterLight < clusterSpotLightCount; clusterLight++) {
+			int i = int(lightIndices[lightCluster.x + clusterPointLightCount + clusterLight]);
 			vec3 lightToFrag = worldFragPos - spotLights[i].position;
 			vec3 lightToFragNorm = normalize(lightToFrag);
 			vec3 reflectedVec = reflect(lightToFragNorm, normal);
@@ -221,7 +264,7 @@ void main() {
 }
 
 vec3 WorldPosFromDepth(vec2 texCoords) {
-	float z = 2.0 * texture(refractionDepthTexture, texCoords).r - 1.0; // [-1, 1]
+	float z = 2.0 * texture(refractionDepthTexture, TileToAtlasCoords(texCoords, refractionAtlasScaleBias, textureSize(refractionDepthTexture, 0))).r - 1.0; // [-1, 1]
 	vec4 clipSpacePos = vec4(texCoords * 2.0 - 1.0 , z, 1.0);
 	vec4 viewSpacePos = projectionInverse * clipSpacePos;
 	viewSpacePos /= viewSpacePos.w; // Perspective division
@@ -230,3 +273,102 @@ vec3 WorldPosFromDepth(vec2 texCoords) {
 
 	return worldSpacePos.xyz;
 }
+
+// Keeps half a texel inside of the tile so bilinear filtering never reads a neighbouring tile in the atlas
+vec2 TileToAtlasCoords(vec2 tileCoords, vec4 atlasScaleBias, vec2 atlasSize) {
+	vec2 halfTexel = 0.5 / atlasSize;
+	return clamp(tileCoords * atlasScaleBias.xy + atlasScaleBias.zw, atlasScaleBias.zw + halfTexel, atlasScaleBias.zw + atlasScaleBias.xy - halfTexel);
+}
+
+// Traces the reflected view ray against the depth pyramid of the opaque scene, blending to the reflection probe as the hit becomes less reliable
+vec3 ScreenSpaceReflection(vec3 normal, vec3 viewVec) {
+	vec3 reflectDir = reflect(-viewVec, normal);
+	vec3 probeColour = textureLod(prefilterMap, reflectDir, 0.0).rgb;
+
+	vec3 viewPos = (view * vec4(worldFragPos, 1.0)).xyz;
+	vec3 viewReflectDir = normalize(mat3(view) * reflectDir);
+	if (viewReflectDir.z > 0.0) {
+		return probeColour; // Rays towards the camera can only hit surfaces that weren't rendered
+	}
+
+	vec3 screenStart = ProjectToScreen(viewPos);
+	vec3 screenEnd = ProjectToScreen(viewPos + viewReflectDir);
+	vec3 hitPoint;
+	if (!TraceHiZ(screenStart, screenEnd - screenStart, hitPoint)) {
+		return probeColour;
+	}
+
+	vec2 edgeFade = smoothstep(vec2(0.0), vec2(0.1), hitPoint.xy) * (1.0 - smoothstep(vec2(0.9), vec2(1.0), hitPoint.xy));
+	return mix(probeColour, texture(sceneColourTexture, hitPoint.xy * renderScale).rgb, edgeFade.x * edgeFade.y);
+}
+
+// Returns (texture coordinates, depth), depth after the perspective divide is linear in screen space so the ray can be stepped linearly
+vec3 ProjectToScreen(vec3 viewPos) {
+	vec4 clipSpacePos = projection * vec4(viewPos, 1.0);
+	return (clipSpacePos.xyz / clipSpacePos.w) * 0.5 + 0.5;
+}
+
+float LinearizeDepth(float depth) {
+	return projection[3][2] / ((depth * 2.0 - 1.0) + projection[2][2]);
+}
+
+// Walks the ray through the depth pyramid. Cells the ray passes entirely in front of (or too far behind) are stepped over and the trace moves up a mip,
+// otherwise the trace moves down a mip. A hit is found once the trace moves below the base mip
+bool TraceHiZ(vec3 rayStart, vec3 rayDir, out vec3 hitPoint) {
+	if (abs(rayDir.x) < 0.00001) rayDir.x = 0.00001;
+	if (abs(rayDir.y) < 0.00001) rayDir.y = 0.00001;
+	vec2 crossStep = vec2(rayDir.x >= 0.0 ? 1.0 : 0.0, rayDir.y >= 0.0 ? 1.0 : 0.0);
+	vec2 crossOffset = (crossStep * 2.0 - 1.0) * 0.00001; // Nudges the ray over the boundary so it lands in the next cell
+
+	vec2 baseCellCount = vec2(hiZBaseSize);
+	vec3 ray = IntersectCellBoundary(rayStart, rayDir, floor(rayStart.xy * baseCellCount), baseCellCount, crossStep, crossOffset);
+
+	int level = 0;
+	int iterations = 0;
+	while (level >= 0 && iterations < ssrMaxIterations) {
+		if (any(lessThan(ray.xy, vec2(0.0))) || any(greaterThanEqual(ray.xy, vec2(1.0))) || ray.z <= 0.0 || ray.z >= 1.0) {
+			return false;
+		}
+
+		vec2 cellCount = vec2(max(hiZBaseSize >> level, ivec2(1)));
+		vec2 cell = floor(ray.xy * cellCount);
+		vec2 minMaxDepth = texelFetch(hiZBuffer, ivec2(cell), level).rg;
+
+		// Rays moving away from the camera can jump straight to the closest depth in the cell
+		vec3 tmpRay = ray;
+		if (rayDir.z > 0.0 && ray.z < minMaxDepth.x) {
+			tmpRay = ray + rayDir * ((minMaxDepth.x - ray.z) / rayDir.z);
+		}
+
+		bool inFrontOfCell = tmpRay.z < minMaxDepth.x;
+		bool behindCell = LinearizeDepth(tmpRay.z) > LinearizeDepth(minMaxDepth.y) + ssrThickness;
+		if (floor(tmpRay.xy * cellCount) != cell || inFrontOfCell || behindCell) {
+			tmpRay = IntersectCellBoundary(ray, rayDir, cell, cellCount, crossStep, crossOffset);
+			level = min(hiZMaxLevel, level + 2);
+		}
+
+		ray = tmpRay;
+		level--;
+		iterations++;
+	}
+
+	hitPoint = ray;
+	return level < 0;
+}
+
+vec3 IntersectCellBoundary(vec3 rayOrigin, vec3 rayDir, vec2 cell, vec2 cellCount, vec2 crossStep, vec2 crossOffset) {
+	vec2 boundary = (cell + crossStep) / cellCount + crossOffset;
+	vec2 t = (boundary - rayOrigin.xy) / rayDir.xy;
+	return rayOrigin + rayDir * min(t.x, t.y);
+}
+
+// Finds the cluster a world space position falls in, so only the lights overlapping that cluster need to be iterated
+uint GetLightClusterIndex(vec3 worldPos) {
+	vec4 viewSpacePos = clusterView * vec4(worldPos, 1.0);
+	vec4 clipSpacePos = clusterProjection * viewSpacePos;
+	vec2 screenUV = clamp((clipSpacePos.xy / clipSpacePos.w) * 0.5 + 0.5, 0.0, 0.9999);
+
+	int slice = clamp(int(log(max(-viewSpacePos.z, 0.0001)) * clusterZParams.x - clusterZParams.y), 0, clusterGridSize.z - 1);
+	ivec2 tile = ivec2(screenUV * vec2(clusterGridSize.xy));
+	return uint(tile.x + tile.y * clusterGridSize.x + slice * clusterGridSize.x * clusterGridSize.y);
+}
@@ -8,7 +8,7 @@
 
 namespace Arcane
 {
-	Terrain::Terrain(glm::vec3 &worldPosition) : m_Position(worldPosition)
+	Terrain::Terrain(glm::vec3 &worldPosition) : m_Position(worldPosition), m_MinHeight(0.0f)
 	{
 		m_GLCache = GLCache::GetInstance();
 
@@ -158,12 +158,15 @@ namespace Arcane
 
 		m_Textures[20] = assetManager.Load2DTextureAsync(std::string("res/terrain/blendMap.tga"), &textureSettings);
 
+		CalculateOccluderBoxes(positions);
+
 		m_Mesh = new Mesh(std::move(positions), std::move(uvs), std::move(normals), std::move(tangents), std::move(bitangents), std::move(indices));
 		m_Mesh->LoadData(true);
 		m_Mesh->GenerateGpuData();
 	}
 
 	Terrain::~Terrain() {
+		m_Mesh->ReleaseGpuData();
 		delete m_Mesh;
 	}
 
@@ -234,13 +237,47 @@ namespace Arcane
 		shader->SetUniform("model", m_ModelMatrix);
 
 		m_GLCache->SetDepthTest(true);
-		m_GLCache->SetDepthFunc(GL_LESS);
 		m_GLCache->SetBlend(false);
 		m_GLCache->SetFaceCull(true);
 		m_GLCache->SetCullFace(GL_BACK);
 		m_Mesh->Draw();
 	}
 
+	// Every chunk's box goes from the lowest point of the whole terrain up to the lowest vertex in the chunk (including the vertices on its borders), the surface is
+	// linear between vertices so it never dips below that. Anything inside or behind the box is hidden by the terrain as long as it's viewed from above the box's bottom
+	void Terrain::CalculateOccluderBoxes(const std::vector<glm::vec3> &positions) {
+		m_MinHeight = std::numeric_limits<float>::max();
+		for (const glm::vec3 &position : positions) {
+			m_MinHeight = glm::min(m_MinHeight, position.y);
+		}
+
+		unsigned int quadsPerSide = m_SideVertexCount - 1;
+		unsigned int chunksPerSide = glm::min((unsigned int)TERRAIN_OCCLUDER_CHUNKS_PER_SIDE, quadsPerSide);
+		m_OccluderBoxes.clear();
+		m_OccluderBoxes.reserve(chunksPerSide * chunksPerSide);
+		for (unsigned int chunkZ = 0; chunkZ < chunksPerSide; chunkZ++) {
+			unsigned int startZ = chunkZ * quadsPerSide / chunksPerSide, endZ = (chunkZ + 1) * quadsPerSide / chunksPerSide;
+			for (unsigned int chunkX = 0; chunkX < chunksPerSide; chunkX++) {
+				unsigned int startX = chunkX * quadsPerSide / chunksPerSide, endX = (chunkX + 1) * quadsPerSide / chunksPerSide;
+
+				float chunkMinHeight = std::numeric_limits<float>::max();
+				for (unsigned int z = startZ; z <= endZ; z++) {
+					for (unsigned int x = startX; x <= endX; x++) {
+						chunkMinHeight = glm::min(chunkMinHeight, positions[x + z * m_SideVertexCount].y);
+					}
+				}
+
+				const glm::vec3 &cornerMin = positions[startX + startZ * m_SideVertexCount];
+				const glm::vec3 &cornerMax = positions[endX + endZ * m_SideVertexCount];
+				TerrainOccluderBox box;
+				box.BoundsMin = m_Position + glm::vec3(cornerMin.x, m_MinHeight, cornerMin.z);
+				box.BoundsMax = m_Position + glm::vec3(cornerMax.x, chunkMinHeight, cornerMax.z);
+				m_OccluderBoxes.push_back(box);
+			}
+		}
+		m_MinHeight += m_Position.y;
+	}
+
 	// Bilinear filtering for the terrain's normal
 	glm::vec3 Terrain::CalculateNormal(float worldPosX, float worldPosZ, unsigned char *heightMapData) {
 		float heightR = SampleHeightfieldNearest(worldPosX + m_SpaceBetweenVertices * 2, worldPosZ                         , heightMapData);
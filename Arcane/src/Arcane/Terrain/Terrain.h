@@ -12,6 +12,13 @@ namespace Arcane
 	class Mesh;
 	class GLCache;
 
+	// World space box under the lowest point of a chunk of the terrain, used as an occluder by the software occlusion rasterizer
+	struct TerrainOccluderBox
+	{
+		glm::vec3 BoundsMin;
+		glm::vec3 BoundsMax;
+	};
+
 	class Terrain
 	{
 	public:
@@ -21,7 +28,10 @@ namespace Arcane
 		void Draw(Shader *shader, RenderPassType pass) const;
 
 		inline const glm::vec3& GetPosition() const { return m_Position; }
+		inline const std::vector<TerrainOccluderBox>& GetOccluderBoxes() const { return m_OccluderBoxes; }
+		inline float GetMinHeight() const { return m_MinHeight; } // World space height of the terrain's lowest point, the occluder boxes are only valid when viewed from above it
 	private:
+		void CalculateOccluderBoxes(const std::vector<glm::vec3> &positions);
 		glm::vec3 CalculateNormal(float worldPosX, float worldPosZ, unsigned char *heightMapData);
 
 		float SampleHeightfieldBilinear(float worldPosX, float worldPosZ, unsigned char *heightMapData);
@@ -45,6 +55,9 @@ namespace Arcane
 		glm::vec3 m_Position;
 		Mesh *m_Mesh;
 		std::array<Texture*, 21> m_Textures; // Represents all the textures supported by the terrain's texure splatting (rgba and the default value)
+
+		std::vector<TerrainOccluderBox> m_OccluderBoxes;
+		float m_MinHeight;
 	};
 }
 #endif
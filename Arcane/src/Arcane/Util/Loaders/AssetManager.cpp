@@ -73,6 +73,17 @@ namespace Arcane
 		return model;
 	}
 
+	std::string AssetManager::GetModelPath(Model *model)
+	{
+		for (auto &cachedModel : m_ModelCache)
+		{
+			if (cachedModel.second == model)
+				return cachedModel.first;
+		}
+
+		return std::string();
+	}
+
 	// Function force loads a texture on the main thread and blocks until it is generated
 	Texture* AssetManager::Load2DTexture(const std::string &path, TextureSettings *settings)
 	{
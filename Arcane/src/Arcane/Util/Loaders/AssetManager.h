@@ -44,6 +44,7 @@ namespace Arcane
 
 		Model* LoadModel(const std::string &path);
 		Model* LoadModelAsync(const std::string &path);
+		std::string GetModelPath(Model *model); // Returns an empty string if the model wasn't loaded through the asset manager
 
 		Texture* Load2DTexture(const std::string &path, TextureSettings *settings = nullptr);
 		Texture* Load2DTextureAsync(const std::string &path, TextureSettings *settings = nullptr);
@@ -11,8 +11,16 @@ namespace Arcane
 	std::hash<std::string> ShaderLoader::s_Hasher;
 
 	Shader* ShaderLoader::LoadShader(const std::string &path) {
+		return LoadShader(path, std::vector<std::string>());
+	}
+
+	Shader* ShaderLoader::LoadShader(const std::string &path, const std::vector<std::string> &defines) {
 		std::string shaderPath = s_ShaderFilepath + path;
-		std::size_t hash = s_Hasher(shaderPath);
+		std::string variantKey = shaderPath;
+		for (const std::string &define : defines) {
+			variantKey += "|" + define;
+		}
+		std::size_t hash = s_Hasher(variantKey);
 
 		// Check the cache
 		auto iter = s_ShaderCache.find(hash);
@@ -21,7 +29,7 @@ namespace Arcane
 		}
 
 		// Load the shader
-		Shader *shader = new Shader(shaderPath);
+		Shader *shader = new Shader(shaderPath, defines);
 
 		s_ShaderCache.insert(std::pair<std::size_t, Shader*>(hash, shader));
 		return s_ShaderCache[hash];
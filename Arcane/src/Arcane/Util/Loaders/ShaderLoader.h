@@ -10,6 +10,7 @@ namespace Arcane
 	{
 	public:
 		static Shader* LoadShader(const std::string &path);
+		static Shader* LoadShader(const std::string &path, const std::vector<std::string> &defines); // Compiles a variant of the shader with each define set, variants are cached separately
 		inline static void SetShaderFilepath(const std::string &path) { s_ShaderFilepath = path; }
 	private:
 		static std::string s_ShaderFilepath;